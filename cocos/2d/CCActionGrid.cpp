@@ -27,6 +27,8 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "2d/CCGrid.h"
 #include "2d/CCNodeGrid.h"
+#include "renderer/CCGLProgramCache.h"
+#include "renderer/CCGLProgramState.h"
 
 NS_CC_BEGIN
 // implementation of GridAction
@@ -98,11 +100,100 @@ GridBase* GridAction::getGrid()
 
 // implementation of Grid3DAction
 
+bool Grid3DAction::s_shaderEffectsEnabled = true;
+
+void Grid3DAction::setShaderEffectsEnabled(bool enabled)
+{
+    s_shaderEffectsEnabled = enabled;
+}
+
+bool Grid3DAction::isShaderEffectsEnabled()
+{
+    return s_shaderEffectsEnabled;
+}
+
+Grid3DAction::Grid3DAction()
+: _effectGLProgramState(nullptr)
+, _isEffectRunning(false)
+, _effectTime(0)
+{
+}
+
+Grid3DAction::~Grid3DAction()
+{
+    CC_SAFE_RELEASE(_effectGLProgramState);
+}
+
 GridBase* Grid3DAction::getGrid()
 {
     return Grid3D::create(_gridSize);
 }
 
+void Grid3DAction::startWithTarget(Node *target)
+{
+    GridAction::startWithTarget(target);
+
+    Grid3D *g = dynamic_cast<Grid3D*>(_gridNodeTarget->getGrid());
+    const char* programName = getEffectGLProgramName();
+    _isEffectRunning = g && programName && s_shaderEffectsEnabled;
+
+    if (_isEffectRunning)
+    {
+        if (!_effectGLProgramState)
+        {
+            _effectGLProgramState = GLProgramState::create(GLProgramCache::getInstance()->getGLProgram(programName));
+            _effectGLProgramState->retain();
+        }
+        _effectTime = 0;
+        g->setEffectGLProgramState(_effectGLProgramState);
+    }
+    else if (g)
+    {
+        // a reused grid may still run the effect of the previous action
+        g->setEffectGLProgramState(nullptr);
+    }
+}
+
+void Grid3DAction::stop()
+{
+    if (_isEffectRunning)
+    {
+        _isEffectRunning = false;
+
+        // the last frame is computed on the CPU too, so that the grid keeps the same vertices
+        // when the next action reuses it or when the effect of the program is removed
+        Grid3D *g = dynamic_cast<Grid3D*>(_gridNodeTarget->getGrid());
+        if (g && g->getEffectGLProgramState() == _effectGLProgramState)
+        {
+            g->setEffectGLProgramState(nullptr);
+            update(_effectTime);
+        }
+    }
+
+    GridAction::stop();
+}
+
+bool Grid3DAction::updateWithShader(float time)
+{
+    if (!_isEffectRunning)
+        return false;
+
+    _effectTime = time;
+    updateEffect(_effectGLProgramState, time);
+    return true;
+}
+
+void Grid3DAction::setGridUniforms(GLProgramState* glProgramState) const
+{
+    Grid3D *g = (Grid3D*)_gridNodeTarget->getGrid();
+    Vec2 origin = g->getTexCoord(Vec2::ZERO);
+    Vec2 end = g->getTexCoord(Vec2(_gridSize.width, _gridSize.height));
+
+    glProgramState->setUniformVec2("u_gridOrigin", origin);
+    glProgramState->setUniformVec2("u_gridScale", Vec2(_gridSize.width / (end.x - origin.x), _gridSize.height / (end.y - origin.y)));
+    glProgramState->setUniformVec2("u_gridSize", Vec2(_gridSize.width, _gridSize.height));
+}
+
 Vec3 Grid3DAction::getVertex(const Vec2& position) const
 {
     Grid3D *g = (Grid3D*)_gridNodeTarget->getGrid();
@@ -200,6 +291,13 @@ void AccelDeccelAmplitude::startWithTarget(Node *target)
     _other->startWithTarget(target);
 }
 
+void AccelDeccelAmplitude::stop()
+{
+    // the grid effects finish their last frame when they stop
+    _other->stop();
+    ActionInterval::stop();
+}
+
 void AccelDeccelAmplitude::update(float time)
 {
     float f = time * 2;
@@ -272,6 +370,13 @@ void AccelAmplitude::startWithTarget(Node *target)
     _other->startWithTarget(target);
 }
 
+void AccelAmplitude::stop()
+{
+    // the grid effects finish their last frame when they stop
+    _other->stop();
+    ActionInterval::stop();
+}
+
 void AccelAmplitude::update(float time)
 {
     ((AccelAmplitude*)(_other))->setAmplitudeRate(powf(time, _rate));
@@ -328,6 +433,13 @@ void DeccelAmplitude::startWithTarget(Node *target)
     _other->startWithTarget(target);
 }
 
+void DeccelAmplitude::stop()
+{
+    // the grid effects finish their last frame when they stop
+    _other->stop();
+    ActionInterval::stop();
+}
+
 void DeccelAmplitude::update(float time)
 {
     ((DeccelAmplitude*)(_other))->setAmplitudeRate(powf((1 - time), _rate));
@@ -33,6 +33,7 @@ NS_CC_BEGIN
 
 class GridBase;
 class NodeGrid;
+class GLProgramState;
 
 /**
  * @addtogroup actions
@@ -75,6 +76,13 @@ private:
 class CC_DLL Grid3DAction : public GridAction
 {
 public:
+    /** Whether the actions that support it (Waves3D, Ripple3D, Liquid, Waves and Twirl) displace the grid
+     in a vertex shader instead of computing its vertices on the CPU every frame. Enabled by default.
+     @since v3.2
+     */
+    static void setShaderEffectsEnabled(bool enabled);
+    static bool isShaderEffectsEnabled();
+
 
     /** returns the grid */
     virtual GridBase* getGrid();
@@ -110,6 +118,27 @@ public:
 
     // Overrides
 	virtual Grid3DAction * clone() const override = 0;
+    virtual void startWithTarget(Node *target) override;
+    virtual void stop() override;
+
+protected:
+    Grid3DAction();
+    virtual ~Grid3DAction();
+
+    /** Returns the name of the GLProgram that displaces the grid like update() does, nullptr if the action only runs on the CPU */
+    virtual const char* getEffectGLProgramName() const { return nullptr; }
+    /** Sets the uniforms of the effect program for the given time */
+    virtual void updateEffect(GLProgramState* glProgramState, float time) {}
+    /** Called by update(): returns true when the effect is computed in the vertex shader, after having updated it */
+    bool updateWithShader(float time);
+    /** Sets u_gridOrigin, u_gridScale and u_gridSize, for the effects that use the position of the vertices in the grid */
+    void setGridUniforms(GLProgramState* glProgramState) const;
+
+    GLProgramState* _effectGLProgramState;
+    bool _isEffectRunning;
+    float _effectTime;
+
+    static bool s_shaderEffectsEnabled;
 };
 
 /** @brief Base class for TiledGrid3D actions */
@@ -173,6 +202,7 @@ public:
 
     // Overrides
     virtual void startWithTarget(Node *target) override;
+    virtual void stop() override;
     virtual void update(float time) override;
 	virtual AccelDeccelAmplitude* clone() const override;
 	virtual AccelDeccelAmplitude* reverse() const override;
@@ -206,6 +236,7 @@ public:
 
     // Overrides
     virtual void startWithTarget(Node *target) override;
+    virtual void stop() override;
     virtual void update(float time) override;
 	virtual AccelAmplitude* clone() const override;
 	virtual AccelAmplitude* reverse() const override;
@@ -238,6 +269,7 @@ public:
 
     // overrides
     virtual void startWithTarget(Node *target) override;
+    virtual void stop() override;
     virtual void update(float time) override;
 	virtual DeccelAmplitude* clone() const override;
 	virtual DeccelAmplitude* reverse() const override;
@@ -25,6 +25,8 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "2d/CCActionGrid3D.h"
 #include "base/CCDirector.h"
+#include "renderer/CCGLProgram.h"
+#include "renderer/CCGLProgramState.h"
 #include <stdlib.h>
 
 NS_CC_BEGIN
@@ -74,6 +76,9 @@ Waves3D* Waves3D::clone() const
 
 void Waves3D::update(float time)
 {
+    if (updateWithShader(time))
+        return;
+
     int i, j;
     for (i = 0; i < _gridSize.width + 1; ++i)
     {
@@ -87,6 +92,17 @@ void Waves3D::update(float time)
     }
 }
 
+const char* Waves3D::getEffectGLProgramName() const
+{
+    return GLProgram::SHADER_NAME_GRID3D_WAVES3D;
+}
+
+void Waves3D::updateEffect(GLProgramState* glProgramState, float time)
+{
+    glProgramState->setUniformFloat("u_phase", (float)M_PI * time * _waves * 2);
+    glProgramState->setUniformFloat("u_amplitude", _amplitude * _amplitudeRate);
+}
+
 // implementation of FlipX3D
 
 FlipX3D* FlipX3D::create(float duration)
@@ -447,6 +463,9 @@ Ripple3D* Ripple3D::clone() const
 
 void Ripple3D::update(float time)
 {
+    if (updateWithShader(time))
+        return;
+
     int i, j;
 
     for (i = 0; i < (_gridSize.width+1); ++i)
@@ -469,6 +488,19 @@ void Ripple3D::update(float time)
     }
 }
 
+const char* Ripple3D::getEffectGLProgramName() const
+{
+    return GLProgram::SHADER_NAME_GRID3D_RIPPLE3D;
+}
+
+void Ripple3D::updateEffect(GLProgramState* glProgramState, float time)
+{
+    glProgramState->setUniformVec2("u_center", _position);
+    glProgramState->setUniformFloat("u_radius", _radius);
+    glProgramState->setUniformFloat("u_phase", time * (float)M_PI * _waves * 2);
+    glProgramState->setUniformFloat("u_amplitude", _amplitude * _amplitudeRate);
+}
+
 // implementation of Shaky3D
 
 Shaky3D* Shaky3D::create(float duration, const Size& gridSize, int range, bool shakeZ)
@@ -580,6 +612,9 @@ Liquid* Liquid::clone() const
 
 void Liquid::update(float time)
 {
+    if (updateWithShader(time))
+        return;
+
     int i, j;
 
     for (i = 1; i < _gridSize.width; ++i)
@@ -594,6 +629,18 @@ void Liquid::update(float time)
     }
 }
 
+const char* Liquid::getEffectGLProgramName() const
+{
+    return GLProgram::SHADER_NAME_GRID3D_LIQUID;
+}
+
+void Liquid::updateEffect(GLProgramState* glProgramState, float time)
+{
+    setGridUniforms(glProgramState);
+    glProgramState->setUniformFloat("u_phase", time * (float)M_PI * _waves * 2);
+    glProgramState->setUniformFloat("u_amplitude", _amplitude * _amplitudeRate);
+}
+
 // implementation of Waves
 
 Waves* Waves::create(float duration, const Size& gridSize, unsigned int waves, float amplitude, bool horizontal, bool vertical)
@@ -642,6 +689,9 @@ Waves* Waves::clone() const
 
 void Waves::update(float time)
 {
+    if (updateWithShader(time))
+        return;
+
     int i, j;
 
     for (i = 0; i < _gridSize.width + 1; ++i)
@@ -665,6 +715,18 @@ void Waves::update(float time)
     }
 }
 
+const char* Waves::getEffectGLProgramName() const
+{
+    return GLProgram::SHADER_NAME_GRID3D_WAVES;
+}
+
+void Waves::updateEffect(GLProgramState* glProgramState, float time)
+{
+    glProgramState->setUniformVec2("u_direction", Vec2(_vertical ? 1.0f : 0.0f, _horizontal ? 1.0f : 0.0f));
+    glProgramState->setUniformFloat("u_phase", time * (float)M_PI * _waves * 2);
+    glProgramState->setUniformFloat("u_amplitude", _amplitude * _amplitudeRate);
+}
+
 // implementation of Twirl
 
 Twirl* Twirl::create(float duration, const Size& gridSize, Vec2 position, unsigned int twirls, float amplitude)
@@ -717,6 +779,9 @@ Twirl *Twirl::clone() const
 
 void Twirl::update(float time)
 {
+    if (updateWithShader(time))
+        return;
+
     int i, j;
     Vec2    c = _position;
     
@@ -744,5 +809,17 @@ void Twirl::update(float time)
     }
 }
 
+const char* Twirl::getEffectGLProgramName() const
+{
+    return GLProgram::SHADER_NAME_GRID3D_TWIRL;
+}
+
+void Twirl::updateEffect(GLProgramState* glProgramState, float time)
+{
+    setGridUniforms(glProgramState);
+    glProgramState->setUniformVec2("u_center", _position);
+    glProgramState->setUniformFloat("u_twirl", cosf((float)M_PI/2.0f + time * (float)M_PI * _twirls * 2) * 0.1f * _amplitude * _amplitudeRate);
+}
+
 NS_CC_END
 
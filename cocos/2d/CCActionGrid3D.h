@@ -66,6 +66,9 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithDuration(float duration, const Size& gridSize, unsigned int waves, float amplitude);
 
 protected:
+    virtual const char* getEffectGLProgramName() const override;
+    virtual void updateEffect(GLProgramState* glProgramState, float time) override;
+
     unsigned int _waves;
     float _amplitude;
     float _amplitudeRate;
@@ -188,6 +191,9 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithDuration(float duration, const Size& gridSize, const Vec2& position, float radius, unsigned int waves, float amplitude);
 
 protected:
+    virtual const char* getEffectGLProgramName() const override;
+    virtual void updateEffect(GLProgramState* glProgramState, float time) override;
+
     /* center position */
     Vec2 _position;
     float _radius;
@@ -250,6 +256,9 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithDuration(float duration, const Size& gridSize, unsigned int waves, float amplitude);
 
 protected:
+    virtual const char* getEffectGLProgramName() const override;
+    virtual void updateEffect(GLProgramState* glProgramState, float time) override;
+
     unsigned int _waves;
     float _amplitude;
     float _amplitudeRate;
@@ -283,6 +292,9 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithDuration(float duration, const Size& gridSize, unsigned int waves, float amplitude, bool horizontal, bool vertical);
 
 protected:
+    virtual const char* getEffectGLProgramName() const override;
+    virtual void updateEffect(GLProgramState* glProgramState, float time) override;
+
     unsigned int _waves;
     float _amplitude;
     float _amplitudeRate;
@@ -324,6 +336,9 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithDuration(float duration, const Size& gridSize, Vec2 position, unsigned int twirls, float amplitude);
 
 protected:
+    virtual const char* getEffectGLProgramName() const override;
+    virtual void updateEffect(GLProgramState* glProgramState, float time) override;
+
     /* twirl center */
     Vec2 _position;
     unsigned int _twirls;
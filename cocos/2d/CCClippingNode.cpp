@@ -28,7 +28,10 @@
 #include "2d/CCClippingNode.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramCache.h"
+#include "renderer/ccGLStateCache.h"
 #include "2d/CCDrawingPrimitives.h"
+#include "2d/CCSprite.h"
+#include "2d/CCLayer.h"
 #include "base/CCDirector.h"
 
 #include "renderer/CCRenderer.h"
@@ -69,7 +72,12 @@ ClippingNode::ClippingNode()
 ,  _currentAlphaTestEnabled(GL_FALSE)
 , _currentAlphaTestFunc(GL_ALWAYS)
 , _currentAlphaTestRef(1)
+, _scissorEnabled(true)
+, _stencilRectangular(false)
+, _isUsingScissor(false)
+, _currentScissorEnabled(GL_FALSE)
 {
+    _currentScissorBox[0] = _currentScissorBox[1] = _currentScissorBox[2] = _currentScissorBox[3] = 0;
 
 }
 
@@ -228,32 +236,47 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, bool p
 
     renderer->pushGroup(_groupCommand.getRenderQueueID());
 
-    _beforeVisitCmd.init(_globalZOrder);
-    _beforeVisitCmd.func = CC_CALLBACK_0(ClippingNode::onBeforeVisit, this);
-    renderer->addCommand(&_beforeVisitCmd);
-    if (_alphaThreshold < 1)
+    // a rectangular stencil is replaced by the scissor test: it is not drawn at all
+    Rect stencilRect;
+    _isUsingScissor = _scissorEnabled && !_inverted && _alphaThreshold >= 1
+        && _stencil && _stencil->isVisible() && getStencilRect(&stencilRect)
+        && updateScissorRect(stencilRect, director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION) * _modelViewTransform * _stencil->getNodeToParentTransform());
+
+    if (_isUsingScissor)
+    {
+        _beforeVisitCmd.init(_globalZOrder);
+        _beforeVisitCmd.func = CC_CALLBACK_0(ClippingNode::onBeforeVisitScissor, this);
+        renderer->addCommand(&_beforeVisitCmd);
+    }
+    else
     {
+        _beforeVisitCmd.init(_globalZOrder);
+        _beforeVisitCmd.func = CC_CALLBACK_0(ClippingNode::onBeforeVisit, this);
+        renderer->addCommand(&_beforeVisitCmd);
+        if (_alphaThreshold < 1)
+        {
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WINDOWS || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
 #else
-        // since glAlphaTest do not exists in OES, use a shader that writes
-        // pixel only if greater than an alpha threshold
-        GLProgram *program = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV);
-        GLint alphaValueLocation = glGetUniformLocation(program->getProgram(), GLProgram::UNIFORM_NAME_ALPHA_TEST_VALUE);
-        // set our alphaThreshold
-        program->use();
-        program->setUniformLocationWith1f(alphaValueLocation, _alphaThreshold);
-        // we need to recursively apply this shader to all the nodes in the stencil node
-        // XXX: we should have a way to apply shader to all nodes without having to do this
-        setProgram(_stencil, program);
-        
+            // since glAlphaTest do not exists in OES, use a shader that writes
+            // pixel only if greater than an alpha threshold
+            GLProgram *program = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV);
+            GLint alphaValueLocation = glGetUniformLocation(program->getProgram(), GLProgram::UNIFORM_NAME_ALPHA_TEST_VALUE);
+            // set our alphaThreshold
+            program->use();
+            program->setUniformLocationWith1f(alphaValueLocation, _alphaThreshold);
+            // we need to recursively apply this shader to all the nodes in the stencil node
+            // XXX: we should have a way to apply shader to all nodes without having to do this
+            setProgram(_stencil, program);
+
 #endif
 
-    }
-    _stencil->visit(renderer, _modelViewTransform, dirty);
+        }
+        _stencil->visit(renderer, _modelViewTransform, dirty);
 
-    _afterDrawStencilCmd.init(_globalZOrder);
-    _afterDrawStencilCmd.func = CC_CALLBACK_0(ClippingNode::onAfterDrawStencil, this);
-    renderer->addCommand(&_afterDrawStencilCmd);
+        _afterDrawStencilCmd.init(_globalZOrder);
+        _afterDrawStencilCmd.func = CC_CALLBACK_0(ClippingNode::onAfterDrawStencil, this);
+        renderer->addCommand(&_afterDrawStencilCmd);
+    }
 
     int i = 0;
     
@@ -282,7 +305,10 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, bool p
     }
 
     _afterVisitCmd.init(_globalZOrder);
-    _afterVisitCmd.func = CC_CALLBACK_0(ClippingNode::onAfterVisit, this);
+    if (_isUsingScissor)
+        _afterVisitCmd.func = CC_CALLBACK_0(ClippingNode::onAfterVisitScissor, this);
+    else
+        _afterVisitCmd.func = CC_CALLBACK_0(ClippingNode::onAfterVisit, this);
     renderer->addCommand(&_afterVisitCmd);
 
     renderer->popGroup();
@@ -322,6 +348,108 @@ void ClippingNode::setInverted(bool inverted)
     _inverted = inverted;
 }
 
+bool ClippingNode::isScissorEnabled() const
+{
+    return _scissorEnabled;
+}
+
+void ClippingNode::setScissorEnabled(bool enabled)
+{
+    _scissorEnabled = enabled;
+}
+
+bool ClippingNode::isStencilRectangular() const
+{
+    return _stencilRectangular;
+}
+
+void ClippingNode::setStencilRectangular(bool rectangular)
+{
+    _stencilRectangular = rectangular;
+}
+
+bool ClippingNode::getStencilRect(Rect* rect) const
+{
+    if (_stencilRectangular)
+    {
+        *rect = Rect::ZERO;
+        rect->size = _stencil->getContentSize();
+        return true;
+    }
+
+    // the children could draw anywhere
+    if (!_stencil->getChildren().empty())
+    {
+        return false;
+    }
+
+    auto sprite = dynamic_cast<Sprite*>(_stencil);
+    if (sprite && sprite->getBatchNode() == nullptr)
+    {
+        // the quad might be smaller than the content size when the sprite frame is trimmed
+        const V3F_C4B_T2F_Quad& quad = sprite->getQuad();
+        float minX = std::min(quad.bl.vertices.x, quad.tr.vertices.x);
+        float minY = std::min(quad.bl.vertices.y, quad.tr.vertices.y);
+        float maxX = std::max(quad.bl.vertices.x, quad.tr.vertices.x);
+        float maxY = std::max(quad.bl.vertices.y, quad.tr.vertices.y);
+        *rect = Rect(minX, minY, maxX - minX, maxY - minY);
+        return true;
+    }
+
+    if (dynamic_cast<LayerColor*>(_stencil))
+    {
+        *rect = Rect::ZERO;
+        rect->size = _stencil->getContentSize();
+        return true;
+    }
+
+    return false;
+}
+
+bool ClippingNode::updateScissorRect(const Rect& stencilRect, const Mat4& stencilTransform)
+{
+    static const float EPSILON = 1e-4f;
+
+    Vec4 corners[4] = {
+        Vec4(stencilRect.getMinX(), stencilRect.getMinY(), 0, 1),
+        Vec4(stencilRect.getMaxX(), stencilRect.getMinY(), 0, 1),
+        Vec4(stencilRect.getMaxX(), stencilRect.getMaxY(), 0, 1),
+        Vec4(stencilRect.getMinX(), stencilRect.getMaxY(), 0, 1),
+    };
+
+    // project the corners in normalized device coordinates
+    Vec2 ndc[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        Vec4 clip;
+        stencilTransform.transformVector(corners[i], &clip);
+        if (clip.w <= 0)
+        {
+            return false;
+        }
+        ndc[i].set(clip.x / clip.w, clip.y / clip.w);
+    }
+
+    float minX = std::min(std::min(ndc[0].x, ndc[1].x), std::min(ndc[2].x, ndc[3].x));
+    float maxX = std::max(std::max(ndc[0].x, ndc[1].x), std::max(ndc[2].x, ndc[3].x));
+    float minY = std::min(std::min(ndc[0].y, ndc[1].y), std::min(ndc[2].y, ndc[3].y));
+    float maxY = std::max(std::max(ndc[0].y, ndc[1].y), std::max(ndc[2].y, ndc[3].y));
+
+    // the rectangle is aligned with the screen axes when each of its corners is a corner of its bounding box
+    for (int i = 0; i < 4; ++i)
+    {
+        bool onX = fabsf(ndc[i].x - minX) < EPSILON || fabsf(ndc[i].x - maxX) < EPSILON;
+        bool onY = fabsf(ndc[i].y - minY) < EPSILON || fabsf(ndc[i].y - maxY) < EPSILON;
+        if (!onX || !onY)
+        {
+            return false;
+        }
+    }
+
+    _scissorRect.setRect(minX, minY, maxX - minX, maxY - minY);
+    return true;
+}
+
 void ClippingNode::onBeforeVisit()
 {
     ///////////////////////////////////
@@ -339,27 +467,23 @@ void ClippingNode::onBeforeVisit()
 
     // manually save the stencil state
 
-    _currentStencilEnabled = glIsEnabled(GL_STENCIL_TEST);
-    glGetIntegerv(GL_STENCIL_WRITEMASK, (GLint *)&_currentStencilWriteMask);
-    glGetIntegerv(GL_STENCIL_FUNC, (GLint *)&_currentStencilFunc);
-    glGetIntegerv(GL_STENCIL_REF, &_currentStencilRef);
-    glGetIntegerv(GL_STENCIL_VALUE_MASK, (GLint *)&_currentStencilValueMask);
-    glGetIntegerv(GL_STENCIL_FAIL, (GLint *)&_currentStencilFail);
-    glGetIntegerv(GL_STENCIL_PASS_DEPTH_FAIL, (GLint *)&_currentStencilPassDepthFail);
-    glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS, (GLint *)&_currentStencilPassDepthPass);
+    _currentStencilEnabled = GL::isEnabled(GL_STENCIL_TEST);
+    _currentStencilWriteMask = GL::getStencilMask();
+    GL::getStencilFunc(&_currentStencilFunc, &_currentStencilRef, &_currentStencilValueMask);
+    GL::getStencilOp(&_currentStencilFail, &_currentStencilPassDepthFail, &_currentStencilPassDepthPass);
 
     // enable stencil use
-    glEnable(GL_STENCIL_TEST);
+    GL::enable(GL_STENCIL_TEST);
     // check for OpenGL error while enabling stencil test
     CHECK_GL_ERROR_DEBUG();
 
     // all bits on the stencil buffer are readonly, except the current layer bit,
     // this means that operation like glClear or glStencilOp will be masked with this value
-    glStencilMask(mask_layer);
+    GL::stencilMask(mask_layer);
 
     // manually save the depth test state
 
-    glGetBooleanv(GL_DEPTH_WRITEMASK, &_currentDepthWriteMask);
+    _currentDepthWriteMask = GL::getDepthMask();
 
     // disable depth test while drawing the stencil
     //glDisable(GL_DEPTH_TEST);
@@ -367,7 +491,7 @@ void ClippingNode::onBeforeVisit()
     // as the stencil is not meant to be rendered in the real scene,
     // it should never prevent something else to be drawn,
     // only disabling depth buffer update should do
-    glDepthMask(GL_FALSE);
+    GL::depthMask(GL_FALSE);
 
     ///////////////////////////////////
     // CLEAR STENCIL BUFFER
@@ -378,8 +502,8 @@ void ClippingNode::onBeforeVisit()
     //     never draw it into the frame buffer
     //     if not in inverted mode: set the current layer value to 0 in the stencil buffer
     //     if in inverted mode: set the current layer value to 1 in the stencil buffer
-    glStencilFunc(GL_NEVER, mask_layer, mask_layer);
-    glStencilOp(!_inverted ? GL_ZERO : GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_NEVER, mask_layer, mask_layer);
+    GL::stencilOp(!_inverted ? GL_ZERO : GL_REPLACE, GL_KEEP, GL_KEEP);
 
     // draw a fullscreen solid rectangle to clear the stencil buffer
     //ccDrawSolidRect(Vec2::ZERO, ccpFromSize([[Director sharedDirector] winSize]), Color4F(1, 1, 1, 1));
@@ -393,8 +517,8 @@ void ClippingNode::onBeforeVisit()
     //     never draw it into the frame buffer
     //     if not in inverted mode: set the current layer value to 1 in the stencil buffer
     //     if in inverted mode: set the current layer value to 0 in the stencil buffer
-    glStencilFunc(GL_NEVER, mask_layer, mask_layer);
-    glStencilOp(!_inverted ? GL_REPLACE : GL_ZERO, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_NEVER, mask_layer, mask_layer);
+    GL::stencilOp(!_inverted ? GL_REPLACE : GL_ZERO, GL_KEEP, GL_KEEP);
 
     // enable alpha test only if the alpha threshold < 1,
     // indeed if alpha threshold == 1, every pixel will be drawn anyways
@@ -436,7 +560,7 @@ void ClippingNode::onAfterDrawStencil()
     }
 
     // restore the depth test state
-    glDepthMask(_currentDepthWriteMask);
+    GL::depthMask(_currentDepthWriteMask);
     //if (currentDepthTestEnabled) {
     //    glEnable(GL_DEPTH_TEST);
     //}
@@ -450,8 +574,8 @@ void ClippingNode::onAfterDrawStencil()
     //         draw the pixel and keep the current layer in the stencil buffer
     //     else
     //         do not draw the pixel but keep the current layer in the stencil buffer
-    glStencilFunc(GL_EQUAL, _mask_layer_le, _mask_layer_le);
-    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_EQUAL, _mask_layer_le, _mask_layer_le);
+    GL::stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 
     // draw (according to the stencil test func) this node and its childs
 }
@@ -463,16 +587,53 @@ void ClippingNode::onAfterVisit()
     // CLEANUP
 
     // manually restore the stencil state
-    glStencilFunc(_currentStencilFunc, _currentStencilRef, _currentStencilValueMask);
-    glStencilOp(_currentStencilFail, _currentStencilPassDepthFail, _currentStencilPassDepthPass);
-    glStencilMask(_currentStencilWriteMask);
+    GL::stencilFunc(_currentStencilFunc, _currentStencilRef, _currentStencilValueMask);
+    GL::stencilOp(_currentStencilFail, _currentStencilPassDepthFail, _currentStencilPassDepthPass);
+    GL::stencilMask(_currentStencilWriteMask);
     if (!_currentStencilEnabled)
     {
-        glDisable(GL_STENCIL_TEST);
+        GL::disable(GL_STENCIL_TEST);
     }
 
     // we are done using this layer, decrement
     s_layer--;
 }
 
+void ClippingNode::onBeforeVisitScissor()
+{
+    // manually save the scissor state, restored after the content is drawn
+    _currentScissorEnabled = GL::isEnabled(GL_SCISSOR_TEST);
+    GL::getScissorBox(_currentScissorBox);
+
+    // from normalized device coordinates to window coordinates, with the viewport of the current target
+    GLint viewport[4];
+    GL::getViewport(viewport);
+    GLint x0 = (GLint)floorf(viewport[0] + (_scissorRect.getMinX() + 1) * 0.5f * viewport[2] + 0.5f);
+    GLint y0 = (GLint)floorf(viewport[1] + (_scissorRect.getMinY() + 1) * 0.5f * viewport[3] + 0.5f);
+    GLint x1 = (GLint)floorf(viewport[0] + (_scissorRect.getMaxX() + 1) * 0.5f * viewport[2] + 0.5f);
+    GLint y1 = (GLint)floorf(viewport[1] + (_scissorRect.getMaxY() + 1) * 0.5f * viewport[3] + 0.5f);
+
+    // nested in another scissor box: only draw where both clip
+    if (_currentScissorEnabled)
+    {
+        x0 = std::max(x0, _currentScissorBox[0]);
+        y0 = std::max(y0, _currentScissorBox[1]);
+        x1 = std::min(x1, _currentScissorBox[0] + _currentScissorBox[2]);
+        y1 = std::min(y1, _currentScissorBox[1] + _currentScissorBox[3]);
+    }
+
+    GL::enable(GL_SCISSOR_TEST);
+    GL::scissor(x0, y0, std::max(x1 - x0, 0), std::max(y1 - y0, 0));
+}
+
+void ClippingNode::onAfterVisitScissor()
+{
+    // manually restore the scissor state
+    GL::scissor(_currentScissorBox[0], _currentScissorBox[1], _currentScissorBox[2], _currentScissorBox[3]);
+    if (!_currentScissorEnabled)
+    {
+        GL::disable(GL_SCISSOR_TEST);
+    }
+}
+
 NS_CC_END
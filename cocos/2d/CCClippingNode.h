@@ -69,11 +69,34 @@ public:
     
     /** Inverted. If this is set to true,
      the stencil is inverted, so the content is drawn where the stencil is NOT drawn.
-     This default to false.
+     This defaults to false.
      */
     bool isInverted() const;
     void setInverted(bool inverted);
 
+    /** Whether the clipping can be done with the scissor test instead of the stencil buffer (enabled by default).
+     The scissor test is used when the stencil is a rectangle that stays aligned with the screen axes,
+     the alpha threshold is 1 and the clipping is not inverted. The stencil is a rectangle when it is a `Sprite` or a `LayerColor`
+     without children, or when it is declared with `setStencilRectangular()`.
+     The stencil is then neither drawn nor cleared, fewer commands break the batches, and the nesting is not limited
+     by the number of bits of the stencil buffer: nested clipping nodes intersect their scissor boxes.
+     @since v3.2
+     */
+    bool isScissorEnabled() const;
+    void setScissorEnabled(bool enabled);
+
+    /** Declares that the stencil (with its children) covers exactly the rectangle (0, 0, width, height) of its content size,
+     so that the scissor test can be used for any kind of stencil node. This defaults to false.
+     @since v3.2
+     */
+    bool isStencilRectangular() const;
+    void setStencilRectangular(bool rectangular);
+
+    /** Returns whether the last visit clipped with the scissor test instead of the stencil buffer
+     @since v3.2
+     */
+    bool isUsingScissor() const { return _isUsingScissor; }
+
     // Overrides
     /**
      * @js NA
@@ -120,6 +143,11 @@ protected:
     */
     void drawFullScreenQuadClearStencil();
 
+    // Returns the rectangle covered by the stencil in its own space, if it is a rectangle
+    bool getStencilRect(Rect* rect) const;
+    // Computes _scissorRect when the stencil rectangle stays aligned with the screen axes once projected
+    bool updateScissorRect(const Rect& stencilRect, const Mat4& stencilTransform);
+
     Node* _stencil;
     GLfloat _alphaThreshold;
     bool    _inverted;
@@ -128,6 +156,16 @@ protected:
     void onBeforeVisit();
     void onAfterDrawStencil();
     void onAfterVisit();
+    void onBeforeVisitScissor();
+    void onAfterVisitScissor();
+
+    bool _scissorEnabled;
+    bool _stencilRectangular;
+    bool _isUsingScissor;
+    // clipped area in normalized device coordinates, turned into a scissor box with the viewport when rendered
+    Rect _scissorRect;
+    GLboolean _currentScissorEnabled;
+    GLint _currentScissorBox[4];
 
     GLboolean _currentStencilEnabled;
     GLuint _currentStencilWriteMask;
@@ -27,7 +27,9 @@
 #include "base/CCConfiguration.h"
 #include "renderer/CCCustomCommand.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCFrameAllocator.h"
 #include "renderer/CCGLProgramState.h"
+#include "renderer/ccGLStateCache.h"
 #include "base/CCDirector.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
@@ -107,7 +109,10 @@ DrawNode::DrawNode()
 , _bufferCapacity(0)
 , _bufferCount(0)
 , _buffer(nullptr)
+, _defaultGLProgramState(nullptr)
+, _batchGLProgramState(nullptr)
 , _dirty(false)
+, _trianglesDirty(false)
 {
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
 }
@@ -116,8 +121,11 @@ DrawNode::~DrawNode()
 {
     free(_buffer);
     _buffer = nullptr;
+
+    CC_SAFE_RELEASE(_defaultGLProgramState);
+    CC_SAFE_RELEASE(_batchGLProgramState);
     
-    glDeleteBuffers(1, &_vbo);
+    GL::deleteBuffers(1, &_vbo);
     _vbo = 0;
     
     if (Configuration::getInstance()->supportsShareableVAO())
@@ -158,7 +166,14 @@ bool DrawNode::init()
 {
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
 
-    setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR));
+    CC_SAFE_RELEASE(_defaultGLProgramState);
+    _defaultGLProgramState = GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR);
+    _defaultGLProgramState->retain();
+    setGLProgramState(_defaultGLProgramState);
+
+    CC_SAFE_RELEASE(_batchGLProgramState);
+    _batchGLProgramState = GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR_NO_MVP);
+    _batchGLProgramState->retain();
     
     ensureCapacity(512);
     
@@ -169,7 +184,7 @@ bool DrawNode::init()
     }
     
     glGenBuffers(1, &_vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
     glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)* _bufferCapacity, _buffer, GL_STREAM_DRAW);
     
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
@@ -181,7 +196,7 @@ bool DrawNode::init()
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, texCoords));
     
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -191,6 +206,7 @@ bool DrawNode::init()
     CHECK_GL_ERROR_DEBUG();
     
     _dirty = true;
+    _trianglesDirty = true;
     
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     // Need to listen the event only when not use batchnode, because it will use VBO
@@ -205,11 +221,70 @@ bool DrawNode::init()
     return true;
 }
 
+namespace {
+    // the arguments of onDraw(), kept in the frame allocator by draw()
+    struct DrawArguments
+    {
+        Mat4 transform;
+        bool transformUpdated;
+    };
+}
+
 void DrawNode::draw(Renderer *renderer, const Mat4 &transform, bool transformUpdated)
 {
-    _customCommand.init(_globalZOrder);
-    _customCommand.func = CC_CALLBACK_0(DrawNode::onDraw, this, transform, transformUpdated);
-    renderer->addCommand(&_customCommand);
+    if (_bufferCount <= 0)
+        return;
+
+    // the Renderer batches the triangles unless the shader was changed or has its own uniforms
+    if (_bufferCount <= MAX_BATCHED_VERTICES && _glProgramState == _defaultGLProgramState && _glProgramState->getUniformCount() == 0)
+    {
+        if (_trianglesDirty)
+        {
+            updateTriangles();
+        }
+
+        TrianglesCommand::Triangles triangles = { _triangleVerts.data(), _triangleIndices.data(), (ssize_t)_bufferCount, (ssize_t)_bufferCount };
+        // _trianglesCommand keeps the material ID between the frames, the renderer gets a copy that only lives during this frame
+        _trianglesCommand.init(_globalZOrder, 0, _batchGLProgramState, _blendFunc, triangles, transform);
+        renderer->addCommand(renderer->getFrameAllocator()->create(_trianglesCommand));
+    }
+    else
+    {
+        // the command and the arguments of onDraw() only live during this frame. The callback captures two pointers,
+        // which std::function stores without a heap allocation
+        auto allocator = renderer->getFrameAllocator();
+        auto arguments = allocator->create<DrawArguments>();
+        arguments->transform = transform;
+        arguments->transformUpdated = transformUpdated;
+
+        auto command = allocator->create<CustomCommand>();
+        command->init(_globalZOrder);
+        command->func = [this, arguments]() { onDraw(arguments->transform, arguments->transformUpdated); };
+        renderer->addCommand(command);
+    }
+}
+
+void DrawNode::updateTriangles()
+{
+    _triangleVerts.resize(_bufferCount);
+    for (GLsizei i = 0; i < _bufferCount; ++i)
+    {
+        const V2F_C4B_T2F& src = _buffer[i];
+        V3F_C4B_T2F& dst = _triangleVerts[i];
+        dst.vertices = Vec3(src.vertices.x, src.vertices.y, 0);
+        dst.colors = src.colors;
+        dst.texCoords = src.texCoords;
+    }
+
+    // the triangles are not indexed, so the indices don't change when the vector grows or shrinks
+    size_t indexCount = _triangleIndices.size();
+    _triangleIndices.resize(_bufferCount);
+    for (size_t i = indexCount; i < _triangleIndices.size(); ++i)
+    {
+        _triangleIndices[i] = (GLuint)i;
+    }
+
+    _trianglesDirty = false;
 }
 
 void DrawNode::onDraw(const Mat4 &transform, bool transformUpdated)
@@ -220,10 +295,11 @@ void DrawNode::onDraw(const Mat4 &transform, bool transformUpdated)
 
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
 
+    // the VBO is kept between the frames, it is only uploaded when the geometry changed
     if (_dirty)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacity, _buffer, GL_STREAM_DRAW);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCount, _buffer, GL_STATIC_DRAW);
         _dirty = false;
     }
     if (Configuration::getInstance()->supportsShareableVAO())
@@ -234,7 +310,7 @@ void DrawNode::onDraw(const Mat4 &transform, bool transformUpdated)
     {
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
 
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
         // vertex
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
 
@@ -246,7 +322,7 @@ void DrawNode::onDraw(const Mat4 &transform, bool transformUpdated)
     }
 
     glDrawArrays(GL_TRIANGLES, 0, _bufferCount);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,_bufferCount);
     CHECK_GL_ERROR_DEBUG();
@@ -271,6 +347,7 @@ void DrawNode::drawDot(const Vec2 &pos, float radius, const Color4F &color)
 	_bufferCount += vertex_count;
 	
 	_dirty = true;
+	_trianglesDirty = true;
 }
 
 void DrawNode::drawSegment(const Vec2 &from, const Vec2 &to, float radius, const Color4F &color)
@@ -344,6 +421,7 @@ void DrawNode::drawSegment(const Vec2 &from, const Vec2 &to, float radius, const
 	_bufferCount += vertex_count;
 	
 	_dirty = true;
+	_trianglesDirty = true;
 }
 
 void DrawNode::drawPolygon(Vec2 *verts, int count, const Color4F &fillColor, float borderWidth, const Color4F &borderColor)
@@ -450,6 +528,7 @@ void DrawNode::drawPolygon(Vec2 *verts, int count, const Color4F &fillColor, flo
 	_bufferCount += vertex_count;
 	
 	_dirty = true;
+	_trianglesDirty = true;
 
     free(extrude);
 }
@@ -470,6 +549,7 @@ void DrawNode::drawTriangle(const Vec2 &p1, const Vec2 &p2, const Vec2 &p3, cons
 
     _bufferCount += vertex_count;
     _dirty = true;
+    _trianglesDirty = true;
 }
 
 void DrawNode::drawCubicBezier(const Vec2& from, const Vec2& control1, const Vec2& control2, const Vec2& to, unsigned int segments, const Color4F &color)
@@ -501,6 +581,7 @@ void DrawNode::drawCubicBezier(const Vec2& from, const Vec2& control1, const Vec
         _bufferCount += 3;
     }
     _dirty = true;
+    _trianglesDirty = true;
 }
 
 void DrawNode::drawQuadraticBezier(const Vec2& from, const Vec2& control, const Vec2& to, unsigned int segments, const Color4F &color)
@@ -532,12 +613,14 @@ void DrawNode::drawQuadraticBezier(const Vec2& from, const Vec2& control, const
         _bufferCount += 3;
     }
     _dirty = true;
+    _trianglesDirty = true;
 }
 
 void DrawNode::clear()
 {
     _bufferCount = 0;
     _dirty = true;
+    _trianglesDirty = true;
 }
 
 const BlendFunc& DrawNode::getBlendFunc() const
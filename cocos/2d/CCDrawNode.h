@@ -34,18 +34,26 @@
 #include "2d/CCNode.h"
 #include "base/ccTypes.h"
 #include "renderer/CCCustomCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 
 NS_CC_BEGIN
 
 /** DrawNode
  Node that draws dots, segments and polygons.
  Faster than the "drawing primitives" since they it draws everything in one single batch.
+
+ Small nodes (up to MAX_BATCHED_VERTICES vertices) that use the default shader are drawn with a `TrianglesCommand`,
+ so the Renderer batches the consecutive DrawNodes that have the same blending function into one draw call.
+ Bigger nodes keep their vertices in their own VBO, which is only uploaded again when the geometry changes.
  
  @since v2.1
  */
 class CC_DLL DrawNode : public Node
 {
 public:
+    /** Nodes with more vertices are not batched with the other DrawNodes, they are drawn from their own VBO */
+    static const int MAX_BATCHED_VERTICES = 1024;
+
     /** creates and initialize a DrawNode node */
     static DrawNode* create();
 
@@ -101,6 +109,8 @@ CC_CONSTRUCTOR_ACCESS:
 
 protected:
     void ensureCapacity(int count);
+    // Converts the buffer into the vertices and indices of _trianglesCommand
+    void updateTriangles();
 
     GLuint      _vao;
     GLuint      _vbo;
@@ -110,9 +120,19 @@ protected:
     V2F_C4B_T2F *_buffer;
 
     BlendFunc   _blendFunc;
-    CustomCommand _customCommand;
 
+    // used when the node is batched by the Renderer, the vertices are in the format of TrianglesCommand
+    TrianglesCommand _trianglesCommand;
+    std::vector<V3F_C4B_T2F> _triangleVerts;
+    std::vector<GLuint> _triangleIndices;
+    GLProgramState* _defaultGLProgramState;
+    // same shader as the default one, for vertices already transformed by the Renderer
+    GLProgramState* _batchGLProgramState;
+
+    // the VBO must be uploaded
     bool        _dirty;
+    // _triangleVerts must be updated
+    bool        _trianglesDirty;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(DrawNode);
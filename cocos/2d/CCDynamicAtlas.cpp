@@ -0,0 +1,333 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "2d/CCDynamicAtlas.h"
+
+#include <climits>
+#include <cstring>
+
+#include "2d/CCTexture2D.h"
+#include "2d/CCTextureCache.h"
+#include "2d/platform/CCImage.h"
+#include "base/CCConfiguration.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+// pixels copied around each image
+static const int PADDING = 1;
+
+DynamicAtlas::DynamicAtlas()
+: _pageSize(DEFAULT_PAGE_SIZE)
+, _maxImageSize(DEFAULT_MAX_IMAGE_SIZE)
+{
+}
+
+DynamicAtlas::~DynamicAtlas()
+{
+    removeAllPages();
+}
+
+void DynamicAtlas::setPageSize(int pageSize)
+{
+    CCASSERT(pageSize > 2 * PADDING, "Invalid page size");
+    _pageSize = pageSize;
+}
+
+bool DynamicAtlas::canAddImage(Image* image) const
+{
+    if (image == nullptr || image->isCompressed() || image->getNumberOfMipmaps() > 1)
+        return false;
+
+    auto format = image->getRenderFormat();
+    bool premultiplied = image->hasPremultipliedAlpha() && image->isPremultipliedAlpha();
+    if (!(format == Texture2D::PixelFormat::RGB888 || (format == Texture2D::PixelFormat::RGBA8888 && premultiplied)))
+        return false;
+
+    int width = image->getWidth();
+    int height = image->getHeight();
+    return width > 0 && height > 0
+        && width <= _maxImageSize && height <= _maxImageSize
+        && width + 2 * PADDING <= _pageSize && height + 2 * PADDING <= _pageSize;
+}
+
+Texture2D* DynamicAtlas::addImage(Image* image, const std::string& key, Rect* rectInPixels)
+{
+    Texture2D* texture = getImage(key, rectInPixels);
+    if (texture || !canAddImage(image))
+        return texture;
+
+    int width = image->getWidth() + 2 * PADDING;
+    int height = image->getHeight() + 2 * PADDING;
+    int x = 0, y = 0;
+
+    // the last pages are the less full ones
+    Page* page = nullptr;
+    for (auto it = _pages.rbegin(); it != _pages.rend(); ++it)
+    {
+        if (packRect(*it, width, height, &x, &y))
+        {
+            page = *it;
+            break;
+        }
+    }
+
+    if (page == nullptr)
+    {
+        page = createPage();
+        if (page == nullptr || !packRect(page, width, height, &x, &y))
+            return nullptr;
+    }
+
+    copyImage(page, image, x, y);
+
+    PackedImage packed;
+    packed.page = page;
+    packed.rect = Rect(x + PADDING, y + PADDING, image->getWidth(), image->getHeight());
+    _images[key] = packed;
+
+    if (rectInPixels)
+        *rectInPixels = packed.rect;
+    return page->texture;
+}
+
+Texture2D* DynamicAtlas::getImage(const std::string& key, Rect* rectInPixels) const
+{
+    auto it = _images.find(key);
+    if (it == _images.end())
+        return nullptr;
+
+    if (rectInPixels)
+        *rectInPixels = it->second.rect;
+    return it->second.page->texture;
+}
+
+void DynamicAtlas::removeUnusedPages()
+{
+    for (auto it = _pages.begin(); it != _pages.end(); /* nothing */)
+    {
+        Page* page = *it;
+        if (page->texture->getReferenceCount() == 1)
+        {
+            for (auto imageIt = _images.begin(); imageIt != _images.end(); /* nothing */)
+            {
+                if (imageIt->second.page == page)
+                    imageIt = _images.erase(imageIt);
+                else
+                    ++imageIt;
+            }
+
+            releasePage(page);
+            it = _pages.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void DynamicAtlas::removeAllPages()
+{
+    for (auto page : _pages)
+    {
+        releasePage(page);
+    }
+    _pages.clear();
+    _images.clear();
+}
+
+DynamicAtlas::Page* DynamicAtlas::createPage()
+{
+    int pageSize = std::min(_pageSize, Configuration::getInstance()->getMaxTextureSize());
+
+    // transparent black
+    std::vector<unsigned char> pixels(pageSize * pageSize * 4, 0);
+    auto image = new Image();
+    auto texture = new Texture2D();
+    if (!image->initWithRawData(pixels.data(), pixels.size(), pageSize, pageSize, 8, true)
+        || !texture->initWithImage(image, Texture2D::PixelFormat::RGBA8888))
+    {
+        CCLOG("cocos2d: DynamicAtlas: couldn't create a %d x %d page", pageSize, pageSize);
+        image->release();
+        texture->release();
+        return nullptr;
+    }
+
+    Page* page = new Page();
+    page->texture = texture;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    VolatileTextureMgr::addImage(texture, image);
+    page->image = image;
+#else
+    image->release();
+#endif
+
+    SkylineNode node = { 0, 0, pageSize };
+    page->skyline.push_back(node);
+
+    _pages.push_back(page);
+    return page;
+}
+
+void DynamicAtlas::releasePage(Page* page)
+{
+    page->texture->release();
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    page->image->release();
+#endif
+    delete page;
+}
+
+int DynamicAtlas::fitRect(const Page* page, size_t index, int width, int height) const
+{
+    int pageSize = page->texture->getPixelsWide();
+    const auto& skyline = page->skyline;
+
+    if (skyline[index].x + width > pageSize)
+        return -1;
+
+    // the rect lies on the highest of the nodes it covers
+    int y = skyline[index].y;
+    int widthLeft = width;
+    while (widthLeft > 0)
+    {
+        if (index == skyline.size())
+            return -1;
+
+        y = std::max(y, skyline[index].y);
+        if (y + height > pageSize)
+            return -1;
+
+        widthLeft -= skyline[index].width;
+        ++index;
+    }
+    return y;
+}
+
+bool DynamicAtlas::packRect(Page* page, int width, int height, int* x, int* y)
+{
+    auto& skyline = page->skyline;
+
+    // bottom-left: lowest top edge, then the narrowest node
+    int bestIndex = -1;
+    int bestTop = INT_MAX;
+    int bestWidth = INT_MAX;
+    for (size_t i = 0; i < skyline.size(); ++i)
+    {
+        int top = fitRect(page, i, width, height);
+        if (top < 0)
+            continue;
+
+        top += height;
+        if (top < bestTop || (top == bestTop && skyline[i].width < bestWidth))
+        {
+            bestIndex = static_cast<int>(i);
+            bestTop = top;
+            bestWidth = skyline[i].width;
+        }
+    }
+
+    if (bestIndex < 0)
+        return false;
+
+    *x = skyline[bestIndex].x;
+    *y = bestTop - height;
+
+    SkylineNode node = { *x, bestTop, width };
+    skyline.insert(skyline.begin() + bestIndex, node);
+
+    // shrink or remove the nodes that are now under the new one
+    for (size_t i = bestIndex + 1; i < skyline.size(); ++i)
+    {
+        int previousEnd = skyline[i - 1].x + skyline[i - 1].width;
+        if (skyline[i].x >= previousEnd)
+            break;
+
+        int shrink = previousEnd - skyline[i].x;
+        skyline[i].x += shrink;
+        skyline[i].width -= shrink;
+        if (skyline[i].width > 0)
+            break;
+
+        skyline.erase(skyline.begin() + i);
+        --i;
+    }
+
+    // merge the nodes at the same height
+    for (size_t i = 0; i + 1 < skyline.size(); /* nothing */)
+    {
+        if (skyline[i].y == skyline[i + 1].y)
+        {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    return true;
+}
+
+void DynamicAtlas::copyImage(Page* page, Image* image, int x, int y)
+{
+    int width = image->getWidth();
+    int height = image->getHeight();
+    int paddedWidth = width + 2 * PADDING;
+    int paddedHeight = height + 2 * PADDING;
+    int bytesPerPixel = image->getRenderFormat() == Texture2D::PixelFormat::RGB888 ? 3 : 4;
+    const unsigned char* src = image->getData();
+
+    // the padding repeats the border pixels
+    std::vector<unsigned char> pixels(paddedWidth * paddedHeight * 4);
+    for (int row = 0; row < paddedHeight; ++row)
+    {
+        int srcRow = std::min(std::max(row - PADDING, 0), height - 1);
+        for (int column = 0; column < paddedWidth; ++column)
+        {
+            int srcColumn = std::min(std::max(column - PADDING, 0), width - 1);
+            const unsigned char* srcPixel = src + (srcRow * width + srcColumn) * bytesPerPixel;
+            unsigned char* dstPixel = &pixels[(row * paddedWidth + column) * 4];
+            dstPixel[0] = srcPixel[0];
+            dstPixel[1] = srcPixel[1];
+            dstPixel[2] = srcPixel[2];
+            dstPixel[3] = bytesPerPixel == 4 ? srcPixel[3] : 255;
+        }
+    }
+
+    page->texture->updateWithData(pixels.data(), x, y, paddedWidth, paddedHeight);
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    int pageSize = page->image->getWidth();
+    for (int row = 0; row < paddedHeight; ++row)
+    {
+        memcpy(page->image->getData() + ((y + row) * pageSize + x) * 4, &pixels[row * paddedWidth * 4], paddedWidth * 4);
+    }
+#endif
+}
+
+NS_CC_END
@@ -0,0 +1,153 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CCDYNAMICATLAS_H__
+#define __CCDYNAMICATLAS_H__
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "base/CCRef.h"
+#include "math/CCGeometry.h"
+
+NS_CC_BEGIN
+
+class Texture2D;
+class Image;
+
+/**
+ * @addtogroup textures
+ * @{
+ */
+
+/** @brief Packs small images into shared textures ("pages") at load time.
+
+ Sprites made from different images can't be drawn in the same batch. Once their images are packed
+ in the same page they share a texture, and the renderer batches them again.
+
+ The pages are filled with a skyline bottom-left packer. Each image is surrounded by a copy of its
+ border pixels, so that linear filtering doesn't pick pixels of its neighbours.
+
+ Only uncompressed RGBA8888 images with premultiplied alpha and RGB888 images are packed, and only
+ when both sides are not bigger than getMaxImageSize(). The pages are RGBA8888 whatever the default
+ alpha pixel format is. Sprites using packed images must not change the texture parameters (e.g.
+ GL_REPEAT), since the page is shared.
+
+ It is used by TextureCache::addImageRegion(), see TextureCache::setDynamicAtlasEnabled().
+ @since v3.2
+ */
+class CC_DLL DynamicAtlas : public Ref
+{
+public:
+    static const int DEFAULT_PAGE_SIZE = 1024;
+    static const int DEFAULT_MAX_IMAGE_SIZE = 128;
+
+    /**
+     * @js ctor
+     */
+    DynamicAtlas();
+    /**
+     * @js NA
+     * @lua NA
+     */
+    virtual ~DynamicAtlas();
+
+    /** Width and height of the pages in pixels. Only used by the pages created afterwards. */
+    void setPageSize(int pageSize);
+    inline int getPageSize() const { return _pageSize; }
+
+    /** Images that are wider or higher than this, in pixels, are not packed */
+    inline void setMaxImageSize(int maxImageSize) { _maxImageSize = maxImageSize; }
+    inline int getMaxImageSize() const { return _maxImageSize; }
+
+    /** Returns whether the image can be packed */
+    bool canAddImage(Image* image) const;
+
+    /** Packs `image` under `key`, or returns the page it was already packed in.
+     `rectInPixels` is set to the part of the page used by the image.
+     Returns nullptr when the image can't be packed.
+     */
+    Texture2D* addImage(Image* image, const std::string& key, Rect* rectInPixels);
+
+    /** Returns the page the image `key` was packed in and its rect, or nullptr if it was not packed */
+    Texture2D* getImage(const std::string& key, Rect* rectInPixels) const;
+
+    /** Number of pages, and of images packed in them */
+    inline ssize_t getPageCount() const { return _pages.size(); }
+    inline ssize_t getImageCount() const { return _images.size(); }
+
+    /** Removes the pages that are only used by the atlas, and the images packed in them */
+    void removeUnusedPages();
+
+    /** Removes all the pages. The sprites using them keep them alive. */
+    void removeAllPages();
+
+protected:
+    struct SkylineNode
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    struct Page
+    {
+        Texture2D* texture;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        // pixels of the page, reloaded by VolatileTextureMgr when the GL context is lost
+        Image* image;
+#endif
+        std::vector<SkylineNode> skyline;
+    };
+
+    struct PackedImage
+    {
+        Page* page;
+        Rect rect;
+    };
+
+    Page* createPage();
+    void releasePage(Page* page);
+
+    // finds the place of a width x height rect in the page, returns false if it doesn't fit
+    bool packRect(Page* page, int width, int height, int* x, int* y);
+    int fitRect(const Page* page, size_t index, int width, int height) const;
+
+    void copyImage(Page* page, Image* image, int x, int y);
+
+    int _pageSize;
+    int _maxImageSize;
+
+    std::vector<Page*> _pages;
+    std::unordered_map<std::string, PackedImage> _images;
+};
+
+// end of textures group
+/// @}
+
+NS_CC_END
+
+#endif /* __CCDYNAMICATLAS_H__ */
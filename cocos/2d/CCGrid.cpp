@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "2d/CCGrid.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramCache.h"
+#include "renderer/CCGLProgramState.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
 #include "CCGL.h"
@@ -183,7 +184,7 @@ void GridBase::set2DProjection()
 
     Size    size = director->getWinSizeInPixels();
 
-    glViewport(0, 0, (GLsizei)(size.width), (GLsizei)(size.height) );
+    GL::viewport(0, 0, (GLsizei)(size.width), (GLsizei)(size.height) );
     director->loadIdentityMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
 
     Mat4 orthoMatrix;
@@ -298,8 +299,10 @@ Grid3D::Grid3D()
     , _vertices(nullptr)
     , _originalVertices(nullptr)
     , _indices(nullptr)
+    , _effectGLProgramState(nullptr)
+    , _effectVBODirty(true)
 {
-
+    _effectVBO[0] = _effectVBO[1] = 0;
 }
 
 Grid3D::~Grid3D(void)
@@ -308,10 +311,29 @@ Grid3D::~Grid3D(void)
     CC_SAFE_FREE(_vertices);
     CC_SAFE_FREE(_indices);
     CC_SAFE_FREE(_originalVertices);
+
+    CC_SAFE_RELEASE(_effectGLProgramState);
+    if (_effectVBO[0])
+    {
+        GL::deleteBuffers(2, _effectVBO);
+    }
+}
+
+void Grid3D::setEffectGLProgramState(GLProgramState* glProgramState)
+{
+    CC_SAFE_RETAIN(glProgramState);
+    CC_SAFE_RELEASE(_effectGLProgramState);
+    _effectGLProgramState = glProgramState;
 }
 
 void Grid3D::blit(void)
 {
+    if (_effectGLProgramState)
+    {
+        blitEffect();
+        return;
+    }
+
     int n = _gridSize.width * _gridSize.height;
 
     GL::enableVertexAttribs( GL::VERTEX_ATTRIB_FLAG_POSITION | GL::VERTEX_ATTRIB_FLAG_TEX_COORD );
@@ -347,6 +369,48 @@ void Grid3D::blit(void)
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,n*6);
 }
 
+void Grid3D::blitEffect()
+{
+    int n = _gridSize.width * _gridSize.height;
+    unsigned int numOfPoints = (_gridSize.width+1) * (_gridSize.height+1);
+
+    if (_effectVBO[0] == 0)
+    {
+        glGenBuffers(2, _effectVBO);
+    }
+
+    // unbinds the VAO, the element array buffer binding is part of its state
+    GL::enableVertexAttribs( GL::VERTEX_ATTRIB_FLAG_POSITION | GL::VERTEX_ATTRIB_FLAG_TEX_COORD );
+
+    // the original vertices only change when the grid is rebuilt or reused
+    if (_effectVBODirty)
+    {
+        GL::bindBuffer(GL_ARRAY_BUFFER, _effectVBO[0]);
+        glBufferData(GL_ARRAY_BUFFER, numOfPoints * (sizeof(Vec3) + sizeof(Vec2)), nullptr, GL_STATIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, numOfPoints * sizeof(Vec3), _originalVertices);
+        glBufferSubData(GL_ARRAY_BUFFER, numOfPoints * sizeof(Vec3), numOfPoints * sizeof(Vec2), _texCoordinates);
+
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _effectVBO[1]);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, n * 6 * sizeof(GLushort), _indices, GL_STATIC_DRAW);
+
+        _effectVBODirty = false;
+    }
+
+    _effectGLProgramState->apply(Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW));
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, _effectVBO[0]);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid*)0);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, 0, (GLvoid*)(numOfPoints * sizeof(Vec3)));
+
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _effectVBO[1]);
+    glDrawElements(GL_TRIANGLES, (GLsizei) n*6, GL_UNSIGNED_SHORT, (GLvoid*)0);
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,n*6);
+}
+
 void Grid3D::calculateVertexPoints(void)
 {
     float width = (float)_texture->getPixelsWide();
@@ -421,6 +485,7 @@ void Grid3D::calculateVertexPoints(void)
     }
 
     memcpy(_originalVertices, _vertices, (_gridSize.width+1) * (_gridSize.height+1) * sizeof(Vec3));
+    _effectVBODirty = true;
 }
 
 Vec3 Grid3D::getVertex(const Vec2& pos) const
@@ -457,11 +522,22 @@ void Grid3D::setVertex(const Vec2& pos, const Vec3& vertex)
     vertArray[index+2] = vertex.z;
 }
 
+Vec2 Grid3D::getTexCoord(const Vec2& pos) const
+{
+    CCASSERT( pos.x == (unsigned int)pos.x && pos.y == (unsigned int) pos.y , "Numbers must be integers");
+
+    int index = (pos.x * (_gridSize.height+1) + pos.y) * 2;
+    float *texArray = (float*)_texCoordinates;
+
+    return Vec2(texArray[index], texArray[index+1]);
+}
+
 void Grid3D::reuse(void)
 {
     if (_reuseGrid > 0)
     {
         memcpy(_originalVertices, _vertices, (_gridSize.width+1) * (_gridSize.height+1) * sizeof(Vec3));
+        _effectVBODirty = true;
         --_reuseGrid;
     }
 }
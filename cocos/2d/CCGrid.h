@@ -40,6 +40,7 @@ NS_CC_BEGIN
 class Texture2D;
 class Grabber;
 class GLProgram;
+class GLProgramState;
 
 /**
  * @addtogroup effects
@@ -154,16 +155,40 @@ public:
      */
     void setVertex(const Vec2& pos, const Vec3& vertex);
 
+    /** returns the texture coordinates of the vertex at a given position
+     * @js NA
+     * @lua NA
+     */
+    Vec2 getTexCoord(const Vec2& pos) const;
+
+    /** Draws the grid with a program that displaces the original vertices in its vertex shader,
+     instead of the vertices set with setVertex(). The original vertices stay in a VBO, so nothing is
+     uploaded while the effect runs: the program state holds the parameters of the effect as uniforms.
+     Pass nullptr to draw the vertices again.
+     @since v3.2
+     * @js NA
+     * @lua NA
+     */
+    void setEffectGLProgramState(GLProgramState* glProgramState);
+    inline GLProgramState* getEffectGLProgramState() const { return _effectGLProgramState; }
+
     // Overrides
     virtual void blit() override;
     virtual void reuse() override;
     virtual void calculateVertexPoints() override;
 
 protected:
+    void blitEffect();
+
     GLvoid *_texCoordinates;
     GLvoid *_vertices;
     GLvoid *_originalVertices;
     GLushort *_indices;
+
+    GLProgramState* _effectGLProgramState;
+    // 0: original vertices followed by the texture coordinates  1: indices
+    GLuint _effectVBO[2];
+    bool _effectVBODirty;
 };
 
 /**
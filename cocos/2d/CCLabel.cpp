@@ -33,6 +33,8 @@
 #include "2d/CCFont.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCFrameAllocator.h"
+#include "renderer/CCCustomCommand.h"
 #include "base/CCDirector.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
@@ -46,6 +48,15 @@ NS_CC_BEGIN
 
 const int Label::DistanceFieldFontSize = 50;
 
+namespace {
+    // the arguments of onDraw(), kept in the frame allocator by draw()
+    struct DrawArguments
+    {
+        Mat4 transform;
+        bool transformUpdated;
+    };
+}
+
 Label* Label::create()
 {
     auto ret = new Label();
@@ -883,9 +894,17 @@ void Label::draw(Renderer *renderer, const Mat4 &transform, bool transformUpdate
     _insideBounds = transformUpdated ? renderer->checkVisibility(transform, _contentSize) : _insideBounds;
 
     if(_insideBounds) {
-        _customCommand.init(_globalZOrder);
-        _customCommand.func = CC_CALLBACK_0(Label::onDraw, this, transform, transformUpdated);
-        renderer->addCommand(&_customCommand);
+        // the command and the arguments of onDraw() only live during this frame. The callback captures two pointers,
+        // which std::function stores without a heap allocation
+        auto allocator = renderer->getFrameAllocator();
+        auto arguments = allocator->create<DrawArguments>();
+        arguments->transform = transform;
+        arguments->transformUpdated = transformUpdated;
+
+        auto command = allocator->create<CustomCommand>();
+        command->init(_globalZOrder);
+        command->func = [this, arguments]() { onDraw(arguments->transform, arguments->transformUpdated); };
+        renderer->addCommand(command);
     }
 }
 
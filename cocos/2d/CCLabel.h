@@ -357,7 +357,6 @@ protected:
 
     GLuint _uniformEffectColor;
     GLuint _uniformTextColor;
-    CustomCommand _customCommand;   
 
     bool    _shadowDirty;
     bool    _shadowEnabled;
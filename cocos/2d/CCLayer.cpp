@@ -93,6 +93,8 @@ Layer *Layer::create()
     if (ret && ret->init())
     {
         ret->autorelease();
+        // plain layers draw nothing, subclasses have to opt in
+        ret->setCullable(true);
         return ret;
     }
     else
@@ -451,6 +453,8 @@ LayerColor::LayerColor()
 {
     // default blend function
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
+    // the color quad covers the content size
+    _cullable = true;
 }
     
 LayerColor::~LayerColor()
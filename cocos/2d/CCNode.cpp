@@ -45,6 +45,8 @@ THE SOFTWARE.
 #include "2d/CCComponentContainer.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
+#include "renderer/CCRenderer.h"
+#include "2d/CCStaticBatchNode.h"
 #include "math/TransformUtils.h"
 
 #include "deprecated/CCString.h"
@@ -107,6 +109,12 @@ Node::Node(void)
 , _visible(true)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
+, _parallelVisitEnabled(false)
+, _staticBatched(false)
+, _cullable(false)
+, _subtreeCullable(false)
+, _subtreeBoundsDirty(true)
+, _subtreeNodeCount(1)
 , _isTransitionFinished(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _updateScriptHandler(0)
@@ -200,6 +208,8 @@ void Node::setSkewX(float skewX)
     
     _skewX = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticBatchDirty();
+    setBoundsDirty();
 }
 
 float Node::getSkewY() const
@@ -214,6 +224,8 @@ void Node::setSkewY(float skewY)
     
     _skewY = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticBatchDirty();
+    setBoundsDirty();
 }
 
 
@@ -262,6 +274,8 @@ void Node::setRotation(float rotation)
     
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticBatchDirty();
+    setBoundsDirty();
 
 #if CC_USE_PHYSICS
     if (_physicsBody && !_physicsBody->_rotationResetTag)
@@ -285,6 +299,8 @@ void Node::setRotation3D(const Vec3& rotation)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticBatchDirty();
+    setBoundsDirty();
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -316,6 +332,8 @@ void Node::setRotationSkewX(float rotationX)
     
     _rotationZ_X = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticBatchDirty();
+    setBoundsDirty();
 }
 
 float Node::getRotationSkewY() const
@@ -330,6 +348,8 @@ void Node::setRotationSkewY(float rotationY)
     
     _rotationZ_Y = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticBatchDirty();
+    setBoundsDirty();
 }
 
 /// scale getter
@@ -347,6 +367,8 @@ void Node::setScale(float scale)
 
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticBatchDirty();
+    setBoundsDirty();
 }
 
 /// scaleX getter
@@ -364,6 +386,8 @@ void Node::setScale(float scaleX,float scaleY)
     _scaleX = scaleX;
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticBatchDirty();
+    setBoundsDirty();
 }
 
 /// scaleX setter
@@ -374,6 +398,8 @@ void Node::setScaleX(float scaleX)
     
     _scaleX = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticBatchDirty();
+    setBoundsDirty();
 }
 
 /// scaleY getter
@@ -390,6 +416,8 @@ void Node::setScaleZ(float scaleZ)
     
     _scaleZ = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticBatchDirty();
+    setBoundsDirty();
 }
 
 /// scaleY getter
@@ -406,6 +434,8 @@ void Node::setScaleY(float scaleY)
     
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticBatchDirty();
+    setBoundsDirty();
 }
 
 
@@ -423,6 +453,8 @@ void Node::setPosition(const Vec2& position)
     
     _position = position;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticBatchDirty();
+    setBoundsDirty();
 
 #if CC_USE_PHYSICS
     if (_physicsBody != nullptr && !_physicsBody->_positionResetTag)
@@ -490,6 +522,8 @@ void Node::setPositionZ(float positionZ)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticBatchDirty();
+    setBoundsDirty();
 
     _positionZ = positionZ;
 
@@ -516,6 +550,8 @@ void Node::setVisible(bool var)
     {
         _visible = var;
         if(_visible) _transformUpdated = _transformDirty = _inverseDirty = true;
+        setStaticBatchDirty();
+        setBoundsDirty();
     }
 }
 
@@ -545,6 +581,8 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints = Vec2(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y );
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        setStaticBatchDirty();
+        setBoundsDirty();
     }
 }
 
@@ -562,6 +600,8 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints = Vec2(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y );
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        setStaticBatchDirty();
+        setBoundsDirty();
     }
 }
 
@@ -589,6 +629,8 @@ void Node::ignoreAnchorPointForPosition(bool newValue)
     {
 		_ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        setStaticBatchDirty();
+        setBoundsDirty();
 	}
 }
 
@@ -639,6 +681,7 @@ void Node::setGLProgramState(cocos2d::GLProgramState *glProgramState)
         CC_SAFE_RELEASE(_glProgramState);
         _glProgramState = glProgramState;
         CC_SAFE_RETAIN(_glProgramState);
+        setStaticBatchDirty();
     }
 }
 
@@ -649,6 +692,7 @@ void Node::setGLProgram(GLProgram *glProgram)
         CC_SAFE_RELEASE(_glProgramState);
         _glProgramState = GLProgramState::getOrCreateWithGLProgram(glProgram);
         _glProgramState->retain();
+        setStaticBatchDirty();
     }
 }
 
@@ -677,6 +721,8 @@ Node * Node::create(void)
     if (ret && ret->init())
     {
         ret->autorelease();
+        // plain nodes draw nothing, subclasses have to opt in
+        ret->setCullable(true);
     }
     else
     {
@@ -909,6 +955,13 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
     child->setParent(nullptr);
 
     _children.erase(childIndex);
+
+    if (child->_staticBatched)
+    {
+        StaticBatchNode::forgetNode(child);
+        setStaticBatchDirty();
+    }
+    setBoundsDirty();
 }
 
 
@@ -918,6 +971,8 @@ void Node::insertChild(Node* child, int z)
     _transformUpdated = true;
     _reorderChildDirty = true;
     _children.pushBack(child);
+    setStaticBatchDirty();
+    setBoundsDirty();
     child->_setLocalZOrder(z);
 }
 
@@ -927,6 +982,7 @@ void Node::reorderChild(Node *child, int zOrder)
     _reorderChildDirty = true;
     child->setOrderOfArrival(s_globalOrderOfArrival++);
     child->_setLocalZOrder(zOrder);
+    setStaticBatchDirty();
 }
 
 void Node::sortAllChildren()
@@ -937,6 +993,88 @@ void Node::sortAllChildren()
     }
 }
 
+void Node::setStaticBatchDirty()
+{
+    if (!_staticBatched)
+        return;
+
+    for (Node* node = _parent; node != nullptr; node = node->_parent)
+    {
+        auto staticBatchNode = dynamic_cast<StaticBatchNode*>(node);
+        if (staticBatchNode)
+        {
+            staticBatchNode->setDirty(true);
+            return;
+        }
+    }
+}
+
+void Node::setCullable(bool cullable)
+{
+    if (cullable != _cullable)
+    {
+        _cullable = cullable;
+        setBoundsDirty();
+    }
+}
+
+void Node::setBoundsDirty()
+{
+    // the ancestors of a dirty node are dirty too
+    for (Node* node = this; node != nullptr && !node->_subtreeBoundsDirty; node = node->_parent)
+    {
+        node->_subtreeBoundsDirty = true;
+    }
+}
+
+void Node::updateSubtreeBounds()
+{
+    if (!_subtreeBoundsDirty)
+        return;
+
+    _subtreeBoundsDirty = false;
+    _subtreeCullable = _cullable;
+    _subtreeNodeCount = 1;
+    _subtreeBounds = Rect::ZERO;
+    if (_contentSize.width > 0 && _contentSize.height > 0)
+    {
+        _subtreeBounds.size = _contentSize;
+    }
+
+    // the clean children keep their bounds: only the dirty branches are walked
+    for (const auto& child : _children)
+    {
+        child->updateSubtreeBounds();
+        _subtreeCullable = _subtreeCullable && child->_subtreeCullable;
+        _subtreeNodeCount += child->_subtreeNodeCount;
+
+        if (!_subtreeCullable || !child->_visible || child->_subtreeBounds.size.width <= 0 || child->_subtreeBounds.size.height <= 0)
+            continue;
+
+        Rect childBounds = RectApplyTransform(child->_subtreeBounds, child->getNodeToParentTransform());
+        if (_subtreeBounds.size.width > 0 && _subtreeBounds.size.height > 0)
+            _subtreeBounds = _subtreeBounds.unionWithRect(childBounds);
+        else
+            _subtreeBounds = childBounds;
+    }
+}
+
+bool Node::isSubtreeCulled(Renderer* renderer)
+{
+    updateSubtreeBounds();
+
+    if (!_subtreeCullable)
+        return false;
+
+    // nothing is drawn
+    if (_subtreeBounds.size.width <= 0 || _subtreeBounds.size.height <= 0)
+        return true;
+
+    Mat4 transform = _modelViewTransform;
+    transform.translate(_subtreeBounds.origin.x, _subtreeBounds.origin.y, 0);
+    return !renderer->checkVisibility(transform, _subtreeBounds.size);
+}
+
 void Node::draw()
 {
     auto renderer = Director::getInstance()->getRenderer();
@@ -967,18 +1105,37 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, bool parentTra
         _modelViewTransform = this->transform(parentTransform);
     _transformUpdated = false;
 
+    // skip the whole subtree when it is off screen, the leaves cull themselves in draw()
+    if (!_children.empty() && isSubtreeCulled(renderer))
+    {
+        // the children will get the new transform when the subtree is visited again
+        _transformUpdated = dirty;
+        _orderOfArrival = 0;
+        renderer->addCulledNodes(_subtreeNodeCount);
+        return;
+    }
 
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
-    // but it is deprecated and your code should not rely on it
+    // but it is deprecated and your code should not rely on it.
+    // It is not thread safe, so it is not updated while visiting in parallel.
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    bool useMatrixStack = !renderer->isVisitingInParallel();
+    if (useMatrixStack)
+    {
+        director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    }
 
     int i = 0;
 
-    if(!_children.empty())
+    if(!_children.empty() && _parallelVisitEnabled)
+    {
+        sortAllChildren();
+        visitChildrenInParallel(renderer, dirty);
+    }
+    else if(!_children.empty())
     {
         sortAllChildren();
         // draw children zOrder < 0
@@ -1005,7 +1162,25 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, bool parentTra
     // reset for next frame
     _orderOfArrival = 0;
  
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    if (useMatrixStack)
+    {
+        director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    }
+}
+
+void Node::visitChildrenInParallel(Renderer* renderer, bool dirty)
+{
+    ssize_t selfIndex = 0;
+    while (selfIndex < _children.size() && _children.at(selfIndex)->_localZOrder < 0)
+        ++selfIndex;
+
+    // same order as a serial visit: children zOrder < 0, self draw, then the other children
+    renderer->visitInParallel(_children.size() + 1, [&](ssize_t index){
+        if (index == selfIndex)
+            this->draw(renderer, _modelViewTransform, dirty);
+        else
+            _children.at(index < selfIndex ? index : index - 1)->visit(renderer, _modelViewTransform, dirty);
+    });
 }
 
 Mat4 Node::transform(const Mat4& parentTransform)
@@ -1441,6 +1616,8 @@ void Node::setNodeToParentTransform(const Mat4& transform)
     _transform = transform;
     _transformDirty = false;
     _transformUpdated = true;
+    setStaticBatchDirty();
+    setBoundsDirty();
 }
 
 void Node::setAdditionalTransform(const AffineTransform& additionalTransform)
@@ -1459,6 +1636,8 @@ void Node::setAdditionalTransform(Mat4* additionalTransform)
         _useAdditionalTransform = true;
     }
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setStaticBatchDirty();
+    setBoundsDirty();
 }
 
 
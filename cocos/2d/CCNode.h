@@ -960,6 +960,39 @@ public:
     virtual void visit(Renderer *renderer, const Mat4& parentTransform, bool parentTransformUpdated);
     virtual void visit() final;
 
+    /**
+     * Sets whether the children of this node are visited in parallel, on the worker threads.
+     * Their RenderCommands are merged back in the same order as a serial visit, so the result is the same.
+     * Only use it on large subtrees whose nodes just emit RenderCommands in draw() (sprites, particles...):
+     * no GL calls, no autoreleased objects and no use of the Director matrix stack, which is not updated
+     * for the nodes visited in parallel.
+     * Default is false.
+     */
+    void setParallelVisitEnabled(bool enabled) { _parallelVisitEnabled = enabled; }
+    /** Returns whether the children of this node are visited in parallel */
+    bool isParallelVisitEnabled() const { return _parallelVisitEnabled; }
+
+    /**
+     * Sets whether the node can be skipped by visit() when it is off screen.
+     * A cullable node only draws inside its content size, and its visit() and draw() have no other side effects.
+     * When all the nodes of a subtree are cullable, the bounds of the subtree are cached and the whole subtree
+     * is skipped when they are outside the screen.
+     * Nodes and layers made by Node::create() and Layer::create(), sprites and LayerColor are cullable,
+     * the other nodes are not by default.
+     * @since v3.2
+     */
+    void setCullable(bool cullable);
+    /** Returns whether the node can be skipped by visit() when it is off screen */
+    bool isCullable() const { return _cullable; }
+
+    /** Used by StaticBatchNode: marks the node as drawn from the geometry captured by a StaticBatchNode ancestor.
+     * @js NA
+     * @lua NA
+     */
+    void setStaticBatched(bool staticBatched) { _staticBatched = staticBatched; }
+    /** Returns whether the node is drawn from the geometry captured by a StaticBatchNode ancestor */
+    bool isStaticBatched() const { return _staticBatched; }
+
 
     /** Returns the Scene that contains the Node.
      It returns `nullptr` if the node doesn't belong to any Scene.
@@ -1391,6 +1424,19 @@ protected:
 
     Mat4 transform(const Mat4 &parentTransform);
 
+    /// visits the children and draws self on the worker threads, see setParallelVisitEnabled()
+    void visitChildrenInParallel(Renderer* renderer, bool dirty);
+
+    /// tells the StaticBatchNode that captured this node that its geometry has to be captured again
+    void setStaticBatchDirty();
+
+    /// the bounds of the subtree of this node and of its ancestors have to be computed again
+    void setBoundsDirty();
+    /// computes the bounds of the subtree if they are dirty, walking the dirty children only
+    void updateSubtreeBounds();
+    /// returns whether the whole subtree is outside the screen, `_modelViewTransform` has to be up to date
+    bool isSubtreeCulled(Renderer* renderer);
+
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
     virtual void updateCascadeColor();
@@ -1466,6 +1512,13 @@ protected:
                                           ///< Used by Layer and Scene.
 
     bool _reorderChildDirty;          ///< children order dirty flag
+    bool _parallelVisitEnabled;       ///< whether the children are visited on the worker threads
+    bool _staticBatched;              ///< whether the node was captured by a StaticBatchNode
+    bool _cullable;                   ///< whether the node only draws inside its content size, see setCullable()
+    bool _subtreeCullable;            ///< whether all the nodes of the subtree are cullable
+    bool _subtreeBoundsDirty;         ///< whether the subtree bounds have to be computed again
+    int _subtreeNodeCount;            ///< number of nodes in the subtree, this one included
+    Rect _subtreeBounds;              ///< bounds of the visible subtree in the node space, empty if nothing is drawn
     bool _isTransitionFinished;       ///< flag to indicate whether the transition was finished
 
 #if CC_ENABLE_SCRIPT_BINDING
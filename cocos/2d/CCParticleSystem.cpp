@@ -47,6 +47,7 @@ THE SOFTWARE.
 #include <string>
 
 #include "CCParticleBatchNode.h"
+#include "2d/CCParticleSystemCache.h"
 #include "base/ccTypes.h"
 #include "2d/CCTextureCache.h"
 #include "2d/CCTextureAtlas.h"
@@ -56,6 +57,9 @@ THE SOFTWARE.
 #include "base/ZipUtils.h"
 #include "base/CCDirector.h"
 #include "base/CCProfiling.h"
+#include "base/CCScheduler.h"
+#include "base/CCWorkerPool.h"
+#include "math/MathUtil.h"
 // opengl
 #include "CCGL.h"
 
@@ -81,12 +85,100 @@ NS_CC_BEGIN
 //  cocos2d uses a another approach, but the results are almost identical. 
 //
 
+// number of arrays in ParticleData, atlasIndex included
+static const int PARTICLE_ARRAY_COUNT = 26;
+
+static_assert(sizeof(unsigned int) == sizeof(float), "ParticleData stores atlasIndex in a float sized slot");
+
+// parallel update mode, see ParticleSystem::setParallelUpdateEnabled()
+static bool s_parallelUpdateEnabled = false;
+
+ParticleData::ParticleData()
+{
+    memset(this, 0, sizeof(ParticleData));
+}
+
+ParticleData::~ParticleData()
+{
+    release();
+}
+
+bool ParticleData::init(int count)
+{
+    release();
+
+    // every array is padded to a multiple of 4 floats so the SIMD kernels start on an aligned address
+    _stride = (count + 3) & ~3;
+    _buffer = (float*)calloc(_stride * PARTICLE_ARRAY_COUNT, sizeof(float));
+    if (_buffer == nullptr && _stride > 0)
+    {
+        return false;
+    }
+
+    float* array = _buffer;
+    auto nextArray = [&]() {
+        float* ret = array;
+        array += _stride;
+        return ret;
+    };
+
+    posx = nextArray();
+    posy = nextArray();
+    startPosX = nextArray();
+    startPosY = nextArray();
+
+    colorR = nextArray();
+    colorG = nextArray();
+    colorB = nextArray();
+    colorA = nextArray();
+
+    deltaColorR = nextArray();
+    deltaColorG = nextArray();
+    deltaColorB = nextArray();
+    deltaColorA = nextArray();
+
+    size = nextArray();
+    deltaSize = nextArray();
+    rotation = nextArray();
+    deltaRotation = nextArray();
+    timeToLive = nextArray();
+    atlasIndex = (unsigned int*)nextArray();
+
+    modeA.dirX = nextArray();
+    modeA.dirY = nextArray();
+    modeA.radialAccel = nextArray();
+    modeA.tangentialAccel = nextArray();
+
+    modeB.angle = nextArray();
+    modeB.degreesPerSecond = nextArray();
+    modeB.radius = nextArray();
+    modeB.deltaRadius = nextArray();
+
+    maxCount = count;
+    return true;
+}
+
+void ParticleData::release()
+{
+    CC_SAFE_FREE(_buffer);
+    memset(this, 0, sizeof(ParticleData));
+}
+
+void ParticleData::copyParticle(int p1, int p2)
+{
+    // copied as integers, atlasIndex shares the buffer with the floats
+    unsigned int* buffer = (unsigned int*)_buffer;
+    for (int i = 0; i < PARTICLE_ARRAY_COUNT; ++i, buffer += _stride)
+    {
+        buffer[p1] = buffer[p2];
+    }
+}
+
 ParticleSystem::ParticleSystem()
 : _isBlendAdditive(false)
 , _isAutoRemoveOnFinish(false)
 , _plistFile("")
 , _elapsed(0)
-, _particles(nullptr)
 , _configName("")
 , _emitCounter(0)
 , _particleIdx(0)
@@ -119,6 +211,10 @@ ParticleSystem::ParticleSystem()
 , _opacityModifyRGB(false)
 , _yCoordFlipped(1)
 , _positionType(PositionType::FREE)
+, _currentPosition(Vec2::ZERO)
+, _queuedDelta(0)
+, _isQueued(false)
+, _randomState(1)
 {
     modeA.gravity = Vec2::ZERO;
     modeA.speed = 0;
@@ -134,6 +230,8 @@ ParticleSystem::ParticleSystem()
     modeB.endRadiusVar = 0;            
     modeB.rotatePerSecond = 0;
     modeB.rotatePerSecondVar = 0;
+
+    setRandomSeed(rand());
 }
 // implementation ParticleSystem
 
@@ -170,7 +268,8 @@ bool ParticleSystem::initWithFile(const std::string& plistFile)
 {
     bool ret = false;
     _plistFile = FileUtils::getInstance()->fullPathForFilename(plistFile);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(_plistFile.c_str());
+    // parsed once, shared by the systems created from the same file
+    const ValueMap& dict = ParticleSystemCache::getInstance()->getDefinition(_plistFile);
 
     CCASSERT( !dict.empty(), "Particles: file not found");
     
@@ -189,12 +288,19 @@ bool ParticleSystem::initWithFile(const std::string& plistFile)
     return ret;
 }
 
-bool ParticleSystem::initWithDictionary(ValueMap& dictionary)
+bool ParticleSystem::initWithDictionary(const ValueMap& dictionary)
 {
     return initWithDictionary(dictionary, "");
 }
 
-bool ParticleSystem::initWithDictionary(ValueMap& dictionary, const std::string& dirname)
+// The missing keys read as a null value, without being added: the cached definitions are shared
+static const Value& valueForKey(const ValueMap& dictionary, const std::string& key)
+{
+    auto iter = dictionary.find(key);
+    return iter != dictionary.end() ? iter->second : Value::Null;
+}
+
+bool ParticleSystem::initWithDictionary(const ValueMap& dictionary, const std::string& dirname)
 {
     bool ret = false;
     unsigned char *buffer = nullptr;
@@ -202,94 +308,94 @@ bool ParticleSystem::initWithDictionary(ValueMap& dictionary, const std::string&
     Image *image = nullptr;
     do 
     {
-        int maxParticles = dictionary["maxParticles"].asInt();
+        int maxParticles = valueForKey(dictionary, "maxParticles").asInt();
         // self, not super
         if(this->initWithTotalParticles(maxParticles))
         {
             // Emitter name in particle designer 2.0
-            _configName = dictionary["configName"].asString();
+            _configName = valueForKey(dictionary, "configName").asString();
 
             // angle
-            _angle = dictionary["angle"].asFloat();
-            _angleVar = dictionary["angleVariance"].asFloat();
+            _angle = valueForKey(dictionary, "angle").asFloat();
+            _angleVar = valueForKey(dictionary, "angleVariance").asFloat();
 
             // duration
-            _duration = dictionary["duration"].asFloat();
+            _duration = valueForKey(dictionary, "duration").asFloat();
 
             // blend function 
             if (_configName.length()>0)
             {
-                _blendFunc.src = dictionary["blendFuncSource"].asFloat();
+                _blendFunc.src = valueForKey(dictionary, "blendFuncSource").asFloat();
             }
             else
             {
-                _blendFunc.src = dictionary["blendFuncSource"].asInt();
+                _blendFunc.src = valueForKey(dictionary, "blendFuncSource").asInt();
             }
-            _blendFunc.dst = dictionary["blendFuncDestination"].asInt();
+            _blendFunc.dst = valueForKey(dictionary, "blendFuncDestination").asInt();
 
             // color
-            _startColor.r = dictionary["startColorRed"].asFloat();
-            _startColor.g = dictionary["startColorGreen"].asFloat();
-            _startColor.b = dictionary["startColorBlue"].asFloat();
-            _startColor.a = dictionary["startColorAlpha"].asFloat();
-
-            _startColorVar.r = dictionary["startColorVarianceRed"].asFloat();
-            _startColorVar.g = dictionary["startColorVarianceGreen"].asFloat();
-            _startColorVar.b = dictionary["startColorVarianceBlue"].asFloat();
-            _startColorVar.a = dictionary["startColorVarianceAlpha"].asFloat();
-
-            _endColor.r = dictionary["finishColorRed"].asFloat();
-            _endColor.g = dictionary["finishColorGreen"].asFloat();
-            _endColor.b = dictionary["finishColorBlue"].asFloat();
-            _endColor.a = dictionary["finishColorAlpha"].asFloat();
-
-            _endColorVar.r = dictionary["finishColorVarianceRed"].asFloat();
-            _endColorVar.g = dictionary["finishColorVarianceGreen"].asFloat();
-            _endColorVar.b = dictionary["finishColorVarianceBlue"].asFloat();
-            _endColorVar.a = dictionary["finishColorVarianceAlpha"].asFloat();
+            _startColor.r = valueForKey(dictionary, "startColorRed").asFloat();
+            _startColor.g = valueForKey(dictionary, "startColorGreen").asFloat();
+            _startColor.b = valueForKey(dictionary, "startColorBlue").asFloat();
+            _startColor.a = valueForKey(dictionary, "startColorAlpha").asFloat();
+
+            _startColorVar.r = valueForKey(dictionary, "startColorVarianceRed").asFloat();
+            _startColorVar.g = valueForKey(dictionary, "startColorVarianceGreen").asFloat();
+            _startColorVar.b = valueForKey(dictionary, "startColorVarianceBlue").asFloat();
+            _startColorVar.a = valueForKey(dictionary, "startColorVarianceAlpha").asFloat();
+
+            _endColor.r = valueForKey(dictionary, "finishColorRed").asFloat();
+            _endColor.g = valueForKey(dictionary, "finishColorGreen").asFloat();
+            _endColor.b = valueForKey(dictionary, "finishColorBlue").asFloat();
+            _endColor.a = valueForKey(dictionary, "finishColorAlpha").asFloat();
+
+            _endColorVar.r = valueForKey(dictionary, "finishColorVarianceRed").asFloat();
+            _endColorVar.g = valueForKey(dictionary, "finishColorVarianceGreen").asFloat();
+            _endColorVar.b = valueForKey(dictionary, "finishColorVarianceBlue").asFloat();
+            _endColorVar.a = valueForKey(dictionary, "finishColorVarianceAlpha").asFloat();
 
             // particle size
-            _startSize = dictionary["startParticleSize"].asFloat();
-            _startSizeVar = dictionary["startParticleSizeVariance"].asFloat();
-            _endSize = dictionary["finishParticleSize"].asFloat();
-            _endSizeVar = dictionary["finishParticleSizeVariance"].asFloat();
+            _startSize = valueForKey(dictionary, "startParticleSize").asFloat();
+            _startSizeVar = valueForKey(dictionary, "startParticleSizeVariance").asFloat();
+            _endSize = valueForKey(dictionary, "finishParticleSize").asFloat();
+            _endSizeVar = valueForKey(dictionary, "finishParticleSizeVariance").asFloat();
 
             // position
-            float x = dictionary["sourcePositionx"].asFloat();
-            float y = dictionary["sourcePositiony"].asFloat();
+            float x = valueForKey(dictionary, "sourcePositionx").asFloat();
+            float y = valueForKey(dictionary, "sourcePositiony").asFloat();
             this->setPosition( Vec2(x,y) );            
-            _posVar.x = dictionary["sourcePositionVariancex"].asFloat();
-            _posVar.y = dictionary["sourcePositionVariancey"].asFloat();
+            _posVar.x = valueForKey(dictionary, "sourcePositionVariancex").asFloat();
+            _posVar.y = valueForKey(dictionary, "sourcePositionVariancey").asFloat();
 
             // Spinning
-            _startSpin = dictionary["rotationStart"].asFloat();
-            _startSpinVar = dictionary["rotationStartVariance"].asFloat();
-            _endSpin= dictionary["rotationEnd"].asFloat();
-            _endSpinVar= dictionary["rotationEndVariance"].asFloat();
+            _startSpin = valueForKey(dictionary, "rotationStart").asFloat();
+            _startSpinVar = valueForKey(dictionary, "rotationStartVariance").asFloat();
+            _endSpin= valueForKey(dictionary, "rotationEnd").asFloat();
+            _endSpinVar= valueForKey(dictionary, "rotationEndVariance").asFloat();
 
-            _emitterMode = (Mode) dictionary["emitterType"].asInt();
+            _emitterMode = (Mode) valueForKey(dictionary, "emitterType").asInt();
 
             // Mode A: Gravity + tangential accel + radial accel
             if (_emitterMode == Mode::GRAVITY)
             {
                 // gravity
-                modeA.gravity.x = dictionary["gravityx"].asFloat();
-                modeA.gravity.y = dictionary["gravityy"].asFloat();
+                modeA.gravity.x = valueForKey(dictionary, "gravityx").asFloat();
+                modeA.gravity.y = valueForKey(dictionary, "gravityy").asFloat();
 
                 // speed
-                modeA.speed = dictionary["speed"].asFloat();
-                modeA.speedVar = dictionary["speedVariance"].asFloat();
+                modeA.speed = valueForKey(dictionary, "speed").asFloat();
+                modeA.speedVar = valueForKey(dictionary, "speedVariance").asFloat();
 
                 // radial acceleration
-                modeA.radialAccel = dictionary["radialAcceleration"].asFloat();
-                modeA.radialAccelVar = dictionary["radialAccelVariance"].asFloat();
+                modeA.radialAccel = valueForKey(dictionary, "radialAcceleration").asFloat();
+                modeA.radialAccelVar = valueForKey(dictionary, "radialAccelVariance").asFloat();
 
                 // tangential acceleration
-                modeA.tangentialAccel = dictionary["tangentialAcceleration"].asFloat();
-                modeA.tangentialAccelVar = dictionary["tangentialAccelVariance"].asFloat();
+                modeA.tangentialAccel = valueForKey(dictionary, "tangentialAcceleration").asFloat();
+                modeA.tangentialAccelVar = valueForKey(dictionary, "tangentialAccelVariance").asFloat();
                 
                 // rotation is dir
-                modeA.rotationIsDir = dictionary["rotationIsDir"].asBool();
+                modeA.rotationIsDir = valueForKey(dictionary, "rotationIsDir").asBool();
             }
 
             // or Mode B: radius movement
@@ -297,25 +403,25 @@ bool ParticleSystem::initWithDictionary(ValueMap& dictionary, const std::string&
             {
                 if (_configName.length()>0)
                 {
-                    modeB.startRadius = dictionary["maxRadius"].asInt();
+                    modeB.startRadius = valueForKey(dictionary, "maxRadius").asInt();
                 }
                 else
                 {
-                    modeB.startRadius = dictionary["maxRadius"].asFloat();
+                    modeB.startRadius = valueForKey(dictionary, "maxRadius").asFloat();
                 }
-                modeB.startRadiusVar = dictionary["maxRadiusVariance"].asFloat();
+                modeB.startRadiusVar = valueForKey(dictionary, "maxRadiusVariance").asFloat();
                 if (_configName.length()>0)
                 {
-                    modeB.endRadius = dictionary["minRadius"].asInt();
+                    modeB.endRadius = valueForKey(dictionary, "minRadius").asInt();
                 }
                 else
                 {
-                    modeB.endRadius = dictionary["minRadius"].asFloat();
+                    modeB.endRadius = valueForKey(dictionary, "minRadius").asFloat();
                 }
                 
                 if (dictionary.find("minRadiusVariance") != dictionary.end())
                 {
-                    modeB.endRadiusVar = dictionary["minRadiusVariance"].asFloat();
+                    modeB.endRadiusVar = valueForKey(dictionary, "minRadiusVariance").asFloat();
                 }
                 else
                 {
@@ -324,13 +430,13 @@ bool ParticleSystem::initWithDictionary(ValueMap& dictionary, const std::string&
                 
                 if (_configName.length()>0)
                 {
-                    modeB.rotatePerSecond = dictionary["rotatePerSecond"].asInt();
+                    modeB.rotatePerSecond = valueForKey(dictionary, "rotatePerSecond").asInt();
                 }
                 else
                 {
-                    modeB.rotatePerSecond = dictionary["rotatePerSecond"].asFloat();
+                    modeB.rotatePerSecond = valueForKey(dictionary, "rotatePerSecond").asFloat();
                 }
-                modeB.rotatePerSecondVar = dictionary["rotatePerSecondVariance"].asFloat();
+                modeB.rotatePerSecondVar = valueForKey(dictionary, "rotatePerSecondVariance").asFloat();
 
             } else {
                 CCASSERT( false, "Invalid emitterType in config file");
@@ -338,8 +444,8 @@ bool ParticleSystem::initWithDictionary(ValueMap& dictionary, const std::string&
             }
 
             // life span
-            _life = dictionary["particleLifespan"].asFloat();
-            _lifeVar = dictionary["particleLifespanVariance"].asFloat();
+            _life = valueForKey(dictionary, "particleLifespan").asFloat();
+            _lifeVar = valueForKey(dictionary, "particleLifespanVariance").asFloat();
 
             // emission Rate
             _emissionRate = _totalParticles / _life;
@@ -352,7 +458,7 @@ bool ParticleSystem::initWithDictionary(ValueMap& dictionary, const std::string&
 
                 // texture        
                 // Try to get the texture from the cache
-                std::string textureName = dictionary["textureFileName"].asString();
+                std::string textureName = valueForKey(dictionary, "textureFileName").asString();
                 
                 size_t rPos = textureName.rfind('/');
                
@@ -374,6 +480,12 @@ bool ParticleSystem::initWithDictionary(ValueMap& dictionary, const std::string&
                 Texture2D *tex = nullptr;
                 
                 if (textureName.length() > 0)
+                {
+                    // the textures decoded from textureImageData are only found by their key
+                    tex = Director::getInstance()->getTextureCache()->getTextureForKey(textureName);
+                }
+
+                if (! tex && textureName.length() > 0)
                 {
                     // set not pop-up message box when load image failed
                     bool notify = FileUtils::getInstance()->isPopupNotify();
@@ -433,11 +545,7 @@ bool ParticleSystem::initWithTotalParticles(int numberOfParticles)
 {
     _totalParticles = numberOfParticles;
 
-    CC_SAFE_FREE(_particles);
-    
-    _particles = (tParticle*)calloc(_totalParticles, sizeof(tParticle));
-
-    if( ! _particles )
+    if( ! _particleData.init(_totalParticles) )
     {
         CCLOG("Particle system: not enough memory");
         this->release();
@@ -449,7 +557,7 @@ bool ParticleSystem::initWithTotalParticles(int numberOfParticles)
     {
         for (int i = 0; i < _totalParticles; i++)
         {
-            _particles[i].atlasIndex=i;
+            _particleData.atlasIndex[i]=i;
         }
     }
     // default, active
@@ -470,9 +578,6 @@ bool ParticleSystem::initWithTotalParticles(int numberOfParticles)
 
     _isAutoRemoveOnFinish = false;
 
-    // Optimization: compile updateParticle method
-    //updateParticleSel = @selector(updateQuadWithParticle:newPosition:);
-    //updateParticleImp = (CC_UPDATE_PARTICLE_IMP) [self methodForSelector:updateParticleSel];
     //for batchNode
     _transformSystemDirty = false;
 
@@ -484,7 +589,7 @@ ParticleSystem::~ParticleSystem()
     // Since the scheduler retains the "target (in this case the ParticleSystem)
 	// it is not needed to call "unscheduleUpdate" here. In fact, it will be called in "cleanup"
     //unscheduleUpdate();
-    CC_SAFE_FREE(_particles);
+    _particleData.release();
     CC_SAFE_RELEASE(_texture);
 }
 
@@ -495,123 +600,168 @@ bool ParticleSystem::addParticle()
         return false;
     }
 
-    tParticle * particle = &_particles[ _particleCount ];
-    this->initParticle(particle);
-    ++_particleCount;
+    this->addParticles(1);
 
     return true;
 }
 
-void ParticleSystem::initParticle(tParticle* particle)
+void ParticleSystem::initRandomValues(float* values, int start, int end, float base, float variance)
 {
-    // timeToLive
-    // no negative life. prevent division by 0
-    particle->timeToLive = _life + _lifeVar * CCRANDOM_MINUS1_1();
-    particle->timeToLive = MAX(0, particle->timeToLive);
+    for (int i = start; i < end; ++i)
+    {
+        values[i] = base + variance * randomMinus1To1();
+    }
+}
 
-    // position
-    particle->pos.x = _sourcePosition.x + _posVar.x * CCRANDOM_MINUS1_1();
+static void clampValues(float* values, int start, int end, float minValue, float maxValue)
+{
+    for (int i = start; i < end; ++i)
+    {
+        values[i] = clampf(values[i], minValue, maxValue);
+    }
+}
 
-    particle->pos.y = _sourcePosition.y + _posVar.y * CCRANDOM_MINUS1_1();
+// Turns the end values stored in deltas into the per second change from the start values
+static void initDeltaValues(float* deltas, const float* values, const float* timeToLive, int start, int end)
+{
+    for (int i = start; i < end; ++i)
+    {
+        deltas[i] = (deltas[i] - values[i]) / timeToLive[i];
+    }
+}
 
+void ParticleSystem::addParticles(int count)
+{
+    _currentPosition = computeCurrentPosition();
+    emitParticles(count);
+}
 
-    // Color
-    Color4F start;
-    start.r = clampf(_startColor.r + _startColorVar.r * CCRANDOM_MINUS1_1(), 0, 1);
-    start.g = clampf(_startColor.g + _startColorVar.g * CCRANDOM_MINUS1_1(), 0, 1);
-    start.b = clampf(_startColor.b + _startColorVar.b * CCRANDOM_MINUS1_1(), 0, 1);
-    start.a = clampf(_startColor.a + _startColorVar.a * CCRANDOM_MINUS1_1(), 0, 1);
+void ParticleSystem::emitParticles(int count)
+{
+    count = MIN(count, _totalParticles - _particleCount);
+    if (count <= 0)
+    {
+        return;
+    }
 
-    Color4F end;
-    end.r = clampf(_endColor.r + _endColorVar.r * CCRANDOM_MINUS1_1(), 0, 1);
-    end.g = clampf(_endColor.g + _endColorVar.g * CCRANDOM_MINUS1_1(), 0, 1);
-    end.b = clampf(_endColor.b + _endColorVar.b * CCRANDOM_MINUS1_1(), 0, 1);
-    end.a = clampf(_endColor.a + _endColorVar.a * CCRANDOM_MINUS1_1(), 0, 1);
+    int start = _particleCount;
+    int end = start + count;
 
-    particle->color = start;
-    particle->deltaColor.r = (end.r - start.r) / particle->timeToLive;
-    particle->deltaColor.g = (end.g - start.g) / particle->timeToLive;
-    particle->deltaColor.b = (end.b - start.b) / particle->timeToLive;
-    particle->deltaColor.a = (end.a - start.a) / particle->timeToLive;
+    // timeToLive
+    // no negative life. prevent division by 0
+    initRandomValues(_particleData.timeToLive, start, end, _life, _lifeVar);
+    MathUtil::clampMin(_particleData.timeToLive + start, 0, count);
 
-    // size
-    float startS = _startSize + _startSizeVar * CCRANDOM_MINUS1_1();
-    startS = MAX(0, startS); // No negative value
+    // position
+    initRandomValues(_particleData.posx, start, end, _sourcePosition.x, _posVar.x);
+    initRandomValues(_particleData.posy, start, end, _sourcePosition.y, _posVar.y);
+
+    // Color, the end color is kept in the deltas until they are computed
+    initRandomValues(_particleData.colorR, start, end, _startColor.r, _startColorVar.r);
+    initRandomValues(_particleData.colorG, start, end, _startColor.g, _startColorVar.g);
+    initRandomValues(_particleData.colorB, start, end, _startColor.b, _startColorVar.b);
+    initRandomValues(_particleData.colorA, start, end, _startColor.a, _startColorVar.a);
+    initRandomValues(_particleData.deltaColorR, start, end, _endColor.r, _endColorVar.r);
+    initRandomValues(_particleData.deltaColorG, start, end, _endColor.g, _endColorVar.g);
+    initRandomValues(_particleData.deltaColorB, start, end, _endColor.b, _endColorVar.b);
+    initRandomValues(_particleData.deltaColorA, start, end, _endColor.a, _endColorVar.a);
+
+    float* colors[] = {
+        _particleData.colorR, _particleData.colorG, _particleData.colorB, _particleData.colorA,
+        _particleData.deltaColorR, _particleData.deltaColorG, _particleData.deltaColorB, _particleData.deltaColorA,
+    };
+    for (auto values : colors)
+    {
+        clampValues(values, start, end, 0, 1);
+    }
 
-    particle->size = startS;
+    initDeltaValues(_particleData.deltaColorR, _particleData.colorR, _particleData.timeToLive, start, end);
+    initDeltaValues(_particleData.deltaColorG, _particleData.colorG, _particleData.timeToLive, start, end);
+    initDeltaValues(_particleData.deltaColorB, _particleData.colorB, _particleData.timeToLive, start, end);
+    initDeltaValues(_particleData.deltaColorA, _particleData.colorA, _particleData.timeToLive, start, end);
+
+    // size
+    initRandomValues(_particleData.size, start, end, _startSize, _startSizeVar);
+    MathUtil::clampMin(_particleData.size + start, 0, count); // No negative value
 
     if (_endSize == START_SIZE_EQUAL_TO_END_SIZE)
     {
-        particle->deltaSize = 0;
+        memset(_particleData.deltaSize + start, 0, sizeof(float) * count);
     }
     else
     {
-        float endS = _endSize + _endSizeVar * CCRANDOM_MINUS1_1();
-        endS = MAX(0, endS); // No negative values
-        particle->deltaSize = (endS - startS) / particle->timeToLive;
+        initRandomValues(_particleData.deltaSize, start, end, _endSize, _endSizeVar);
+        MathUtil::clampMin(_particleData.deltaSize + start, 0, count); // No negative values
+        initDeltaValues(_particleData.deltaSize, _particleData.size, _particleData.timeToLive, start, end);
     }
 
     // rotation
-    float startA = _startSpin + _startSpinVar * CCRANDOM_MINUS1_1();
-    float endA = _endSpin + _endSpinVar * CCRANDOM_MINUS1_1();
-    particle->rotation = startA;
-    particle->deltaRotation = (endA - startA) / particle->timeToLive;
+    initRandomValues(_particleData.rotation, start, end, _startSpin, _startSpinVar);
+    initRandomValues(_particleData.deltaRotation, start, end, _endSpin, _endSpinVar);
+    initDeltaValues(_particleData.deltaRotation, _particleData.rotation, _particleData.timeToLive, start, end);
 
     // position
-    if (_positionType == PositionType::FREE)
+    if (_positionType == PositionType::FREE || _positionType == PositionType::RELATIVE)
     {
-        particle->startPos = this->convertToWorldSpace(Vec2::ZERO);
-    }
-    else if (_positionType == PositionType::RELATIVE)
-    {
-        particle->startPos = _position;
+        for (int i = start; i < end; ++i)
+        {
+            _particleData.startPosX[i] = _currentPosition.x;
+            _particleData.startPosY[i] = _currentPosition.y;
+        }
     }
 
-    // direction
-    float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * CCRANDOM_MINUS1_1() );    
-
     // Mode Gravity: A
     if (_emitterMode == Mode::GRAVITY)
     {
-        Vec2 v(cosf( a ), sinf( a ));
-        float s = modeA.speed + modeA.speedVar * CCRANDOM_MINUS1_1();
-
         // direction
-        particle->modeA.dir = v * s ;
+        for (int i = start; i < end; ++i)
+        {
+            float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * randomMinus1To1() );
+            float s = modeA.speed + modeA.speedVar * randomMinus1To1();
+            _particleData.modeA.dirX[i] = cosf(a) * s;
+            _particleData.modeA.dirY[i] = sinf(a) * s;
+        }
 
         // radial accel
-        particle->modeA.radialAccel = modeA.radialAccel + modeA.radialAccelVar * CCRANDOM_MINUS1_1();
- 
+        initRandomValues(_particleData.modeA.radialAccel, start, end, modeA.radialAccel, modeA.radialAccelVar);
 
         // tangential accel
-        particle->modeA.tangentialAccel = modeA.tangentialAccel + modeA.tangentialAccelVar * CCRANDOM_MINUS1_1();
+        initRandomValues(_particleData.modeA.tangentialAccel, start, end, modeA.tangentialAccel, modeA.tangentialAccelVar);
 
         // rotation is dir
-        if(modeA.rotationIsDir)
-            particle->rotation = -CC_RADIANS_TO_DEGREES(particle->modeA.dir.getAngle());
+        if (modeA.rotationIsDir)
+        {
+            for (int i = start; i < end; ++i)
+            {
+                _particleData.rotation[i] = -CC_RADIANS_TO_DEGREES(atan2f(_particleData.modeA.dirY[i], _particleData.modeA.dirX[i]));
+            }
+        }
     }
 
     // Mode Radius: B
-    else 
+    else
     {
         // Set the default diameter of the particle from the source position
-        float startRadius = modeB.startRadius + modeB.startRadiusVar * CCRANDOM_MINUS1_1();
-        float endRadius = modeB.endRadius + modeB.endRadiusVar * CCRANDOM_MINUS1_1();
-
-        particle->modeB.radius = startRadius;
+        initRandomValues(_particleData.modeB.radius, start, end, modeB.startRadius, modeB.startRadiusVar);
 
         if (modeB.endRadius == START_RADIUS_EQUAL_TO_END_RADIUS)
         {
-            particle->modeB.deltaRadius = 0;
+            memset(_particleData.modeB.deltaRadius + start, 0, sizeof(float) * count);
         }
         else
         {
-            particle->modeB.deltaRadius = (endRadius - startRadius) / particle->timeToLive;
+            initRandomValues(_particleData.modeB.deltaRadius, start, end, modeB.endRadius, modeB.endRadiusVar);
+            initDeltaValues(_particleData.modeB.deltaRadius, _particleData.modeB.radius, _particleData.timeToLive, start, end);
         }
 
-        particle->modeB.angle = a;
-        particle->modeB.degreesPerSecond = CC_DEGREES_TO_RADIANS(modeB.rotatePerSecond + modeB.rotatePerSecondVar * CCRANDOM_MINUS1_1());
-    }    
+        for (int i = start; i < end; ++i)
+        {
+            _particleData.modeB.angle[i] = CC_DEGREES_TO_RADIANS( _angle + _angleVar * randomMinus1To1() );
+            _particleData.modeB.degreesPerSecond[i] = CC_DEGREES_TO_RADIANS(modeB.rotatePerSecond + modeB.rotatePerSecondVar * randomMinus1To1());
+        }
+    }
+
+    _particleCount += count;
 }
 
 void ParticleSystem::onEnter()
@@ -619,7 +769,9 @@ void ParticleSystem::onEnter()
     Node::onEnter();
     
     // update after action in run!
-    this->scheduleUpdateWithPriority(1);
+    _scheduler->scheduleUpdate(this, 1, !_running, [this](float dt){
+        this->scheduledUpdate(dt);
+    });
 }
 
 void ParticleSystem::onExit()
@@ -639,10 +791,9 @@ void ParticleSystem::resetSystem()
 {
     _isActive = true;
     _elapsed = 0;
-    for (_particleIdx = 0; _particleIdx < _particleCount; ++_particleIdx)
+    for (int i = 0; i < _particleCount; ++i)
     {
-        tParticle *p = &_particles[_particleIdx];
-        p->timeToLive = 0;
+        _particleData.timeToLive[i] = 0;
     }
 }
 bool ParticleSystem::isFull()
@@ -651,180 +802,235 @@ bool ParticleSystem::isFull()
 }
 
 // ParticleSystem - MainLoop
-void ParticleSystem::update(float dt)
+void ParticleSystem::scheduledUpdate(float dt)
 {
-    CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
-
-    if (_isActive && _emissionRate)
+    // systems in a batch node write in the shared atlas, they are updated right away
+    if (s_parallelUpdateEnabled && ! _batchNode)
     {
-        float rate = 1.0f / _emissionRate;
-        //issue #1201, prevent bursts of particles, due to too high emitCounter
-        if (_particleCount < _totalParticles)
+        if (_isQueued)
         {
-            _emitCounter += dt;
+            _queuedDelta += dt;
+            return;
         }
-        
-        while (_particleCount < _totalParticles && _emitCounter > rate) 
+
+        // kept alive until it is updated
+        retain();
+        _scheduler->queueParticleSystem(this);
+        _isQueued = true;
+        _queuedDelta = dt;
+        _currentPosition = computeCurrentPosition();
+        return;
+    }
+
+    update(dt);
+}
+
+void ParticleSystem::update(float dt)
+{
+    CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+
+    _currentPosition = computeCurrentPosition();
+    bool lastParticleDied = updateParticles(dt);
+    finishUpdate(lastParticleDied);
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+}
+
+void ParticleSystem::updateQueuedSystems(const std::vector<ParticleSystem*>& systems)
+{
+    CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - parallel update");
+
+    // systems that left the scene since they were queued are skipped
+    std::vector<char> lastParticleDied(systems.size());
+    WorkerPool::getInstance()->parallelFor(systems.size(), [&](ssize_t index){
+        auto system = systems[index];
+        if (system->isRunning())
         {
-            this->addParticle();
-            _emitCounter -= rate;
+            lastParticleDied[index] = system->updateParticles(system->_queuedDelta);
         }
+    });
 
-        _elapsed += dt;
-        if (_duration != -1 && _duration < _elapsed)
+    for (size_t i = 0; i < systems.size(); ++i)
+    {
+        if (systems[i]->isRunning())
         {
-            this->stopSystem();
+            systems[i]->finishUpdate(lastParticleDied[i] != 0);
         }
+        systems[i]->_isQueued = false;
+        systems[i]->_queuedDelta = 0;
+        systems[i]->release();
     }
 
-    _particleIdx = 0;
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - parallel update");
+}
 
-    Vec2 currentPosition = Vec2::ZERO;
+Vec2 ParticleSystem::computeCurrentPosition()
+{
     if (_positionType == PositionType::FREE)
     {
-        currentPosition = this->convertToWorldSpace(Vec2::ZERO);
+        return this->convertToWorldSpace(Vec2::ZERO);
     }
     else if (_positionType == PositionType::RELATIVE)
     {
-        currentPosition = _position;
+        return _position;
     }
+    return Vec2::ZERO;
+}
 
+bool ParticleSystem::updateParticles(float dt)
+{
+    if (_isActive && _emissionRate)
     {
-        while (_particleIdx < _particleCount)
+        float rate = 1.0f / _emissionRate;
+        //issue #1201, prevent bursts of particles, due to too high emitCounter
+        if (_particleCount < _totalParticles)
         {
-            tParticle *p = &_particles[_particleIdx];
-
-            // life
-            p->timeToLive -= dt;
+            _emitCounter += dt;
+        }
+        
+        int emitCount = (int)MIN(_totalParticles - _particleCount, _emitCounter / rate);
+        this->emitParticles(emitCount);
+        _emitCounter -= rate * emitCount;
 
-            if (p->timeToLive > 0) 
-            {
-                // Mode A: gravity, direction, tangential accel & radial accel
-                if (_emitterMode == Mode::GRAVITY)
-                {
-                    Vec2 tmp, radial, tangential;
+        _elapsed += dt;
+        if (_duration != -1 && _duration < _elapsed)
+        {
+            this->stopSystem();
+        }
+    }
 
-                    radial = Vec2::ZERO;
-                    // radial acceleration
-                    if (p->pos.x || p->pos.y)
-                    {
-                        radial = p->pos.getNormalized();
-                    }
-                    tangential = radial;
-                    radial = radial * p->modeA.radialAccel;
-
-                    // tangential acceleration
-                    float newy = tangential.x;
-                    tangential.x = -tangential.y;
-                    tangential.y = newy;
-                    tangential = tangential * p->modeA.tangentialAccel;
-
-                    // (gravity + radial + tangential) * dt
-                    tmp = radial + tangential + modeA.gravity;
-                    tmp = tmp * dt;
-                    p->modeA.dir = p->modeA.dir + tmp;
-                    
-                    // this is cocos2d-x v3.0
-//                    if (_configName.length()>0 && _yCoordFlipped != -1)
+    // every attribute is updated for all the particles in its own pass,
+    // the particles dying in this step are removed afterwards
+    MathUtil::addScalar(_particleData.timeToLive, -dt, _particleCount);
 
-                    // this is cocos2d-x v3.0
-                    tmp = p->modeA.dir * dt * _yCoordFlipped;
-                    p->pos = p->pos + tmp;
-                }
+    // Mode A: gravity, direction, tangential accel & radial accel
+    if (_emitterMode == Mode::GRAVITY)
+    {
+        float* posx = _particleData.posx;
+        float* posy = _particleData.posy;
+        float* dirX = _particleData.modeA.dirX;
+        float* dirY = _particleData.modeA.dirY;
+        const float* radialAccel = _particleData.modeA.radialAccel;
+        const float* tangentialAccel = _particleData.modeA.tangentialAccel;
+
+        // branch free so the compiler can vectorize it
+        for (int i = 0; i < _particleCount; ++i)
+        {
+            float length = sqrtf(posx[i] * posx[i] + posy[i] * posy[i]);
+            float invLength = length > 0 ? 1.0f / length : 0.0f;
 
-                // Mode B: radius movement
-                else 
-                {                
-                    // Update the angle and radius of the particle.
-                    p->modeB.angle += p->modeB.degreesPerSecond * dt;
-                    p->modeB.radius += p->modeB.deltaRadius * dt;
+            // radial is the normalized position, tangential is radial rotated by 90 degrees
+            float radialX = posx[i] * invLength;
+            float radialY = posy[i] * invLength;
 
-                    p->pos.x = - cosf(p->modeB.angle) * p->modeB.radius;
-                    p->pos.y = - sinf(p->modeB.angle) * p->modeB.radius;
-                    p->pos.y *= _yCoordFlipped;
-				}
+            // (gravity + radial + tangential) * dt
+            dirX[i] += (radialX * radialAccel[i] - radialY * tangentialAccel[i] + modeA.gravity.x) * dt;
+            dirY[i] += (radialY * radialAccel[i] + radialX * tangentialAccel[i] + modeA.gravity.y) * dt;
+        }
 
-                // color
-                p->color.r += (p->deltaColor.r * dt);
-                p->color.g += (p->deltaColor.g * dt);
-                p->color.b += (p->deltaColor.b * dt);
-                p->color.a += (p->deltaColor.a * dt);
+        // this is cocos2d-x v3.0
+        MathUtil::addScaled(posx, dirX, dt * _yCoordFlipped, _particleCount);
+        MathUtil::addScaled(posy, dirY, dt * _yCoordFlipped, _particleCount);
+    }
 
-                // size
-                p->size += (p->deltaSize * dt);
-                p->size = MAX( 0, p->size );
+    // Mode B: radius movement
+    else
+    {
+        // Update the angle and radius of the particle.
+        MathUtil::addScaled(_particleData.modeB.angle, _particleData.modeB.degreesPerSecond, dt, _particleCount);
+        MathUtil::addScaled(_particleData.modeB.radius, _particleData.modeB.deltaRadius, dt, _particleCount);
 
-                // angle
-                p->rotation += (p->deltaRotation * dt);
+        for (int i = 0; i < _particleCount; ++i)
+        {
+            _particleData.posx[i] = - cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
+            _particleData.posy[i] = - sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
+        }
+    }
 
-                //
-                // update values in quad
-                //
+    // color
+    MathUtil::addScaled(_particleData.colorR, _particleData.deltaColorR, dt, _particleCount);
+    MathUtil::addScaled(_particleData.colorG, _particleData.deltaColorG, dt, _particleCount);
+    MathUtil::addScaled(_particleData.colorB, _particleData.deltaColorB, dt, _particleCount);
+    MathUtil::addScaled(_particleData.colorA, _particleData.deltaColorA, dt, _particleCount);
 
-                Vec2    newPos;
+    // size
+    MathUtil::addScaled(_particleData.size, _particleData.deltaSize, dt, _particleCount);
+    MathUtil::clampMin(_particleData.size, 0, _particleCount);
 
-                if (_positionType == PositionType::FREE || _positionType == PositionType::RELATIVE)
-                {
-                    Vec2 diff = currentPosition - p->startPos;
-                    newPos = p->pos - diff;
-                } 
-                else
-                {
-                    newPos = p->pos;
-                }
+    // angle
+    MathUtil::addScaled(_particleData.rotation, _particleData.deltaRotation, dt, _particleCount);
 
-                // translate newPos to correct position, since matrix transform isn't performed in batchnode
-                // don't update the particle with the new position information, it will interfere with the radius and tangential calculations
-                if (_batchNode)
-                {
-                    newPos.x+=_position.x;
-                    newPos.y+=_position.y;
-                }
+    // remove the dead particles, the last particle takes the place of the removed one
+    bool lastParticleDied = false;
+    int index = 0;
+    while (index < _particleCount)
+    {
+        if (_particleData.timeToLive[index] > 0)
+        {
+            ++index;
+            continue;
+        }
 
-                updateQuadWithParticle(p, newPos);
-                //updateParticleImp(self, updateParticleSel, p, newPos);
+        // life < 0
+        int lastIndex = _particleCount - 1;
+        unsigned int currentIndex = _particleData.atlasIndex[index];
+        if( index != lastIndex )
+        {
+            _particleData.copyParticle(index, lastIndex);
+        }
+        if (_batchNode)
+        {
+            //disable the switched particle
+            _batchNode->disableParticle(_atlasIndex+currentIndex);
 
-                // update particle counter
-                ++_particleIdx;
-            } 
-            else 
-            {
-                // life < 0
-                int currentIndex = p->atlasIndex;
-                if( _particleIdx != _particleCount-1 )
-                {
-                    _particles[_particleIdx] = _particles[_particleCount-1];
-                }
-                if (_batchNode)
-                {
-                    //disable the switched particle
-                    _batchNode->disableParticle(_atlasIndex+currentIndex);
+            //switch indexes
+            _particleData.atlasIndex[lastIndex] = currentIndex;
+        }
 
-                    //switch indexes
-                    _particles[_particleCount-1].atlasIndex = currentIndex;
-                }
+        --_particleCount;
+        lastParticleDied = (_particleCount == 0);
+    }
 
+    //
+    // update values in quad
+    //
+    _particleIdx = _particleCount;
+    updateParticleQuads();
+    _transformSystemDirty = false;
 
-                --_particleCount;
+    return lastParticleDied;
+}
 
-                if( _particleCount == 0 && _isAutoRemoveOnFinish )
-                {
-                    this->unscheduleUpdate();
-                    _parent->removeChild(this, true);
-                    return;
-                }
-            }
-        } //while
-        _transformSystemDirty = false;
+void ParticleSystem::finishUpdate(bool lastParticleDied)
+{
+    if( lastParticleDied && _isAutoRemoveOnFinish )
+    {
+        this->unscheduleUpdate();
+        _parent->removeChild(this, true);
+        return;
     }
-    
+
     // only update gl buffer when visible
     if (_visible && ! _batchNode)
     {
         postStep();
     }
+}
 
-    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+void ParticleSystem::setRandomSeed(unsigned int seed)
+{
+    // xorshift can't leave the zero state
+    _randomState = seed ? seed : 0x9e3779b9;
+}
+
+void ParticleSystem::setParallelUpdateEnabled(bool enabled)
+{
+    s_parallelUpdateEnabled = enabled;
+}
+
+bool ParticleSystem::isParallelUpdateEnabled()
+{
+    return s_parallelUpdateEnabled;
 }
 
 void ParticleSystem::updateWithNoTime(void)
@@ -832,10 +1038,8 @@ void ParticleSystem::updateWithNoTime(void)
     this->update(0.0f);
 }
 
-void ParticleSystem::updateQuadWithParticle(tParticle* particle, const Vec2& newPosition)
+void ParticleSystem::updateParticleQuads()
 {
-    CC_UNUSED_PARAM(particle);
-    CC_UNUSED_PARAM(newPosition);
     // should be overridden
 }
 
@@ -1133,7 +1337,7 @@ void ParticleSystem::setBatchNode(ParticleBatchNode* batchNode)
             //each particle needs a unique index
             for (int i = 0; i < _totalParticles; i++)
             {
-                _particles[i].atlasIndex=i;
+                _particleData.atlasIndex[i]=i;
             }
         }
     }
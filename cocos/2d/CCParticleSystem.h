@@ -41,44 +41,70 @@ NS_CC_BEGIN
 
 class ParticleBatchNode;
 
-/**
-Structure that contains the values of each particle
-*/
-typedef struct sParticle {
-    Vec2     pos;
-    Vec2     startPos;
-
-    Color4F    color;
-    Color4F    deltaColor;
-
-    float        size;
-    float        deltaSize;
-
-    float        rotation;
-    float        deltaRotation;
-
-    float        timeToLive;
+/** Values of the particles of a system, stored as one array per attribute (structure of arrays).
 
-    unsigned int    atlasIndex;
+ Every attribute of the particles is updated in a single pass over its own array,
+ which keeps the memory accesses contiguous and lets the update use SIMD kernels.
+ @since v3.2
+ */
+class CC_DLL ParticleData
+{
+public:
+    float* posx;
+    float* posy;
+    float* startPosX;
+    float* startPosY;
+
+    float* colorR;
+    float* colorG;
+    float* colorB;
+    float* colorA;
+
+    float* deltaColorR;
+    float* deltaColorG;
+    float* deltaColorB;
+    float* deltaColorA;
+
+    float* size;
+    float* deltaSize;
+    float* rotation;
+    float* deltaRotation;
+    float* timeToLive;
+    unsigned int* atlasIndex;
 
     //! Mode A: gravity, direction, radial accel, tangential accel
     struct {
-        Vec2        dir;
-        float        radialAccel;
-        float        tangentialAccel;
+        float* dirX;
+        float* dirY;
+        float* radialAccel;
+        float* tangentialAccel;
     } modeA;
 
     //! Mode B: radius mode
     struct {
-        float        angle;
-        float        degreesPerSecond;
-        float        radius;
-        float        deltaRadius;
+        float* angle;
+        float* degreesPerSecond;
+        float* radius;
+        float* deltaRadius;
     } modeB;
 
-}tParticle;
+    unsigned int maxCount;
 
-//typedef void (*CC_UPDATE_PARTICLE_IMP)(id, SEL, tParticle*, Vec2);
+    ParticleData();
+    ~ParticleData();
+
+    /** Allocates the arrays for count particles, releasing the previous ones. Returns false when out of memory. */
+    bool init(int count);
+    void release();
+
+    /** Copies the values of the particle p2 to the particle p1 */
+    void copyParticle(int p1, int p2);
+
+protected:
+    // all the arrays share a single allocation, _stride floats apart
+    float* _buffer;
+    int _stride;
+};
 
 class Texture2D;
 
@@ -182,8 +208,10 @@ public:
 
     //! Add a particle to the emitter
     bool addParticle();
-    //! Initializes a particle
-    void initParticle(tParticle* particle);
+    /** Adds up to count particles to the emitter, initializing them attribute by attribute.
+     @since v3.2
+     */
+    void addParticles(int count);
     //! stop emitting particles. Running particles will continue to run until they die
     void stopSystem();
     //! Kill all living particles.
@@ -191,13 +219,37 @@ public:
     //! whether or not the system is full
     bool isFull();
 
-    //! should be overridden by subclasses
-    virtual void updateQuadWithParticle(tParticle* particle, const Vec2& newPosition);
+    /** Updates the quads of the living particles, called once per update after the particles moved.
+     Should be overridden by subclasses.
+     @since v3.2
+     */
+    virtual void updateParticleQuads();
     //! should be overridden by subclasses
     virtual void postStep();
 
     virtual void updateWithNoTime(void);
 
+    /** Seeds the random generator of the system. The same seed and the same steps give the same particles.
+     Each system has a generator of its own, seeded with rand() when it's created.
+     @since v3.2
+     */
+    void setRandomSeed(unsigned int seed);
+
+    /** Sets whether the particle systems are updated in parallel, on the worker threads.
+     When enabled, the scheduled update of a system queues it on its Scheduler, the direct calls to update() are still done right away.
+     Once the other update callbacks of the Scheduler are done, and before the scene is visited,
+     the queued systems emit and move their particles and build their quads at the same time on the WorkerPool.
+     The GL buffer uploads and the auto removal are then done on the cocos2d thread, in the order the systems were queued.
+     Systems in a ParticleBatchNode share its atlas, so they are still updated right away.
+     Since every system uses its own random generator, the particles don't depend on the thread that updated them.
+     Subclasses overriding updateParticleQuads() must not use the scene graph or GL there.
+     Default is false.
+     @since v3.2
+     */
+    static void setParallelUpdateEnabled(bool enabled);
+    /** Returns whether the particle systems are updated in parallel */
+    static bool isParallelUpdateEnabled();
+
     virtual bool isAutoRemoveOnFinish() const;
     virtual void setAutoRemoveOnFinish(bool var);
 
@@ -396,12 +448,12 @@ CC_CONSTRUCTOR_ACCESS:
     /** initializes a QuadParticleSystem from a Dictionary.
      @since v0.99.3
      */
-    bool initWithDictionary(ValueMap& dictionary);
+    bool initWithDictionary(const ValueMap& dictionary);
     
     /** initializes a particle system from a NSDictionary and the path from where to load the png
      @since v2.1
      */
-    bool initWithDictionary(ValueMap& dictionary, const std::string& dirname);
+    bool initWithDictionary(const ValueMap& dictionary, const std::string& dirname);
     
     //! Initializes a system with a fixed number of particles
     virtual bool initWithTotalParticles(int numberOfParticles);
@@ -409,6 +461,34 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     virtual void updateBlendFunc();
 
+    // position of the emitter the living particles are moved back from, see PositionType.
+    // Uses the scene graph, so it is computed on the cocos2d thread before the particles are updated
+    Vec2 computeCurrentPosition();
+
+    // Emits, moves and removes the particles and updates their quads. Touches neither the scene graph nor GL,
+    // so it can run on a worker thread. Returns whether the last living particle died.
+    bool updateParticles(float dt);
+    // Removes the finished system or uploads its quads, on the cocos2d thread
+    void finishUpdate(bool lastParticleDied);
+    void emitParticles(int count);
+
+    // Fills values[start, end) with base + variance * [-1, 1]
+    void initRandomValues(float* values, int start, int end, float base, float variance);
+    // [-1, 1] from the random generator of the system (xorshift)
+    inline float randomMinus1To1()
+    {
+        _randomState ^= _randomState << 13;
+        _randomState ^= _randomState >> 17;
+        _randomState ^= _randomState << 5;
+        return _randomState * (2.0f / 4294967295.0f) - 1.0f;
+    }
+
+    // the update scheduled by onEnter(), queued on the Scheduler in parallel mode
+    virtual void scheduledUpdate(float dt);
+    // updates the systems queued in parallel mode, called by the Scheduler
+    static void updateQueuedSystems(const std::vector<ParticleSystem*>& systems);
+    friend class Scheduler;
+
     /** whether or not the particles are using blend additive.
      If enabled, the following blending function will be used.
      @code
@@ -465,8 +545,8 @@ protected:
         float rotatePerSecondVar;
     } modeB;
 
-    //! Array of particles
-    tParticle *_particles;
+    //! Values of the particles
+    ParticleData _particleData;
 
     //Emitter name
     std::string _configName;
@@ -564,6 +644,15 @@ protected:
      */
     PositionType _positionType;
 
+    //! Emitter position computed by computeCurrentPosition() for the current update
+    Vec2 _currentPosition;
+    //! Delta time of the update queued in parallel mode
+    float _queuedDelta;
+    //! Whether the system waits in the parallel update queue
+    bool _isQueued;
+    //! State of the random generator
+    uint32_t _randomState;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ParticleSystem);
 };
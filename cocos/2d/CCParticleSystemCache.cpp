@@ -0,0 +1,126 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "2d/CCParticleSystemCache.h"
+#include "2d/CCParticleSystemQuad.h"
+#include "2d/platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+ParticleSystemCache* ParticleSystemCache::s_sharedParticleSystemCache = nullptr;
+
+ParticleSystemCache* ParticleSystemCache::getInstance()
+{
+    if (! s_sharedParticleSystemCache)
+    {
+        s_sharedParticleSystemCache = new ParticleSystemCache();
+    }
+
+    return s_sharedParticleSystemCache;
+}
+
+void ParticleSystemCache::destroyInstance()
+{
+    CC_SAFE_RELEASE_NULL(s_sharedParticleSystemCache);
+}
+
+ParticleSystemCache::ParticleSystemCache()
+{
+}
+
+ParticleSystemCache::~ParticleSystemCache()
+{
+}
+
+const ValueMap& ParticleSystemCache::getDefinition(const std::string& fullPath)
+{
+    auto it = _definitions.find(fullPath);
+    if (it == _definitions.end())
+    {
+        ValueMap definition = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+        if (definition.empty())
+        {
+            // not cached: the file might be downloaded or fixed later
+            return ValueMapNull;
+        }
+        it = _definitions.insert(std::make_pair(fullPath, std::move(definition))).first;
+    }
+    return it->second;
+}
+
+ParticleSystemQuad* ParticleSystemCache::getParticleSystem(const std::string& plistFile)
+{
+    // the full paths are cached by FileUtils
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plistFile);
+    auto& pool = _pools[fullPath];
+
+    for (const auto& system : pool)
+    {
+        // only retained by the pool: the system left its parent
+        if (system->getReferenceCount() == 1)
+        {
+            system->resetSystem();
+            // in use until the autorelease pool is drained, like a new system
+            system->retain();
+            system->autorelease();
+            return system;
+        }
+    }
+
+    auto system = ParticleSystemQuad::create(plistFile);
+    if (system)
+    {
+        pool.pushBack(system);
+    }
+    return system;
+}
+
+void ParticleSystemCache::removeUnusedParticleSystems()
+{
+    for (auto& pool : _pools)
+    {
+        auto& systems = pool.second;
+        for (ssize_t i = systems.size() - 1; i >= 0; --i)
+        {
+            if (systems.at(i)->getReferenceCount() == 1)
+            {
+                systems.erase(i);
+            }
+        }
+    }
+}
+
+void ParticleSystemCache::removeAllDefinitions()
+{
+    _definitions.clear();
+}
+
+void ParticleSystemCache::removeAll()
+{
+    _pools.clear();
+    _definitions.clear();
+}
+
+NS_CC_END
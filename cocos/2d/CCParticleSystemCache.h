@@ -0,0 +1,109 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_PARTICLE_SYSTEM_CACHE_H__
+#define __CC_PARTICLE_SYSTEM_CACHE_H__
+
+#include "base/CCRef.h"
+#include "base/CCValue.h"
+#include "base/CCVector.h"
+
+#include <string>
+#include <unordered_map>
+
+NS_CC_BEGIN
+
+class ParticleSystemQuad;
+
+/**
+ * @addtogroup particle_nodes
+ * @{
+ */
+
+/** Singleton that caches the particle definitions and pools the particle systems.
+
+A plist file is read and parsed once, ParticleSystem::initWithFile() gets its definition from the cache.
+
+getParticleSystem() returns a system from the pool of the file. A pooled system can be reused once the
+cache is the only one retaining it, e.g. after it removed itself with setAutoRemoveOnFinish(true). It is
+restarted with resetSystem(), so its particles are not allocated again. The properties changed on a
+system are kept when it is reused.
+@since v3.2
+*/
+class CC_DLL ParticleSystemCache : public Ref
+{
+public:
+    /** Returns the shared instance of the cache */
+    static ParticleSystemCache* getInstance();
+
+    /** Purges the cache. It releases the definitions, the pooled systems and the shared instance.
+     */
+    static void destroyInstance();
+
+    /** Returns the parsed content of a plist file, which is read the first time only.
+     The path is a full path, as returned by FileUtils::fullPathForFilename().
+     A missing or invalid file returns an empty map, and is read again by the next call.
+     The map is shared by all the systems created from the file, so it is read-only.
+     */
+    const ValueMap& getDefinition(const std::string& fullPath);
+
+    /** Returns a ParticleSystemQuad created from a plist file. An unused system of the pool is reset and
+     returned when there is one, otherwise a new system is created and added to the pool.
+     */
+    ParticleSystemQuad* getParticleSystem(const std::string& plistFile);
+
+    /** Releases the pooled systems which are not used */
+    void removeUnusedParticleSystems();
+
+    /** Releases the parsed definitions. The files are read again when they are used */
+    void removeAllDefinitions();
+
+    /** Releases the definitions and the pooled systems */
+    void removeAll();
+
+CC_CONSTRUCTOR_ACCESS:
+    /**
+     * @js ctor
+     */
+    ParticleSystemCache();
+    /**
+     * @js NA
+     * @lua NA
+     */
+    ~ParticleSystemCache();
+
+protected:
+    // key: full path of the plist file
+    std::unordered_map<std::string, ValueMap> _definitions;
+    std::unordered_map<std::string, Vector<ParticleSystemQuad*>> _pools;
+
+    static ParticleSystemCache* s_sharedParticleSystemCache;
+};
+
+// end of particle_nodes group
+/// @}
+
+NS_CC_END
+
+#endif //__CC_PARTICLE_SYSTEM_CACHE_H__
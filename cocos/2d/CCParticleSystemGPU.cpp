@@ -0,0 +1,372 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "2d/CCParticleSystemGPU.h"
+
+#include <float.h>
+
+#include "CCGL.h"
+#include "2d/CCTexture2D.h"
+#include "base/CCDirector.h"
+#include "base/CCEventType.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventDispatcher.h"
+#include "renderer/CCGLProgram.h"
+#include "renderer/CCGLProgramCache.h"
+#include "renderer/CCGLProgramState.h"
+#include "renderer/ccGLStateCache.h"
+#include "renderer/CCRenderer.h"
+#include "deprecated/CCString.h"
+
+NS_CC_BEGIN
+
+// floats per vertex: position & corner, velocity & times, size & rotation, color, delta color
+static const int PARTICLE_GPU_VERTEX_SIZE = 20;
+// the quads are indexed with GLushort
+static const int PARTICLE_GPU_MAX_PARTICLES = 65536 / 4;
+
+ParticleSystemGPU::ParticleSystemGPU()
+: _particlesDirty(true)
+, _buffersDirty(true)
+, _time(0)
+, _period(0)
+, _emitEndTime(FLT_MAX)
+, _maxLife(0)
+, _timeUniform(-1)
+, _emitEndUniform(-1)
+{
+    _buffersVBO[0] = _buffersVBO[1] = 0;
+}
+
+ParticleSystemGPU::~ParticleSystemGPU()
+{
+    if (_buffersVBO[0])
+    {
+        GL::deleteBuffers(2, &_buffersVBO[0]);
+    }
+}
+
+ParticleSystemGPU * ParticleSystemGPU::createWithTotalParticles(int numberOfParticles)
+{
+    ParticleSystemGPU *ret = new (std::nothrow) ParticleSystemGPU();
+    if (ret && ret->initWithTotalParticles(numberOfParticles))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return ret;
+}
+
+ParticleSystemGPU * ParticleSystemGPU::create(const std::string& filename)
+{
+    ParticleSystemGPU *ret = new (std::nothrow) ParticleSystemGPU();
+    if (ret && ret->initWithFile(filename))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return ret;
+}
+
+ParticleSystemGPU * ParticleSystemGPU::create(ValueMap &dictionary)
+{
+    ParticleSystemGPU *ret = new (std::nothrow) ParticleSystemGPU();
+    if (ret && ret->initWithDictionary(dictionary))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return ret;
+}
+
+bool ParticleSystemGPU::initWithTotalParticles(int numberOfParticles)
+{
+    CCASSERT(numberOfParticles <= PARTICLE_GPU_MAX_PARTICLES, "ParticleSystemGPU: too many particles");
+
+    if( ParticleSystem::initWithTotalParticles(numberOfParticles) )
+    {
+        auto glProgram = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_PARTICLE_GPU);
+        auto glProgramState = GLProgramState::create(glProgram);
+
+        // the pointers are offsets in the VBO, which is bound when the state is applied
+        GLsizei stride = PARTICLE_GPU_VERTEX_SIZE * sizeof(GLfloat);
+        glProgramState->setVertexAttribPointer("a_position", 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(0 * sizeof(GLfloat)));
+        glProgramState->setVertexAttribPointer("a_velocity", 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(4 * sizeof(GLfloat)));
+        glProgramState->setVertexAttribPointer("a_sizeRotation", 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(8 * sizeof(GLfloat)));
+        glProgramState->setVertexAttribPointer("a_color", 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(12 * sizeof(GLfloat)));
+        glProgramState->setVertexAttribPointer("a_deltaColor", 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(16 * sizeof(GLfloat)));
+        _timeUniform = glProgramState->getUniformHandle("u_time");
+        _emitEndUniform = glProgramState->getUniformHandle("u_emitEnd");
+        setGLProgramState(glProgramState);
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        auto listener = EventListenerCustom::create(EVENT_COME_TO_FOREGROUND, CC_CALLBACK_1(ParticleSystemGPU::listenBackToForeground, this));
+        _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+#endif
+
+        _particlesDirty = true;
+        return true;
+    }
+    return false;
+}
+
+void ParticleSystemGPU::setTotalParticles(int tp)
+{
+    CCASSERT(tp <= PARTICLE_GPU_MAX_PARTICLES, "ParticleSystemGPU: too many particles");
+
+    if (tp > _allocatedParticles)
+    {
+        if (! _particleData.init(tp))
+        {
+            CCLOG("Particle system: out of memory");
+            return;
+        }
+        _allocatedParticles = tp;
+    }
+
+    _totalParticles = tp;
+    _particlesDirty = true;
+}
+
+void ParticleSystemGPU::rebuildParticles()
+{
+    _particlesDirty = false;
+    _buffersDirty = true;
+
+    if (_emitterMode != Mode::GRAVITY)
+    {
+        CCLOG("ParticleSystemGPU: the radius mode is not supported");
+    }
+    if (modeA.radialAccel || modeA.radialAccelVar || modeA.tangentialAccel || modeA.tangentialAccelVar)
+    {
+        CCLOG("ParticleSystemGPU: radial and tangential accelerations are not supported");
+    }
+
+    // the same generation as the CPU systems, all the slots at once
+    _particleCount = 0;
+    _currentPosition = Vec2::ZERO;
+    emitParticles(_totalParticles);
+    int count = _particleCount;
+    _particleCount = 0;
+
+    _vertices.resize(count * 4 * PARTICLE_GPU_VERTEX_SIZE);
+
+    // a slot emits once per period, its particle has to die before it emits again
+    _period = _emissionRate > 0 ? _totalParticles / _emissionRate : 0;
+    _maxLife = 0;
+
+    static const float corners[4][2] = { {-0.5f, -0.5f}, {0.5f, -0.5f}, {-0.5f, 0.5f}, {0.5f, 0.5f} };
+
+    GLfloat* vertex = _vertices.data();
+    for (int i = 0; i < count; ++i)
+    {
+        float life = MIN(_particleData.timeToLive[i], _period);
+        _maxLife = MAX(_maxLife, life);
+
+        for (int j = 0; j < 4; ++j)
+        {
+            vertex[0] = _particleData.posx[i];
+            vertex[1] = _particleData.posy[i];
+            vertex[2] = corners[j][0];
+            vertex[3] = corners[j][1];
+
+            vertex[4] = _particleData.modeA.dirX[i] * _yCoordFlipped;
+            vertex[5] = _particleData.modeA.dirY[i] * _yCoordFlipped;
+            vertex[6] = _period > 0 ? i / _emissionRate : 0;
+            vertex[7] = life;
+
+            vertex[8] = _particleData.size[i];
+            vertex[9] = _particleData.deltaSize[i];
+            vertex[10] = _particleData.rotation[i];
+            vertex[11] = _particleData.deltaRotation[i];
+
+            vertex[12] = _particleData.colorR[i];
+            vertex[13] = _particleData.colorG[i];
+            vertex[14] = _particleData.colorB[i];
+            vertex[15] = _particleData.colorA[i];
+
+            vertex[16] = _particleData.deltaColorR[i];
+            vertex[17] = _particleData.deltaColorG[i];
+            vertex[18] = _particleData.deltaColorB[i];
+            vertex[19] = _particleData.deltaColorA[i];
+
+            vertex += PARTICLE_GPU_VERTEX_SIZE;
+        }
+    }
+
+    auto glProgramState = getGLProgramState();
+    glProgramState->setUniformFloat("u_period", _period > 0 ? _period : 1);
+    glProgramState->setUniformVec2("u_gravity", modeA.gravity * _yCoordFlipped);
+    glProgramState->setUniformFloat("u_opacityModifyRGB", _opacityModifyRGB ? 1.0f : 0.0f);
+    glProgramState->setUniformFloat(_emitEndUniform, _emitEndTime);
+}
+
+void ParticleSystemGPU::scheduledUpdate(float dt)
+{
+    update(dt);
+}
+
+void ParticleSystemGPU::update(float dt)
+{
+    if (_particlesDirty)
+    {
+        rebuildParticles();
+    }
+
+    // resetSystem() was called, the emission starts again
+    if (_isActive && _elapsed == 0)
+    {
+        _time = 0;
+        _emitEndTime = FLT_MAX;
+        getGLProgramState()->setUniformFloat(_emitEndUniform, _emitEndTime);
+    }
+
+    _time += dt;
+
+    if (_isActive && _period > 0)
+    {
+        _elapsed += dt;
+        if (_duration != DURATION_INFINITY && _duration < _elapsed)
+        {
+            this->stopSystem();
+        }
+    }
+
+    if (! _isActive && _emitEndTime == FLT_MAX)
+    {
+        _emitEndTime = _time;
+        getGLProgramState()->setUniformFloat(_emitEndUniform, _emitEndTime);
+    }
+
+    if (_period <= 0 || _time > _emitEndTime + _maxLife)
+    {
+        // nothing was emitted, or every particle is dead
+        _particleCount = 0;
+        if (_isAutoRemoveOnFinish && ! _isActive)
+        {
+            this->unscheduleUpdate();
+            _parent->removeChild(this, true);
+            return;
+        }
+    }
+    else
+    {
+        // the time only grows while the emitter runs, going back by one period leaves the particles unchanged
+        if (_emitEndTime == FLT_MAX && _time >= 2 * _period)
+        {
+            _time -= _period;
+        }
+        // number of slots which emitted
+        _particleCount = MIN(_totalParticles, (int)(_time * _emissionRate) + 1);
+    }
+
+    // the only per frame work
+    getGLProgramState()->setUniformFloat(_timeUniform, _time);
+}
+
+void ParticleSystemGPU::draw(Renderer *renderer, const Mat4 &transform, bool transformUpdated)
+{
+    if (_particleCount > 0 && _texture)
+    {
+        _customCommand.init(_globalZOrder);
+        _customCommand.func = CC_CALLBACK_0(ParticleSystemGPU::onDraw, this, transform, transformUpdated);
+        renderer->addCommand(&_customCommand);
+    }
+}
+
+void ParticleSystemGPU::uploadParticles()
+{
+    if (_buffersVBO[0] == 0)
+    {
+        glGenBuffers(2, &_buffersVBO[0]);
+    }
+
+    int count = (int)(_vertices.size() / (4 * PARTICLE_GPU_VERTEX_SIZE));
+    std::vector<GLushort> indices(count * 6);
+    for (int i = 0; i < count; ++i)
+    {
+        const GLushort i6 = i * 6;
+        const GLushort i4 = i * 4;
+        indices[i6 + 0] = i4 + 0;
+        indices[i6 + 1] = i4 + 1;
+        indices[i6 + 2] = i4 + 2;
+
+        indices[i6 + 3] = i4 + 3;
+        indices[i6 + 4] = i4 + 2;
+        indices[i6 + 5] = i4 + 1;
+    }
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * _vertices.size(), _vertices.data(), GL_STATIC_DRAW);
+
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * indices.size(), indices.data(), GL_STATIC_DRAW);
+
+    _buffersDirty = false;
+}
+
+void ParticleSystemGPU::onDraw(const Mat4 &transform, bool transformUpdated)
+{
+    // unbinds the VAO, the element array buffer binding is part of its state
+    GL::bindVAO(0);
+
+    if (_buffersDirty)
+    {
+        uploadParticles();
+    }
+
+    GL::bindTexture2D(_texture->getName());
+    GL::blendFunc(_blendFunc.src, _blendFunc.dst);
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    getGLProgramState()->apply(transform);
+
+    // the slots which didn't emit yet are drawn as empty quads too
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    glDrawElements(GL_TRIANGLES, (GLsizei)_particleCount * 6, GL_UNSIGNED_SHORT, (GLvoid*)0);
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _particleCount * 6);
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void ParticleSystemGPU::listenBackToForeground(EventCustom* event)
+{
+    // the buffers were lost with the GL context
+    _buffersVBO[0] = _buffersVBO[1] = 0;
+    _buffersDirty = true;
+}
+
+std::string ParticleSystemGPU::getDescription() const
+{
+    return StringUtils::format("<ParticleSystemGPU | Tag = %d, Total Particles = %d>", _tag, _totalParticles);
+}
+
+NS_CC_END
@@ -0,0 +1,133 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_PARTICLE_SYSTEM_GPU_H__
+#define __CC_PARTICLE_SYSTEM_GPU_H__
+
+#include "2d/CCParticleSystem.h"
+#include "renderer/CCCustomCommand.h"
+
+NS_CC_BEGIN
+
+class EventCustom;
+
+/**
+ * @addtogroup particle_nodes
+ * @{
+ */
+
+/** @brief ParticleSystemGPU is a subclass of ParticleSystem that computes its particles in the vertex shader
+
+The spawn parameters of every particle are generated once and uploaded to a static VBO. The state of
+a particle is a function of these parameters and of its age, so each frame only the time uniform is
+updated, whatever the number of particles.
+
+Every particle slot emits again once per period (totalParticles / emissionRate), with the same
+parameters. The life of the particles is clamped to this period.
+
+Limitations:
+- Only the gravity mode is supported, without radial and tangential acceleration.
+- The particles move with the emitter, like PositionType::GROUPED.
+- The particles use the whole texture, and it can't be added to a ParticleBatchNode.
+- The properties are read when the particles are built: call rebuildParticles() after changing them.
+@since v3.2
+*/
+class CC_DLL ParticleSystemGPU : public ParticleSystem
+{
+public:
+    /** creates a Particle Emitter with a number of particles */
+    static ParticleSystemGPU * createWithTotalParticles(int numberOfParticles);
+    /** creates an initializes a ParticleSystemGPU from a plist file. */
+    static ParticleSystemGPU * create(const std::string& filename);
+    /** creates a Particle Emitter with a dictionary */
+    static ParticleSystemGPU * create(ValueMap &dictionary);
+
+    /** Generates the spawn parameters of the particles from the current properties, and uploads them.
+     It is done by the first update, it has to be called again when the properties change.
+     */
+    void rebuildParticles();
+
+    /**
+     * @js NA
+     * @lua NA
+     */
+    void listenBackToForeground(EventCustom* event);
+
+    // Overrides
+    virtual void update(float dt) override;
+    virtual void draw(Renderer *renderer, const Mat4 &transform, bool transformUpdated) override;
+    virtual void setTotalParticles(int tp) override;
+    virtual std::string getDescription() const override;
+
+CC_CONSTRUCTOR_ACCESS:
+    /**
+     * @js ctor
+     */
+    ParticleSystemGPU();
+    /**
+     * @js NA
+     * @lua NA
+     */
+    virtual ~ParticleSystemGPU();
+
+    // Overrides
+    /**
+     * @js NA
+     * @lua NA
+     */
+    virtual bool initWithTotalParticles(int numberOfParticles) override;
+
+protected:
+    // the particles are moved by the shader, there's nothing to update in parallel
+    virtual void scheduledUpdate(float dt) override;
+    void onDraw(const Mat4 &transform, bool transformUpdated);
+    void uploadParticles();
+
+    // 0: vertices  1: indices
+    GLuint _buffersVBO[2];
+    // 20 floats per vertex, see ccShader_ParticleGPU.vert
+    std::vector<GLfloat> _vertices;
+    bool _particlesDirty;
+    bool _buffersDirty;
+
+    // time of the shader, wrapped by periods while the emission is infinite
+    float _time;
+    float _period;
+    float _emitEndTime;
+    float _maxLife;
+    int _timeUniform;
+    int _emitEndUniform;
+
+    CustomCommand _customCommand;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(ParticleSystemGPU);
+};
+
+// end of particle_nodes group
+/// @}
+
+NS_CC_END
+
+#endif //__CC_PARTICLE_SYSTEM_GPU_H__
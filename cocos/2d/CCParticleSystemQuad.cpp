@@ -32,8 +32,6 @@ THE SOFTWARE.
 #include "2d/CCParticleBatchNode.h"
 #include "2d/CCTextureAtlas.h"
 #include "base/CCDirector.h"
-#include "base/CCEventType.h"
-#include "base/CCConfiguration.h"
 #include "math/TransformUtils.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/ccGLStateCache.h"
@@ -42,18 +40,11 @@ THE SOFTWARE.
 #include "renderer/CCQuadCommand.h"
 #include "renderer/CCCustomCommand.h"
 
-// extern
-#include "base/CCEventListenerCustom.h"
-#include "base/CCEventDispatcher.h"
-
 NS_CC_BEGIN
 
 ParticleSystemQuad::ParticleSystemQuad()
 :_quads(nullptr)
-,_indices(nullptr)
-,_VAOname(0)
 {
-    memset(_buffersVBO, 0, sizeof(_buffersVBO));
 }
 
 ParticleSystemQuad::~ParticleSystemQuad()
@@ -61,13 +52,6 @@ ParticleSystemQuad::~ParticleSystemQuad()
     if (nullptr == _batchNode)
     {
         CC_SAFE_FREE(_quads);
-        CC_SAFE_FREE(_indices);
-        glDeleteBuffers(2, &_buffersVBO[0]);
-        if (Configuration::getInstance()->supportsShareableVAO())
-        {
-            glDeleteVertexArrays(1, &_VAOname);
-            GL::bindVAO(0);
-        }
     }
 }
 
@@ -121,24 +105,9 @@ bool ParticleSystemQuad::initWithTotalParticles(int numberOfParticles)
             return false;
         }
 
-        initIndices();
-        if (Configuration::getInstance()->supportsShareableVAO())
-        {
-            setupVBOandVAO();
-        }
-        else
-        {
-            setupVBO();
-        }
-
+        // the quads are drawn by the renderer, batched with the other systems and sprites sharing the material
         setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP));
 
-#if CC_ENABLE_CACHE_TEXTURE_DATA
-        // Need to listen the event only when not use batchnode, because it will use VBO
-        auto listener = EventListenerCustom::create(EVENT_COME_TO_FOREGROUND, CC_CALLBACK_1(ParticleSystemQuad::listenBackToForeground, this));
-        _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
-#endif
-
         return true;
     }
     return false;
@@ -249,123 +218,89 @@ void ParticleSystemQuad::setDisplayFrame(SpriteFrame *spriteFrame)
     }
 }
 
-void ParticleSystemQuad::initIndices()
+void ParticleSystemQuad::updateParticleQuads()
 {
-    for(int i = 0; i < _totalParticles; ++i)
+    if (_particleCount <= 0)
     {
-        const unsigned int i6 = i*6;
-        const unsigned int i4 = i*4;
-        _indices[i6+0] = (GLushort) i4+0;
-        _indices[i6+1] = (GLushort) i4+1;
-        _indices[i6+2] = (GLushort) i4+2;
-
-        _indices[i6+5] = (GLushort) i4+1;
-        _indices[i6+4] = (GLushort) i4+2;
-        _indices[i6+3] = (GLushort) i4+3;
+        return;
     }
-}
 
-void ParticleSystemQuad::updateQuadWithParticle(tParticle* particle, const Vec2& newPosition)
-{
-    V3F_C4B_T2F_Quad *quad;
+    Vec2 currentPosition = _currentPosition;
 
-    if (_batchNode)
+    // living particles of FREE and RELATIVE systems are moved back by the distance the emitter moved since they were born
+    const float* startPosX = nullptr;
+    const float* startPosY = nullptr;
+    if (_positionType == PositionType::FREE || _positionType == PositionType::RELATIVE)
     {
-        V3F_C4B_T2F_Quad *batchQuads = _batchNode->getTextureAtlas()->getQuads();
-        quad = &(batchQuads[_atlasIndex+particle->atlasIndex]);
+        startPosX = _particleData.startPosX;
+        startPosY = _particleData.startPosY;
     }
-    else
+
+    // translate the particles to their correct position, since matrix transform isn't performed in batchnode
+    V3F_C4B_T2F_Quad *batchQuads = nullptr;
+    if (_batchNode)
     {
-        quad = &(_quads[_particleIdx]);
+        batchQuads = _batchNode->getTextureAtlas()->getQuads() + _atlasIndex;
+        currentPosition -= _position;
     }
-    Color4B color = (_opacityModifyRGB)
-        ? Color4B( particle->color.r*particle->color.a*255, particle->color.g*particle->color.a*255, particle->color.b*particle->color.a*255, particle->color.a*255)
-        : Color4B( particle->color.r*255, particle->color.g*255, particle->color.b*255, particle->color.a*255);
-
-    quad->bl.colors = color;
-    quad->br.colors = color;
-    quad->tl.colors = color;
-    quad->tr.colors = color;
-
-    // vertices
-    GLfloat size_2 = particle->size/2;
-    if (particle->rotation) 
+
+    for (int i = 0; i < _particleCount; ++i)
     {
-        GLfloat x1 = -size_2;
-        GLfloat y1 = -size_2;
-
-        GLfloat x2 = size_2;
-        GLfloat y2 = size_2;
-        GLfloat x = newPosition.x;
-        GLfloat y = newPosition.y;
-
-        GLfloat r = (GLfloat)-CC_DEGREES_TO_RADIANS(particle->rotation);
-        GLfloat cr = cosf(r);
-        GLfloat sr = sinf(r);
-        GLfloat ax = x1 * cr - y1 * sr + x;
-        GLfloat ay = x1 * sr + y1 * cr + y;
-        GLfloat bx = x2 * cr - y1 * sr + x;
-        GLfloat by = x2 * sr + y1 * cr + y;
-        GLfloat cx = x2 * cr - y2 * sr + x;
-        GLfloat cy = x2 * sr + y2 * cr + y;
-        GLfloat dx = x1 * cr - y2 * sr + x;
-        GLfloat dy = x1 * sr + y2 * cr + y;
-
-        // bottom-left
-        quad->bl.vertices.x = ax;
-        quad->bl.vertices.y = ay;
+        V3F_C4B_T2F_Quad *quad = batchQuads ? &batchQuads[_particleData.atlasIndex[i]] : &_quads[i];
 
-        // bottom-right vertex:
-        quad->br.vertices.x = bx;
-        quad->br.vertices.y = by;
+        GLfloat x = _particleData.posx[i];
+        GLfloat y = _particleData.posy[i];
+        if (startPosX)
+        {
+            x += startPosX[i] - currentPosition.x;
+            y += startPosY[i] - currentPosition.y;
+        }
+        else if (batchQuads)
+        {
+            x -= currentPosition.x;
+            y -= currentPosition.y;
+        }
 
-        // top-left vertex:
-        quad->tl.vertices.x = dx;
-        quad->tl.vertices.y = dy;
+        // vertices, a particle without rotation uses cos = 1 and sin = 0
+        GLfloat size_2 = _particleData.size[i]/2;
+        GLfloat cr = 1;
+        GLfloat sr = 0;
+        if (_particleData.rotation[i])
+        {
+            GLfloat r = (GLfloat)-CC_DEGREES_TO_RADIANS(_particleData.rotation[i]);
+            cr = cosf(r);
+            sr = sinf(r);
+        }
+        GLfloat hc = size_2 * cr;
+        GLfloat hs = size_2 * sr;
 
-        // top-right vertex:
-        quad->tr.vertices.x = cx;
-        quad->tr.vertices.y = cy;
-    } 
-    else 
-    {
         // bottom-left vertex:
-        quad->bl.vertices.x = newPosition.x - size_2;
-        quad->bl.vertices.y = newPosition.y - size_2;
+        quad->bl.vertices.x = x - hc + hs;
+        quad->bl.vertices.y = y - hs - hc;
 
         // bottom-right vertex:
-        quad->br.vertices.x = newPosition.x + size_2;
-        quad->br.vertices.y = newPosition.y - size_2;
+        quad->br.vertices.x = x + hc + hs;
+        quad->br.vertices.y = y + hs - hc;
 
         // top-left vertex:
-        quad->tl.vertices.x = newPosition.x - size_2;
-        quad->tl.vertices.y = newPosition.y + size_2;
+        quad->tl.vertices.x = x - hc - hs;
+        quad->tl.vertices.y = y - hs + hc;
 
         // top-right vertex:
-        quad->tr.vertices.x = newPosition.x + size_2;
-        quad->tr.vertices.y = newPosition.y + size_2;                
+        quad->tr.vertices.x = x + hc - hs;
+        quad->tr.vertices.y = y + hs + hc;
+
+        // colors
+        GLfloat a = _particleData.colorA[i];
+        GLfloat rgbScale = _opacityModifyRGB ? a : 1;
+        Color4B color(_particleData.colorR[i] * rgbScale * 255, _particleData.colorG[i] * rgbScale * 255, _particleData.colorB[i] * rgbScale * 255, a * 255);
+
+        quad->bl.colors = color;
+        quad->br.colors = color;
+        quad->tl.colors = color;
+        quad->tr.colors = color;
     }
 }
-void ParticleSystemQuad::postStep()
-{
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    
-    // Option 1: Sub Data
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(_quads[0])*_totalParticles, _quads);
-    
-    // Option 2: Data
-    //  glBufferData(GL_ARRAY_BUFFER, sizeof(quads_[0]) * particleCount, quads_, GL_DYNAMIC_DRAW);
-    
-    // Option 3: Orphaning + glMapBuffer
-    // glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0])*_totalParticles, nullptr, GL_STREAM_DRAW);
-    // void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-    // memcpy(buf, _quads, sizeof(_quads[0])*_totalParticles);
-    // glUnmapBuffer(GL_ARRAY_BUFFER);
-    
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    
-    CHECK_GL_ERROR_DEBUG();
-}
 
 // overriding draw method
 void ParticleSystemQuad::draw(Renderer *renderer, const Mat4 &transform, bool transformUpdated)
@@ -386,34 +321,30 @@ void ParticleSystemQuad::setTotalParticles(int tp)
     if( tp > _allocatedParticles )
     {
         // Allocate new memory
-        size_t particlesSize = tp * sizeof(tParticle);
         size_t quadsSize = sizeof(_quads[0]) * tp * 1;
-        size_t indicesSize = sizeof(_indices[0]) * tp * 6 * 1;
 
-        tParticle* particlesNew = (tParticle*)realloc(_particles, particlesSize);
+        bool particlesAllocated = _particleData.init(tp);
         V3F_C4B_T2F_Quad* quadsNew = (V3F_C4B_T2F_Quad*)realloc(_quads, quadsSize);
-        GLushort* indicesNew = (GLushort*)realloc(_indices, indicesSize);
 
-        if (particlesNew && quadsNew && indicesNew)
+        if (particlesAllocated && quadsNew)
         {
             // Assign pointers
-            _particles = particlesNew;
             _quads = quadsNew;
-            _indices = indicesNew;
 
             // Clear the memory
-            memset(_particles, 0, particlesSize);
             memset(_quads, 0, quadsSize);
-            memset(_indices, 0, indicesSize);
             
             _allocatedParticles = tp;
         }
         else
         {
             // Out of memory, failed to resize some array
-            if (particlesNew) _particles = particlesNew;
             if (quadsNew) _quads = quadsNew;
-            if (indicesNew) _indices = indicesNew;
+
+            // the living particles were dropped with the previous arrays
+            _particleCount = 0;
+            _particleIdx = 0;
+            _totalParticles = MIN(_totalParticles, (int)_particleData.maxCount);
 
             CCLOG("Particle system: out of memory");
             return;
@@ -426,20 +357,10 @@ void ParticleSystemQuad::setTotalParticles(int tp)
         {
             for (int i = 0; i < _totalParticles; i++)
             {
-                _particles[i].atlasIndex=i;
+                _particleData.atlasIndex[i]=i;
             }
         }
 
-        initIndices();
-        if (Configuration::getInstance()->supportsShareableVAO())
-        {
-            setupVBOandVAO();
-        }
-        else
-        {
-            setupVBO();
-        }
-        
         // fixed http://www.cocos2d-x.org/issues/3990
         // Updates texture coords.
         updateTexCoords();
@@ -452,96 +373,22 @@ void ParticleSystemQuad::setTotalParticles(int tp)
     resetSystem();
 }
 
-void ParticleSystemQuad::setupVBOandVAO()
-{
-    // clean VAO
-    glDeleteBuffers(2, &_buffersVBO[0]);
-    glDeleteVertexArrays(1, &_VAOname);
-    GL::bindVAO(0);
-    
-    glGenVertexArrays(1, &_VAOname);
-    GL::bindVAO(_VAOname);
-
-#define kQuadSize sizeof(_quads[0].bl)
-
-    glGenBuffers(2, &_buffersVBO[0]);
-
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _totalParticles, _quads, GL_DYNAMIC_DRAW);
-
-    // vertices
-    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof( V3F_C4B_T2F, vertices));
-
-    // colors
-    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) offsetof( V3F_C4B_T2F, colors));
-
-    // tex coords
-    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _totalParticles * 6, _indices, GL_STATIC_DRAW);
-
-    // Must unbind the VAO before changing the element buffer.
-    GL::bindVAO(0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    CHECK_GL_ERROR_DEBUG();
-}
-
-void ParticleSystemQuad::setupVBO()
-{
-    glDeleteBuffers(2, &_buffersVBO[0]);
-    
-    glGenBuffers(2, &_buffersVBO[0]);
-
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _totalParticles, _quads, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _totalParticles * 6, _indices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-    CHECK_GL_ERROR_DEBUG();
-}
-
-void ParticleSystemQuad::listenBackToForeground(EventCustom* event)
-{
-    if (Configuration::getInstance()->supportsShareableVAO())
-    {
-        setupVBOandVAO();
-    }
-    else
-    {
-        setupVBO();
-    }
-}
-
 bool ParticleSystemQuad::allocMemory()
 {
     CCASSERT( !_batchNode, "Memory should not be alloced when not using batchNode");
 
     CC_SAFE_FREE(_quads);
-    CC_SAFE_FREE(_indices);
 
     _quads = (V3F_C4B_T2F_Quad*)malloc(_totalParticles * sizeof(V3F_C4B_T2F_Quad));
-    _indices = (GLushort*)malloc(_totalParticles * 6 * sizeof(GLushort));
     
-    if( !_quads || !_indices) 
+    if( !_quads )
     {
         CCLOG("cocos2d: Particle system: not enough memory");
-        CC_SAFE_FREE(_quads);
-        CC_SAFE_FREE(_indices);
 
         return false;
     }
 
     memset(_quads, 0, _totalParticles * sizeof(V3F_C4B_T2F_Quad));
-    memset(_indices, 0, _totalParticles * 6 * sizeof(GLushort));
 
     return true;
 }
@@ -558,16 +405,7 @@ void ParticleSystemQuad::setBatchNode(ParticleBatchNode * batchNode)
         if( ! batchNode ) 
         {
             allocMemory();
-            initIndices();
             setTexture(oldBatch->getTexture());
-            if (Configuration::getInstance()->supportsShareableVAO())
-            {
-                setupVBOandVAO();
-            }
-            else
-            {
-                setupVBO();
-            }
         }
         // OLD: was it self render ? cleanup
         else if( !oldBatch )
@@ -578,16 +416,6 @@ void ParticleSystemQuad::setBatchNode(ParticleBatchNode * batchNode)
             memcpy( quad, _quads, _totalParticles * sizeof(_quads[0]) );
 
             CC_SAFE_FREE(_quads);
-            CC_SAFE_FREE(_indices);
-
-            glDeleteBuffers(2, &_buffersVBO[0]);
-            memset(_buffersVBO, 0, sizeof(_buffersVBO));
-            if (Configuration::getInstance()->supportsShareableVAO())
-            {
-                glDeleteVertexArrays(1, &_VAOname);
-                GL::bindVAO(0);
-                _VAOname = 0;
-            }
         }
     }
 }
@@ -34,7 +34,6 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 class SpriteFrame;
-class EventCustom;
 
 /**
  * @addtogroup particle_nodes
@@ -51,6 +50,7 @@ Special features and Limitations:
 - The particles can be rotated
 - It supports subrects
 - It supports batched rendering since 1.1
+- The systems sharing a texture and a blend function are drawn together by the renderer, without a ParticleBatchNode
 @since v0.8
 */
 class CC_DLL ParticleSystemQuad : public ParticleSystem
@@ -81,11 +81,17 @@ public:
      */
     void setTextureWithRect(Texture2D *texture, const Rect& rect);
 
-    /** listen the event that coming to foreground on Android
-     * @js NA
-     * @lua NA
+    /**
+     * Sets whether the system can be drawn out of order.
+     *
+     * The renderer may then draw it before or after the other order independent commands queued right next to it,
+     * so that the systems sharing a texture are batched together even when other nodes are drawn between them.
+     * Use it for additive systems, or for systems that don't overlap.
+     * @since v3.2
      */
-    void listenBackToForeground(EventCustom* event);
+    inline void setOrderIndependent(bool orderIndependent) { _quadCommand.setOrderIndependent(orderIndependent); }
+    /** Returns whether the system can be drawn out of order */
+    inline bool isOrderIndependent() const { return _quadCommand.isOrderIndependent(); }
 
     /**
      * @js NA
@@ -96,12 +102,7 @@ public:
      * @js NA
      * @lua NA
      */
-    virtual void updateQuadWithParticle(tParticle* particle, const Vec2& newPosition) override;
-    /**
-     * @js NA
-     * @lua NA
-     */
-    virtual void postStep() override;
+    virtual void updateParticleQuads() override;
     /**
      * @js NA
      * @lua NA
@@ -140,23 +141,15 @@ CC_CONSTRUCTOR_ACCESS:
     virtual bool initWithTotalParticles(int numberOfParticles) override;
 
 protected:
-    /** initializes the indices for the vertices*/
-    void initIndices();
-    
     /** initializes the texture with a rectangle measured Points */
     void initTexCoordsWithRect(const Rect& rect);
     
     /** Updates texture coords */
     void updateTexCoords();
 
-    void setupVBOandVAO();
-    void setupVBO();
     bool allocMemory();
 
     V3F_C4B_T2F_Quad    *_quads;        // quads to be rendered
-    GLushort            *_indices;      // indices
-    GLuint              _VAOname;
-    GLuint              _buffersVBO[2]; //0: vertex  1: indices
 
     QuadCommand _quadCommand;           // quad command
 
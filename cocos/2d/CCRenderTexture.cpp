@@ -41,13 +41,155 @@ THE SOFTWARE.
 #include "renderer/CCRenderer.h"
 #include "renderer/CCGroupCommand.h"
 #include "renderer/CCCustomCommand.h"
+#include "renderer/CCFrameAllocator.h"
 
 // extern
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
+#include "base/CCScheduler.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
 
 NS_CC_BEGIN
 
+// Frames to wait before mapping a pixel buffer when fences are not supported
+static const int READBACK_FRAMES = 2;
+
+struct RenderTexture::Readback
+{
+    std::function<void(Image*)> callback;
+    bool flipImage;
+    int width;
+    int height;
+    // the pixels are in `pixelBuffer`, or already in `image` when they were read synchronously
+    GLuint pixelBuffer;
+#ifdef CC_GL_FENCE_SYNC
+    GLsync fence;
+#endif
+    Image* image;
+    int frames;
+};
+
+// implementation ImageSaver
+ImageSaver* ImageSaver::s_instance = nullptr;
+
+ImageSaver* ImageSaver::getInstance()
+{
+    if (s_instance == nullptr)
+    {
+        s_instance = new ImageSaver();
+    }
+    return s_instance;
+}
+
+void ImageSaver::destroyInstance()
+{
+    CC_SAFE_DELETE(s_instance);
+}
+
+ImageSaver::ImageSaver()
+: _scheduler(nullptr)
+, _quit(false)
+{
+}
+
+ImageSaver::~ImageSaver()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _condition.notify_one();
+
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+}
+
+void ImageSaver::save(Image* image, const std::string& fullpath, const std::function<void(bool)>& callback)
+{
+    image->retain();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    // the worker thread must not create a Director
+    _scheduler = Director::getInstance()->getScheduler();
+    Task task = { image, fullpath, callback };
+    _tasks.push_back(task);
+    if (!_thread.joinable())
+    {
+        _thread = std::thread(&ImageSaver::run, this);
+    }
+    _condition.notify_one();
+}
+
+void ImageSaver::run()
+{
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this](){ return _quit || !_tasks.empty(); });
+            // the queued images are still written when the thread is stopped
+            if (_tasks.empty())
+            {
+                return;
+            }
+            task = _tasks.front();
+            _tasks.pop_front();
+        }
+
+        bool saved = task.image->saveToFile(task.fullpath, true);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_quit)
+        {
+            // the Director is being purged: the cocos2d thread waits for this one, and the callback is dropped
+            task.image->release();
+        }
+        else
+        {
+            _scheduler->performFunctionInCocosThread([task, saved](){
+                task.image->release();
+                if (task.callback)
+                {
+                    task.callback(saved);
+                }
+            });
+        }
+    }
+}
+
+// Creates an image from RGBA8888 pixels, flipping the rows (bottom up in GL) when `flipImage` is true
+static Image* newImageWithPixels(const GLubyte* pixels, int width, int height, bool flipImage)
+{
+    Image* image = new Image();
+    ssize_t dataLen = width * height * 4;
+
+    if (flipImage)
+    {
+        // -- flip is only required when saving image to file
+        // #640 the image read from rendertexture is dirty
+        GLubyte* buffer = new GLubyte[dataLen];
+        for (int i = 0; i < height; ++i)
+        {
+            memcpy(&buffer[i * width * 4], &pixels[(height - i - 1) * width * 4], width * 4);
+        }
+        image->initWithRawData(buffer, dataLen, width, height, 8);
+        delete[] buffer;
+    }
+    else
+    {
+        image->initWithRawData(pixels, dataLen, width, height, 8);
+    }
+
+    return image;
+}
+
 // implementation RenderTexture
 RenderTexture::RenderTexture()
 : _FBO(0)
@@ -67,6 +209,7 @@ RenderTexture::RenderTexture()
 , _rtTextureRect(Rect::ZERO)
 , _fullRect(Rect::ZERO)
 , _fullviewPort(Rect::ZERO)
+, _readbackListener(nullptr)
 {
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     // Listen this event to save render texture before come to background.
@@ -419,101 +562,209 @@ bool RenderTexture::saveToFile(const std::string& filename)
     return saveToFile(filename,Image::Format::JPG);
 }
 bool RenderTexture::saveToFile(const std::string& fileName, Image::Format format)
+{
+    return saveToFile(fileName, format, nullptr);
+}
+
+bool RenderTexture::saveToFile(const std::string& fileName, Image::Format format, const std::function<void(RenderTexture*, const std::string&)>& callback)
 {
     CCASSERT(format == Image::Format::JPG || format == Image::Format::PNG,
              "the image can only be saved as JPG or PNG format");
     
     std::string fullpath = FileUtils::getInstance()->getWritablePath() + fileName;
-    _saveToFileCommand.init(_globalZOrder);
-    _saveToFileCommand.func = CC_CALLBACK_0(RenderTexture::onSaveToFile,this,fullpath);
-    
-    Director::getInstance()->getRenderer()->addCommand(&_saveToFileCommand);
+    newImageAsync([this, fullpath, callback](Image* image){
+        // kept alive until the file is written
+        retain();
+        ImageSaver::getInstance()->save(image, fullpath, [this, fullpath, callback](bool saved){
+            if (callback)
+            {
+                callback(this, fullpath);
+            }
+            release();
+        });
+    }, true);
     return true;
 }
 
-void RenderTexture::onSaveToFile(const std::string& filename)
+void RenderTexture::newImageAsync(const std::function<void(Image*)>& callback, bool flipImage)
 {
-    Image *image = newImage(true);
-    if (image)
-    {
-        image->saveToFile(filename.c_str(), true);
-    }
+    CCASSERT(_pixelFormat == Texture2D::PixelFormat::RGBA8888, "only RGBA8888 can be saved as image");
+    CCASSERT(callback, "Invalid callback");
 
-    CC_SAFE_DELETE(image);
+    auto renderer = Director::getInstance()->getRenderer();
+    auto command = renderer->getFrameAllocator()->create<CustomCommand>();
+    command->init(_globalZOrder);
+    command->func = std::bind(&RenderTexture::onReadPixelsAsync, this, callback, flipImage);
+    renderer->addCommand(command);
 }
 
-/* get buffer as Image */
-Image* RenderTexture::newImage(bool fliimage)
+void RenderTexture::onReadPixelsAsync(const std::function<void(Image*)>& callback, bool flipImage)
 {
-    CCASSERT(_pixelFormat == Texture2D::PixelFormat::RGBA8888, "only RGBA8888 can be saved as image");
-
     if (nullptr == _texture)
     {
-        return nullptr;
+        return;
     }
 
     const Size& s = _texture->getContentSizeInPixels();
 
-    // to get the image size to save
-    //        if the saving image domain exceeds the buffer texture domain,
-    //        it should be cut
-    int savedBufferWidth = (int)s.width;
-    int savedBufferHeight = (int)s.height;
-
-    GLubyte *buffer = nullptr;
-    GLubyte *tempData = nullptr;
-    Image *image = new Image();
+    auto readback = new Readback();
+    readback->callback = callback;
+    readback->flipImage = flipImage;
+    readback->width = (int)s.width;
+    readback->height = (int)s.height;
+    readback->pixelBuffer = 0;
+#ifdef CC_GL_FENCE_SYNC
+    readback->fence = nullptr;
+#endif
+    readback->image = nullptr;
+    readback->frames = 0;
 
-    do
+#ifdef CC_GL_PIXEL_BUFFER
+    if (Configuration::getInstance()->supportsPixelBufferObject())
     {
-        CC_BREAK_IF(! (buffer = new GLubyte[savedBufferWidth * savedBufferHeight * 4]));
-
-        if(! (tempData = new GLubyte[savedBufferWidth * savedBufferHeight * 4]))
+        // glReadPixels only queues the copy into the buffer and returns
+        glGenBuffers(1, &readback->pixelBuffer);
+        GL::bindBuffer(GL_PIXEL_PACK_BUFFER, readback->pixelBuffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, readback->width * readback->height * 4, nullptr, GL_STREAM_READ);
+        readPixels(nullptr, readback->width, readback->height);
+        GL::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+#ifdef CC_GL_FENCE_SYNC
+        if (Configuration::getInstance()->supportsFenceSync())
         {
-            delete[] buffer;
-            buffer = nullptr;
-            break;
+            readback->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
         }
+#endif
+    }
+    else
+#endif
+    {
+        readback->image = newImage(flipImage);
+    }
 
-        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
-        glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
+    if (_readbacks.empty())
+    {
+        // kept alive until the images are delivered
+        retain();
+        _readbackListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom* event){
+            pollReadbacks();
+        });
+    }
+    _readbacks.push_back(readback);
+}
 
-        //TODO move this to configration, so we don't check it every time
-        /*  Certain Qualcomm Andreno gpu's will retain data in memory after a frame buffer switch which corrupts the render to the texture. The solution is to clear the frame buffer before rendering to the texture. However, calling glClear has the unintended result of clearing the current texture. Create a temporary texture to overcome this. At the end of RenderTexture::begin(), switch the attached texture to the second one, call glClear, and then switch back to the original texture. This solution is unnecessary for other devices as they don't have the same issue with switching frame buffers.
-         */
-        if (Configuration::getInstance()->checkForGLExtension("GL_QCOM"))
+void RenderTexture::pollReadbacks()
+{
+    std::vector<std::pair<Readback*, Image*>> delivered;
+
+    for (auto iter = _readbacks.begin(); iter != _readbacks.end();)
+    {
+        auto readback = *iter;
+        ++readback->frames;
+
+        bool isReady = readback->pixelBuffer == 0 || readback->frames > READBACK_FRAMES;
+#ifdef CC_GL_FENCE_SYNC
+        if (readback->fence)
         {
-            // -- bind a temporary texture so we can clear the render buffer without losing our texture
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _textureCopy->getName(), 0);
-            CHECK_GL_ERROR_DEBUG();
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture->getName(), 0);
+            GLenum status = glClientWaitSync(readback->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            isReady = status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED || status == GL_WAIT_FAILED;
+        }
+#endif
+        if (!isReady)
+        {
+            ++iter;
+            continue;
         }
-        glPixelStorei(GL_PACK_ALIGNMENT, 1);
-        glReadPixels(0,0,savedBufferWidth, savedBufferHeight,GL_RGBA,GL_UNSIGNED_BYTE, tempData);
-        glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
 
-        if ( fliimage ) // -- flip is only required when saving image to file
+        Image* image = readback->image;
+#ifdef CC_GL_PIXEL_BUFFER
+        if (readback->pixelBuffer)
         {
-            // to get the actual texture data
-            // #640 the image read from rendertexture is dirty
-            for (int i = 0; i < savedBufferHeight; ++i)
+            GL::bindBuffer(GL_PIXEL_PACK_BUFFER, readback->pixelBuffer);
+            auto pixels = static_cast<const GLubyte*>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+            if (pixels)
             {
-                memcpy(&buffer[i * savedBufferWidth * 4],
-                       &tempData[(savedBufferHeight - i - 1) * savedBufferWidth * 4],
-                       savedBufferWidth * 4);
+                image = newImageWithPixels(pixels, readback->width, readback->height, readback->flipImage);
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
             }
-
-            image->initWithRawData(buffer, savedBufferWidth * savedBufferHeight * 4, savedBufferWidth, savedBufferHeight, 8);
+            GL::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            GL::deleteBuffers(1, &readback->pixelBuffer);
         }
-        else
+#endif
+#ifdef CC_GL_FENCE_SYNC
+        if (readback->fence)
         {
-            image->initWithRawData(tempData, savedBufferWidth * savedBufferHeight * 4, savedBufferWidth, savedBufferHeight, 8);
+            glDeleteSync(readback->fence);
         }
-        
-    } while (0);
+#endif
+
+        delivered.push_back(std::make_pair(readback, image));
+        iter = _readbacks.erase(iter);
+    }
+
+    // the callbacks might ask for more readbacks
+    for (auto& pair : delivered)
+    {
+        if (pair.second)
+        {
+            pair.first->callback(pair.second);
+            pair.second->release();
+        }
+        delete pair.first;
+    }
+
+    if (!delivered.empty() && _readbacks.empty())
+    {
+        Director::getInstance()->getEventDispatcher()->removeEventListener(_readbackListener);
+        _readbackListener = nullptr;
+        release();
+    }
+}
+
+void RenderTexture::readPixels(GLvoid* pixels, int width, int height)
+{
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
+
+    //TODO move this to configration, so we don't check it every time
+    /*  Certain Qualcomm Andreno gpu's will retain data in memory after a frame buffer switch which corrupts the render to the texture. The solution is to clear the frame buffer before rendering to the texture. However, calling glClear has the unintended result of clearing the current texture. Create a temporary texture to overcome this. At the end of RenderTexture::begin(), switch the attached texture to the second one, call glClear, and then switch back to the original texture. This solution is unnecessary for other devices as they don't have the same issue with switching frame buffers.
+     */
+    if (Configuration::getInstance()->checkForGLExtension("GL_QCOM"))
+    {
+        // -- bind a temporary texture so we can clear the render buffer without losing our texture
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _textureCopy->getName(), 0);
+        CHECK_GL_ERROR_DEBUG();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture->getName(), 0);
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0,0,width, height,GL_RGBA,GL_UNSIGNED_BYTE, pixels);
+    glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
+}
+
+/* get buffer as Image */
+Image* RenderTexture::newImage(bool fliimage)
+{
+    CCASSERT(_pixelFormat == Texture2D::PixelFormat::RGBA8888, "only RGBA8888 can be saved as image");
+
+    if (nullptr == _texture)
+    {
+        return nullptr;
+    }
+
+    const Size& s = _texture->getContentSizeInPixels();
+
+    // to get the image size to save
+    //        if the saving image domain exceeds the buffer texture domain,
+    //        it should be cut
+    int savedBufferWidth = (int)s.width;
+    int savedBufferHeight = (int)s.height;
+
+    GLubyte *tempData = new GLubyte[savedBufferWidth * savedBufferHeight * 4];
+
+    readPixels(tempData, savedBufferWidth, savedBufferHeight);
+    Image *image = newImageWithPixels(tempData, savedBufferWidth, savedBufferHeight, fliimage);
 
-    CC_SAFE_DELETE_ARRAY(buffer);
     CC_SAFE_DELETE_ARRAY(tempData);
 
     return image;
@@ -562,7 +813,7 @@ void RenderTexture::onBegin()
         viewport.origin.x = (_fullRect.origin.x - _rtTextureRect.origin.x) * viewPortRectWidthRatio;
         viewport.origin.y = (_fullRect.origin.y - _rtTextureRect.origin.y) * viewPortRectHeightRatio;
         //glViewport(_fullviewPort.origin.x, _fullviewPort.origin.y, (GLsizei)_fullviewPort.size.width, (GLsizei)_fullviewPort.size.height);
-        glViewport(viewport.origin.x, viewport.origin.y, (GLsizei)viewport.size.width, (GLsizei)viewport.size.height);
+        GL::viewport(viewport.origin.x, viewport.origin.y, (GLsizei)viewport.size.width, (GLsizei)viewport.size.height);
     }
 
     // Adjust the orthographic projection and viewport
@@ -32,15 +32,64 @@ THE SOFTWARE.
 #include "renderer/CCGroupCommand.h"
 #include "renderer/CCCustomCommand.h"
 
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
 NS_CC_BEGIN
 
 class EventCustom;
+class EventListenerCustom;
+class Scheduler;
 
 /**
  * @addtogroup textures
  * @{
  */
 
+/** Encodes the images saved by RenderTexture::saveToFile() one after the other, on a thread of its own.
+ * @since v3.2
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL ImageSaver
+{
+public:
+    static ImageSaver* getInstance();
+
+    /** Waits until the queued images are written, and stops the thread.
+     The Director calls it when it is purged: the callbacks of these images are not called.
+     */
+    static void destroyInstance();
+
+    /** Writes `image` to `fullpath`. `callback` is called on the cocos2d thread once the file is written */
+    void save(Image* image, const std::string& fullpath, const std::function<void(bool)>& callback);
+
+protected:
+    struct Task
+    {
+        Image* image;
+        std::string fullpath;
+        std::function<void(bool)> callback;
+    };
+
+    ImageSaver();
+    ~ImageSaver();
+
+    void run();
+
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<Task> _tasks;
+    // where the callbacks are performed, it belongs to the Director that queued the images
+    Scheduler* _scheduler;
+    bool _quit;
+
+    static ImageSaver* s_instance;
+};
+
 /**
 @brief RenderTexture is a generic rendering target. To render things into it,
 simply construct a render target, call begin on it, call visit on any cocos
@@ -100,6 +149,14 @@ public:
     
     CC_DEPRECATED_ATTRIBUTE Image* newCCImage(bool flipImage = true) { return newImage(flipImage); };
 
+    /** Reads the texture when the renderer reaches this node, without waiting for the GPU, and calls `callback`
+     with its data one or more frames later, on the cocos2d thread. The image is released once the callback returns.
+     The pixels are copied into a pixel buffer object, and mapped once a fence says that the copy is done, or after a
+     few frames without fences. Without pixel buffer objects they are read right away, like `newImage()`.
+     @since v3.2
+     */
+    void newImageAsync(const std::function<void(Image*)>& callback, bool flipImage = true);
+
     /** saves the texture into a file using JPEG format. The file will be saved in the Documents folder.
         Returns true if the operation is successful.
      */
@@ -109,6 +166,13 @@ public:
         Returns true if the operation is successful.
      */
     bool saveToFile(const std::string& filename, Image::Format format);
+
+    /** saves the texture into a file. The format could be JPG or PNG. The file will be saved in the Documents folder.
+     The pixels are read with `newImageAsync()` and encoded on a thread of their own: `callback` is called with
+     the full path of the file on the cocos2d thread once it is written.
+     @since v3.2
+     */
+    bool saveToFile(const std::string& filename, Image::Format format, const std::function<void(RenderTexture*, const std::string&)>& callback);
     
     /** Listen "come to background" message, and save render texture.
      It only has effect on Android.
@@ -213,7 +277,11 @@ protected:
     CustomCommand _clearCommand;
     CustomCommand _beginCommand;
     CustomCommand _endCommand;
-    CustomCommand _saveToFileCommand;
+
+    // pending newImageAsync() calls, polled after each frame is drawn
+    struct Readback;
+    std::vector<Readback*> _readbacks;
+    EventListenerCustom* _readbackListener;
 protected:
     //renderer caches and callbacks
     void onBegin();
@@ -222,7 +290,10 @@ protected:
     void onClear();
     void onClearDepth();
 
-    void onSaveToFile(const std::string& fileName);
+    // Reads the pixels of the texture into `pixels`, an offset in the buffer bound to GL_PIXEL_PACK_BUFFER if there is one
+    void readPixels(GLvoid* pixels, int width, int height);
+    void onReadPixelsAsync(const std::function<void(Image*)>& callback, bool flipImage);
+    void pollReadbacks();
     
     Mat4 _oldTransMatrix, _oldProjMatrix;
     Mat4 _transformMatrix, _projectionMatrix;
@@ -38,6 +38,7 @@ THE SOFTWARE.
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCFrameAllocator.h"
 #include "base/CCProfiling.h"
 #include "base/CCDirector.h"
 #include "base/CCDirector.h"
@@ -168,11 +169,11 @@ bool Sprite::initWithFile(const std::string& filename)
 {
     CCASSERT(filename.size()>0, "Invalid filename for sprite");
 
-    Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(filename);
+    // the texture may be a page of the dynamic atlas, see TextureCache::addImageRegion()
+    Rect rect;
+    Texture2D *texture = Director::getInstance()->getTextureCache()->addImageRegion(filename, &rect);
     if (texture)
     {
-        Rect rect = Rect::ZERO;
-        rect.size = texture->getContentSize();
         return initWithTexture(texture, rect);
     }
 
@@ -186,10 +187,13 @@ bool Sprite::initWithFile(const std::string &filename, const Rect& rect)
 {
     CCASSERT(filename.size()>0, "Invalid filename");
 
-    Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(filename);
+    Rect region;
+    Texture2D *texture = Director::getInstance()->getTextureCache()->addImageRegion(filename, &region);
     if (texture)
     {
-        return initWithTexture(texture, rect);
+        Rect rectInTexture = rect;
+        rectInTexture.origin += region.origin;
+        return initWithTexture(texture, rectInTexture);
     }
 
     // don't release here.
@@ -274,6 +278,8 @@ Sprite::Sprite(void)
 , _texture(nullptr)
 , _insideBounds(true)
 {
+    // a sprite only draws its quad, which lies inside its content size
+    _cullable = true;
 }
 
 Sprite::~Sprite(void)
@@ -307,11 +313,9 @@ static unsigned char cc_2x2_white_image[] = {
 
 void Sprite::setTexture(const std::string &filename)
 {
-    Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(filename);
+    Rect rect;
+    Texture2D *texture = Director::getInstance()->getTextureCache()->addImageRegion(filename, &rect);
     setTexture(texture);
-
-    Rect rect = Rect::ZERO;
-    rect.size = texture->getContentSize();
     setTextureRect(rect);
 }
 
@@ -346,6 +350,7 @@ void Sprite::setTexture(Texture2D *texture)
         CC_SAFE_RELEASE(_texture);
         _texture = texture;
         updateBlendFunc();
+        setStaticBatchDirty();
     }
 }
 
@@ -403,6 +408,8 @@ void Sprite::setTextureRect(const Rect& rect, bool rotated, const Size& untrimme
         _quad.br.vertices = Vec3(x2, y1, 0);
         _quad.tl.vertices = Vec3(x1, y2, 0);
         _quad.tr.vertices = Vec3(x2, y2, 0);
+
+        setStaticBatchDirty();
     }
 }
 
@@ -590,14 +597,19 @@ void Sprite::draw(Renderer *renderer, const Mat4 &transform, bool transformUpdat
 
     if(_insideBounds)
     {
+        // _quadCommand keeps the material ID between the frames, the renderer gets a copy that only lives during this frame
         _quadCommand.init(_globalZOrder, _texture->getName(), getGLProgramState(), _blendFunc, &_quad, 1, transform);
-        renderer->addCommand(&_quadCommand);
+        renderer->addCommand(renderer->getFrameAllocator()->create(_quadCommand));
 #if CC_SPRITE_DEBUG_DRAW
         _customDebugDrawCommand.init(_globalZOrder);
         _customDebugDrawCommand.func = CC_CALLBACK_0(Sprite::drawDebugData, this);
         renderer->addCommand(&_customDebugDrawCommand);
 #endif //CC_SPRITE_DEBUG_DRAW
     }
+    else
+    {
+        renderer->addCulledNodes(1);
+    }
 }
 #if CC_SPRITE_DEBUG_DRAW
 void Sprite::drawDebugData()
@@ -898,7 +910,7 @@ void Sprite::updateColor(void)
     }
 
     // self render
-    // do nothing
+    setStaticBatchDirty();
 }
 
 void Sprite::setOpacityModifyRGB(bool modify)
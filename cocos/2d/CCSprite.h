@@ -319,6 +319,17 @@ public:
      */
     inline const Vec2& getOffsetPosition(void) const { return _offsetPosition; }
 
+    /**
+     * Sets whether the sprite can be drawn out of order.
+     *
+     * The renderer may then draw it before or after the other order independent sprites queued right next to it,
+     * so that the ones using the same texture are batched together. Only use it for sprites that don't overlap,
+     * like the icons of a grid.
+     */
+    inline void setOrderIndependent(bool orderIndependent) { _quadCommand.setOrderIndependent(orderIndependent); }
+    /** Returns whether the sprite can be drawn out of order */
+    inline bool isOrderIndependent() const { return _quadCommand.isOrderIndependent(); }
+
 
     /**
      * Returns the flag which indicates whether the sprite is flipped horizontally or not.
@@ -383,7 +394,7 @@ public:
     *In lua: local setBlendFunc(local src, local dst)
     *@endcode
     */
-    inline void setBlendFunc(const BlendFunc &blendFunc) override { _blendFunc = blendFunc; }
+    inline void setBlendFunc(const BlendFunc &blendFunc) override { _blendFunc = blendFunc; setStaticBatchDirty(); }
     /**
     * @js  NA
     * @lua NA
@@ -542,7 +553,7 @@ protected:
     //
     BlendFunc        _blendFunc;            /// It's required for TextureProtocol inheritance
     Texture2D*       _texture;              /// Texture2D object that is used to render the sprite
-    QuadCommand      _quadCommand;          /// quad command
+    QuadCommand      _quadCommand;          /// quad command, copied in the frame allocator when drawn
 #if CC_SPRITE_DEBUG_DRAW
     CustomCommand   _customDebugDrawCommand;
     void drawDebugData();
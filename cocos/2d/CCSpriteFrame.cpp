@@ -102,6 +102,20 @@ bool SpriteFrame::initWithTexture(Texture2D* texture, const Rect& rect, bool rot
 
 bool SpriteFrame::initWithTextureFilename(const std::string& filename, const Rect& rect, bool rotated, const Vec2& offset, const Size& originalSize)
 {
+    // with the dynamic atlas, the image may be a part of a page: it is loaded now to know where
+    auto textureCache = Director::getInstance()->getTextureCache();
+    if (textureCache->isDynamicAtlasEnabled() && !filename.empty())
+    {
+        Rect region;
+        Texture2D* texture = textureCache->addImageRegion(filename, &region);
+        if (texture)
+        {
+            Rect rectInTexture = rect;
+            rectInTexture.origin += CC_POINT_POINTS_TO_PIXELS(region.origin);
+            return initWithTexture(texture, rectInTexture, rotated, offset, originalSize);
+        }
+    }
+
     _texture = nullptr;
     _textureFilename = filename;
     _rectInPixels = rect;
@@ -0,0 +1,313 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCStaticBatchNode.h"
+#include "2d/CCSprite.h"
+#include "2d/CCTexture2D.h"
+#include "CCGL.h"
+#include "base/CCConfiguration.h"
+#include "base/CCDirector.h"
+#include "base/CCEventType.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventDispatcher.h"
+#include "math/MathUtil.h"
+#include "renderer/CCGLProgram.h"
+#include "renderer/CCGLProgramState.h"
+#include "renderer/CCRenderer.h"
+#include "renderer/ccGLStateCache.h"
+
+NS_CC_BEGIN
+
+// the quads are drawn in pieces that can be addressed with GLushort indices
+static const ssize_t MAX_QUADS_PER_DRAW = 65536 / 4;
+
+StaticBatchNode* StaticBatchNode::create()
+{
+    StaticBatchNode* ret = new StaticBatchNode();
+    if (ret && ret->init())
+    {
+        ret->autorelease();
+    }
+    else
+    {
+        CC_SAFE_DELETE(ret);
+    }
+
+    return ret;
+}
+
+StaticBatchNode::StaticBatchNode()
+: _dirty(true)
+, _bufferDirty(false)
+{
+    _buffersVBO[0] = _buffersVBO[1] = 0;
+}
+
+StaticBatchNode::~StaticBatchNode()
+{
+    for (const auto& child : _children)
+    {
+        forgetNode(child);
+    }
+
+    for (const auto& run : _runs)
+    {
+        run.glProgramState->release();
+    }
+
+    GL::deleteBuffers(2, _buffersVBO);
+}
+
+bool StaticBatchNode::init()
+{
+    if (!Node::init())
+    {
+        return false;
+    }
+
+    setupBuffers();
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // the VBOs are lost with the GL context on Android
+    auto listener = EventListenerCustom::create(EVENT_COME_TO_FOREGROUND, [this](EventCustom* event){
+        this->setupBuffers();
+        this->_bufferDirty = true;
+    });
+
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+#endif
+
+    return true;
+}
+
+void StaticBatchNode::setupBuffers()
+{
+    std::vector<GLushort> indices(MAX_QUADS_PER_DRAW * 6);
+    for (int i = 0; i < MAX_QUADS_PER_DRAW; ++i)
+    {
+        indices[i*6+0] = (GLushort) (i*4+0);
+        indices[i*6+1] = (GLushort) (i*4+1);
+        indices[i*6+2] = (GLushort) (i*4+2);
+        indices[i*6+3] = (GLushort) (i*4+3);
+        indices[i*6+4] = (GLushort) (i*4+2);
+        indices[i*6+5] = (GLushort) (i*4+1);
+    }
+
+    glGenBuffers(2, _buffersVBO);
+
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices[0]) * indices.size(), indices.data(), GL_STATIC_DRAW);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void StaticBatchNode::forgetNode(Node* node)
+{
+    node->setStaticBatched(false);
+
+    for (const auto& child : node->getChildren())
+    {
+        forgetNode(child);
+    }
+}
+
+void StaticBatchNode::addChild(Node* child, int localZOrder, int tag)
+{
+    Node::addChild(child, localZOrder, tag);
+    _dirty = true;
+}
+
+void StaticBatchNode::removeChild(Node* child, bool cleanup)
+{
+    Node::removeChild(child, cleanup);
+    _dirty = true;
+}
+
+void StaticBatchNode::removeAllChildrenWithCleanup(bool cleanup)
+{
+    Node::removeAllChildrenWithCleanup(cleanup);
+    _dirty = true;
+}
+
+void StaticBatchNode::reorderChild(Node* child, int localZOrder)
+{
+    Node::reorderChild(child, localZOrder);
+    _dirty = true;
+}
+
+void StaticBatchNode::visit(Renderer* renderer, const Mat4& parentTransform, bool parentTransformUpdated)
+{
+    // quick return if not visible. children won't be drawn.
+    if (!_visible)
+    {
+        return;
+    }
+
+    bool dirty = _transformUpdated || parentTransformUpdated;
+    if (dirty)
+        _modelViewTransform = this->transform(parentTransform);
+    _transformUpdated = false;
+
+    // the children are not visited: they are drawn from the captured quads
+    if (_dirty || memcmp(&_capturedTransform, &_modelViewTransform, sizeof(Mat4)) != 0)
+    {
+        capture();
+    }
+
+    if (!_runs.empty())
+    {
+        _customCommand.init(_globalZOrder);
+        _customCommand.func = CC_CALLBACK_0(StaticBatchNode::onDraw, this);
+        renderer->addCommand(&_customCommand);
+    }
+
+    // reset for next frame
+    _orderOfArrival = 0;
+}
+
+void StaticBatchNode::capture()
+{
+    for (const auto& run : _runs)
+    {
+        run.glProgramState->release();
+    }
+    _runs.clear();
+    _quads.clear();
+
+    // same order as Node::visit(): children zOrder < 0 first
+    sortAllChildren();
+    for (const auto& child : _children)
+    {
+        captureNode(child, _modelViewTransform);
+    }
+
+    _capturedTransform = _modelViewTransform;
+    _dirty = false;
+    _bufferDirty = true;
+}
+
+void StaticBatchNode::captureNode(Node* node, const Mat4& parentTransform)
+{
+    // flagged even when invisible: setVisible(true) has to mark the batch dirty
+    node->setStaticBatched(true);
+
+    if (!node->isVisible())
+    {
+        return;
+    }
+
+    Mat4 transform = parentTransform * node->getNodeToParentTransform();
+
+    node->sortAllChildren();
+    auto& children = node->getChildren();
+    ssize_t i = 0;
+
+    // children zOrder < 0
+    for ( ; i < children.size(); i++)
+    {
+        auto child = children.at(i);
+        if (child->getLocalZOrder() < 0)
+            captureNode(child, transform);
+        else
+            break;
+    }
+
+    // self
+    Sprite* sprite = dynamic_cast<Sprite*>(node);
+    if (sprite && sprite->getBatchNode() == nullptr && sprite->getTexture() && sprite->getGLProgramState())
+    {
+        V3F_C4B_T2F_Quad quad = sprite->getQuad();
+        MathUtil::transformVertices((V3F_C4B_T2F*) &quad, (const V3F_C4B_T2F*) &quad, 4, transform);
+        _quads.push_back(quad);
+
+        GLuint textureID = sprite->getTexture()->getName();
+        GLProgramState* glProgramState = sprite->getGLProgramState();
+        const BlendFunc& blendFunc = sprite->getBlendFunc();
+
+        if (_runs.empty()
+            || _runs.back().textureID != textureID
+            || _runs.back().glProgramState != glProgramState
+            || !(_runs.back().blendFunc == blendFunc))
+        {
+            glProgramState->retain();
+            Run run = { textureID, glProgramState, blendFunc, (ssize_t) _quads.size() - 1, 0 };
+            _runs.push_back(run);
+        }
+        _runs.back().count++;
+    }
+
+    // children zOrder >= 0
+    for ( ; i < children.size(); i++)
+    {
+        captureNode(children.at(i), transform);
+    }
+}
+
+void StaticBatchNode::onDraw()
+{
+    GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    if (_bufferDirty)
+    {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _quads.size(), _quads.data(), GL_STATIC_DRAW);
+        _bufferDirty = false;
+    }
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        GL::bindVAO(0);
+    }
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+
+#define kQuadSize sizeof(_quads[0].bl)
+    for (const auto& run : _runs)
+    {
+        GL::bindTexture2D(run.textureID);
+        GL::blendFunc(run.blendFunc.src, run.blendFunc.dst);
+        // the quads are already in view space
+        run.glProgramState->apply(Mat4::IDENTITY);
+
+        for (ssize_t first = run.start; first < run.start + run.count; first += MAX_QUADS_PER_DRAW)
+        {
+            ssize_t count = MIN(MAX_QUADS_PER_DRAW, run.start + run.count - first);
+            size_t offset = sizeof(_quads[0]) * first;
+
+            glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) (offset + offsetof(V3F_C4B_T2F, vertices)));
+            glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) (offset + offsetof(V3F_C4B_T2F, colors)));
+            glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) (offset + offsetof(V3F_C4B_T2F, texCoords)));
+
+            glDrawElements(GL_TRIANGLES, (GLsizei) count * 6, GL_UNSIGNED_SHORT, (GLvoid*) 0);
+            CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, count * 6);
+        }
+    }
+#undef kQuadSize
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+NS_CC_END
@@ -0,0 +1,119 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCSTATICBATCHNODE_H__
+#define __CCSTATICBATCHNODE_H__
+
+#include <vector>
+
+#include "2d/CCNode.h"
+#include "renderer/CCCustomCommand.h"
+
+NS_CC_BEGIN
+
+class GLProgramState;
+
+/** StaticBatchNode
+ Node that draws the Sprites of its subtree from geometry captured once.
+
+ The first time it is visited, the node walks its subtree, transforms the quads of the
+ Sprites and uploads them to a static VBO. The following frames issue one draw call per
+ texture / program / blend run without visiting the children.
+ Any change of a captured node (transform, visibility, color, texture rect, children)
+ marks the StaticBatchNode dirty and the geometry is captured again on the next visit,
+ so it is meant for content that rarely changes: backgrounds, tile decorations...
+
+ Only the Sprites that don't use a SpriteBatchNode are drawn; the other nodes of the
+ subtree only contribute their transform.
+ @since v3.2
+ */
+class CC_DLL StaticBatchNode : public Node
+{
+public:
+    /** creates a StaticBatchNode */
+    static StaticBatchNode* create();
+
+    /** marks the captured geometry as outdated, it is captured again on the next visit */
+    void setDirty(bool dirty) { _dirty = dirty; }
+    /** returns whether the geometry has to be captured again */
+    bool isDirty() const { return _dirty; }
+
+    /** returns the number of quads captured in the static VBO */
+    ssize_t getQuadCount() const { return _quads.size(); }
+
+    /** Unmarks a node and its children as captured by a StaticBatchNode
+     * @js NA
+     * @lua NA
+     */
+    static void forgetNode(Node* node);
+
+    void onDraw();
+
+    // Overrides
+    virtual void addChild(Node* child, int localZOrder, int tag) override;
+    virtual void removeChild(Node* child, bool cleanup = true) override;
+    virtual void removeAllChildrenWithCleanup(bool cleanup) override;
+    virtual void reorderChild(Node* child, int localZOrder) override;
+    virtual void visit(Renderer* renderer, const Mat4& parentTransform, bool parentTransformUpdated) override;
+
+    using Node::addChild;
+
+CC_CONSTRUCTOR_ACCESS:
+    StaticBatchNode();
+    virtual ~StaticBatchNode();
+    virtual bool init() override;
+
+protected:
+    /** quads of the same texture, program and blend function, drawn with one call */
+    struct Run
+    {
+        GLuint textureID;
+        GLProgramState* glProgramState;
+        BlendFunc blendFunc;
+        ssize_t start;
+        ssize_t count;
+    };
+
+    void setupBuffers();
+    void capture();
+    void captureNode(Node* node, const Mat4& parentTransform);
+
+    std::vector<V3F_C4B_T2F_Quad> _quads;
+    std::vector<Run> _runs;
+    // the batch node transform used by the captured quads, they are in view space
+    Mat4 _capturedTransform;
+
+    GLuint _buffersVBO[2]; //0: vertex  1: indices
+    CustomCommand _customCommand;
+    bool _dirty;
+    // the quads were captured during the visit, they are uploaded by onDraw()
+    bool _bufferDirty;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(StaticBatchNode);
+};
+
+NS_CC_END
+
+#endif // __CCSTATICBATCHNODE_H__
@@ -67,7 +67,7 @@ TextureAtlas::~TextureAtlas()
     CC_SAFE_FREE(_quads);
     CC_SAFE_FREE(_indices);
 
-    glDeleteBuffers(2, _buffersVBO);
+    GL::deleteBuffers(2, _buffersVBO);
 
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -262,7 +262,7 @@ void TextureAtlas::setupVBOandVAO()
 
     glGenBuffers(2, &_buffersVBO[0]);
 
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _capacity, _quads, GL_DYNAMIC_DRAW);
 
     // vertices
@@ -277,13 +277,13 @@ void TextureAtlas::setupVBOandVAO()
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _capacity * 6, _indices, GL_STATIC_DRAW);
 
     // Must unbind the VAO before changing the element buffer.
     GL::bindVAO(0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 
     CHECK_GL_ERROR_DEBUG();
 }
@@ -300,13 +300,13 @@ void TextureAtlas::mapBuffers()
     // Avoid changing the element buffer for whatever VAO might be bound.
 	GL::bindVAO(0);
     
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _capacity, _quads, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _capacity * 6, _indices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     CHECK_GL_ERROR_DEBUG();
 }
@@ -616,7 +616,7 @@ void TextureAtlas::drawNumberOfQuads(ssize_t numberOfQuads, ssize_t start)
         // XXX: update is done in draw... perhaps it should be done in a timer
         if (_dirty) 
         {
-            glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+            GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
             // option 1: subdata
 //            glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0])*start, sizeof(_quads[0]) * n , &_quads[start] );
 
@@ -629,7 +629,7 @@ void TextureAtlas::drawNumberOfQuads(ssize_t numberOfQuads, ssize_t start)
             memcpy(buf, _quads, sizeof(_quads[0])* (numberOfQuads-start));
             glUnmapBuffer(GL_ARRAY_BUFFER);
             
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 
             _dirty = false;
         }
@@ -637,13 +637,13 @@ void TextureAtlas::drawNumberOfQuads(ssize_t numberOfQuads, ssize_t start)
         GL::bindVAO(_VAOname);
 
 #if CC_REBIND_INDICES_BUFFER
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
 #endif
 
         glDrawElements(GL_TRIANGLES, (GLsizei) numberOfQuads*6, GL_UNSIGNED_SHORT, (GLvoid*) (start*6*sizeof(_indices[0])) );
 
 #if CC_REBIND_INDICES_BUFFER
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 #endif
 
 //    glBindVertexArray(0);
@@ -655,7 +655,7 @@ void TextureAtlas::drawNumberOfQuads(ssize_t numberOfQuads, ssize_t start)
         //
 
 #define kQuadSize sizeof(_quads[0].bl)
-        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
 
         // XXX: update is done in draw... perhaps it should be done in a timer
         if (_dirty) 
@@ -675,12 +675,12 @@ void TextureAtlas::drawNumberOfQuads(ssize_t numberOfQuads, ssize_t start)
         // tex coords
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
 
         glDrawElements(GL_TRIANGLES, (GLsizei)numberOfQuads*6, GL_UNSIGNED_SHORT, (GLvoid*) (start*6*sizeof(_indices[0])));
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
 
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,numberOfQuads*6);
@@ -32,6 +32,7 @@ THE SOFTWARE.
 
 #include "2d/CCTextureCache.h"
 #include "2d/CCTexture2D.h"
+#include "2d/CCDynamicAtlas.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
 #include "2d/platform/CCFileUtils.h"
@@ -62,6 +63,7 @@ TextureCache::TextureCache()
 , _imageInfoQueue(nullptr)
 , _needQuit(false)
 , _asyncRefCount(0)
+, _dynamicAtlas(nullptr)
 {
 }
 
@@ -72,6 +74,7 @@ TextureCache::~TextureCache()
     for( auto it=_textures.begin(); it!=_textures.end(); ++it)
         (it->second)->release();
 
+    CC_SAFE_RELEASE(_dynamicAtlas);
     CC_SAFE_DELETE(_loadingThread);
 }
 
@@ -310,29 +313,102 @@ Texture2D * TextureCache::addImage(const std::string &path)
             bool bRet = image->initWithImageFile(fullpath);
             CC_BREAK_IF(!bRet);
 
-            texture = new Texture2D();
+            texture = addImageWithFullPath(image, fullpath);
+        } while (0);
+    }
 
-            if( texture && texture->initWithImage(image) )
-            {
+    CC_SAFE_RELEASE(image);
+
+    return texture;
+}
+
+Texture2D* TextureCache::addImageWithFullPath(Image* image, const std::string& fullpath)
+{
+    Texture2D* texture = new Texture2D();
+
+    if( texture && texture->initWithImage(image) )
+    {
 #if CC_ENABLE_CACHE_TEXTURE_DATA
-                // cache the texture file name
-                VolatileTextureMgr::addImageTexture(texture, fullpath);
+        // cache the texture file name
+        VolatileTextureMgr::addImageTexture(texture, fullpath);
 #endif
-                // texture already retained, no need to re-retain it
-                _textures.insert( std::make_pair(fullpath, texture) );
-            }
-            else
+        // texture already retained, no need to re-retain it
+        _textures.insert( std::make_pair(fullpath, texture) );
+    }
+    else
+    {
+        CCLOG("cocos2d: Couldn't create texture for file:%s in TextureCache", fullpath.c_str());
+        CC_SAFE_RELEASE_NULL(texture);
+    }
+
+    return texture;
+}
+
+Texture2D* TextureCache::addImageRegion(const std::string &path, Rect* rect)
+{
+    CCASSERT(rect != nullptr, "TextureCache: rect MUST not be nil");
+
+    Texture2D* texture = nullptr;
+
+    if (_dynamicAtlas)
+    {
+        std::string fullpath = FileUtils::getInstance()->fullPathForFilename(path);
+        if (fullpath.size() == 0)
+        {
+            return nullptr;
+        }
+
+        Rect rectInPixels;
+        texture = _dynamicAtlas->getImage(fullpath, &rectInPixels);
+        if (!texture)
+        {
+            Image* image = new Image();
+            if (image->initWithImageFile(fullpath))
             {
-                CCLOG("cocos2d: Couldn't create texture for file:%s in TextureCache", path.c_str());
+                texture = _dynamicAtlas->addImage(image, fullpath, &rectInPixels);
+
+                // too big, or a format that can't be packed: the image gets its own texture
+                if (!texture)
+                {
+                    auto it = _textures.find(fullpath);
+                    texture = (it != _textures.end()) ? it->second : addImageWithFullPath(image, fullpath);
+                    if (texture)
+                    {
+                        rectInPixels = Rect(0, 0, texture->getPixelsWide(), texture->getPixelsHigh());
+                    }
+                }
             }
-        } while (0);
-    }
+            image->release();
+        }
 
-    CC_SAFE_RELEASE(image);
+        if (texture)
+        {
+            *rect = CC_RECT_PIXELS_TO_POINTS(rectInPixels);
+        }
+        return texture;
+    }
 
+    texture = addImage(path);
+    if (texture)
+    {
+        *rect = Rect::ZERO;
+        rect->size = texture->getContentSize();
+    }
     return texture;
 }
 
+void TextureCache::setDynamicAtlasEnabled(bool enabled)
+{
+    if (enabled && !_dynamicAtlas)
+    {
+        _dynamicAtlas = new DynamicAtlas();
+    }
+    else if (!enabled)
+    {
+        CC_SAFE_RELEASE_NULL(_dynamicAtlas);
+    }
+}
+
 Texture2D* TextureCache::addImage(Image *image, const std::string &key)
 {
     CCASSERT(image != nullptr, "TextureCache: image MUST not be nil");
@@ -416,6 +492,11 @@ void TextureCache::removeAllTextures()
         (it->second)->release();
     }
     _textures.clear();
+
+    if (_dynamicAtlas)
+    {
+        _dynamicAtlas->removeAllPages();
+    }
 }
 
 void TextureCache::removeUnusedTextures()
@@ -432,6 +513,11 @@ void TextureCache::removeUnusedTextures()
         }
 
     }
+
+    if (_dynamicAtlas)
+    {
+        _dynamicAtlas->removeUnusedPages();
+    }
 }
 
 void TextureCache::removeTexture(Texture2D* texture)
@@ -532,6 +618,14 @@ std::string TextureCache::getCachedTextureInfo() const
     snprintf(buftmp, sizeof(buftmp)-1, "TextureCache dumpDebugInfo: %ld textures, for %lu KB (%.2f MB)\n", (long)count, (long)totalBytes / 1024, totalBytes / (1024.0f*1024.0f));
     buffer += buftmp;
 
+    if (_dynamicAtlas)
+    {
+        auto pageSize = _dynamicAtlas->getPageSize();
+        snprintf(buftmp, sizeof(buftmp)-1, "TextureCache dynamic atlas: %ld images in %ld pages of %d x %d\n",
+                 (long)_dynamicAtlas->getImageCount(), (long)_dynamicAtlas->getPageCount(), pageSize, pageSize);
+        buffer += buftmp;
+    }
+
     return buffer;
 }
 
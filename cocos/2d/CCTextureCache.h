@@ -48,6 +48,8 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+class DynamicAtlas;
+
 /**
  * @addtogroup textures
  * @{
@@ -110,6 +112,26 @@ public:
     */
     Texture2D* addImage(const std::string &filepath);
 
+    /** Returns the texture to use for an image file, and in `rect` the part of it used by the image, in points.
+    * When the dynamic atlas is enabled, small images are packed in shared textures: the texture is then
+    * a page of the atlas. Otherwise it is the same as addImage() and `rect` covers the whole texture.
+    * Sprite and SpriteFrame use it when they are created from a file name.
+    * @since v3.2
+    */
+    Texture2D* addImageRegion(const std::string &filepath, Rect* rect);
+
+    /** Enables or disables the DynamicAtlas used by addImageRegion(). Disabled by default.
+    * Disabling it doesn't affect the sprites that already use its pages.
+    * @since v3.2
+    */
+    void setDynamicAtlasEnabled(bool enabled);
+    inline bool isDynamicAtlasEnabled() const { return _dynamicAtlas != nullptr; }
+
+    /** Returns the dynamic atlas, nullptr when it is disabled
+    * @since v3.2
+    */
+    inline DynamicAtlas* getDynamicAtlas() const { return _dynamicAtlas; }
+
     /* Returns a Texture2D object given a file image
     * If the file image was not previously loaded, it will create a new Texture2D object and it will return it.
     * Otherwise it will load a texture in a new thread, and when the image is loaded, the callback will be called with the Texture2D as a parameter.
@@ -180,6 +202,7 @@ public:
 private:
     void addImageAsyncCallBack(float dt);
     void loadImage();
+    Texture2D* addImageWithFullPath(Image* image, const std::string& fullpath);
 
 public:
     struct AsyncStruct
@@ -214,6 +237,8 @@ protected:
     int _asyncRefCount;
 
     std::unordered_map<std::string, Texture2D*> _textures;
+
+    DynamicAtlas* _dynamicAtlas;
 };
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
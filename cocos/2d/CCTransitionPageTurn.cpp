@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "2d/CCActionPageTurn3D.h"
 #include "2d/CCNodeGrid.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/ccGLStateCache.h"
 
 NS_CC_BEGIN
 
@@ -82,13 +83,13 @@ void TransitionPageTurn::sceneOrder()
 
 void TransitionPageTurn::onEnablePolygonOffset()
 {
-    glEnable(GL_POLYGON_OFFSET_FILL);
+    GL::enable(GL_POLYGON_OFFSET_FILL);
     glPolygonOffset(POLYGON_OFFSET_FACTOR, POLYGON_OFFSET_UNITS);
 }
 
 void TransitionPageTurn::onDisablePolygonOffset()
 {
-    glDisable(GL_POLYGON_OFFSET_FILL);
+    GL::disable(GL_POLYGON_OFFSET_FILL);
     glPolygonOffset(0, 0);
 }
 
@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include "base/CCTouch.h"
 #include "base/CCDirector.h"
 #include "base/CCEventDispatcher.h"
+#include "renderer/ccGLStateCache.h"
 
 NS_CC_BEGIN
 
@@ -193,7 +194,7 @@ Vec2 GLViewProtocol::getVisibleOrigin() const
 
 void GLViewProtocol::setViewPortInPoints(float x , float y , float w , float h)
 {
-    glViewport((GLint)(x * _scaleX + _viewPortRect.origin.x),
+    GL::viewport((GLint)(x * _scaleX + _viewPortRect.origin.x),
                (GLint)(y * _scaleY + _viewPortRect.origin.y),
                (GLsizei)(w * _scaleX),
                (GLsizei)(h * _scaleY));
@@ -201,7 +202,7 @@ void GLViewProtocol::setViewPortInPoints(float x , float y , float w , float h)
 
 void GLViewProtocol::setScissorInPoints(float x , float y , float w , float h)
 {
-    glScissor((GLint)(x * _scaleX + _viewPortRect.origin.x),
+    GL::scissor((GLint)(x * _scaleX + _viewPortRect.origin.x),
               (GLint)(y * _scaleY + _viewPortRect.origin.y),
               (GLsizei)(w * _scaleX),
               (GLsizei)(h * _scaleY));
@@ -209,13 +210,13 @@ void GLViewProtocol::setScissorInPoints(float x , float y , float w , float h)
 
 bool GLViewProtocol::isScissorEnabled()
 {
-	return (GL_FALSE == glIsEnabled(GL_SCISSOR_TEST)) ? false : true;
+	return GL::isEnabled(GL_SCISSOR_TEST);
 }
 
 Rect GLViewProtocol::getScissorRect() const
 {
-	GLfloat params[4];
-	glGetFloatv(GL_SCISSOR_BOX, params);
+	GLint params[4];
+	GL::getScissorBox(params);
 	float x = (params[0] - _viewPortRect.origin.x) / _scaleX;
 	float y = (params[1] - _viewPortRect.origin.y) / _scaleY;
 	float w = params[2] / _scaleX;
@@ -35,6 +35,12 @@ THE SOFTWARE.
 #define glBindVertexArray			glBindVertexArrayOES
 #define glMapBuffer					glMapBufferOES
 #define glUnmapBuffer				glUnmapBufferOES
+#define glMapBufferRange			glMapBufferRangeEXTEXT
+#define glFlushMappedBufferRange	glFlushMappedBufferRangeEXTEXT
+#define glVertexAttribDivisor		glVertexAttribDivisorEXTEXT
+#define glDrawArraysInstanced		glDrawArraysInstancedEXTEXT
+#define glGetProgramBinary			glGetProgramBinaryOESEXT
+#define glProgramBinary				glProgramBinaryOESEXT
 
 #define GL_DEPTH24_STENCIL8			GL_DEPTH24_STENCIL8_OES
 #define GL_WRITE_ONLY				GL_WRITE_ONLY_OES
@@ -65,6 +71,44 @@ extern PFNGLDELETEVERTEXARRAYSOESPROC glDeleteVertexArraysOESEXT;
 #define glBindVertexArrayOES glBindVertexArrayOESEXT
 #define glDeleteVertexArraysOES glDeleteVertexArraysOESEXT
 
+// GL_EXT_map_buffer_range is missing in the gl2ext.h of old NDKs
+typedef GLvoid* (GL_APIENTRYP CC_PFNGLMAPBUFFERRANGEEXTPROC) (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+typedef void (GL_APIENTRYP CC_PFNGLFLUSHMAPPEDBUFFERRANGEEXTPROC) (GLenum target, GLintptr offset, GLsizeiptr length);
+extern CC_PFNGLMAPBUFFERRANGEEXTPROC glMapBufferRangeEXTEXT;
+extern CC_PFNGLFLUSHMAPPEDBUFFERRANGEEXTPROC glFlushMappedBufferRangeEXTEXT;
+
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT			0x0002
+#define GL_MAP_INVALIDATE_RANGE_BIT	0x0004
+#define GL_MAP_FLUSH_EXPLICIT_BIT	0x0010
+#define GL_MAP_UNSYNCHRONIZED_BIT	0x0020
+#endif
+
+#define CC_GL_MAP_BUFFER_RANGE      1
+
+// GL_EXT_instanced_arrays
+typedef void (GL_APIENTRYP CC_PFNGLVERTEXATTRIBDIVISOREXTPROC) (GLuint index, GLuint divisor);
+typedef void (GL_APIENTRYP CC_PFNGLDRAWARRAYSINSTANCEDEXTPROC) (GLenum mode, GLint first, GLsizei count, GLsizei primcount);
+extern CC_PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisorEXTEXT;
+extern CC_PFNGLDRAWARRAYSINSTANCEDEXTPROC glDrawArraysInstancedEXTEXT;
+
+#define CC_GL_INSTANCED_ARRAYS      1
+
+// GL_OES_get_program_binary
+typedef void (GL_APIENTRYP CC_PFNGLGETPROGRAMBINARYOESPROC) (GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, GLvoid *binary);
+typedef void (GL_APIENTRYP CC_PFNGLPROGRAMBINARYOESPROC) (GLuint program, GLenum binaryFormat, const GLvoid *binary, GLint length);
+extern CC_PFNGLGETPROGRAMBINARYOESPROC glGetProgramBinaryOESEXT;
+extern CC_PFNGLPROGRAMBINARYOESPROC glProgramBinaryOESEXT;
+
+#ifndef GL_PROGRAM_BINARY_LENGTH_OES
+#define GL_PROGRAM_BINARY_LENGTH_OES		0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS_OES	0x87FE
+#endif
+#define GL_PROGRAM_BINARY_LENGTH			GL_PROGRAM_BINARY_LENGTH_OES
+#define GL_NUM_PROGRAM_BINARY_FORMATS		GL_NUM_PROGRAM_BINARY_FORMATS_OES
+
+#define CC_GL_PROGRAM_BINARY        1
+
 
 #endif // CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
 
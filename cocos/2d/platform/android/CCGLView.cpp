@@ -42,11 +42,23 @@ THE SOFTWARE.
 PFNGLGENVERTEXARRAYSOESPROC glGenVertexArraysOESEXT = 0;
 PFNGLBINDVERTEXARRAYOESPROC glBindVertexArrayOESEXT = 0;
 PFNGLDELETEVERTEXARRAYSOESPROC glDeleteVertexArraysOESEXT = 0;
+CC_PFNGLMAPBUFFERRANGEEXTPROC glMapBufferRangeEXTEXT = 0;
+CC_PFNGLFLUSHMAPPEDBUFFERRANGEEXTPROC glFlushMappedBufferRangeEXTEXT = 0;
+CC_PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisorEXTEXT = 0;
+CC_PFNGLDRAWARRAYSINSTANCEDEXTPROC glDrawArraysInstancedEXTEXT = 0;
+CC_PFNGLGETPROGRAMBINARYOESPROC glGetProgramBinaryOESEXT = 0;
+CC_PFNGLPROGRAMBINARYOESPROC glProgramBinaryOESEXT = 0;
 
 void initExtensions() {
      glGenVertexArraysOESEXT = (PFNGLGENVERTEXARRAYSOESPROC)eglGetProcAddress("glGenVertexArraysOES");
      glBindVertexArrayOESEXT = (PFNGLBINDVERTEXARRAYOESPROC)eglGetProcAddress("glBindVertexArrayOES");
      glDeleteVertexArraysOESEXT = (PFNGLDELETEVERTEXARRAYSOESPROC)eglGetProcAddress("glDeleteVertexArraysOES");
+     glMapBufferRangeEXTEXT = (CC_PFNGLMAPBUFFERRANGEEXTPROC)eglGetProcAddress("glMapBufferRangeEXT");
+     glFlushMappedBufferRangeEXTEXT = (CC_PFNGLFLUSHMAPPEDBUFFERRANGEEXTPROC)eglGetProcAddress("glFlushMappedBufferRangeEXT");
+     glVertexAttribDivisorEXTEXT = (CC_PFNGLVERTEXATTRIBDIVISOREXTPROC)eglGetProcAddress("glVertexAttribDivisorEXT");
+     glDrawArraysInstancedEXTEXT = (CC_PFNGLDRAWARRAYSINSTANCEDEXTPROC)eglGetProcAddress("glDrawArraysInstancedEXT");
+     glGetProgramBinaryOESEXT = (CC_PFNGLGETPROGRAMBINARYOESPROC)eglGetProcAddress("glGetProgramBinaryOES");
+     glProgramBinaryOESEXT = (CC_PFNGLPROGRAMBINARYOESPROC)eglGetProcAddress("glProgramBinaryOES");
 }
 
 NS_CC_BEGIN
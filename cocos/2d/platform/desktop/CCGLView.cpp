@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "base/CCEventKeyboard.h"
 #include "base/CCEventMouse.h"
 #include "2d/CCIMEDispatcher.h"
+#include "renderer/ccGLStateCache.h"
 
 #include <unordered_map>
 
@@ -522,7 +523,7 @@ void GLView::setFrameSize(float width, float height)
 
 void GLView::setViewPortInPoints(float x , float y , float w , float h)
 {
-    glViewport((GLint)(x * _scaleX * _retinaFactor * _frameZoomFactor + _viewPortRect.origin.x * _retinaFactor * _frameZoomFactor),
+    GL::viewport((GLint)(x * _scaleX * _retinaFactor * _frameZoomFactor + _viewPortRect.origin.x * _retinaFactor * _frameZoomFactor),
                (GLint)(y * _scaleY * _retinaFactor  * _frameZoomFactor + _viewPortRect.origin.y * _retinaFactor * _frameZoomFactor),
                (GLsizei)(w * _scaleX * _retinaFactor * _frameZoomFactor),
                (GLsizei)(h * _scaleY * _retinaFactor * _frameZoomFactor));
@@ -530,7 +531,7 @@ void GLView::setViewPortInPoints(float x , float y , float w , float h)
 
 void GLView::setScissorInPoints(float x , float y , float w , float h)
 {
-    glScissor((GLint)(x * _scaleX * _retinaFactor * _frameZoomFactor + _viewPortRect.origin.x * _retinaFactor * _frameZoomFactor),
+    GL::scissor((GLint)(x * _scaleX * _retinaFactor * _frameZoomFactor + _viewPortRect.origin.x * _retinaFactor * _frameZoomFactor),
                (GLint)(y * _scaleY * _retinaFactor  * _frameZoomFactor + _viewPortRect.origin.y * _retinaFactor * _frameZoomFactor),
                (GLsizei)(w * _scaleX * _retinaFactor * _frameZoomFactor),
                (GLsizei)(h * _scaleY * _retinaFactor * _frameZoomFactor));
@@ -54,8 +54,8 @@ public:
     virtual void setScissorInPoints(float x , float y , float w , float h);
 
 
-    bool windowShouldClose();
-    void pollEvents();
+    virtual bool windowShouldClose();
+    virtual void pollEvents();
     GLFWwindow* getWindow() const { return _mainWindow; }
 
     /* override functions */
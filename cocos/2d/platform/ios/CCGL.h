@@ -35,9 +35,22 @@ THE SOFTWARE.
 #define glBindVertexArray			glBindVertexArrayOES
 #define glMapBuffer					glMapBufferOES
 #define glUnmapBuffer				glUnmapBufferOES
+#define glMapBufferRange			glMapBufferRangeEXT
+#define glFlushMappedBufferRange	glFlushMappedBufferRangeEXT
 
 #define GL_DEPTH24_STENCIL8			GL_DEPTH24_STENCIL8_OES
 #define GL_WRITE_ONLY				GL_WRITE_ONLY_OES
+#define GL_MAP_WRITE_BIT			GL_MAP_WRITE_BIT_EXT
+#define GL_MAP_INVALIDATE_RANGE_BIT	GL_MAP_INVALIDATE_RANGE_BIT_EXT
+#define GL_MAP_FLUSH_EXPLICIT_BIT	GL_MAP_FLUSH_EXPLICIT_BIT_EXT
+#define GL_MAP_UNSYNCHRONIZED_BIT	GL_MAP_UNSYNCHRONIZED_BIT_EXT
+
+#define CC_GL_MAP_BUFFER_RANGE      1
+
+// GL_EXT_instanced_arrays, iOS 7 and later
+#define glVertexAttribDivisor		glVertexAttribDivisorEXT
+#define glDrawArraysInstanced		glDrawArraysInstancedEXT
+#define CC_GL_INSTANCED_ARRAYS      1
 
 #include <OpenGLES/ES2/gl.h>
 #include <OpenGLES/ES2/glext.h>
@@ -32,6 +32,113 @@ THE SOFTWARE.
 
 #define CC_GL_DEPTH24_STENCIL8		GL_DEPTH24_STENCIL8
 
+// glMapBufferRange is loaded by GLEW
+#define CC_GL_MAP_BUFFER_RANGE      1
+
+// GL_ARB_instanced_arrays is loaded by GLEW. OpenGL 2.1 contexts only have the ARB entry points,
+// the core ones are left null: always call the ARB ones.
+#undef glVertexAttribDivisor
+#undef glDrawArraysInstanced
+#define glVertexAttribDivisor       glVertexAttribDivisorARB
+#define glDrawArraysInstanced       glDrawArraysInstancedARB
+#define CC_GL_INSTANCED_ARRAYS      1
+
+// GL_ARB_get_program_binary is loaded by GLEW, it uses the core names
+#define CC_GL_PROGRAM_BINARY        1
+
+// glBeginQuery and friends are part of OpenGL 1.5, GL_ARB_occlusion_query tells whether they work
+#define CC_GL_OCCLUSION_QUERY       1
+
+// GL_ARB_pixel_buffer_object and GL_ARB_sync are loaded by GLEW
+#define CC_GL_PIXEL_BUFFER          1
+#define CC_GL_FENCE_SYNC            1
+
+#if CC_USE_HEADLESS
+// GLEW only loads the entry points newer than OpenGL 1.1, the 1.1 ones are
+// called through these pointers so that GLNull can replace all of them.
+extern decltype(&glAlphaFunc) ccglAlphaFunc;
+extern decltype(&glBindTexture) ccglBindTexture;
+extern decltype(&glBlendFunc) ccglBlendFunc;
+extern decltype(&glClear) ccglClear;
+extern decltype(&glClearColor) ccglClearColor;
+extern decltype(&glClearDepth) ccglClearDepth;
+extern decltype(&glClearStencil) ccglClearStencil;
+extern decltype(&glColorMask) ccglColorMask;
+extern decltype(&glDeleteTextures) ccglDeleteTextures;
+extern decltype(&glDepthFunc) ccglDepthFunc;
+extern decltype(&glDepthMask) ccglDepthMask;
+extern decltype(&glDepthRange) ccglDepthRange;
+extern decltype(&glDisable) ccglDisable;
+extern decltype(&glDrawArrays) ccglDrawArrays;
+extern decltype(&glDrawElements) ccglDrawElements;
+extern decltype(&glEnable) ccglEnable;
+extern decltype(&glFinish) ccglFinish;
+extern decltype(&glFlush) ccglFlush;
+extern decltype(&glGenTextures) ccglGenTextures;
+extern decltype(&glGetBooleanv) ccglGetBooleanv;
+extern decltype(&glGetError) ccglGetError;
+extern decltype(&glGetFloatv) ccglGetFloatv;
+extern decltype(&glGetIntegerv) ccglGetIntegerv;
+extern decltype(&glGetString) ccglGetString;
+extern decltype(&glHint) ccglHint;
+extern decltype(&glIsEnabled) ccglIsEnabled;
+extern decltype(&glLineWidth) ccglLineWidth;
+extern decltype(&glPixelStorei) ccglPixelStorei;
+extern decltype(&glPointSize) ccglPointSize;
+extern decltype(&glPolygonOffset) ccglPolygonOffset;
+extern decltype(&glReadPixels) ccglReadPixels;
+extern decltype(&glScissor) ccglScissor;
+extern decltype(&glStencilFunc) ccglStencilFunc;
+extern decltype(&glStencilMask) ccglStencilMask;
+extern decltype(&glStencilOp) ccglStencilOp;
+extern decltype(&glTexImage2D) ccglTexImage2D;
+extern decltype(&glTexParameteri) ccglTexParameteri;
+extern decltype(&glTexSubImage2D) ccglTexSubImage2D;
+extern decltype(&glViewport) ccglViewport;
+
+#ifndef CC_GL_DISPATCH_IMPLEMENTATION
+#define glAlphaFunc               ccglAlphaFunc
+#define glBindTexture             ccglBindTexture
+#define glBlendFunc               ccglBlendFunc
+#define glClear                   ccglClear
+#define glClearColor              ccglClearColor
+#define glClearDepth              ccglClearDepth
+#define glClearStencil            ccglClearStencil
+#define glColorMask               ccglColorMask
+#define glDeleteTextures          ccglDeleteTextures
+#define glDepthFunc               ccglDepthFunc
+#define glDepthMask               ccglDepthMask
+#define glDepthRange              ccglDepthRange
+#define glDisable                 ccglDisable
+#define glDrawArrays              ccglDrawArrays
+#define glDrawElements            ccglDrawElements
+#define glEnable                  ccglEnable
+#define glFinish                  ccglFinish
+#define glFlush                   ccglFlush
+#define glGenTextures             ccglGenTextures
+#define glGetBooleanv             ccglGetBooleanv
+#define glGetError                ccglGetError
+#define glGetFloatv               ccglGetFloatv
+#define glGetIntegerv             ccglGetIntegerv
+#define glGetString               ccglGetString
+#define glHint                    ccglHint
+#define glIsEnabled               ccglIsEnabled
+#define glLineWidth               ccglLineWidth
+#define glPixelStorei             ccglPixelStorei
+#define glPointSize               ccglPointSize
+#define glPolygonOffset           ccglPolygonOffset
+#define glReadPixels              ccglReadPixels
+#define glScissor                 ccglScissor
+#define glStencilFunc             ccglStencilFunc
+#define glStencilMask             ccglStencilMask
+#define glStencilOp               ccglStencilOp
+#define glTexImage2D              ccglTexImage2D
+#define glTexParameteri           ccglTexParameteri
+#define glTexSubImage2D           ccglTexSubImage2D
+#define glViewport                ccglViewport
+#endif // CC_GL_DISPATCH_IMPLEMENTATION
+#endif // CC_USE_HEADLESS
+
 #endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
 
 #endif // __CCGL_H__
@@ -0,0 +1,1100 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+// keep the real names of the OpenGL 1.1 entry points in this file
+#define CC_GL_DISPATCH_IMPLEMENTATION
+
+#include "CCGLNull.h"
+#include "CCGL.h"
+#include "base/ccMacros.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// The OpenGL 1.1 entry points called by the engine, see CCGL.h
+decltype(&glAlphaFunc) ccglAlphaFunc = &glAlphaFunc;
+decltype(&glBindTexture) ccglBindTexture = &glBindTexture;
+decltype(&glBlendFunc) ccglBlendFunc = &glBlendFunc;
+decltype(&glClear) ccglClear = &glClear;
+decltype(&glClearColor) ccglClearColor = &glClearColor;
+decltype(&glClearDepth) ccglClearDepth = &glClearDepth;
+decltype(&glClearStencil) ccglClearStencil = &glClearStencil;
+decltype(&glColorMask) ccglColorMask = &glColorMask;
+decltype(&glDeleteTextures) ccglDeleteTextures = &glDeleteTextures;
+decltype(&glDepthFunc) ccglDepthFunc = &glDepthFunc;
+decltype(&glDepthMask) ccglDepthMask = &glDepthMask;
+decltype(&glDepthRange) ccglDepthRange = &glDepthRange;
+decltype(&glDisable) ccglDisable = &glDisable;
+decltype(&glDrawArrays) ccglDrawArrays = &glDrawArrays;
+decltype(&glDrawElements) ccglDrawElements = &glDrawElements;
+decltype(&glEnable) ccglEnable = &glEnable;
+decltype(&glFinish) ccglFinish = &glFinish;
+decltype(&glFlush) ccglFlush = &glFlush;
+decltype(&glGenTextures) ccglGenTextures = &glGenTextures;
+decltype(&glGetBooleanv) ccglGetBooleanv = &glGetBooleanv;
+decltype(&glGetError) ccglGetError = &glGetError;
+decltype(&glGetFloatv) ccglGetFloatv = &glGetFloatv;
+decltype(&glGetIntegerv) ccglGetIntegerv = &glGetIntegerv;
+decltype(&glGetString) ccglGetString = &glGetString;
+decltype(&glHint) ccglHint = &glHint;
+decltype(&glIsEnabled) ccglIsEnabled = &glIsEnabled;
+decltype(&glLineWidth) ccglLineWidth = &glLineWidth;
+decltype(&glPixelStorei) ccglPixelStorei = &glPixelStorei;
+decltype(&glPointSize) ccglPointSize = &glPointSize;
+decltype(&glPolygonOffset) ccglPolygonOffset = &glPolygonOffset;
+decltype(&glReadPixels) ccglReadPixels = &glReadPixels;
+decltype(&glScissor) ccglScissor = &glScissor;
+decltype(&glStencilFunc) ccglStencilFunc = &glStencilFunc;
+decltype(&glStencilMask) ccglStencilMask = &glStencilMask;
+decltype(&glStencilOp) ccglStencilOp = &glStencilOp;
+decltype(&glTexImage2D) ccglTexImage2D = &glTexImage2D;
+decltype(&glTexParameteri) ccglTexParameteri = &glTexParameteri;
+decltype(&glTexSubImage2D) ccglTexSubImage2D = &glTexSubImage2D;
+decltype(&glViewport) ccglViewport = &glViewport;
+
+NS_CC_BEGIN
+
+//
+// call counters
+//
+struct NullGLCounter
+{
+    NullGLCounter(const char* functionName);
+
+    const char* name;
+    unsigned int count;
+};
+
+static std::vector<NullGLCounter*>& getCounters()
+{
+    static std::vector<NullGLCounter*> counters;
+    return counters;
+}
+
+NullGLCounter::NullGLCounter(const char* functionName)
+: name(functionName)
+, count(0)
+{
+    getCounters().push_back(this);
+}
+
+// a counter is registered the first time its function is called
+#define NULL_GL_COUNT(function) \
+    static NullGLCounter s_counter(#function); \
+    ++s_counter.count
+
+//
+// emulated state
+//
+struct NullGLVariable
+{
+    std::string name;
+    GLenum type;
+    GLint size;
+    GLint location;
+};
+
+struct NullGLShader
+{
+    GLenum type;
+    std::string source;
+};
+
+struct NullGLProgram
+{
+    std::vector<GLuint> shaders;
+    std::unordered_map<std::string, GLint> attribBindings;
+    std::vector<NullGLVariable> attributes;
+    std::vector<NullGLVariable> uniforms;
+};
+
+static bool s_installed = false;
+static GLuint s_lastName = 0;
+
+static std::unordered_map<GLuint, NullGLShader> s_shaders;
+static std::unordered_map<GLuint, NullGLProgram> s_programs;
+static std::unordered_map<GLuint, GLsizeiptr> s_bufferSizes;
+static std::unordered_set<GLenum> s_enabledCaps;
+static std::vector<char> s_mappedBuffer;
+
+static GLuint s_arrayBuffer = 0;
+static GLuint s_elementArrayBuffer = 0;
+static GLuint s_pixelPackBuffer = 0;
+static GLuint s_framebuffer = 0;
+static GLuint s_renderbuffer = 0;
+static GLuint s_currentProgram = 0;
+static GLint s_packAlignment = 4;
+static GLint s_viewport[4] = { 0, 0, 0, 0 };
+static GLint s_scissorBox[4] = { 0, 0, 0, 0 };
+static GLfloat s_clearColor[4] = { 0, 0, 0, 0 };
+static GLboolean s_colorMask[4] = { GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE };
+static GLboolean s_depthMask = GL_TRUE;
+
+static void genNames(GLsizei n, GLuint* names)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        names[i] = ++s_lastName;
+    }
+}
+
+static GLuint* getBufferBinding(GLenum target)
+{
+    switch (target)
+    {
+        case GL_ARRAY_BUFFER:
+            return &s_arrayBuffer;
+        case GL_ELEMENT_ARRAY_BUFFER:
+            return &s_elementArrayBuffer;
+        case GL_PIXEL_PACK_BUFFER:
+            return &s_pixelPackBuffer;
+        default:
+            return nullptr;
+    }
+}
+
+static void copyString(const std::string& str, GLsizei bufSize, GLsizei* length, GLchar* buffer)
+{
+    GLsizei copied = 0;
+    if (buffer && bufSize > 0)
+    {
+        copied = std::min((GLsizei)str.size(), bufSize - 1);
+        memcpy(buffer, str.c_str(), copied);
+        buffer[copied] = '\0';
+    }
+    if (length)
+        *length = copied;
+}
+
+//
+// shader reflection: the active attributes and uniforms are the ones declared in the sources
+//
+static GLenum getVariableType(const std::string& typeName)
+{
+    static const struct { const char* name; GLenum type; } types[] = {
+        { "float", GL_FLOAT },
+        { "vec2", GL_FLOAT_VEC2 },
+        { "vec3", GL_FLOAT_VEC3 },
+        { "vec4", GL_FLOAT_VEC4 },
+        { "int", GL_INT },
+        { "ivec2", GL_INT_VEC2 },
+        { "ivec3", GL_INT_VEC3 },
+        { "ivec4", GL_INT_VEC4 },
+        { "bool", GL_BOOL },
+        { "mat2", GL_FLOAT_MAT2 },
+        { "mat3", GL_FLOAT_MAT3 },
+        { "mat4", GL_FLOAT_MAT4 },
+        { "sampler2D", GL_SAMPLER_2D },
+        { "samplerCube", GL_SAMPLER_CUBE },
+    };
+
+    for (const auto& type : types)
+    {
+        if (typeName == type.name)
+            return type.type;
+    }
+    return 0;
+}
+
+static std::vector<std::string> tokenize(const std::string& source)
+{
+    std::vector<std::string> tokens;
+    size_t i = 0;
+    while (i < source.size())
+    {
+        unsigned char c = source[i];
+        if (c == '/' && i + 1 < source.size() && source[i + 1] == '/')
+        {
+            i = source.find('\n', i);
+            if (i == std::string::npos)
+                break;
+        }
+        else if (c == '/' && i + 1 < source.size() && source[i + 1] == '*')
+        {
+            i = source.find("*/", i + 2);
+            if (i == std::string::npos)
+                break;
+            i += 2;
+        }
+        else if (isalnum(c) || c == '_')
+        {
+            size_t start = i;
+            while (i < source.size() && (isalnum((unsigned char)source[i]) || source[i] == '_'))
+                ++i;
+            tokens.push_back(source.substr(start, i - start));
+        }
+        else
+        {
+            if (!isspace(c))
+                tokens.push_back(std::string(1, c));
+            ++i;
+        }
+    }
+    return tokens;
+}
+
+// Adds the variables of the "<qualifier> [precision] <type> <name>[[size]], ...;" declarations
+static void parseDeclarations(const std::string& source, const std::string& qualifier, std::vector<NullGLVariable>& variables)
+{
+    auto tokens = tokenize(source);
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        if (tokens[i] != qualifier)
+            continue;
+
+        size_t t = i + 1;
+        if (t < tokens.size() && (tokens[t] == "lowp" || tokens[t] == "mediump" || tokens[t] == "highp"))
+            ++t;
+        if (t + 1 >= tokens.size())
+            break;
+
+        GLenum type = getVariableType(tokens[t]);
+        if (type == 0)
+            continue;
+
+        for (t = t + 1; t < tokens.size(); t += 2)
+        {
+            NullGLVariable variable;
+            variable.name = tokens[t];
+            variable.type = type;
+            variable.size = 1;
+            variable.location = -1;
+            if (t + 3 < tokens.size() && tokens[t + 1] == "[")
+            {
+                variable.size = std::max(atoi(tokens[t + 2].c_str()), 1);
+                t += 3;
+            }
+
+            auto found = std::find_if(variables.begin(), variables.end(), [&](const NullGLVariable& v){ return v.name == variable.name; });
+            if (found == variables.end())
+                variables.push_back(variable);
+
+            if (t + 1 >= tokens.size() || tokens[t + 1] != ",")
+                break;
+        }
+        i = t;
+    }
+}
+
+// "name" and "name[index]" both refer to a variable, returns its location
+static GLint findLocation(const std::vector<NullGLVariable>& variables, const GLchar* name)
+{
+    std::string variableName(name);
+    GLint index = 0;
+    auto bracket = variableName.find('[');
+    if (bracket != std::string::npos)
+    {
+        index = atoi(variableName.c_str() + bracket + 1);
+        variableName.resize(bracket);
+    }
+
+    for (const auto& variable : variables)
+    {
+        if (variable.name == variableName && index < variable.size)
+            return variable.location + index;
+    }
+    return -1;
+}
+
+static std::string getActiveName(const NullGLVariable& variable)
+{
+    return variable.size > 1 ? variable.name + "[0]" : variable.name;
+}
+
+static GLint getMaxActiveNameLength(const std::vector<NullGLVariable>& variables)
+{
+    GLint length = 0;
+    for (const auto& variable : variables)
+    {
+        length = std::max(length, (GLint)getActiveName(variable).size() + 1);
+    }
+    return length;
+}
+
+static void getActiveVariable(const std::vector<NullGLVariable>& variables, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    if (index >= variables.size())
+    {
+        copyString("", bufSize, length, name);
+        return;
+    }
+
+    const auto& variable = variables[index];
+    copyString(getActiveName(variable), bufSize, length, name);
+    if (size)
+        *size = variable.size;
+    if (type)
+        *type = variable.type;
+}
+
+//
+// OpenGL 1.1
+//
+static void GLAPIENTRY nullAlphaFunc(GLenum, GLclampf) { NULL_GL_COUNT(glAlphaFunc); }
+static void GLAPIENTRY nullBindTexture(GLenum, GLuint) { NULL_GL_COUNT(glBindTexture); }
+static void GLAPIENTRY nullBlendFunc(GLenum, GLenum) { NULL_GL_COUNT(glBlendFunc); }
+static void GLAPIENTRY nullClear(GLbitfield) { NULL_GL_COUNT(glClear); }
+static void GLAPIENTRY nullClearDepth(GLclampd) { NULL_GL_COUNT(glClearDepth); }
+static void GLAPIENTRY nullClearStencil(GLint) { NULL_GL_COUNT(glClearStencil); }
+static void GLAPIENTRY nullDepthFunc(GLenum) { NULL_GL_COUNT(glDepthFunc); }
+static void GLAPIENTRY nullDrawArrays(GLenum, GLint, GLsizei) { NULL_GL_COUNT(glDrawArrays); }
+static void GLAPIENTRY nullDrawArraysInstanced(GLenum, GLint, GLsizei, GLsizei) { NULL_GL_COUNT(glDrawArraysInstanced); }
+static void GLAPIENTRY nullDrawElements(GLenum, GLsizei, GLenum, const GLvoid*) { NULL_GL_COUNT(glDrawElements); }
+static void GLAPIENTRY nullFinish() { NULL_GL_COUNT(glFinish); }
+static void GLAPIENTRY nullFlush() { NULL_GL_COUNT(glFlush); }
+static GLenum GLAPIENTRY nullGetError() { NULL_GL_COUNT(glGetError); return GL_NO_ERROR; }
+static void GLAPIENTRY nullHint(GLenum, GLenum) { NULL_GL_COUNT(glHint); }
+static void GLAPIENTRY nullLineWidth(GLfloat) { NULL_GL_COUNT(glLineWidth); }
+static void GLAPIENTRY nullPointSize(GLfloat) { NULL_GL_COUNT(glPointSize); }
+static void GLAPIENTRY nullPolygonOffset(GLfloat, GLfloat) { NULL_GL_COUNT(glPolygonOffset); }
+static void GLAPIENTRY nullStencilFunc(GLenum, GLint, GLuint) { NULL_GL_COUNT(glStencilFunc); }
+static void GLAPIENTRY nullStencilMask(GLuint) { NULL_GL_COUNT(glStencilMask); }
+static void GLAPIENTRY nullStencilOp(GLenum, GLenum, GLenum) { NULL_GL_COUNT(glStencilOp); }
+static void GLAPIENTRY nullTexImage2D(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid*) { NULL_GL_COUNT(glTexImage2D); }
+static void GLAPIENTRY nullTexParameteri(GLenum, GLenum, GLint) { NULL_GL_COUNT(glTexParameteri); }
+static void GLAPIENTRY nullTexSubImage2D(GLenum, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*) { NULL_GL_COUNT(glTexSubImage2D); }
+
+static void GLAPIENTRY nullClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+{
+    NULL_GL_COUNT(glClearColor);
+    s_clearColor[0] = red;
+    s_clearColor[1] = green;
+    s_clearColor[2] = blue;
+    s_clearColor[3] = alpha;
+}
+
+static void GLAPIENTRY nullColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+    NULL_GL_COUNT(glColorMask);
+    s_colorMask[0] = red;
+    s_colorMask[1] = green;
+    s_colorMask[2] = blue;
+    s_colorMask[3] = alpha;
+}
+
+static void GLAPIENTRY nullDepthMask(GLboolean flag)
+{
+    NULL_GL_COUNT(glDepthMask);
+    s_depthMask = flag;
+}
+
+static void GLAPIENTRY nullDepthRange(GLclampd, GLclampd)
+{
+    NULL_GL_COUNT(glDepthRange);
+}
+
+static void GLAPIENTRY nullDeleteTextures(GLsizei, const GLuint*)
+{
+    NULL_GL_COUNT(glDeleteTextures);
+}
+
+static void GLAPIENTRY nullGenTextures(GLsizei n, GLuint* textures)
+{
+    NULL_GL_COUNT(glGenTextures);
+    genNames(n, textures);
+}
+
+static void GLAPIENTRY nullEnable(GLenum cap)
+{
+    NULL_GL_COUNT(glEnable);
+    s_enabledCaps.insert(cap);
+}
+
+static void GLAPIENTRY nullDisable(GLenum cap)
+{
+    NULL_GL_COUNT(glDisable);
+    s_enabledCaps.erase(cap);
+}
+
+static GLboolean GLAPIENTRY nullIsEnabled(GLenum cap)
+{
+    NULL_GL_COUNT(glIsEnabled);
+    return s_enabledCaps.count(cap) ? GL_TRUE : GL_FALSE;
+}
+
+static void GLAPIENTRY nullGetBooleanv(GLenum pname, GLboolean* params)
+{
+    NULL_GL_COUNT(glGetBooleanv);
+    switch (pname)
+    {
+        case GL_COLOR_WRITEMASK:
+            memcpy(params, s_colorMask, sizeof(s_colorMask));
+            break;
+        case GL_DEPTH_WRITEMASK:
+            params[0] = s_depthMask;
+            break;
+        default:
+            params[0] = s_enabledCaps.count(pname) ? GL_TRUE : GL_FALSE;
+            break;
+    }
+}
+
+static void GLAPIENTRY nullGetIntegerv(GLenum pname, GLint* params)
+{
+    NULL_GL_COUNT(glGetIntegerv);
+    switch (pname)
+    {
+        case GL_VIEWPORT:
+            memcpy(params, s_viewport, sizeof(s_viewport));
+            break;
+        case GL_SCISSOR_BOX:
+            memcpy(params, s_scissorBox, sizeof(s_scissorBox));
+            break;
+        case GL_MAX_TEXTURE_SIZE:
+            params[0] = 8192;
+            break;
+        case GL_MAX_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_VERTEX_ATTRIBS:
+            params[0] = 16;
+            break;
+        case GL_RED_BITS:
+        case GL_GREEN_BITS:
+        case GL_BLUE_BITS:
+        case GL_ALPHA_BITS:
+        case GL_STENCIL_BITS:
+            params[0] = 8;
+            break;
+        case GL_DEPTH_BITS:
+            params[0] = 24;
+            break;
+        case GL_PACK_ALIGNMENT:
+            params[0] = s_packAlignment;
+            break;
+        case GL_FRAMEBUFFER_BINDING:
+            params[0] = s_framebuffer;
+            break;
+        case GL_RENDERBUFFER_BINDING:
+            params[0] = s_renderbuffer;
+            break;
+        case GL_CURRENT_PROGRAM:
+            params[0] = s_currentProgram;
+            break;
+        case GL_ARRAY_BUFFER_BINDING:
+            params[0] = s_arrayBuffer;
+            break;
+        case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+            params[0] = s_elementArrayBuffer;
+            break;
+        default:
+            params[0] = 0;
+            break;
+    }
+}
+
+static void GLAPIENTRY nullGetFloatv(GLenum pname, GLfloat* params)
+{
+    NULL_GL_COUNT(glGetFloatv);
+    switch (pname)
+    {
+        case GL_COLOR_CLEAR_VALUE:
+            memcpy(params, s_clearColor, sizeof(s_clearColor));
+            break;
+        case GL_VIEWPORT:
+            for (int i = 0; i < 4; ++i)
+                params[i] = (GLfloat)s_viewport[i];
+            break;
+        default:
+            params[0] = 0;
+            break;
+    }
+}
+
+static const GLubyte* GLAPIENTRY nullGetString(GLenum name)
+{
+    NULL_GL_COUNT(glGetString);
+    switch (name)
+    {
+        case GL_VENDOR:
+            return (const GLubyte*)"cocos2d-x";
+        case GL_RENDERER:
+            return (const GLubyte*)"GLNull";
+        case GL_VERSION:
+            return (const GLubyte*)"2.1 GLNull";
+        case GL_SHADING_LANGUAGE_VERSION:
+            return (const GLubyte*)"1.20";
+        case GL_EXTENSIONS:
+            return (const GLubyte*)"GL_ARB_vertex_array_object GL_ARB_map_buffer_range GL_ARB_instanced_arrays GL_ARB_framebuffer_object GL_EXT_framebuffer_object";
+        default:
+            return (const GLubyte*)"";
+    }
+}
+
+static void GLAPIENTRY nullPixelStorei(GLenum pname, GLint param)
+{
+    NULL_GL_COUNT(glPixelStorei);
+    if (pname == GL_PACK_ALIGNMENT)
+        s_packAlignment = param;
+}
+
+static void GLAPIENTRY nullReadPixels(GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid* pixels)
+{
+    NULL_GL_COUNT(glReadPixels);
+
+    // pixels is an offset in the bound pack buffer
+    if (s_pixelPackBuffer != 0 || pixels == nullptr)
+        return;
+
+    GLsizei bytesPerPixel = 4;
+    if (type == GL_UNSIGNED_BYTE)
+    {
+        if (format == GL_RGB)
+            bytesPerPixel = 3;
+        else if (format == GL_ALPHA || format == GL_LUMINANCE)
+            bytesPerPixel = 1;
+    }
+    else if (type != GL_FLOAT)
+    {
+        bytesPerPixel = 2;
+    }
+    else if (format == GL_RGBA)
+    {
+        bytesPerPixel = 16;
+    }
+
+    GLsizei rowSize = (width * bytesPerPixel + s_packAlignment - 1) / s_packAlignment * s_packAlignment;
+    memset(pixels, 0, rowSize * height);
+}
+
+static void GLAPIENTRY nullScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    NULL_GL_COUNT(glScissor);
+    s_scissorBox[0] = x;
+    s_scissorBox[1] = y;
+    s_scissorBox[2] = width;
+    s_scissorBox[3] = height;
+}
+
+static void GLAPIENTRY nullViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    NULL_GL_COUNT(glViewport);
+    s_viewport[0] = x;
+    s_viewport[1] = y;
+    s_viewport[2] = width;
+    s_viewport[3] = height;
+}
+
+//
+// OpenGL 1.2 and later, loaded by GLEW
+//
+static void GLAPIENTRY nullActiveTexture(GLenum) { NULL_GL_COUNT(glActiveTexture); }
+static void GLAPIENTRY nullBindVertexArray(GLuint) { NULL_GL_COUNT(glBindVertexArray); }
+static void GLAPIENTRY nullBlendEquation(GLenum) { NULL_GL_COUNT(glBlendEquation); }
+static void GLAPIENTRY nullBlendFuncSeparate(GLenum, GLenum, GLenum, GLenum) { NULL_GL_COUNT(glBlendFuncSeparate); }
+static void GLAPIENTRY nullBufferSubData(GLenum, GLintptr, GLsizeiptr, const GLvoid*) { NULL_GL_COUNT(glBufferSubData); }
+static void GLAPIENTRY nullCompileShader(GLuint) { NULL_GL_COUNT(glCompileShader); }
+static void GLAPIENTRY nullCompressedTexImage2D(GLenum, GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei, const GLvoid*) { NULL_GL_COUNT(glCompressedTexImage2D); }
+static void GLAPIENTRY nullDeleteFramebuffers(GLsizei, const GLuint*) { NULL_GL_COUNT(glDeleteFramebuffers); }
+static void GLAPIENTRY nullDeleteRenderbuffers(GLsizei, const GLuint*) { NULL_GL_COUNT(glDeleteRenderbuffers); }
+static void GLAPIENTRY nullDeleteVertexArrays(GLsizei, const GLuint*) { NULL_GL_COUNT(glDeleteVertexArrays); }
+static void GLAPIENTRY nullDisableVertexAttribArray(GLuint) { NULL_GL_COUNT(glDisableVertexAttribArray); }
+static void GLAPIENTRY nullEnableVertexAttribArray(GLuint) { NULL_GL_COUNT(glEnableVertexAttribArray); }
+static void GLAPIENTRY nullFlushMappedBufferRange(GLenum, GLintptr, GLsizeiptr) { NULL_GL_COUNT(glFlushMappedBufferRange); }
+static void GLAPIENTRY nullFramebufferRenderbuffer(GLenum, GLenum, GLenum, GLuint) { NULL_GL_COUNT(glFramebufferRenderbuffer); }
+static void GLAPIENTRY nullFramebufferTexture2D(GLenum, GLenum, GLenum, GLuint, GLint) { NULL_GL_COUNT(glFramebufferTexture2D); }
+static void GLAPIENTRY nullGenerateMipmap(GLenum) { NULL_GL_COUNT(glGenerateMipmap); }
+static void GLAPIENTRY nullRenderbufferStorage(GLenum, GLenum, GLsizei, GLsizei) { NULL_GL_COUNT(glRenderbufferStorage); }
+static void GLAPIENTRY nullVertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const GLvoid*) { NULL_GL_COUNT(glVertexAttribPointer); }
+static void GLAPIENTRY nullVertexAttribDivisor(GLuint, GLuint) { NULL_GL_COUNT(glVertexAttribDivisor); }
+static void GLAPIENTRY nullUniform1f(GLint, GLfloat) { NULL_GL_COUNT(glUniform1f); }
+static void GLAPIENTRY nullUniform2f(GLint, GLfloat, GLfloat) { NULL_GL_COUNT(glUniform2f); }
+static void GLAPIENTRY nullUniform3f(GLint, GLfloat, GLfloat, GLfloat) { NULL_GL_COUNT(glUniform3f); }
+static void GLAPIENTRY nullUniform4f(GLint, GLfloat, GLfloat, GLfloat, GLfloat) { NULL_GL_COUNT(glUniform4f); }
+static void GLAPIENTRY nullUniform1i(GLint, GLint) { NULL_GL_COUNT(glUniform1i); }
+static void GLAPIENTRY nullUniform2i(GLint, GLint, GLint) { NULL_GL_COUNT(glUniform2i); }
+static void GLAPIENTRY nullUniform3i(GLint, GLint, GLint, GLint) { NULL_GL_COUNT(glUniform3i); }
+static void GLAPIENTRY nullUniform4i(GLint, GLint, GLint, GLint, GLint) { NULL_GL_COUNT(glUniform4i); }
+static void GLAPIENTRY nullUniform1fv(GLint, GLsizei, const GLfloat*) { NULL_GL_COUNT(glUniform1fv); }
+static void GLAPIENTRY nullUniform2fv(GLint, GLsizei, const GLfloat*) { NULL_GL_COUNT(glUniform2fv); }
+static void GLAPIENTRY nullUniform3fv(GLint, GLsizei, const GLfloat*) { NULL_GL_COUNT(glUniform3fv); }
+static void GLAPIENTRY nullUniform4fv(GLint, GLsizei, const GLfloat*) { NULL_GL_COUNT(glUniform4fv); }
+static void GLAPIENTRY nullUniform1iv(GLint, GLsizei, const GLint*) { NULL_GL_COUNT(glUniform1iv); }
+static void GLAPIENTRY nullUniform2iv(GLint, GLsizei, const GLint*) { NULL_GL_COUNT(glUniform2iv); }
+static void GLAPIENTRY nullUniform3iv(GLint, GLsizei, const GLint*) { NULL_GL_COUNT(glUniform3iv); }
+static void GLAPIENTRY nullUniform4iv(GLint, GLsizei, const GLint*) { NULL_GL_COUNT(glUniform4iv); }
+static void GLAPIENTRY nullUniformMatrix2fv(GLint, GLsizei, GLboolean, const GLfloat*) { NULL_GL_COUNT(glUniformMatrix2fv); }
+static void GLAPIENTRY nullUniformMatrix3fv(GLint, GLsizei, GLboolean, const GLfloat*) { NULL_GL_COUNT(glUniformMatrix3fv); }
+static void GLAPIENTRY nullUniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat*) { NULL_GL_COUNT(glUniformMatrix4fv); }
+
+static void GLAPIENTRY nullGenBuffers(GLsizei n, GLuint* buffers)
+{
+    NULL_GL_COUNT(glGenBuffers);
+    genNames(n, buffers);
+}
+
+static void GLAPIENTRY nullGenFramebuffers(GLsizei n, GLuint* framebuffers)
+{
+    NULL_GL_COUNT(glGenFramebuffers);
+    genNames(n, framebuffers);
+}
+
+static void GLAPIENTRY nullGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+{
+    NULL_GL_COUNT(glGenRenderbuffers);
+    genNames(n, renderbuffers);
+}
+
+static void GLAPIENTRY nullGenVertexArrays(GLsizei n, GLuint* arrays)
+{
+    NULL_GL_COUNT(glGenVertexArrays);
+    genNames(n, arrays);
+}
+
+static void GLAPIENTRY nullDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    NULL_GL_COUNT(glDeleteBuffers);
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        s_bufferSizes.erase(buffers[i]);
+    }
+}
+
+static void GLAPIENTRY nullBindBuffer(GLenum target, GLuint buffer)
+{
+    NULL_GL_COUNT(glBindBuffer);
+    auto binding = getBufferBinding(target);
+    if (binding)
+        *binding = buffer;
+}
+
+static void GLAPIENTRY nullBufferData(GLenum target, GLsizeiptr size, const GLvoid*, GLenum)
+{
+    NULL_GL_COUNT(glBufferData);
+    auto binding = getBufferBinding(target);
+    if (binding)
+        s_bufferSizes[*binding] = size;
+}
+
+static GLvoid* GLAPIENTRY nullMapBuffer(GLenum target, GLenum)
+{
+    NULL_GL_COUNT(glMapBuffer);
+    auto binding = getBufferBinding(target);
+    GLsizeiptr size = binding ? s_bufferSizes[*binding] : 0;
+    s_mappedBuffer.resize(std::max(size, (GLsizeiptr)1));
+    return s_mappedBuffer.data();
+}
+
+static GLvoid* GLAPIENTRY nullMapBufferRange(GLenum, GLintptr, GLsizeiptr length, GLbitfield)
+{
+    NULL_GL_COUNT(glMapBufferRange);
+    s_mappedBuffer.resize(std::max(length, (GLsizeiptr)1));
+    return s_mappedBuffer.data();
+}
+
+static GLboolean GLAPIENTRY nullUnmapBuffer(GLenum)
+{
+    NULL_GL_COUNT(glUnmapBuffer);
+    return GL_TRUE;
+}
+
+static void GLAPIENTRY nullBindFramebuffer(GLenum, GLuint framebuffer)
+{
+    NULL_GL_COUNT(glBindFramebuffer);
+    s_framebuffer = framebuffer;
+}
+
+static void GLAPIENTRY nullBindRenderbuffer(GLenum, GLuint renderbuffer)
+{
+    NULL_GL_COUNT(glBindRenderbuffer);
+    s_renderbuffer = renderbuffer;
+}
+
+static GLenum GLAPIENTRY nullCheckFramebufferStatus(GLenum)
+{
+    NULL_GL_COUNT(glCheckFramebufferStatus);
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+static GLuint GLAPIENTRY nullCreateShader(GLenum type)
+{
+    NULL_GL_COUNT(glCreateShader);
+    GLuint shader = ++s_lastName;
+    s_shaders[shader].type = type;
+    return shader;
+}
+
+static void GLAPIENTRY nullDeleteShader(GLuint shader)
+{
+    NULL_GL_COUNT(glDeleteShader);
+    s_shaders.erase(shader);
+}
+
+static void GLAPIENTRY nullShaderSource(GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths)
+{
+    NULL_GL_COUNT(glShaderSource);
+    std::string source;
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (lengths && lengths[i] >= 0)
+            source.append(strings[i], lengths[i]);
+        else
+            source.append(strings[i]);
+    }
+    s_shaders[shader].source = source;
+}
+
+static void GLAPIENTRY nullGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    NULL_GL_COUNT(glGetShaderiv);
+    switch (pname)
+    {
+        case GL_COMPILE_STATUS:
+            params[0] = GL_TRUE;
+            break;
+        case GL_SHADER_TYPE:
+            params[0] = s_shaders[shader].type;
+            break;
+        case GL_SHADER_SOURCE_LENGTH:
+            params[0] = (GLint)s_shaders[shader].source.size() + 1;
+            break;
+        default:
+            params[0] = 0;
+            break;
+    }
+}
+
+static void GLAPIENTRY nullGetShaderSource(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* source)
+{
+    NULL_GL_COUNT(glGetShaderSource);
+    copyString(s_shaders[shader].source, bufSize, length, source);
+}
+
+static void GLAPIENTRY nullGetShaderInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    NULL_GL_COUNT(glGetShaderInfoLog);
+    copyString("", bufSize, length, infoLog);
+}
+
+static GLuint GLAPIENTRY nullCreateProgram()
+{
+    NULL_GL_COUNT(glCreateProgram);
+    GLuint program = ++s_lastName;
+    s_programs[program];
+    return program;
+}
+
+static void GLAPIENTRY nullDeleteProgram(GLuint program)
+{
+    NULL_GL_COUNT(glDeleteProgram);
+    s_programs.erase(program);
+}
+
+static void GLAPIENTRY nullAttachShader(GLuint program, GLuint shader)
+{
+    NULL_GL_COUNT(glAttachShader);
+    s_programs[program].shaders.push_back(shader);
+}
+
+static void GLAPIENTRY nullBindAttribLocation(GLuint program, GLuint index, const GLchar* name)
+{
+    NULL_GL_COUNT(glBindAttribLocation);
+    s_programs[program].attribBindings[name] = index;
+}
+
+static void GLAPIENTRY nullLinkProgram(GLuint program)
+{
+    NULL_GL_COUNT(glLinkProgram);
+    auto& p = s_programs[program];
+    p.attributes.clear();
+    p.uniforms.clear();
+
+    for (auto shader : p.shaders)
+    {
+        const auto& source = s_shaders[shader].source;
+        parseDeclarations(source, "attribute", p.attributes);
+        parseDeclarations(source, "uniform", p.uniforms);
+    }
+
+    // bound attributes keep their location, the others take the free ones
+    std::unordered_set<GLint> usedLocations;
+    for (auto& attribute : p.attributes)
+    {
+        auto binding = p.attribBindings.find(attribute.name);
+        if (binding != p.attribBindings.end())
+        {
+            attribute.location = binding->second;
+            usedLocations.insert(attribute.location);
+        }
+    }
+    GLint nextLocation = 0;
+    for (auto& attribute : p.attributes)
+    {
+        if (attribute.location >= 0)
+            continue;
+        while (usedLocations.count(nextLocation))
+            ++nextLocation;
+        attribute.location = nextLocation++;
+    }
+
+    GLint location = 0;
+    for (auto& uniform : p.uniforms)
+    {
+        uniform.location = location;
+        location += uniform.size;
+    }
+}
+
+static void GLAPIENTRY nullGetProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+    NULL_GL_COUNT(glGetProgramiv);
+    const auto& p = s_programs[program];
+    switch (pname)
+    {
+        case GL_LINK_STATUS:
+        case GL_VALIDATE_STATUS:
+            params[0] = GL_TRUE;
+            break;
+        case GL_ATTACHED_SHADERS:
+            params[0] = (GLint)p.shaders.size();
+            break;
+        case GL_ACTIVE_ATTRIBUTES:
+            params[0] = (GLint)p.attributes.size();
+            break;
+        case GL_ACTIVE_ATTRIBUTE_MAX_LENGTH:
+            params[0] = getMaxActiveNameLength(p.attributes);
+            break;
+        case GL_ACTIVE_UNIFORMS:
+            params[0] = (GLint)p.uniforms.size();
+            break;
+        case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+            params[0] = getMaxActiveNameLength(p.uniforms);
+            break;
+        default:
+            params[0] = 0;
+            break;
+    }
+}
+
+static void GLAPIENTRY nullGetProgramInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    NULL_GL_COUNT(glGetProgramInfoLog);
+    copyString("", bufSize, length, infoLog);
+}
+
+static void GLAPIENTRY nullGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    NULL_GL_COUNT(glGetActiveAttrib);
+    getActiveVariable(s_programs[program].attributes, index, bufSize, length, size, type, name);
+}
+
+static void GLAPIENTRY nullGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    NULL_GL_COUNT(glGetActiveUniform);
+    getActiveVariable(s_programs[program].uniforms, index, bufSize, length, size, type, name);
+}
+
+static GLint GLAPIENTRY nullGetAttribLocation(GLuint program, const GLchar* name)
+{
+    NULL_GL_COUNT(glGetAttribLocation);
+    return findLocation(s_programs[program].attributes, name);
+}
+
+static GLint GLAPIENTRY nullGetUniformLocation(GLuint program, const GLchar* name)
+{
+    NULL_GL_COUNT(glGetUniformLocation);
+    return findLocation(s_programs[program].uniforms, name);
+}
+
+static void GLAPIENTRY nullUseProgram(GLuint program)
+{
+    NULL_GL_COUNT(glUseProgram);
+    s_currentProgram = program;
+}
+
+namespace GLNull {
+
+void install()
+{
+    if (s_installed)
+        return;
+    s_installed = true;
+
+    ccglAlphaFunc = nullAlphaFunc;
+    ccglBindTexture = nullBindTexture;
+    ccglBlendFunc = nullBlendFunc;
+    ccglClear = nullClear;
+    ccglClearColor = nullClearColor;
+    ccglClearDepth = nullClearDepth;
+    ccglClearStencil = nullClearStencil;
+    ccglColorMask = nullColorMask;
+    ccglDeleteTextures = nullDeleteTextures;
+    ccglDepthFunc = nullDepthFunc;
+    ccglDepthMask = nullDepthMask;
+    ccglDepthRange = nullDepthRange;
+    ccglDisable = nullDisable;
+    ccglDrawArrays = nullDrawArrays;
+    ccglDrawElements = nullDrawElements;
+    ccglEnable = nullEnable;
+    ccglFinish = nullFinish;
+    ccglFlush = nullFlush;
+    ccglGenTextures = nullGenTextures;
+    ccglGetBooleanv = nullGetBooleanv;
+    ccglGetError = nullGetError;
+    ccglGetFloatv = nullGetFloatv;
+    ccglGetIntegerv = nullGetIntegerv;
+    ccglGetString = nullGetString;
+    ccglHint = nullHint;
+    ccglIsEnabled = nullIsEnabled;
+    ccglLineWidth = nullLineWidth;
+    ccglPixelStorei = nullPixelStorei;
+    ccglPointSize = nullPointSize;
+    ccglPolygonOffset = nullPolygonOffset;
+    ccglReadPixels = nullReadPixels;
+    ccglScissor = nullScissor;
+    ccglStencilFunc = nullStencilFunc;
+    ccglStencilMask = nullStencilMask;
+    ccglStencilOp = nullStencilOp;
+    ccglTexImage2D = nullTexImage2D;
+    ccglTexParameteri = nullTexParameteri;
+    ccglTexSubImage2D = nullTexSubImage2D;
+    ccglViewport = nullViewport;
+
+    glActiveTexture = nullActiveTexture;
+    glAttachShader = nullAttachShader;
+    glBindAttribLocation = nullBindAttribLocation;
+    glBindBuffer = nullBindBuffer;
+    glBindFramebuffer = nullBindFramebuffer;
+    glBindRenderbuffer = nullBindRenderbuffer;
+    glBindVertexArray = nullBindVertexArray;
+    glBlendEquation = nullBlendEquation;
+    glBlendFuncSeparate = nullBlendFuncSeparate;
+    glBufferData = nullBufferData;
+    glBufferSubData = nullBufferSubData;
+    glCheckFramebufferStatus = nullCheckFramebufferStatus;
+    glCompileShader = nullCompileShader;
+    glCompressedTexImage2D = nullCompressedTexImage2D;
+    glCreateProgram = nullCreateProgram;
+    glCreateShader = nullCreateShader;
+    glDeleteBuffers = nullDeleteBuffers;
+    glDeleteFramebuffers = nullDeleteFramebuffers;
+    glDeleteProgram = nullDeleteProgram;
+    glDeleteRenderbuffers = nullDeleteRenderbuffers;
+    glDeleteShader = nullDeleteShader;
+    glDeleteVertexArrays = nullDeleteVertexArrays;
+    glDisableVertexAttribArray = nullDisableVertexAttribArray;
+    glEnableVertexAttribArray = nullEnableVertexAttribArray;
+    glFlushMappedBufferRange = nullFlushMappedBufferRange;
+    glFramebufferRenderbuffer = nullFramebufferRenderbuffer;
+    glFramebufferTexture2D = nullFramebufferTexture2D;
+    glGenBuffers = nullGenBuffers;
+    glGenFramebuffers = nullGenFramebuffers;
+    glGenRenderbuffers = nullGenRenderbuffers;
+    glGenVertexArrays = nullGenVertexArrays;
+    glGenerateMipmap = nullGenerateMipmap;
+    glGetActiveAttrib = nullGetActiveAttrib;
+    glGetActiveUniform = nullGetActiveUniform;
+    glGetAttribLocation = nullGetAttribLocation;
+    glGetProgramInfoLog = nullGetProgramInfoLog;
+    glGetProgramiv = nullGetProgramiv;
+    glGetShaderInfoLog = nullGetShaderInfoLog;
+    glGetShaderSource = nullGetShaderSource;
+    glGetShaderiv = nullGetShaderiv;
+    glGetUniformLocation = nullGetUniformLocation;
+    glLinkProgram = nullLinkProgram;
+    glMapBuffer = nullMapBuffer;
+    glMapBufferRange = nullMapBufferRange;
+    glRenderbufferStorage = nullRenderbufferStorage;
+    glShaderSource = nullShaderSource;
+    glUniform1f = nullUniform1f;
+    glUniform2f = nullUniform2f;
+    glUniform3f = nullUniform3f;
+    glUniform4f = nullUniform4f;
+    glUniform1i = nullUniform1i;
+    glUniform2i = nullUniform2i;
+    glUniform3i = nullUniform3i;
+    glUniform4i = nullUniform4i;
+    glUniform1fv = nullUniform1fv;
+    glUniform2fv = nullUniform2fv;
+    glUniform3fv = nullUniform3fv;
+    glUniform4fv = nullUniform4fv;
+    glUniform1iv = nullUniform1iv;
+    glUniform2iv = nullUniform2iv;
+    glUniform3iv = nullUniform3iv;
+    glUniform4iv = nullUniform4iv;
+    glUniformMatrix2fv = nullUniformMatrix2fv;
+    glUniformMatrix3fv = nullUniformMatrix3fv;
+    glUniformMatrix4fv = nullUniformMatrix4fv;
+    glUnmapBuffer = nullUnmapBuffer;
+    glUseProgram = nullUseProgram;
+    glVertexAttribPointer = nullVertexAttribPointer;
+    glVertexAttribDivisorARB = nullVertexAttribDivisor;
+    glDrawArraysInstancedARB = nullDrawArraysInstanced;
+}
+
+bool isInstalled()
+{
+    return s_installed;
+}
+
+unsigned int getCallCount(const std::string& function)
+{
+    for (auto counter : getCounters())
+    {
+        if (function == counter->name)
+            return counter->count;
+    }
+    return 0;
+}
+
+unsigned int getTotalCallCount()
+{
+    unsigned int total = 0;
+    for (auto counter : getCounters())
+    {
+        total += counter->count;
+    }
+    return total;
+}
+
+void resetCallCounts()
+{
+    for (auto counter : getCounters())
+    {
+        counter->count = 0;
+    }
+}
+
+std::string getCallCountsDescription()
+{
+    auto counters = getCounters();
+    std::sort(counters.begin(), counters.end(), [](const NullGLCounter* a, const NullGLCounter* b){ return a->count > b->count; });
+
+    std::stringstream description;
+    for (auto counter : counters)
+    {
+        if (counter->count > 0)
+            description << counter->name << " " << counter->count << "\n";
+    }
+    return description.str();
+}
+
+} // namespace GLNull
+
+NS_CC_END
@@ -0,0 +1,71 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_GL_NULL_H__
+#define __CC_GL_NULL_H__
+
+#include "base/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX && CC_USE_HEADLESS
+
+#include "base/CCPlatformMacros.h"
+#include <string>
+
+NS_CC_BEGIN
+
+/** No-op OpenGL used to run the engine without a GPU.
+
+ Every GL entry point used by the engine is replaced by a stub that counts the
+ call and returns plausible values: ids are generated, shaders compile and link,
+ the uniforms and attributes declared in the shader sources are reported as
+ active, and mapped buffers point to scratch memory. Nothing is drawn.
+ */
+namespace GLNull {
+
+/** Points the GL entry points at the stubs.
+ It must be called before the first GL call, and can't be undone.
+ */
+void CC_DLL install();
+
+/** Returns whether the stubs are installed */
+bool CC_DLL isInstalled();
+
+/** Returns the number of calls made to `function` (e.g. "glDrawElements") since the last reset */
+unsigned int CC_DLL getCallCount(const std::string& function);
+
+/** Returns the number of GL calls made since the last reset */
+unsigned int CC_DLL getTotalCallCount();
+
+/** Sets all the call counters back to 0 */
+void CC_DLL resetCallCounts();
+
+/** Returns one "name count" line per called function, most called first */
+std::string CC_DLL getCallCountsDescription();
+
+} // namespace GLNull
+
+NS_CC_END
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX && CC_USE_HEADLESS
+
+#endif // __CC_GL_NULL_H__
@@ -0,0 +1,181 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "CCGLViewHeadless.h"
+#include "CCGLNull.h"
+#include "CCGL.h"
+#include "base/ccMacros.h"
+
+#if CC_USE_OSMESA
+#include <GL/osmesa.h>
+#endif
+
+NS_CC_BEGIN
+
+GLViewHeadless* GLViewHeadless::create(const std::string& viewName, const Size& frameSize, Backend backend)
+{
+    auto ret = new GLViewHeadless;
+    if(ret && ret->initWithSize(viewName, frameSize, backend)) {
+        ret->autorelease();
+        return ret;
+    }
+
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+bool GLViewHeadless::getBackendByName(const std::string& name, Backend* backend)
+{
+    if (name == "null")
+    {
+        *backend = Backend::NULL_GL;
+        return true;
+    }
+    if (name == "osmesa")
+    {
+        *backend = Backend::OSMESA;
+        return true;
+    }
+    return false;
+}
+
+GLViewHeadless::GLViewHeadless()
+: _backend(Backend::NULL_GL)
+, _ready(false)
+, _frameLimit(0)
+, _frameCount(0)
+, _osmesaContext(nullptr)
+{
+}
+
+GLViewHeadless::~GLViewHeadless()
+{
+#if CC_USE_OSMESA
+    if (_osmesaContext)
+    {
+        OSMesaDestroyContext((OSMesaContext)_osmesaContext);
+    }
+#endif
+}
+
+bool GLViewHeadless::initWithSize(const std::string& viewName, const Size& frameSize, Backend backend)
+{
+    setViewName(viewName);
+    _backend = backend;
+
+    if (_backend == Backend::OSMESA)
+    {
+#if CC_USE_OSMESA
+        _osmesaContext = OSMesaCreateContextExt(OSMESA_RGBA, 24, 8, 0, nullptr);
+        if (!_osmesaContext)
+        {
+            CCLOGERROR("GLViewHeadless: could not create the OSMesa context");
+            return false;
+        }
+
+        // makes the context current
+        setFrameSize(frameSize.width, frameSize.height);
+
+        // GLEW loads the entry points through GLX, which Mesa resolves for the current OSMesa context.
+        // Without an X display GLEW also reports that it couldn't load the GLX extensions: they aren't needed.
+        GLenum result = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+        if (result == GLEW_ERROR_NO_GLX_DISPLAY)
+            result = GLEW_OK;
+#endif
+        if (result != GLEW_OK)
+        {
+            CCLOGERROR("GLViewHeadless: glewInit failed: %s", (const char*)glewGetErrorString(result));
+            return false;
+        }
+#else
+        CCLOGERROR("GLViewHeadless: OSMesa isn't available, build with -DUSE_OSMESA=ON");
+        return false;
+#endif
+    }
+    else
+    {
+        GLNull::install();
+        setFrameSize(frameSize.width, frameSize.height);
+    }
+
+    // same as GLView
+    glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
+
+    _ready = true;
+    return true;
+}
+
+const unsigned char* GLViewHeadless::getPixels() const
+{
+    return _pixels.empty() ? nullptr : _pixels.data();
+}
+
+bool GLViewHeadless::isOpenGLReady()
+{
+    return _ready;
+}
+
+void GLViewHeadless::end()
+{
+    _ready = false;
+    // Release self. Otherwise, GLViewHeadless could not be freed.
+    release();
+}
+
+void GLViewHeadless::swapBuffers()
+{
+    // there is nothing to present, but the frame has to be finished to be timed
+    if (_backend == Backend::OSMESA)
+        glFinish();
+
+    ++_frameCount;
+}
+
+void GLViewHeadless::setFrameSize(float width, float height)
+{
+    GLViewProtocol::setFrameSize(width, height);
+
+#if CC_USE_OSMESA
+    if (_osmesaContext)
+    {
+        int w = (int)width;
+        int h = (int)height;
+        _pixels.resize(w * h * 4);
+        OSMesaMakeCurrent((OSMesaContext)_osmesaContext, _pixels.data(), GL_UNSIGNED_BYTE, w, h);
+    }
+#endif
+}
+
+bool GLViewHeadless::windowShouldClose()
+{
+    return !_ready || (_frameLimit > 0 && _frameCount >= _frameLimit);
+}
+
+void GLViewHeadless::pollEvents()
+{
+}
+
+NS_CC_END
@@ -0,0 +1,107 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_GLVIEW_HEADLESS_H__
+#define __CC_GLVIEW_HEADLESS_H__
+
+#include "base/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX && CC_USE_HEADLESS
+
+#include "2d/platform/desktop/CCGLView.h"
+#include <vector>
+
+NS_CC_BEGIN
+
+/** GLView without a window, used to run and time the engine on machines without a display or a GPU.
+
+ It renders with one of these backends, chosen when the view is created:
+ - NULL_GL: the GL calls go to GLNull, they are counted and nothing is drawn. Measures the CPU side of the engine.
+ - OSMESA: Mesa's software rasterizer draws into memory, see getPixels(). Only available when built with USE_OSMESA.
+
+ It has to be given to the Director before the application creates its own view:
+
+     auto glview = GLViewHeadless::create("Cpp Tests", Size(960, 640), GLViewHeadless::Backend::NULL_GL);
+     Director::getInstance()->setOpenGLView(glview);
+ */
+class CC_DLL GLViewHeadless : public GLView
+{
+public:
+    enum class Backend
+    {
+        NULL_GL,
+        OSMESA,
+    };
+
+    static GLViewHeadless* create(const std::string& viewName, const Size& frameSize, Backend backend);
+
+    /** Finds the backend called `name` ("null" or "osmesa"). Returns false if there is none. */
+    static bool getBackendByName(const std::string& name, Backend* backend);
+
+    Backend getBackend() const { return _backend; }
+
+    /** Once `frames` frames were swapped windowShouldClose() returns true, so that the application quits.
+     0, the default, never quits.
+     */
+    void setFrameLimit(unsigned int frames) { _frameLimit = frames; }
+    unsigned int getFrameLimit() const { return _frameLimit; }
+
+    /** Number of frames swapped so far */
+    unsigned int getFrameCount() const { return _frameCount; }
+
+    /** The RGBA8888 color buffer drawn by OSMesa, bottom row first. nullptr with NULL_GL */
+    const unsigned char* getPixels() const;
+
+    /* override functions */
+    virtual bool isOpenGLReady() override;
+    virtual void end() override;
+    virtual void swapBuffers() override;
+    virtual void setFrameSize(float width, float height) override;
+    virtual bool windowShouldClose() override;
+    virtual void pollEvents() override;
+
+protected:
+    GLViewHeadless();
+    virtual ~GLViewHeadless();
+
+    bool initWithSize(const std::string& viewName, const Size& frameSize, Backend backend);
+
+    Backend _backend;
+    bool _ready;
+    unsigned int _frameLimit;
+    unsigned int _frameCount;
+
+    // OSMesaContext, not spelled out so that this header doesn't need osmesa.h
+    void* _osmesaContext;
+    std::vector<unsigned char> _pixels;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(GLViewHeadless);
+};
+
+NS_CC_END
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX && CC_USE_HEADLESS
+
+#endif // __CC_GLVIEW_HEADLESS_H__
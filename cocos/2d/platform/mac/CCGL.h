@@ -43,6 +43,17 @@ THE SOFTWARE.
 #define glDepthRangef                   glDepthRange
 #define glReleaseShaderCompiler(xxx)
 
+// GL_ARB_instanced_arrays and GL_ARB_draw_instanced
+#define glVertexAttribDivisor           glVertexAttribDivisorARB
+#define glDrawArraysInstanced           glDrawArraysInstancedARB
+#define CC_GL_INSTANCED_ARRAYS          1
+
+// glBeginQuery and friends are part of OpenGL 1.5, GL_ARB_occlusion_query tells whether they work
+#define CC_GL_OCCLUSION_QUERY           1
+
+// GL_PIXEL_PACK_BUFFER is part of OpenGL 2.1, GL_ARB_sync is not available in legacy contexts
+#define CC_GL_PIXEL_BUFFER              1
+
 
 #endif // __PLATFORM_MAC_CCGL_H__
 
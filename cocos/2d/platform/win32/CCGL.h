@@ -33,6 +33,27 @@ THE SOFTWARE.
 
 #define CC_GL_DEPTH24_STENCIL8		GL_DEPTH24_STENCIL8
 
+// glMapBufferRange is loaded by GLEW
+#define CC_GL_MAP_BUFFER_RANGE      1
+
+// GL_ARB_instanced_arrays is loaded by GLEW. OpenGL 2.1 contexts only have the ARB entry points,
+// the core ones are left null: always call the ARB ones.
+#undef glVertexAttribDivisor
+#undef glDrawArraysInstanced
+#define glVertexAttribDivisor       glVertexAttribDivisorARB
+#define glDrawArraysInstanced       glDrawArraysInstancedARB
+#define CC_GL_INSTANCED_ARRAYS      1
+
+// GL_ARB_get_program_binary is loaded by GLEW, it uses the core names
+#define CC_GL_PROGRAM_BINARY        1
+
+// glBeginQuery and friends are part of OpenGL 1.5, GL_ARB_occlusion_query tells whether they work
+#define CC_GL_OCCLUSION_QUERY       1
+
+// GL_ARB_pixel_buffer_object and GL_ARB_sync are loaded by GLEW
+#define CC_GL_PIXEL_BUFFER          1
+#define CC_GL_FENCE_SYNC            1
+
 // These macros are only for making TexturePVR.cpp complied without errors since they are not included in GLEW.
 #define GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG                      0x8C00
 #define GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG                      0x8C01
@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include "CCSet.h"
 #include "ccMacros.h"
 #include "CCDirector.h"
+#include "ccGLStateCache.h"
 #include "CCTouch.h"
 #include "CCIMEDispatcher.h"
 #include "CCApplication.h"
@@ -477,14 +478,14 @@ void GLView::setViewPortInPoints(float x , float y , float w , float h)
 	{
 		case DisplayOrientations::Landscape:
 		case DisplayOrientations::LandscapeFlipped:
-            glViewport((GLint)(y * _scaleY + _viewPortRect.origin.y),
+            GL::viewport((GLint)(y * _scaleY + _viewPortRect.origin.y),
                        (GLint)(x * _scaleX + _viewPortRect.origin.x),
                        (GLsizei)(h * _scaleY),
                        (GLsizei)(w * _scaleX));
 			break;
 
         default:
-            glViewport((GLint)(x * _scaleX + _viewPortRect.origin.x),
+            GL::viewport((GLint)(x * _scaleX + _viewPortRect.origin.x),
                        (GLint)(y * _scaleY + _viewPortRect.origin.y),
                        (GLsizei)(w * _scaleX),
                        (GLsizei)(h * _scaleY));
@@ -497,14 +498,14 @@ void GLView::setScissorInPoints(float x , float y , float w , float h)
 	{
 		case DisplayOrientations::Landscape:
 		case DisplayOrientations::LandscapeFlipped:
-            glScissor((GLint)(y * _scaleX + _viewPortRect.origin.y),
+            GL::scissor((GLint)(y * _scaleX + _viewPortRect.origin.y),
                        (GLint)((_viewPortRect.size.width - ((x + w) * _scaleX)) + _viewPortRect.origin.x),
                        (GLsizei)(h * _scaleY),
                        (GLsizei)(w * _scaleX));
 			break;
 
         default:
-            glScissor((GLint)(x * _scaleX + _viewPortRect.origin.x),
+            GL::scissor((GLint)(x * _scaleX + _viewPortRect.origin.x),
                        (GLint)(y * _scaleY + _viewPortRect.origin.y),
                        (GLsizei)(w * _scaleX),
                        (GLsizei)(h * _scaleY));
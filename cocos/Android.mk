@@ -56,17 +56,21 @@ cocos2d.cpp \
 2d/CCParticleExamples.cpp \
 2d/CCParticleSystem.cpp \
 2d/CCParticleSystemQuad.cpp \
+2d/CCParticleSystemGPU.cpp \
+2d/CCParticleSystemCache.cpp \
 2d/CCProgressTimer.cpp \
 2d/CCRenderTexture.cpp \
 2d/CCScene.cpp \
 2d/CCScriptSupport.cpp \
 2d/CCSpriteBatchNode.cpp \
 2d/CCSprite.cpp \
+2d/CCStaticBatchNode.cpp \
 2d/CCSpriteFrameCache.cpp \
 2d/CCSpriteFrame.cpp \
 2d/CCTextFieldTTF.cpp \
 2d/CCTexture2D.cpp \
 2d/CCTextureAtlas.cpp \
+2d/CCDynamicAtlas.cpp \
 2d/CCTextureCache.cpp \
 2d/CCTileMapAtlas.cpp \
 2d/CCTMXLayer.cpp \
@@ -121,6 +125,7 @@ base/CCEventFocus.cpp \
 base/CCEventListenerFocus.cpp \
 base/CCNS.cpp \
 base/CCProfiling.cpp \
+base/CCWorkerPool.cpp \
 base/CCRef.cpp \
 base/CCScheduler.cpp \
 base/CCTouch.cpp \
@@ -139,9 +144,13 @@ renderer/CCGLProgramStateCache.cpp \
 renderer/ccGLStateCache.cpp \
 renderer/CCGroupCommand.cpp \
 renderer/CCQuadCommand.cpp \
+renderer/CCTrianglesCommand.cpp \
+renderer/CCFrameAllocator.cpp \
+renderer/CCRenderCapture.cpp \
 renderer/CCRenderCommand.cpp \
 renderer/CCRenderer.cpp \
 renderer/CCGLProgramCache.cpp \
+renderer/CCGLProgramBinaryCache.cpp \
 renderer/ccShaders.cpp \
 deprecated/CCArray.cpp \
 deprecated/CCSet.cpp \
@@ -47,6 +47,13 @@ Configuration::Configuration()
 , _supportsBGRA8888(false)
 , _supportsDiscardFramebuffer(false)
 , _supportsShareableVAO(false)
+, _supportsMapBufferRange(false)
+, _supportsElementIndexUint(false)
+, _supportsInstancedArrays(false)
+, _supportsProgramBinary(false)
+, _supportsOcclusionQuery(false)
+, _supportsPixelBufferObject(false)
+, _supportsFenceSync(false)
 , _maxSamplesAllowed(0)
 , _maxTextureUnits(0)
 , _glExtensions(nullptr)
@@ -142,6 +149,52 @@ void Configuration::gatherGPUInfo()
     _supportsShareableVAO = checkForGLExtension("vertex_array_object");
 	_valueDict["gl.supports_vertex_array_object"] = Value(_supportsShareableVAO);
 
+    // GL_ARB_map_buffer_range on desktop, GL_EXT_map_buffer_range on ES 2.0
+    _supportsMapBufferRange = checkForGLExtension("map_buffer_range");
+    _valueDict["gl.supports_map_buffer_range"] = Value(_supportsMapBufferRange);
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    _supportsElementIndexUint = true;
+#else
+    _supportsElementIndexUint = checkForGLExtension("GL_OES_element_index_uint");
+#endif
+    _valueDict["gl.supports_element_index_uint"] = Value(_supportsElementIndexUint);
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    _supportsInstancedArrays = checkForGLExtension("GL_ARB_instanced_arrays");
+#else
+    _supportsInstancedArrays = checkForGLExtension("GL_EXT_instanced_arrays");
+#endif
+    _valueDict["gl.supports_instanced_arrays"] = Value(_supportsInstancedArrays);
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    _supportsProgramBinary = checkForGLExtension("GL_ARB_get_program_binary");
+#else
+    _supportsProgramBinary = checkForGLExtension("GL_OES_get_program_binary");
+#endif
+#ifdef CC_GL_PROGRAM_BINARY
+    // some drivers expose the extension without any binary format
+    if (_supportsProgramBinary)
+    {
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        _supportsProgramBinary = formats > 0;
+    }
+#endif
+    _valueDict["gl.supports_program_binary"] = Value(_supportsProgramBinary);
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    _supportsOcclusionQuery = checkForGLExtension("GL_ARB_occlusion_query");
+#endif
+    _valueDict["gl.supports_occlusion_query"] = Value(_supportsOcclusionQuery);
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    _supportsPixelBufferObject = checkForGLExtension("GL_ARB_pixel_buffer_object");
+    _supportsFenceSync = checkForGLExtension("GL_ARB_sync");
+#endif
+    _valueDict["gl.supports_pixel_buffer_object"] = Value(_supportsPixelBufferObject);
+    _valueDict["gl.supports_fence_sync"] = Value(_supportsFenceSync);
+
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -247,6 +300,65 @@ bool Configuration::supportsShareableVAO() const
 #endif
 }
 
+bool Configuration::supportsMapBufferRange() const
+{
+#ifdef CC_GL_MAP_BUFFER_RANGE
+    return _supportsMapBufferRange;
+#else
+    return false;
+#endif
+}
+
+bool Configuration::supportsElementIndexUint() const
+{
+    return _supportsElementIndexUint;
+}
+
+bool Configuration::supportsInstancedArrays() const
+{
+#ifdef CC_GL_INSTANCED_ARRAYS
+    return _supportsInstancedArrays;
+#else
+    return false;
+#endif
+}
+
+bool Configuration::supportsProgramBinary() const
+{
+#ifdef CC_GL_PROGRAM_BINARY
+    return _supportsProgramBinary;
+#else
+    return false;
+#endif
+}
+
+bool Configuration::supportsOcclusionQuery() const
+{
+#ifdef CC_GL_OCCLUSION_QUERY
+    return _supportsOcclusionQuery;
+#else
+    return false;
+#endif
+}
+
+bool Configuration::supportsPixelBufferObject() const
+{
+#ifdef CC_GL_PIXEL_BUFFER
+    return _supportsPixelBufferObject;
+#else
+    return false;
+#endif
+}
+
+bool Configuration::supportsFenceSync() const
+{
+#ifdef CC_GL_FENCE_SYNC
+    return _supportsFenceSync;
+#else
+    return false;
+#endif
+}
+
 //
 // generic getters for properties
 //
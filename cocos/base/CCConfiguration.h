@@ -110,6 +110,47 @@ public:
      */
 	bool supportsShareableVAO() const;
 
+    /** Whether or not glMapBufferRange is supported (unsynchronized writes into a buffer object).
+     @since v3.2
+     */
+    bool supportsMapBufferRange() const;
+
+    /** Whether or not GL_UNSIGNED_INT indices can be used with glDrawElements.
+     Always supported by desktop OpenGL, OpenGL ES 2.0 needs GL_OES_element_index_uint.
+     @since v3.2
+     */
+    bool supportsElementIndexUint() const;
+
+    /** Whether or not instanced arrays are supported (glVertexAttribDivisor and glDrawArraysInstanced).
+     Desktop OpenGL needs GL_ARB_instanced_arrays, OpenGL ES 2.0 needs GL_EXT_instanced_arrays.
+     @since v3.2
+     */
+    bool supportsInstancedArrays() const;
+
+    /** Whether or not linked programs can be saved and loaded (glGetProgramBinary and glProgramBinary).
+     Desktop OpenGL needs GL_ARB_get_program_binary, OpenGL ES 2.0 needs GL_OES_get_program_binary.
+     @since v3.2
+     */
+    bool supportsProgramBinary() const;
+
+    /** Whether or not occlusion queries can count the samples that pass the depth and stencil tests (GL_SAMPLES_PASSED).
+     Desktop OpenGL needs GL_ARB_occlusion_query, OpenGL ES 2.0 has no equivalent.
+     @since v3.2
+     */
+    bool supportsOcclusionQuery() const;
+
+    /** Whether or not glReadPixels can write into a buffer object bound to GL_PIXEL_PACK_BUFFER, without waiting for the GPU.
+     Desktop OpenGL needs GL_ARB_pixel_buffer_object, OpenGL ES 2.0 has no equivalent.
+     @since v3.2
+     */
+    bool supportsPixelBufferObject() const;
+
+    /** Whether or not fences can tell when the GPU is done with the commands issued before them (glFenceSync).
+     Desktop OpenGL needs GL_ARB_sync, OpenGL ES 2.0 has no equivalent.
+     @since v3.2
+     */
+    bool supportsFenceSync() const;
+
     /** returns whether or not an OpenGL is supported */
     bool checkForGLExtension(const std::string &searchName) const;
 
@@ -146,6 +187,13 @@ protected:
     bool            _supportsBGRA8888;
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
+    bool            _supportsMapBufferRange;
+    bool            _supportsElementIndexUint;
+    bool            _supportsInstancedArrays;
+    bool            _supportsProgramBinary;
+    bool            _supportsOcclusionQuery;
+    bool            _supportsPixelBufferObject;
+    bool            _supportsFenceSync;
     GLint           _maxSamplesAllowed;
     GLint           _maxTextureUnits;
     char *          _glExtensions;
@@ -63,6 +63,7 @@
 #include "2d/CCTextureCache.h"
 #include "CCGLView.h"
 #include "base/base64.h"
+#include "renderer/CCRenderer.h"
 NS_CC_BEGIN
 
 //TODO: these general utils should be in a seperate class
@@ -267,6 +268,7 @@ Console::Console()
 {
     // VS2012 doesn't support initializer list, so we create a new array and assign its elements to '_command'.
 	Command commands[] = {     
+        { "capture", "Record the render commands of the next frames, see RenderReplay. Args: [frames [filename]]", std::bind(&Console::commandCapture, this, std::placeholders::_1, std::placeholders::_2) },
         { "config", "Print the Configuration object", std::bind(&Console::commandConfig, this, std::placeholders::_1, std::placeholders::_2) },
         { "debugmsg", "Whether or not to forward the debug messages on the console. Args: [on | off]", [&](int fd, const std::string& args) {
             if( args.compare("on")==0 || args.compare("off")==0) {
@@ -287,6 +289,7 @@ Console::Console()
                 mydprintf(fd, "FPS is: %s\n", Director::getInstance()->isDisplayStats() ? "on" : "off");
             }
         } },
+        { "glstate", "Print the GL state changes of the last frame: sent to GL / skipped by the GL state cache", std::bind(&Console::commandGLState, this, std::placeholders::_1, std::placeholders::_2) },
         { "help", "Print this message", std::bind(&Console::commandHelp, this, std::placeholders::_1, std::placeholders::_2) },
         { "projection", "Change or print the current projection. Args: [2d | 3d]", std::bind(&Console::commandProjection, this, std::placeholders::_1, std::placeholders::_2) },
         { "resolution", "Change or print the window resolution. Args: [width height resolution_policy | ]", std::bind(&Console::commandResolution, this, std::placeholders::_1, std::placeholders::_2) },
@@ -562,6 +565,40 @@ void Console::commandProjection(int fd, const std::string& args)
     }
 }
 
+void Console::commandCapture(int fd, const std::string& args)
+{
+    int frames = 1;
+    std::string filename = "render_capture.ccrc";
+
+    std::istringstream stream( args );
+    if( !(stream >> frames) || frames <= 0)
+        frames = 1;
+    stream >> filename;
+
+    if( !FileUtils::getInstance()->isAbsolutePath(filename) )
+        filename = FileUtils::getInstance()->getWritablePath() + filename;
+
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        Director::getInstance()->getRenderer()->startCapture(filename, frames);
+    } );
+    mydprintf(fd, "Capturing %d frame(s) to %s\n", frames, filename.c_str());
+}
+
+void Console::commandGLState(int fd, const std::string& args)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        auto director = Director::getInstance();
+        unsigned int issued = director->getGLStateIssuedCalls();
+        unsigned int skipped = director->getGLStateSkippedCalls();
+        unsigned int total = issued + skipped;
+        mydprintf(fd, "GL state calls in the last frame: %u issued, %u skipped (%.1f%% redundant)\n",
+                  issued, skipped, total ? 100.0f * skipped / total : 0.0f);
+        sendPrompt(fd);
+    } );
+}
+
 void Console::commandTextures(int fd, const std::string& args)
 {
     Scheduler *sched = Director::getInstance()->getScheduler();
@@ -111,10 +111,12 @@ protected:
 
     // Add commands here
     void commandHelp(int fd, const std::string &args);
+    void commandCapture(int fd, const std::string &args);
     void commandExit(int fd, const std::string &args);
     void commandSceneGraph(int fd, const std::string &args);
     void commandFileUtils(int fd, const std::string &args);
     void commandConfig(int fd, const std::string &args);
+    void commandGLState(int fd, const std::string &args);
     void commandTextures(int fd, const std::string &args);
     void commandResolution(int fd, const std::string &args);
     void commandProjection(int fd, const std::string &args);
@@ -42,11 +42,14 @@ THE SOFTWARE.
 #include "2d/CCFontFNT.h"
 #include "2d/CCFontAtlasCache.h"
 #include "2d/CCAnimationCache.h"
+#include "2d/CCParticleSystemCache.h"
 #include "2d/CCUserDefault.h"
 #include "renderer/CCGLProgramCache.h"
+#include "renderer/CCGLProgramBinaryCache.h"
 #include "renderer/CCGLProgramStateCache.h"
 #include "2d/CCTransition.h"
 #include "2d/CCTextureCache.h"
+#include "2d/CCRenderTexture.h"
 #include "2d/CCFontFreeType.h"
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
@@ -57,6 +60,7 @@ THE SOFTWARE.
 #include "base/CCAutoreleasePool.h"
 #include "base/CCProfiling.h"
 #include "base/CCConfiguration.h"
+#include "base/CCWorkerPool.h"
 #include "renderer/CCRenderer.h"
 #include "base/CCNS.h"
 #include "math/CCMath.h"
@@ -118,8 +122,10 @@ bool Director::init(void)
     // FPS
     _accumDt = 0.0f;
     _frameRate = 0.0f;
-    _FPSLabel = _drawnBatchesLabel = _drawnVerticesLabel = nullptr;
+    _FPSLabel = _drawnBatchesLabel = _drawnVerticesLabel = _glStateLabel = _culledNodesLabel = nullptr;
     _totalFrames = _frames = 0;
+    _glStateIssuedCalls = _glStateSkippedCalls = 0;
+    _culledNodes = 0;
     _lastUpdate = new struct timeval;
 
     // paused ?
@@ -170,6 +176,8 @@ Director::~Director(void)
     CC_SAFE_RELEASE(_FPSLabel);
     CC_SAFE_RELEASE(_drawnVerticesLabel);
     CC_SAFE_RELEASE(_drawnBatchesLabel);
+    CC_SAFE_RELEASE(_glStateLabel);
+    CC_SAFE_RELEASE(_culledNodesLabel);
 
     CC_SAFE_RELEASE(_runningScene);
     CC_SAFE_RELEASE(_notificationNode);
@@ -298,12 +306,20 @@ void Director::drawScene()
         _notificationNode->visit(_renderer, Mat4::IDENTITY, false);
     }
 
+    // before the stats labels are visited
+    _culledNodes = _renderer->getCulledNodes();
+
     if (_displayStats)
     {
         showStats();
     }
 
     _renderer->render();
+
+    _glStateIssuedCalls = GL::getIssuedCallCount();
+    _glStateSkippedCalls = GL::getSkippedCallCount();
+    GL::resetCallCounters();
+
     _eventDispatcher->dispatchEvent(_eventAfterDraw);
 
     popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
@@ -316,12 +332,30 @@ void Director::drawScene()
         _openGLView->swapBuffers();
     }
 
+    if (_totalFrames == 1)
+    {
+        logStartupTime();
+    }
+
     if (_displayStats)
     {
         calculateMPF();
     }
 }
 
+void Director::logStartupTime() const
+{
+    auto now = std::chrono::high_resolution_clock::now();
+    float ms = std::chrono::duration_cast<std::chrono::microseconds>(now - _openGLViewTime).count() / 1000.0f;
+
+    auto programCache = GLProgramCache::getInstance();
+    auto binaryCache = GLProgramBinaryCache::getInstance();
+    CCLOG("cocos2d: first frame drawn %.2f ms after setOpenGLView(). Default shaders: %d loaded in %.2f ms. Program binary cache: %s, %d loaded, %d saved",
+          ms,
+          programCache->getLoadedDefaultProgramsCount(), programCache->getDefaultProgramsLoadTime(),
+          binaryCache->isEnabled() ? "enabled" : "disabled", binaryCache->getLoadedCount(), binaryCache->getSavedCount());
+}
+
 void Director::calculateDeltaTime()
 {
     struct timeval now;
@@ -365,6 +399,8 @@ void Director::setOpenGLView(GLView *openGLView)
 
     if (_openGLView != openGLView)
     {
+        _openGLViewTime = std::chrono::high_resolution_clock::now();
+
         // Configuration. Gather GPU info
         Configuration *conf = Configuration::getInstance();
         conf->gatherGPUInfo();
@@ -668,12 +704,15 @@ void Director::purgeCachedData(void)
     if (s_SharedDirector->getOpenGLView())
     {
         SpriteFrameCache::getInstance()->removeUnusedSpriteFrames();
+        // the pooled particle systems retain their textures
+        ParticleSystemCache::getInstance()->removeUnusedParticleSystems();
         _textureCache->removeUnusedTextures();
 
         // Note: some tests such as ActionsTest are leaking refcounted textures
         // There should be no test textures left in the cache
         log("%s\n", _textureCache->getCachedTextureInfo().c_str());
     }
+    ParticleSystemCache::getInstance()->removeAllDefinitions();
     FileUtils::getInstance()->purgeCachedEntries();
 }
 
@@ -701,13 +740,13 @@ void Director::setDepthTest(bool on)
     if (on)
     {
         glClearDepth(1.0f);
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(GL_LEQUAL);
+        GL::enable(GL_DEPTH_TEST);
+        GL::depthFunc(GL_LEQUAL);
 //        glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
     }
     else
     {
-        glDisable(GL_DEPTH_TEST);
+        GL::disable(GL_DEPTH_TEST);
     }
     CHECK_GL_ERROR_DEBUG();
 }
@@ -941,6 +980,8 @@ void Director::purgeDirector()
     CC_SAFE_RELEASE_NULL(_FPSLabel);
     CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
     CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+    CC_SAFE_RELEASE_NULL(_glStateLabel);
+    CC_SAFE_RELEASE_NULL(_culledNodesLabel);
 
     // purge bitmap cache
     FontFNT::purgeCachedData();
@@ -949,12 +990,16 @@ void Director::purgeDirector()
 
     // purge all managed caches
     DrawPrimitives::free();
+    ImageSaver::destroyInstance();
     AnimationCache::destroyInstance();
+    ParticleSystemCache::destroyInstance();
     SpriteFrameCache::destroyInstance();
     GLProgramCache::destroyInstance();
     GLProgramStateCache::destroyInstance();
+    GLProgramBinaryCache::destroyInstance();
     FileUtils::destroyInstance();
     Configuration::destroyInstance();
+    WorkerPool::destroyInstance();
 
     // cocos2d-x specific data structures
     UserDefault::destroyInstance();
@@ -1048,13 +1093,16 @@ void Director::showStats()
 {
     static unsigned long prevCalls = 0;
     static unsigned long prevVerts = 0;
+    static unsigned int prevIssued = 0;
+    static unsigned int prevSkipped = 0;
+    static unsigned int prevCulled = 0;
 
     ++_frames;
     _accumDt += _deltaTime;
     
-    if (_displayStats && _FPSLabel && _drawnBatchesLabel && _drawnVerticesLabel)
+    if (_displayStats && _FPSLabel && _drawnBatchesLabel && _drawnVerticesLabel && _glStateLabel && _culledNodesLabel)
     {
-        char buffer[30];
+        char buffer[40];
 
         if (_accumDt > CC_DIRECTOR_STATS_INTERVAL)
         {
@@ -1080,8 +1128,24 @@ void Director::showStats()
             prevVerts = currentVerts;
         }
 
+        if (_glStateIssuedCalls != prevIssued || _glStateSkippedCalls != prevSkipped) {
+            // state changes sent to GL / redundant ones skipped by the cache
+            sprintf(buffer, "GL state:%5u/%5u", _glStateIssuedCalls, _glStateSkippedCalls);
+            _glStateLabel->setString(buffer);
+            prevIssued = _glStateIssuedCalls;
+            prevSkipped = _glStateSkippedCalls;
+        }
+
+        if (_culledNodes != prevCulled) {
+            sprintf(buffer, "Culled:%6u", _culledNodes);
+            _culledNodesLabel->setString(buffer);
+            prevCulled = _culledNodes;
+        }
+
         Mat4 identity = Mat4::IDENTITY;
 
+        _culledNodesLabel->visit(_renderer, identity, false);
+        _glStateLabel->visit(_renderer, identity, false);
         _drawnVerticesLabel->visit(_renderer, identity, false);
         _drawnBatchesLabel->visit(_renderer, identity, false);
         _FPSLabel->visit(_renderer, identity, false);
@@ -1113,6 +1177,8 @@ void Director::createStatsLabel()
         CC_SAFE_RELEASE_NULL(_FPSLabel);
         CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
         CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+        CC_SAFE_RELEASE_NULL(_glStateLabel);
+        CC_SAFE_RELEASE_NULL(_culledNodesLabel);
         _textureCache->removeTextureForKey("/cc_fps_images");
         FileUtils::getInstance()->purgeCachedEntries();
     }
@@ -1161,10 +1227,23 @@ void Director::createStatsLabel()
     _drawnVerticesLabel->initWithString("00000", texture, 12, 32, '.');
     _drawnVerticesLabel->setScale(scaleFactor);
 
+    _glStateLabel = LabelAtlas::create();
+    _glStateLabel->retain();
+    _glStateLabel->setIgnoreContentScaleFactor(true);
+    _glStateLabel->initWithString("00000", texture, 12, 32, '.');
+    _glStateLabel->setScale(scaleFactor);
+
+    _culledNodesLabel = LabelAtlas::create();
+    _culledNodesLabel->retain();
+    _culledNodesLabel->setIgnoreContentScaleFactor(true);
+    _culledNodesLabel->initWithString("00000", texture, 12, 32, '.');
+    _culledNodesLabel->setScale(scaleFactor);
 
     Texture2D::setDefaultAlphaPixelFormat(currentFormat);
 
     const int height_spacing = 22 / CC_CONTENT_SCALE_FACTOR();
+    _culledNodesLabel->setPosition(Vec2(0, height_spacing*4) + CC_DIRECTOR_STATS_POSITION);
+    _glStateLabel->setPosition(Vec2(0, height_spacing*3) + CC_DIRECTOR_STATS_POSITION);
     _drawnVerticesLabel->setPosition(Vec2(0, height_spacing*2) + CC_DIRECTOR_STATS_POSITION);
     _drawnBatchesLabel->setPosition(Vec2(0, height_spacing*1) + CC_DIRECTOR_STATS_POSITION);
     _FPSLabel->setPosition(Vec2(0, height_spacing*0)+CC_DIRECTOR_STATS_POSITION);
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "CCGL.h"
 #include "2d/CCLabelAtlas.h"
 #include <stack>
+#include <chrono>
 #include "math/CCMath.h"
 
 NS_CC_BEGIN
@@ -183,6 +184,21 @@ public:
 
     /** How many frames were called since the director started */
     inline unsigned int getTotalFrames() { return _totalFrames; }
+
+    /** Number of GL state changes sent to GL during the last frame, uniform updates included.
+     @since v3.2
+     */
+    inline unsigned int getGLStateIssuedCalls() const { return _glStateIssuedCalls; }
+
+    /** Number of redundant GL state changes skipped by the GL state cache during the last frame.
+     @since v3.2
+     */
+    inline unsigned int getGLStateSkippedCalls() const { return _glStateSkippedCalls; }
+
+    /** Number of nodes that were not visited or drawn in the last frame because they were off screen.
+     @since v3.2
+     */
+    inline unsigned int getCulledNodes() const { return _culledNodes; }
     
     /** Sets an OpenGL projection
      @since v0.8.2
@@ -418,6 +434,9 @@ protected:
     /** calculates delta time since last time it was called */    
     void calculateDeltaTime();
 
+    /** logs the time taken by the first frame and by the shaders */
+    void logStartupTime() const;
+
     //textureCache creation or release
     void initTextureCache();
     void destroyTextureCache();
@@ -460,6 +479,8 @@ protected:
     LabelAtlas *_FPSLabel;
     LabelAtlas *_drawnBatchesLabel;
     LabelAtlas *_drawnVerticesLabel;
+    LabelAtlas *_glStateLabel;
+    LabelAtlas *_culledNodesLabel;
     
     /** Whether or not the Director is paused */
     bool _paused;
@@ -468,6 +489,16 @@ protected:
     unsigned int _totalFrames;
     unsigned int _frames;
     float _secondsPerFrame;
+
+    /* GL state calls of the last frame, see GL::getIssuedCallCount() */
+    unsigned int _glStateIssuedCalls;
+    unsigned int _glStateSkippedCalls;
+
+    /* nodes culled during the last frame, see Node::setCullable() */
+    unsigned int _culledNodes;
+
+    /* when setOpenGLView() was called, to log the time taken by the first frame */
+    std::chrono::high_resolution_clock::time_point _openGLViewTime;
     
     /* The running scene */
     Scene *_runningScene;
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "2d/utlist.h"
 #include "2d/ccCArray.h"
 #include "2d/CCScriptSupport.h"
+#include "2d/CCParticleSystem.h"
 
 NS_CC_BEGIN
 
@@ -266,6 +267,11 @@ Scheduler::Scheduler(void)
 Scheduler::~Scheduler(void)
 {
     unscheduleAll();
+
+    for (auto system : _queuedParticleSystems)
+    {
+        system->release();
+    }
 }
 
 void Scheduler::removeHashElement(_hashSelectorEntry *element)
@@ -947,6 +953,16 @@ void Scheduler::update(float dt)
         }
     }
 #endif
+    //
+    // Particle systems queued by their scheduled update
+    //
+    if (!_queuedParticleSystems.empty())
+    {
+        std::vector<ParticleSystem*> systems;
+        systems.swap(_queuedParticleSystems);
+        ParticleSystem::updateQueuedSystems(systems);
+    }
+
     //
     // Functions allocated from another thread
     //
@@ -966,6 +982,12 @@ void Scheduler::update(float dt)
     }
 }
 
+void Scheduler::queueParticleSystem(ParticleSystem* system)
+{
+    CCASSERT(system, "Argument system must be non-nullptr");
+    _queuedParticleSystems.push_back(system);
+}
+
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, unsigned int repeat, float delay, bool paused)
 {
     CCASSERT(target, "Argument target must be non-nullptr");
@@ -44,6 +44,7 @@ NS_CC_BEGIN
  */
 
 class Scheduler;
+class ParticleSystem;
 
 typedef std::function<void(float)> ccSchedulerFunc;
 //
@@ -248,6 +249,17 @@ public:
         }, target, priority, paused);
     }
 
+    /** Schedules 'callback' as the update selector of a given target, in place of its 'update' method.
+     It is paused, resumed and unscheduled with the update selector of the target.
+     @since v3.2
+     @lua NA
+     */
+    template <class T>
+    void scheduleUpdate(T *target, int priority, bool paused, const ccSchedulerFunc& callback)
+    {
+        this->schedulePerFrame(callback, target, priority, paused);
+    }
+
 #if CC_ENABLE_SCRIPT_BINDING
     // schedule for script bindings
     /** The scheduled script callback will be called every 'interval' seconds.
@@ -316,6 +328,14 @@ public:
      @since v3.0
      */
     bool isScheduled(SEL_SCHEDULE selector, Ref *target);
+
+    /** Queues a particle system to be updated on the worker threads at the end of update().
+     Called by the scheduled update of the system in parallel mode, see ParticleSystem::setParallelUpdateEnabled().
+     The system has to stay alive until it is updated.
+     @since v3.2
+     @lua NA
+     */
+    void queueParticleSystem(ParticleSystem* system);
     
     /////////////////////////////////////
     
@@ -453,6 +473,8 @@ protected:
     bool _currentTargetSalvaged;
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
     bool _updateHashLocked;
+    // particle systems queued by their scheduled update, in parallel mode
+    std::vector<ParticleSystem*> _queuedParticleSystems;
     
 #if CC_ENABLE_SCRIPT_BINDING
     Vector<SchedulerScriptHandlerEntry*> _scriptHandlerEntries;
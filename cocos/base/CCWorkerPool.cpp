@@ -0,0 +1,161 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCWorkerPool.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+WorkerPool* WorkerPool::s_instance = nullptr;
+
+WorkerPool* WorkerPool::getInstance()
+{
+    if (s_instance == nullptr)
+    {
+        // the thread calling parallelFor() works too, so one worker less than the number of cores
+        ssize_t cores = std::thread::hardware_concurrency();
+        s_instance = new WorkerPool(cores > 1 ? cores - 1 : 0);
+    }
+
+    return s_instance;
+}
+
+void WorkerPool::destroyInstance()
+{
+    CC_SAFE_DELETE(s_instance);
+}
+
+WorkerPool::WorkerPool(ssize_t workerCount)
+: _job(nullptr)
+, _jobCount(0)
+, _nextJob(0)
+, _busyWorkers(0)
+, _generation(0)
+, _running(false)
+, _quit(false)
+{
+    _threadIds.push_back(std::this_thread::get_id());
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (ssize_t i = 0; i < workerCount; ++i)
+    {
+        _workers.push_back(std::thread(&WorkerPool::workerLoop, this));
+        _threadIds.push_back(_workers.back().get_id());
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _wakeUpCondition.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+ssize_t WorkerPool::getCurrentThreadIndex() const
+{
+    auto threadId = std::this_thread::get_id();
+    for (ssize_t i = 0; i < static_cast<ssize_t>(_threadIds.size()); ++i)
+    {
+        if (_threadIds[i] == threadId)
+            return i;
+    }
+    return -1;
+}
+
+void WorkerPool::parallelFor(ssize_t count, const std::function<void(ssize_t)>& job)
+{
+    if (count <= 0)
+        return;
+
+    // nested calls, or nothing to share: run the jobs on the calling thread
+    if (_running || _workers.empty() || count == 1)
+    {
+        for (ssize_t i = 0; i < count; ++i)
+        {
+            job(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _job = &job;
+        _jobCount = count;
+        _nextJob = 0;
+        _busyWorkers = _workers.size();
+        _threadIds[0] = std::this_thread::get_id();
+        _running = true;
+        ++_generation;
+    }
+    _wakeUpCondition.notify_all();
+
+    runJobs();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _doneCondition.wait(lock, [this](){ return _busyWorkers == 0; });
+    _job = nullptr;
+    _running = false;
+}
+
+void WorkerPool::runJobs()
+{
+    ssize_t index;
+    while ((index = _nextJob++) < _jobCount)
+    {
+        (*_job)(index);
+    }
+}
+
+void WorkerPool::workerLoop()
+{
+    unsigned int generation = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wakeUpCondition.wait(lock, [&](){ return _quit || _generation != generation; });
+            if (_quit)
+                return;
+            generation = _generation;
+        }
+
+        runJobs();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_busyWorkers == 0)
+        {
+            _doneCondition.notify_one();
+        }
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,95 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCWORKERPOOL_H__
+#define __CCWORKERPOOL_H__
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "base/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/** Pool of worker threads used to split per-frame work (fork/join).
+
+ The pool is meant to be driven by the cocos2d thread: `parallelFor()` hands
+ the jobs to the workers, helps running them on the calling thread and
+ returns once all of them are done. Calls made from inside a job run serially.
+ */
+class CC_DLL WorkerPool
+{
+public:
+    static WorkerPool* getInstance();
+    static void destroyInstance();
+
+    /** Number of threads running the jobs, the calling thread included */
+    inline ssize_t getThreadCount() const { return _threadIds.size(); }
+
+    /** Returns the index of the calling thread in [0, getThreadCount()).
+     0 is the thread that called `parallelFor()`, -1 is returned for threads that don't belong to the pool.
+     */
+    ssize_t getCurrentThreadIndex() const;
+
+    /** Returns whether `parallelFor()` is running */
+    inline bool isRunning() const { return _running; }
+
+    /** Calls `job(index)` for every index in [0, count) on the worker threads and the calling thread.
+     Returns when all the calls are done. The order in which the indexes are run is undefined.
+     */
+    void parallelFor(ssize_t count, const std::function<void(ssize_t)>& job);
+
+protected:
+    WorkerPool(ssize_t workerCount);
+    ~WorkerPool();
+
+    void workerLoop();
+    void runJobs();
+
+    std::vector<std::thread> _workers;
+    // [0] is the thread calling parallelFor(), the others are the workers
+    std::vector<std::thread::id> _threadIds;
+
+    std::mutex _mutex;
+    std::condition_variable _wakeUpCondition;
+    std::condition_variable _doneCondition;
+
+    const std::function<void(ssize_t)>* _job;
+    ssize_t _jobCount;
+    std::atomic<ssize_t> _nextJob;
+    ssize_t _busyWorkers;
+    unsigned int _generation;
+    bool _running;
+    bool _quit;
+
+    static WorkerPool* s_instance;
+};
+
+NS_CC_END
+
+#endif /* __CCWORKERPOOL_H__ */
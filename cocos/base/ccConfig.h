@@ -54,6 +54,12 @@ THE SOFTWARE.
     - ccGLUseProgram() instead of glUseProgram()
     - GL::deleteProgram() instead of glDeleteProgram()
     - GL::blendFunc() instead of glBlendFunc()
+    - GL::enable() / GL::disable() instead of glEnable() / glDisable()
+    - GL::depthFunc(), GL::depthMask(), GL::stencilFunc(), GL::stencilOp(), GL::stencilMask() instead of the GL ones
+    - GL::scissor() and GL::viewport() instead of glScissor() and glViewport()
+    - GL::bindBuffer() and GL::deleteBuffers() instead of glBindBuffer() and glDeleteBuffers()
+ If the GL state is changed without these functions, call GL::invalidateStateCache() afterwards.
+ The number of state changes sent to GL and skipped by the cache is shown in the stats and by the "glstate" console command.
 
  If this functionality is disabled, then ccGLUseProgram(), GL::deleteProgram(), GL::blendFunc() will call the GL ones, without using the cache.
 
@@ -56,6 +56,7 @@ THE SOFTWARE.
 #include "base/ZipUtils.h"
 #include "base/CCProfiling.h"
 #include "base/CCConsole.h"
+#include "base/CCWorkerPool.h"
 
 // EventDispatcher
 #include "base/CCEventDispatcher.h"
@@ -124,6 +125,8 @@ THE SOFTWARE.
 #include "2d/CCParticleSystem.h"
 #include "2d/CCParticleExamples.h"
 #include "2d/CCParticleSystemQuad.h"
+#include "2d/CCParticleSystemGPU.h"
+#include "2d/CCParticleSystemCache.h"
 
 // 2d utils
 #include "2d/CCGrabber.h"
@@ -137,11 +140,15 @@ THE SOFTWARE.
 #include "renderer/CCCustomCommand.h"
 #include "renderer/CCGroupCommand.h"
 #include "renderer/CCQuadCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCRenderCommandPool.h"
+#include "renderer/CCFrameAllocator.h"
+#include "renderer/CCRenderCapture.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramCache.h"
+#include "renderer/CCGLProgramBinaryCache.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/ccShaders.h"
@@ -203,6 +210,9 @@ THE SOFTWARE.
     #include "2d/platform/desktop/CCGLView.h"
     #include "2d/platform/linux/CCGL.h"
     #include "2d/platform/linux/CCStdC.h"
+#if CC_USE_HEADLESS
+    #include "2d/platform/linux/CCGLViewHeadless.h"
+#endif
 #endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
@@ -231,6 +241,7 @@ THE SOFTWARE.
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCStaticBatchNode.h"
 
 // support
 #include "2d/ccUTF8.h"
@@ -245,6 +256,7 @@ THE SOFTWARE.
 // textures
 #include "2d/CCTexture2D.h"
 #include "2d/CCTextureAtlas.h"
+#include "2d/CCDynamicAtlas.h"
 #include "2d/CCTextureCache.h"
 
 // tilemap_parallax_nodes
@@ -20,6 +20,7 @@ This file was modified to fit the cocos2d-x project
 
 #include "MathUtil.h"
 #include "base/ccMacros.h"
+#include "base/ccTypes.h"
 
 NS_CC_MATH_BEGIN
 
@@ -44,4 +45,36 @@ void MathUtil::smooth(float* x, float target, float elapsedTime, float riseTime,
     }
 }
 
+void MathUtil::transformVertices(V3F_C4B_T2F* dst, const V3F_C4B_T2F* src, size_t count, const Mat4& transform)
+{
+    // The kernels see a vertex as 6 floats, the position being the first 3 of them
+    static_assert(sizeof(V3F_C4B_T2F) == 6 * sizeof(float), "V3F_C4B_T2F size assumption is incorrect");
+    static_assert(offsetof(V3F_C4B_T2F, vertices) == 0, "V3F_C4B_T2F layout assumption is incorrect");
+
+    GP_ASSERT(dst && src);
+
+    transformVertices(transform.m, (const float*)src, (float*)dst, count);
+}
+
+void MathUtil::addScaled(float* dst, const float* src, float scalar, size_t count)
+{
+    GP_ASSERT(dst && src);
+
+    addScaledArray(src, scalar, dst, count);
+}
+
+void MathUtil::addScalar(float* dst, float scalar, size_t count)
+{
+    GP_ASSERT(dst);
+
+    addScalarArray(scalar, dst, count);
+}
+
+void MathUtil::clampMin(float* dst, float minValue, size_t count)
+{
+    GP_ASSERT(dst);
+
+    clampMinArray(minValue, dst, count);
+}
+
 NS_CC_MATH_END
@@ -25,6 +25,9 @@
 
 NS_CC_MATH_BEGIN
 
+class Mat4;
+struct V3F_C4B_T2F;
+
 /**
  * Defines a math utility class.
  *
@@ -66,6 +69,49 @@ public:
      */
     static void smooth(float* x, float target, float elapsedTime, float riseTime, float fallTime);
 
+    /**
+     * Copies the given vertices into dst, transforming their positions by the given matrix.
+     * Colors and texture coordinates are copied unchanged. src and dst may be the same array.
+     *
+     * The copy and the transform are done in a single pass using the SIMD kernel of the
+     * current platform (SSE on x86, NEON on ARM) when available.
+     *
+     * @param dst the destination vertices.
+     * @param src the source vertices.
+     * @param count the number of vertices to transform.
+     * @param transform the matrix used to transform the positions.
+     */
+    static void transformVertices(V3F_C4B_T2F* dst, const V3F_C4B_T2F* src, size_t count, const Mat4& transform);
+
+    /**
+     * Adds src multiplied by the given scalar to dst: dst[i] += src[i] * scalar.
+     * The arrays must not overlap. Uses the SIMD kernel of the current platform when available.
+     *
+     * @param dst the array to update.
+     * @param src the array to scale.
+     * @param scalar the scalar value.
+     * @param count the number of elements.
+     */
+    static void addScaled(float* dst, const float* src, float scalar, size_t count);
+
+    /**
+     * Adds the given scalar to every element of dst.
+     *
+     * @param dst the array to update.
+     * @param scalar the scalar value.
+     * @param count the number of elements.
+     */
+    static void addScalar(float* dst, float scalar, size_t count);
+
+    /**
+     * Raises every element of dst that is lower than minValue to minValue.
+     *
+     * @param dst the array to update.
+     * @param minValue the lower bound.
+     * @param count the number of elements.
+     */
+    static void clampMin(float* dst, float minValue, size_t count);
+
 private:
 
     inline static void addMatrix(const float* m, float scalar, float* dst);
@@ -88,6 +134,15 @@ private:
 
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
 
+    // Transforms `count` interleaved vertices of 6 floats each (position + 3 words of payload)
+    inline static void transformVertices(const float* m, const float* src, float* dst, size_t count);
+
+    inline static void addScaledArray(const float* src, float scalar, float* dst, size_t count);
+
+    inline static void addScalarArray(float scalar, float* dst, size_t count);
+
+    inline static void clampMinArray(float minValue, float* dst, size_t count);
+
     MathUtil();
 };
 
@@ -95,8 +150,10 @@ NS_CC_MATH_END
 
 #define MATRIX_SIZE ( sizeof(float) * 16)
 
-#ifdef USE_NEON
+#if defined(USE_NEON)
 #include "MathUtilNeon.inl"
+#elif defined(__SSE__)
+#include "MathUtilSSE.inl"
 #else
 #include "MathUtil.inl"
 #endif
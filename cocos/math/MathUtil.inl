@@ -191,4 +191,46 @@ inline void MathUtil::crossVec3(const float* v1, const float* v2, float* dst)
     dst[2] = z;
 }
 
+inline void MathUtil::transformVertices(const float* m, const float* src, float* dst, size_t count)
+{
+    for (size_t i = 0; i < count; ++i, src += 6, dst += 6)
+    {
+        // Handle case where src == dst.
+        float x = src[0];
+        float y = src[1];
+        float z = src[2];
+
+        dst[0] = x * m[0] + y * m[4] + z * m[8] + m[12];
+        dst[1] = x * m[1] + y * m[5] + z * m[9] + m[13];
+        dst[2] = x * m[2] + y * m[6] + z * m[10] + m[14];
+
+        // colors and tex coords
+        memcpy(dst + 3, src + 3, sizeof(float) * 3);
+    }
+}
+
+inline void MathUtil::addScaledArray(const float* src, float scalar, float* dst, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        dst[i] += src[i] * scalar;
+    }
+}
+
+inline void MathUtil::addScalarArray(float scalar, float* dst, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        dst[i] += scalar;
+    }
+}
+
+inline void MathUtil::clampMinArray(float minValue, float* dst, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        dst[i] = dst[i] < minValue ? minValue : dst[i];
+    }
+}
+
 NS_CC_MATH_END
@@ -18,6 +18,8 @@
  This file was modified to fit the cocos2d-x project
  */
 
+#include <arm_neon.h>
+
 NS_CC_MATH_BEGIN
 
 inline void MathUtil::addMatrix(const float* m, float scalar, float* dst)
@@ -245,4 +247,60 @@ inline void MathUtil::crossVec3(const float* v1, const float* v2, float* dst)
     );
 }
 
+inline void MathUtil::transformVertices(const float* m, const float* src, float* dst, size_t count)
+{
+    for (size_t i = 0; i < count; ++i, src += 6, dst += 6)
+    {
+        transformVec4(m, src[0], src[1], src[2], 1.0f, dst);
+
+        // colors and tex coords
+        memcpy(dst + 3, src + 3, sizeof(float) * 3);
+    }
+}
+
+inline void MathUtil::addScaledArray(const float* src, float scalar, float* dst, size_t count)
+{
+    const float32x4_t s = vdupq_n_f32(scalar);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(&dst[i], vmlaq_f32(vld1q_f32(&dst[i]), vld1q_f32(&src[i]), s));
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] += src[i] * scalar;
+    }
+}
+
+inline void MathUtil::addScalarArray(float scalar, float* dst, size_t count)
+{
+    const float32x4_t s = vdupq_n_f32(scalar);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(&dst[i], vaddq_f32(vld1q_f32(&dst[i]), s));
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] += scalar;
+    }
+}
+
+inline void MathUtil::clampMinArray(float minValue, float* dst, size_t count)
+{
+    const float32x4_t m = vdupq_n_f32(minValue);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(&dst[i], vmaxq_f32(vld1q_f32(&dst[i]), m));
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] = dst[i] < minValue ? minValue : dst[i];
+    }
+}
+
 NS_CC_MATH_END
@@ -0,0 +1,222 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <xmmintrin.h>
+
+NS_CC_MATH_BEGIN
+
+// Matrices are not guaranteed to be 16 bytes aligned, so only unaligned loads and stores are used.
+
+inline void MathUtil::addMatrix(const float* m, float scalar, float* dst)
+{
+    __m128 s = _mm_set1_ps(scalar);
+    _mm_storeu_ps(&dst[0],  _mm_add_ps(_mm_loadu_ps(&m[0]),  s));
+    _mm_storeu_ps(&dst[4],  _mm_add_ps(_mm_loadu_ps(&m[4]),  s));
+    _mm_storeu_ps(&dst[8],  _mm_add_ps(_mm_loadu_ps(&m[8]),  s));
+    _mm_storeu_ps(&dst[12], _mm_add_ps(_mm_loadu_ps(&m[12]), s));
+}
+
+inline void MathUtil::addMatrix(const float* m1, const float* m2, float* dst)
+{
+    _mm_storeu_ps(&dst[0],  _mm_add_ps(_mm_loadu_ps(&m1[0]),  _mm_loadu_ps(&m2[0])));
+    _mm_storeu_ps(&dst[4],  _mm_add_ps(_mm_loadu_ps(&m1[4]),  _mm_loadu_ps(&m2[4])));
+    _mm_storeu_ps(&dst[8],  _mm_add_ps(_mm_loadu_ps(&m1[8]),  _mm_loadu_ps(&m2[8])));
+    _mm_storeu_ps(&dst[12], _mm_add_ps(_mm_loadu_ps(&m1[12]), _mm_loadu_ps(&m2[12])));
+}
+
+inline void MathUtil::subtractMatrix(const float* m1, const float* m2, float* dst)
+{
+    _mm_storeu_ps(&dst[0],  _mm_sub_ps(_mm_loadu_ps(&m1[0]),  _mm_loadu_ps(&m2[0])));
+    _mm_storeu_ps(&dst[4],  _mm_sub_ps(_mm_loadu_ps(&m1[4]),  _mm_loadu_ps(&m2[4])));
+    _mm_storeu_ps(&dst[8],  _mm_sub_ps(_mm_loadu_ps(&m1[8]),  _mm_loadu_ps(&m2[8])));
+    _mm_storeu_ps(&dst[12], _mm_sub_ps(_mm_loadu_ps(&m1[12]), _mm_loadu_ps(&m2[12])));
+}
+
+inline void MathUtil::multiplyMatrix(const float* m, float scalar, float* dst)
+{
+    __m128 s = _mm_set1_ps(scalar);
+    _mm_storeu_ps(&dst[0],  _mm_mul_ps(_mm_loadu_ps(&m[0]),  s));
+    _mm_storeu_ps(&dst[4],  _mm_mul_ps(_mm_loadu_ps(&m[4]),  s));
+    _mm_storeu_ps(&dst[8],  _mm_mul_ps(_mm_loadu_ps(&m[8]),  s));
+    _mm_storeu_ps(&dst[12], _mm_mul_ps(_mm_loadu_ps(&m[12]), s));
+}
+
+inline void MathUtil::multiplyMatrix(const float* m1, const float* m2, float* dst)
+{
+    // Support the case where m1 or m2 is the same array as dst.
+    __m128 c0 = _mm_loadu_ps(&m1[0]);
+    __m128 c1 = _mm_loadu_ps(&m1[4]);
+    __m128 c2 = _mm_loadu_ps(&m1[8]);
+    __m128 c3 = _mm_loadu_ps(&m1[12]);
+
+    __m128 product[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        const float* col = &m2[i * 4];
+        __m128 v = _mm_mul_ps(c0, _mm_set1_ps(col[0]));
+        v = _mm_add_ps(v, _mm_mul_ps(c1, _mm_set1_ps(col[1])));
+        v = _mm_add_ps(v, _mm_mul_ps(c2, _mm_set1_ps(col[2])));
+        v = _mm_add_ps(v, _mm_mul_ps(c3, _mm_set1_ps(col[3])));
+        product[i] = v;
+    }
+
+    _mm_storeu_ps(&dst[0],  product[0]);
+    _mm_storeu_ps(&dst[4],  product[1]);
+    _mm_storeu_ps(&dst[8],  product[2]);
+    _mm_storeu_ps(&dst[12], product[3]);
+}
+
+inline void MathUtil::negateMatrix(const float* m, float* dst)
+{
+    __m128 z = _mm_setzero_ps();
+    _mm_storeu_ps(&dst[0],  _mm_sub_ps(z, _mm_loadu_ps(&m[0])));
+    _mm_storeu_ps(&dst[4],  _mm_sub_ps(z, _mm_loadu_ps(&m[4])));
+    _mm_storeu_ps(&dst[8],  _mm_sub_ps(z, _mm_loadu_ps(&m[8])));
+    _mm_storeu_ps(&dst[12], _mm_sub_ps(z, _mm_loadu_ps(&m[12])));
+}
+
+inline void MathUtil::transposeMatrix(const float* m, float* dst)
+{
+    __m128 c0 = _mm_loadu_ps(&m[0]);
+    __m128 c1 = _mm_loadu_ps(&m[4]);
+    __m128 c2 = _mm_loadu_ps(&m[8]);
+    __m128 c3 = _mm_loadu_ps(&m[12]);
+
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    _mm_storeu_ps(&dst[0],  c0);
+    _mm_storeu_ps(&dst[4],  c1);
+    _mm_storeu_ps(&dst[8],  c2);
+    _mm_storeu_ps(&dst[12], c3);
+}
+
+inline void MathUtil::transformVec4(const float* m, float x, float y, float z, float w, float* dst)
+{
+    __m128 v = _mm_mul_ps(_mm_loadu_ps(&m[0]), _mm_set1_ps(x));
+    v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(&m[4]), _mm_set1_ps(y)));
+    v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(&m[8]), _mm_set1_ps(z)));
+    v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(&m[12]), _mm_set1_ps(w)));
+
+    // dst is a Vec3: only store x, y and z
+    _mm_storel_pi((__m64*)dst, v);
+    _mm_store_ss(&dst[2], _mm_movehl_ps(v, v));
+}
+
+inline void MathUtil::transformVec4(const float* m, const float* v, float* dst)
+{
+    // Handle case where v == dst.
+    __m128 r = _mm_mul_ps(_mm_loadu_ps(&m[0]), _mm_set1_ps(v[0]));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m[4]), _mm_set1_ps(v[1])));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m[8]), _mm_set1_ps(v[2])));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m[12]), _mm_set1_ps(v[3])));
+
+    _mm_storeu_ps(dst, r);
+}
+
+inline void MathUtil::crossVec3(const float* v1, const float* v2, float* dst)
+{
+    float x = (v1[1] * v2[2]) - (v1[2] * v2[1]);
+    float y = (v1[2] * v2[0]) - (v1[0] * v2[2]);
+    float z = (v1[0] * v2[1]) - (v1[1] * v2[0]);
+
+    dst[0] = x;
+    dst[1] = y;
+    dst[2] = z;
+}
+
+inline void MathUtil::transformVertices(const float* m, const float* src, float* dst, size_t count)
+{
+    // The matrix stays in registers for the whole batch
+    const __m128 c0 = _mm_loadu_ps(&m[0]);
+    const __m128 c1 = _mm_loadu_ps(&m[4]);
+    const __m128 c2 = _mm_loadu_ps(&m[8]);
+    const __m128 c3 = _mm_loadu_ps(&m[12]);
+
+    for (size_t i = 0; i < count; ++i, src += 6, dst += 6)
+    {
+        __m128 v = _mm_mul_ps(c0, _mm_load1_ps(&src[0]));
+        v = _mm_add_ps(v, _mm_mul_ps(c1, _mm_load1_ps(&src[1])));
+        v = _mm_add_ps(v, _mm_mul_ps(c2, _mm_load1_ps(&src[2])));
+        v = _mm_add_ps(v, c3);
+
+        // colors and tex coords, read before the position is written in case src == dst
+        __m128 payload = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)&src[4]);
+        uint32_t color;
+        memcpy(&color, &src[3], sizeof(color));
+
+        _mm_storel_pi((__m64*)&dst[0], v);
+        _mm_store_ss(&dst[2], _mm_movehl_ps(v, v));
+        memcpy(&dst[3], &color, sizeof(color));
+        _mm_storel_pi((__m64*)&dst[4], payload);
+    }
+}
+
+inline void MathUtil::addScaledArray(const float* src, float scalar, float* dst, size_t count)
+{
+    const __m128 s = _mm_set1_ps(scalar);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 v = _mm_add_ps(_mm_loadu_ps(&dst[i]), _mm_mul_ps(_mm_loadu_ps(&src[i]), s));
+        _mm_storeu_ps(&dst[i], v);
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] += src[i] * scalar;
+    }
+}
+
+inline void MathUtil::addScalarArray(float scalar, float* dst, size_t count)
+{
+    const __m128 s = _mm_set1_ps(scalar);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(&dst[i], _mm_add_ps(_mm_loadu_ps(&dst[i]), s));
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] += scalar;
+    }
+}
+
+inline void MathUtil::clampMinArray(float minValue, float* dst, size_t count)
+{
+    const __m128 m = _mm_set1_ps(minValue);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(&dst[i], _mm_max_ps(_mm_loadu_ps(&dst[i]), m));
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] = dst[i] < minValue ? minValue : dst[i];
+    }
+}
+
+NS_CC_MATH_END
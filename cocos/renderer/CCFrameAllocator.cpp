@@ -0,0 +1,127 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "renderer/CCFrameAllocator.h"
+
+#include <stdlib.h>
+#include <algorithm>
+#include <stdint.h>
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+FrameAllocator::FrameAllocator(size_t pageSize)
+: _pageSize(pageSize)
+, _firstPage(nullptr)
+, _lastPage(nullptr)
+, _currentPage(nullptr)
+, _currentOffset(0)
+, _destructors(nullptr)
+, _usedBytes(0)
+, _capacity(0)
+, _heapAllocationCount(0)
+{
+}
+
+FrameAllocator::~FrameAllocator()
+{
+    reset();
+
+    Page* page = _firstPage;
+    while (page)
+    {
+        Page* next = page->next;
+        free(page);
+        page = next;
+    }
+}
+
+void* FrameAllocator::allocate(size_t size, size_t alignment)
+{
+    CCASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "alignment must be a power of 2");
+
+    // try the current page, then the pages kept from the previous frames
+    Page* page = _currentPage;
+    size_t offset = _currentOffset;
+    while (page)
+    {
+        void* ret = allocateFromPage(page, offset, size, alignment);
+        if (ret)
+            return ret;
+
+        page = page->next;
+        offset = 0;
+    }
+
+    // no room left: add a page, big enough for the allocations larger than a page
+    size_t pageSize = std::max(_pageSize, size + alignment);
+    page = static_cast<Page*>(malloc(sizeof(Page) + pageSize));
+    CCASSERT(page, "FrameAllocator: out of memory");
+    page->next = nullptr;
+    page->size = pageSize;
+
+    if (_lastPage)
+        _lastPage->next = page;
+    else
+        _firstPage = page;
+    _lastPage = page;
+
+    _capacity += pageSize;
+    ++_heapAllocationCount;
+
+    return allocateFromPage(page, 0, size, alignment);
+}
+
+void* FrameAllocator::allocateFromPage(Page* page, size_t offset, size_t size, size_t alignment)
+{
+    uintptr_t begin = reinterpret_cast<uintptr_t>(page + 1);
+    uintptr_t start = (begin + offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    if (start + size > begin + page->size)
+        return nullptr;
+
+    _currentPage = page;
+    _currentOffset = start + size - begin;
+    _usedBytes += size;
+
+    return reinterpret_cast<void*>(start);
+}
+
+void FrameAllocator::reset()
+{
+    // destroy in the reverse order of creation
+    Destructor* destructor = _destructors;
+    while (destructor)
+    {
+        destructor->destroy(destructor->object);
+        destructor = destructor->next;
+    }
+    _destructors = nullptr;
+
+    _currentPage = _firstPage;
+    _currentOffset = 0;
+    _usedBytes = 0;
+}
+
+NS_CC_END
@@ -0,0 +1,137 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_FRAMEALLOCATOR_H__
+#define __CC_FRAMEALLOCATOR_H__
+
+#include <new>
+#include <type_traits>
+#include "base/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/** Linear allocator for the objects that only live during one frame: transient `RenderCommand`s and their payloads.
+
+ Allocating is just moving a pointer forward. Everything is released at once by `reset()`, which `Renderer::clean()`
+ calls once the frame is rendered. The memory pages are kept for the next frames, so once the allocator has grown
+ to the size of a frame, no more heap allocations are made.
+ */
+class CC_DLL FrameAllocator
+{
+public:
+    static const size_t DEFAULT_PAGE_SIZE = 64 * 1024;
+
+    FrameAllocator(size_t pageSize = DEFAULT_PAGE_SIZE);
+    ~FrameAllocator();
+
+    /** Returns `size` bytes aligned on `alignment` (a power of 2). The memory is valid until `reset()` */
+    void* allocate(size_t size, size_t alignment);
+
+    /** Returns memory for `count` objects of type T. The objects are not constructed: use it for plain data like vertices */
+    template <class T>
+    T* allocateArray(size_t count)
+    {
+        return static_cast<T*>(allocate(sizeof(T) * count, std::alignment_of<T>::value));
+    }
+
+    /** Creates an object of type T (a `RenderCommand` most of the time). It is destroyed by `reset()` */
+    template <class T>
+    T* create()
+    {
+        return track(new (allocate(sizeof(T), std::alignment_of<T>::value)) T());
+    }
+
+    /** Creates a copy of `other`, e.g. of a command kept by a node to cache its material ID. It is destroyed by `reset()` */
+    template <class T>
+    T* create(const T& other)
+    {
+        return track(new (allocate(sizeof(T), std::alignment_of<T>::value)) T(other));
+    }
+
+    /** Destroys the created objects and releases all the memory, keeping the pages for the next frame */
+    void reset();
+
+    /** Returns the number of bytes allocated since the last `reset()` */
+    inline size_t getUsedBytes() const { return _usedBytes; }
+    /** Returns the size of all the pages */
+    inline size_t getCapacity() const { return _capacity; }
+    /** Returns the number of pages allocated on the heap since the allocator was created */
+    inline unsigned int getHeapAllocationCount() const { return _heapAllocationCount; }
+
+protected:
+    struct Page
+    {
+        Page* next;
+        size_t size;
+    };
+
+    struct Destructor
+    {
+        void (*destroy)(void*);
+        void* object;
+        Destructor* next;
+    };
+
+    template <class T>
+    static void destroy(void* object)
+    {
+        static_cast<T*>(object)->~T();
+    }
+
+    // registers the destructor of a created object
+    template <class T>
+    T* track(T* object)
+    {
+        auto destructor = static_cast<Destructor*>(allocate(sizeof(Destructor), std::alignment_of<Destructor>::value));
+        destructor->destroy = &FrameAllocator::destroy<T>;
+        destructor->object = object;
+        destructor->next = _destructors;
+        _destructors = destructor;
+
+        return object;
+    }
+
+    void* allocateFromPage(Page* page, size_t offset, size_t size, size_t alignment);
+
+    size_t _pageSize;
+    Page* _firstPage;
+    Page* _lastPage;
+    Page* _currentPage;
+    // first free byte of the current page
+    size_t _currentOffset;
+
+    Destructor* _destructors;
+
+    size_t _usedBytes;
+    size_t _capacity;
+    unsigned int _heapAllocationCount;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(FrameAllocator);
+};
+
+NS_CC_END
+
+#endif //__CC_FRAMEALLOCATOR_H__
@@ -28,6 +28,7 @@ THE SOFTWARE.
 
 #include "base/CCDirector.h"
 #include "renderer/CCGLProgram.h"
+#include "renderer/CCGLProgramBinaryCache.h"
 #include "renderer/ccGLStateCache.h"
 #include "base/ccMacros.h"
 #include "2d/platform/CCFileUtils.h"
@@ -54,6 +55,7 @@ typedef struct _hashUniformEntry
 
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR = "ShaderPositionTextureColor";
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP = "ShaderPositionTextureColor_noMVP";
+const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_INSTANCED = "ShaderPositionTextureColor_instanced";
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST = "ShaderPositionTextureColorAlphaTest";
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV = "ShaderPositionTextureColorAlphaTest_NoMV";
 const char* GLProgram::SHADER_NAME_POSITION_COLOR = "ShaderPositionColor";
@@ -63,6 +65,15 @@ const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR = "ShaderPositionTex
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR = "ShaderPositionTextureA8Color";
 const char* GLProgram::SHADER_NAME_POSITION_U_COLOR = "ShaderPosition_uColor";
 const char* GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR = "ShaderPositionLengthTextureColor";
+const char* GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR_NO_MVP = "ShaderPositionLengthTextureColor_noMVP";
+
+const char* GLProgram::SHADER_NAME_GRID3D_WAVES3D = "ShaderGrid3DWaves3D";
+const char* GLProgram::SHADER_NAME_GRID3D_RIPPLE3D = "ShaderGrid3DRipple3D";
+const char* GLProgram::SHADER_NAME_GRID3D_WAVES = "ShaderGrid3DWaves";
+const char* GLProgram::SHADER_NAME_GRID3D_LIQUID = "ShaderGrid3DLiquid";
+const char* GLProgram::SHADER_NAME_GRID3D_TWIRL = "ShaderGrid3DTwirl";
+
+const char* GLProgram::SHADER_NAME_PARTICLE_GPU = "ShaderParticleGPU";
 
 const char* GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL = "ShaderLabelDFNormal";
 const char* GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW = "ShaderLabelDFGlow";
@@ -89,6 +100,8 @@ const char* GLProgram::ATTRIBUTE_NAME_COLOR = "a_color";
 const char* GLProgram::ATTRIBUTE_NAME_POSITION = "a_position";
 const char* GLProgram::ATTRIBUTE_NAME_TEX_COORD = "a_texCoord";
 const char* GLProgram::ATTRIBUTE_NAME_NORMAL = "a_normal";
+const char* GLProgram::ATTRIBUTE_NAME_INSTANCE_ROW0 = "a_instanceRow0";
+const char* GLProgram::ATTRIBUTE_NAME_INSTANCE_ROW1 = "a_instanceRow1";
 
 
 GLProgram* GLProgram::createWithByteArrays(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray)
@@ -124,6 +137,9 @@ GLProgram::GLProgram()
 , _vertShader(0)
 , _fragShader(0)
 , _hashForUniforms(nullptr)
+, _uniformsState(nullptr)
+, _loadedFromBinary(false)
+, _binaryLocationsChanged(false)
 , _flags()
 {
     memset(_builtInUniforms, 0, sizeof(_builtInUniforms));
@@ -171,7 +187,38 @@ bool GLProgram::initWithByteArrays(const GLchar* vShaderByteArray, const GLchar*
     CHECK_GL_ERROR_DEBUG();
 
     _vertShader = _fragShader = 0;
+    _hashForUniforms = nullptr;
+    _loadedFromBinary = false;
+    _binaryLocationsChanged = false;
+    _binaryKey.clear();
+
+    auto binaryCache = GLProgramBinaryCache::getInstance();
+    if (vShaderByteArray && fShaderByteArray && binaryCache->isEnabled())
+    {
+        _binaryKey = binaryCache->computeKey(vShaderByteArray, fShaderByteArray);
+        if (binaryCache->loadProgram(_program, _binaryKey))
+        {
+            _loadedFromBinary = true;
+            _vertSource = vShaderByteArray;
+            _fragSource = fShaderByteArray;
+            return true;
+        }
+    }
+
+    if (!compileAndAttachShaders(vShaderByteArray, fShaderByteArray))
+    {
+        return false;
+    }
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
+    _shaderId = CCPrecompiledShaders::getInstance()->addShaders(vShaderByteArray, fShaderByteArray);
+#endif
+
+    return true;
+}
+
+bool GLProgram::compileAndAttachShaders(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray)
+{
     if (vShaderByteArray)
     {
         if (!compileShader(&_vertShader, GL_VERTEX_SHADER, vShaderByteArray))
@@ -201,14 +248,9 @@ bool GLProgram::initWithByteArrays(const GLchar* vShaderByteArray, const GLchar*
     {
         glAttachShader(_program, _fragShader);
     }
-    _hashForUniforms = nullptr;
     
     CHECK_GL_ERROR_DEBUG();
 
-#if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
-    _shaderId = CCPrecompiledShaders::getInstance()->addShaders(vShaderByteArray, fShaderByteArray);
-#endif
-
     return true;
 }
 
@@ -267,6 +309,8 @@ void GLProgram::bindPredefinedVertexAttribs()
         {GLProgram::ATTRIBUTE_NAME_COLOR, GLProgram::VERTEX_ATTRIB_COLOR},
         {GLProgram::ATTRIBUTE_NAME_TEX_COORD, GLProgram::VERTEX_ATTRIB_TEX_COORD},
         {GLProgram::ATTRIBUTE_NAME_NORMAL, GLProgram::VERTEX_ATTRIB_NORMAL},
+        {GLProgram::ATTRIBUTE_NAME_INSTANCE_ROW0, GLProgram::VERTEX_ATTRIB_INSTANCE_ROW0},
+        {GLProgram::ATTRIBUTE_NAME_INSTANCE_ROW1, GLProgram::VERTEX_ATTRIB_INSTANCE_ROW1},
     };
 
     const int size = sizeof(attribute_locations) / sizeof(attribute_locations[0]);
@@ -449,6 +493,12 @@ GLint GLProgram::getUniformLocation(const std::string &attributeName) const
 void GLProgram::bindAttribLocation(const std::string &attributeName, GLuint index) const
 {
     glBindAttribLocation(_program, index, attributeName.c_str());
+
+    // only used by the next link: a program loaded from a binary has the locations it was saved with
+    if (_loadedFromBinary && glGetAttribLocation(_program, attributeName.c_str()) != static_cast<GLint>(index))
+    {
+        _binaryLocationsChanged = true;
+    }
 }
 
 void GLProgram::updateUniforms()
@@ -505,6 +555,26 @@ bool GLProgram::link()
 
     GLint status = GL_TRUE;
 
+    if (_loadedFromBinary)
+    {
+        if (!_binaryLocationsChanged)
+        {
+            _vertSource.clear();
+            _fragSource.clear();
+
+            parseVertexAttribs();
+            parseUniforms();
+            return true;
+        }
+
+        // the locations bound with bindAttribLocation() are kept by the program object
+        _loadedFromBinary = false;
+        _binaryLocationsChanged = false;
+        compileAndAttachShaders(_vertSource.c_str(), _fragSource.c_str());
+        _vertSource.clear();
+        _fragSource.clear();
+    }
+
     bindPredefinedVertexAttribs();
 
     glLinkProgram(_program);
@@ -523,6 +593,17 @@ bool GLProgram::link()
     }
     
     _vertShader = _fragShader = 0;
+
+    if (!_binaryKey.empty())
+    {
+        GLint linked = GL_FALSE;
+        glGetProgramiv(_program, GL_LINK_STATUS, &linked);
+        if (linked == GL_TRUE)
+        {
+            GLProgramBinaryCache::getInstance()->saveProgram(_program, _binaryKey);
+        }
+        _binaryKey.clear();
+    }
     
 #if DEBUG || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
     glGetProgramiv(_program, GL_LINK_STATUS, &status);
@@ -621,9 +702,26 @@ bool GLProgram::updateUniformLocation(GLint location, const GLvoid* data, unsign
         }
     }
 
+    // a user uniform set from outside of the GLProgramState: it has to apply all its values again
+    if (updated && _uniformsState && !isBuiltInUniformLocation(location))
+    {
+        _uniformsState = nullptr;
+    }
+
+    GL::countCall(updated);
     return updated;
 }
 
+bool GLProgram::isBuiltInUniformLocation(GLint location) const
+{
+    for (int i = 0; i < UNIFORM_MAX; ++i)
+    {
+        if (_builtInUniforms[i] == location)
+            return true;
+    }
+    return false;
+}
+
 GLint GLProgram::getUniformLocationForName(const char* name) const
 {
     CCASSERT(name != nullptr, "Invalid uniform name" );
@@ -858,6 +956,12 @@ void GLProgram::reset()
     // it is already deallocated by android
     //GL::deleteProgram(_program);
     _program = 0;
+    _uniformsState = nullptr;
+    _binaryKey.clear();
+    _loadedFromBinary = false;
+    _binaryLocationsChanged = false;
+    _vertSource.clear();
+    _fragSource.clear();
 
     
     tHashUniformEntry *current_element, *tmp;
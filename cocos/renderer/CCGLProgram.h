@@ -46,6 +46,7 @@ NS_CC_BEGIN
 
 struct _hashUniformEntry;
 class GLProgram;
+class GLProgramState;
 
 typedef void (*GLInfoFunction)(GLuint program, GLenum pname, GLint* params);
 typedef void (*GLLogFunction) (GLuint program, GLsizei bufsize, GLsizei* length, GLchar* infolog);
@@ -84,6 +85,9 @@ public:
         VERTEX_ATTRIB_COLOR,
         VERTEX_ATTRIB_TEX_COORD,
         VERTEX_ATTRIB_NORMAL,
+        // per instance transform of the instanced sprites, see SHADER_NAME_POSITION_TEXTURE_COLOR_INSTANCED
+        VERTEX_ATTRIB_INSTANCE_ROW0,
+        VERTEX_ATTRIB_INSTANCE_ROW1,
 
         VERTEX_ATTRIB_MAX,
 
@@ -110,6 +114,8 @@ public:
     
     static const char* SHADER_NAME_POSITION_TEXTURE_COLOR;
     static const char* SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP;
+    /** Used by the Renderer to draw the quads of SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP with instanced arrays */
+    static const char* SHADER_NAME_POSITION_TEXTURE_COLOR_INSTANCED;
     static const char* SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST;
     static const char* SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV;
     static const char* SHADER_NAME_POSITION_COLOR;
@@ -119,6 +125,17 @@ public:
     static const char* SHADER_NAME_POSITION_TEXTURE_A8_COLOR;
     static const char* SHADER_NAME_POSITION_U_COLOR;
     static const char* SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR;
+    static const char* SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR_NO_MVP;
+
+    /** Used by the Grid3D actions that displace the vertices of the grid in the vertex shader */
+    static const char* SHADER_NAME_GRID3D_WAVES3D;
+    static const char* SHADER_NAME_GRID3D_RIPPLE3D;
+    static const char* SHADER_NAME_GRID3D_WAVES;
+    static const char* SHADER_NAME_GRID3D_LIQUID;
+    static const char* SHADER_NAME_GRID3D_TWIRL;
+
+    /** Used by ParticleSystemGPU, which computes the particles in the vertex shader */
+    static const char* SHADER_NAME_PARTICLE_GPU;
 
     static const char* SHADER_NAME_LABEL_NORMAL;
     static const char* SHADER_NAME_LABEL_OUTLINE;
@@ -146,6 +163,8 @@ public:
     static const char* ATTRIBUTE_NAME_POSITION;
     static const char* ATTRIBUTE_NAME_TEX_COORD;
     static const char* ATTRIBUTE_NAME_NORMAL;
+    static const char* ATTRIBUTE_NAME_INSTANCE_ROW0;
+    static const char* ATTRIBUTE_NAME_INSTANCE_ROW1;
 
     GLProgram();
     virtual ~GLProgram();
@@ -178,7 +197,9 @@ public:
 	Uniform* getUniform(const std::string& name);
     VertexAttrib* getVertexAttrib(const std::string& name);
 
-    /**  It will add a new attribute to the shader by calling glBindAttribLocation */
+    /**  It will add a new attribute to the shader by calling glBindAttribLocation.
+     A program loaded from the GLProgramBinaryCache is recompiled by link() if its locations differ.
+     */
     void bindAttribLocation(const std::string& attributeName, GLuint index) const;
 
     /** calls glGetAttribLocation */
@@ -303,6 +324,7 @@ public:
 
 protected:
     bool updateUniformLocation(GLint location, const GLvoid* data, unsigned int bytes);
+    bool isBuiltInUniformLocation(GLint location) const;
     virtual std::string getDescription() const;
 
     void bindPredefinedVertexAttribs();
@@ -310,6 +332,7 @@ protected:
     void parseUniforms();
 
     bool compileShader(GLuint * shader, GLenum type, const GLchar* source);
+    bool compileAndAttachShaders(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray);
     std::string logForOpenGLObject(GLuint object, GLInfoFunction infoFunc, GLLogFunction logFunc) const;
 
     GLuint            _program;
@@ -317,7 +340,18 @@ protected:
     GLuint            _fragShader;
     GLint             _builtInUniforms[UNIFORM_MAX];
     struct _hashUniformEntry* _hashForUniforms;
+    // the GLProgramState whose uniform values the program has, see GLProgramState::apply()
+    GLProgramState*   _uniformsState;
 	bool              _hasShaderCompiler;
+
+    // key in the GLProgramBinaryCache, empty when the cache is not used
+    std::string       _binaryKey;
+    // the program was loaded from the GLProgramBinaryCache: link() has nothing to do,
+    // unless bindAttribLocation() asked for other locations (the sources are kept for that case)
+    bool              _loadedFromBinary;
+    mutable bool      _binaryLocationsChanged;
+    std::string       _vertSource;
+    std::string       _fragSource;
         
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
     std::string       _shaderId;
@@ -0,0 +1,216 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "renderer/CCGLProgramBinaryCache.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#include "base/CCConfiguration.h"
+#include "base/ccMacros.h"
+#include "2d/platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+namespace {
+
+    // file layout: header, then `length` bytes of binary
+    struct BinaryHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t format;
+        uint32_t length;
+    };
+
+    const char BINARY_MAGIC[4] = { 'C', 'C', 'P', 'B' };
+    const uint32_t BINARY_VERSION = 1;
+
+    // 64-bit FNV-1a, also hashes the terminating 0 so that "ab" + "c" != "a" + "bc"
+    uint64_t hashString(uint64_t hash, const char* str)
+    {
+        if (str)
+        {
+            for (; *str; ++str)
+            {
+                hash ^= static_cast<unsigned char>(*str);
+                hash *= 1099511628211ULL;
+            }
+        }
+        hash *= 1099511628211ULL;
+        return hash;
+    }
+}
+
+GLProgramBinaryCache* GLProgramBinaryCache::s_instance = nullptr;
+
+GLProgramBinaryCache* GLProgramBinaryCache::getInstance()
+{
+    if (s_instance == nullptr)
+    {
+        s_instance = new GLProgramBinaryCache();
+    }
+
+    return s_instance;
+}
+
+void GLProgramBinaryCache::destroyInstance()
+{
+    CC_SAFE_DELETE(s_instance);
+}
+
+GLProgramBinaryCache::GLProgramBinaryCache()
+: _enabled(true)
+, _loadedCount(0)
+, _savedCount(0)
+{
+}
+
+bool GLProgramBinaryCache::isSupported() const
+{
+    return Configuration::getInstance()->supportsProgramBinary();
+}
+
+std::string GLProgramBinaryCache::computeKey(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray) const
+{
+    uint64_t hash = 14695981039346656037ULL;
+    hash = hashString(hash, vShaderByteArray);
+    hash = hashString(hash, fShaderByteArray);
+    // the header that GLProgram adds to the sources comes with the engine
+    hash = hashString(hash, Configuration::getInstance()->getValue("cocos2d.x.version").asString().c_str());
+    hash = hashString(hash, (const char*)glGetString(GL_VENDOR));
+    hash = hashString(hash, (const char*)glGetString(GL_RENDERER));
+    hash = hashString(hash, (const char*)glGetString(GL_VERSION));
+
+    char key[17];
+    snprintf(key, sizeof(key), "%08x%08x", (unsigned int)(hash >> 32), (unsigned int)(hash & 0xffffffff));
+    return key;
+}
+
+std::string GLProgramBinaryCache::getFilePath(const std::string& key) const
+{
+    return FileUtils::getInstance()->getWritablePath() + "ccprogram_" + key + ".bin";
+}
+
+bool GLProgramBinaryCache::loadProgram(GLuint program, const std::string& key)
+{
+#ifdef CC_GL_PROGRAM_BINARY
+    if (!isEnabled())
+        return false;
+
+    std::string path = getFilePath(key);
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp)
+        return false;
+
+    BinaryHeader header;
+    std::vector<unsigned char> binary;
+    bool valid = fread(&header, sizeof(header), 1, fp) == 1
+        && memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0
+        && header.version == BINARY_VERSION
+        && header.length > 0;
+    if (valid)
+    {
+        binary.resize(header.length);
+        valid = fread(binary.data(), 1, header.length, fp) == header.length;
+    }
+    fclose(fp);
+
+    GLint linked = GL_FALSE;
+    if (valid)
+    {
+        glProgramBinary(program, header.format, binary.data(), header.length);
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    }
+
+    if (linked != GL_TRUE)
+    {
+        CCLOG("cocos2d: GLProgramBinaryCache: discarding %s", path.c_str());
+        removeProgram(key);
+        return false;
+    }
+
+    ++_loadedCount;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool GLProgramBinaryCache::saveProgram(GLuint program, const std::string& key)
+{
+#ifdef CC_GL_PROGRAM_BINARY
+    if (!isEnabled())
+        return false;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return false;
+
+    std::vector<unsigned char> binary(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0)
+        return false;
+
+    BinaryHeader header;
+    memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.version = BINARY_VERSION;
+    header.format = format;
+    header.length = written;
+
+    std::string path = getFilePath(key);
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (!fp)
+        return false;
+
+    bool saved = fwrite(&header, sizeof(header), 1, fp) == 1
+        && fwrite(binary.data(), 1, written, fp) == static_cast<size_t>(written);
+    saved = (fclose(fp) == 0) && saved;
+
+    if (!saved)
+    {
+        // don't leave a truncated file behind
+        removeProgram(key);
+        return false;
+    }
+
+    ++_savedCount;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void GLProgramBinaryCache::removeProgram(const std::string& key)
+{
+    remove(getFilePath(key).c_str());
+}
+
+NS_CC_END
@@ -0,0 +1,99 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CCGLPROGRAMBINARYCACHE_H__
+#define __CCGLPROGRAMBINARYCACHE_H__
+
+#include <string>
+
+#include "base/CCPlatformMacros.h"
+#include "CCGL.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup shaders
+ * @{
+ */
+
+/** On-disk cache of linked program binaries (glGetProgramBinary / glProgramBinary).
+
+ GLProgram looks a program up before compiling its shaders, and saves it once it is linked.
+ The binaries are stored in the writable path, one file per program. The key is a hash of the
+ shader sources, of the cocos2d version and of the GL vendor, renderer and version strings,
+ so a driver update invalidates the saved binaries. Binaries rejected by the driver are deleted.
+
+ Needs GL_ARB_get_program_binary on desktop OpenGL and GL_OES_get_program_binary on OpenGL ES 2.0.
+ @since v3.2
+ */
+class CC_DLL GLProgramBinaryCache
+{
+public:
+    static GLProgramBinaryCache* getInstance();
+    static void destroyInstance();
+
+    /** Whether or not the driver can save and load program binaries */
+    bool isSupported() const;
+
+    /** Enables or disables the cache. Enabled by default, it only works when isSupported() is true. */
+    inline void setEnabled(bool enabled) { _enabled = enabled; }
+    inline bool isEnabled() const { return _enabled && isSupported(); }
+
+    /** Returns the key of the program linked from these sources by the current driver */
+    std::string computeKey(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray) const;
+
+    /** Loads the binary saved for `key` into `program`, which is linked if it succeeds.
+     Returns false if there is no binary or if the driver rejected it.
+     */
+    bool loadProgram(GLuint program, const std::string& key);
+
+    /** Saves the binary of the linked `program` for `key` */
+    bool saveProgram(GLuint program, const std::string& key);
+
+    /** Deletes the binary saved for `key`, if any */
+    void removeProgram(const std::string& key);
+
+    /** Number of programs loaded from the cache, and saved to it, since the start */
+    inline int getLoadedCount() const { return _loadedCount; }
+    inline int getSavedCount() const { return _savedCount; }
+
+protected:
+    GLProgramBinaryCache();
+
+    std::string getFilePath(const std::string& key) const;
+
+    bool _enabled;
+    int _loadedCount;
+    int _savedCount;
+
+    static GLProgramBinaryCache* s_instance;
+};
+
+// end of shaders group
+/// @}
+
+NS_CC_END
+
+#endif /* __CCGLPROGRAMBINARYCACHE_H__ */
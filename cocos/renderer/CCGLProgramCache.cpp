@@ -30,11 +30,14 @@ THE SOFTWARE.
 #include "renderer/ccShaders.h"
 #include "base/ccMacros.h"
 
+#include <chrono>
+
 NS_CC_BEGIN
 
 enum {
     kShaderType_PositionTextureColor,
     kShaderType_PositionTextureColor_noMVP,
+    kShaderType_PositionTextureColor_instanced,
     kShaderType_PositionTextureColorAlphaTest,
     kShaderType_PositionTextureColorAlphaTestNoMV,
     kShaderType_PositionColor,
@@ -44,10 +47,17 @@ enum {
     kShaderType_PositionTextureA8Color,
     kShaderType_Position_uColor,
     kShaderType_PositionLengthTexureColor,
+    kShaderType_PositionLengthTexureColor_noMVP,
     kShaderType_LabelDistanceFieldNormal,
     kShaderType_LabelDistanceFieldGlow,
     kShaderType_LabelNormal,
     kShaderType_LabelOutline,
+    kShaderType_Grid3DWaves3D,
+    kShaderType_Grid3DRipple3D,
+    kShaderType_Grid3DWaves,
+    kShaderType_Grid3DLiquid,
+    kShaderType_Grid3DTwirl,
+    kShaderType_ParticleGPU,
     kShaderType_MAX,
 };
 
@@ -84,6 +94,8 @@ void GLProgramCache::purgeSharedShaderCache()
 
 GLProgramCache::GLProgramCache()
 : _programs()
+, _loadedDefaultPrograms(0)
+, _defaultProgramsLoadTime(0)
 {
 
 }
@@ -105,181 +117,70 @@ bool GLProgramCache::init()
 
 void GLProgramCache::loadDefaultGLPrograms()
 {
-    // Position Texture Color shader
-    GLProgram *p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR, p ) );
-
-    // Position Texture Color without MVP shader
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor_noMVP);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, p ) );
-
-    // Position Texture Color alpha test
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTest);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST, p) );
-
-    // Position Texture Color alpha test
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTestNoMV);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV, p) );
-    //
-    // Position, Color shader
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionColor);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_COLOR, p) );
-
-    //
-    // Position, Color shader no MVP
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionColor_noMVP);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP, p) );
-
-    //
-    // Position Texture shader
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE, p) );
-
-    //
-    // Position, Texture attribs, 1 Color as uniform shader
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture_uColor);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR, p) );
-
-    //
-    // Position Texture A8 Color shader
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureA8Color);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR, p) );
-
-    //
-    // Position and 1 color passed as a uniform (to simulate glColor4ub )
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_Position_uColor);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_U_COLOR, p) );
-    
-    //
-	// Position, Legth(TexCoords, Color (used by Draw Node basically )
-	//
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionLengthTexureColor);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR, p) );
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL, p) );
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldGlow);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW, p) );
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelNormal);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_NORMAL, p) );
+    // the programs are compiled the first time they are requested, see getGLProgram()
+    const struct {
+        const char* key;
+        int type;
+    } defaultPrograms[] =
+    {
+        { GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR, kShaderType_PositionTextureColor },
+        { GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, kShaderType_PositionTextureColor_noMVP },
+        { GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_INSTANCED, kShaderType_PositionTextureColor_instanced },
+        { GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST, kShaderType_PositionTextureColorAlphaTest },
+        { GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV, kShaderType_PositionTextureColorAlphaTestNoMV },
+        { GLProgram::SHADER_NAME_POSITION_COLOR, kShaderType_PositionColor },
+        { GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP, kShaderType_PositionColor_noMVP },
+        { GLProgram::SHADER_NAME_POSITION_TEXTURE, kShaderType_PositionTexture },
+        { GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR, kShaderType_PositionTexture_uColor },
+        { GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR, kShaderType_PositionTextureA8Color },
+        { GLProgram::SHADER_NAME_POSITION_U_COLOR, kShaderType_Position_uColor },
+        { GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR, kShaderType_PositionLengthTexureColor },
+        { GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR_NO_MVP, kShaderType_PositionLengthTexureColor_noMVP },
+        { GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL, kShaderType_LabelDistanceFieldNormal },
+        { GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW, kShaderType_LabelDistanceFieldGlow },
+        { GLProgram::SHADER_NAME_LABEL_NORMAL, kShaderType_LabelNormal },
+        { GLProgram::SHADER_NAME_LABEL_OUTLINE, kShaderType_LabelOutline },
+        { GLProgram::SHADER_NAME_GRID3D_WAVES3D, kShaderType_Grid3DWaves3D },
+        { GLProgram::SHADER_NAME_GRID3D_RIPPLE3D, kShaderType_Grid3DRipple3D },
+        { GLProgram::SHADER_NAME_GRID3D_WAVES, kShaderType_Grid3DWaves },
+        { GLProgram::SHADER_NAME_GRID3D_LIQUID, kShaderType_Grid3DLiquid },
+        { GLProgram::SHADER_NAME_GRID3D_TWIRL, kShaderType_Grid3DTwirl },
+        { GLProgram::SHADER_NAME_PARTICLE_GPU, kShaderType_ParticleGPU },
+    };
+
+    for (const auto& program : defaultPrograms)
+    {
+        _defaultPrograms[program.key] = program.type;
+    }
+}
 
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelOutline);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_OUTLINE, p) );
+void GLProgramCache::preloadDefaultGLPrograms()
+{
+    for (const auto& program : _defaultPrograms)
+    {
+        getGLProgram(program.first);
+    }
 }
 
 void GLProgramCache::reloadDefaultGLPrograms()
 {
-    // reset all programs and reload them
-    
-    // Position Texture Color shader
-    GLProgram *p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR);    
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor);
-
-    // Position Texture Color without MVP shader
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
-    p->reset();    
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor_noMVP);
-
-    // Position Texture Color alpha test
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST);
-    p->reset();    
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTest);
-    
-    // Position Texture Color alpha test
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV);
-    p->reset();    
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTestNoMV);
-    //
-    // Position, Color shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionColor);
-    
-    //
-    // Position, Color shader no MVP
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP);
-    loadDefaultGLProgram(p, kShaderType_PositionColor_noMVP);
-
-    //
-    // Position Texture shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture);
-    
-    //
-    // Position, Texture attribs, 1 Color as uniform shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture_uColor);
-    
-    //
-    // Position Texture A8 Color shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureA8Color);
-    
-    //
-    // Position and 1 color passed as a uniform (to simulate glColor4ub )
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_U_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_Position_uColor);
-    
-    //
-	// Position, Legth(TexCoords, Color (used by Draw Node basically )
-	//
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionLengthTexureColor);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldGlow);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_NORMAL);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelNormal);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_OUTLINE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelOutline);
+    // reset the programs that were loaded and reload them, the others are still loaded on demand
+    for (const auto& program : _defaultPrograms)
+    {
+        auto it = _programs.find(program.first);
+        if (it != _programs.end())
+        {
+            GLProgram *p = it->second;
+            p->reset();
+            loadDefaultGLProgram(p, program.second);
+        }
+    }
 }
 
 void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
 {
+    auto start = std::chrono::high_resolution_clock::now();
+
     switch (type) {
         case kShaderType_PositionTextureColor:
             p->initWithByteArrays(ccPositionTextureColor_vert, ccPositionTextureColor_frag);
@@ -287,6 +188,9 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_PositionTextureColor_noMVP:
             p->initWithByteArrays(ccPositionTextureColor_noMVP_vert, ccPositionTextureColor_noMVP_frag);
             break;
+        case kShaderType_PositionTextureColor_instanced:
+            p->initWithByteArrays(ccPositionTextureColor_instanced_vert, ccPositionTextureColor_noMVP_frag);
+            break;
 
         case kShaderType_PositionTextureColorAlphaTest:
             p->initWithByteArrays(ccPositionTextureColor_vert, ccPositionTextureColorAlphaTest_frag);
@@ -317,6 +221,9 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_PositionLengthTexureColor:
             p->initWithByteArrays(ccPositionColorLengthTexture_vert, ccPositionColorLengthTexture_frag);
             break;
+        case kShaderType_PositionLengthTexureColor_noMVP:
+            p->initWithByteArrays(ccPositionColorLengthTexture_noMVP_vert, ccPositionColorLengthTexture_frag);
+            break;
         case kShaderType_LabelDistanceFieldNormal:
             p->initWithByteArrays(ccLabel_vert, ccLabelDistanceFieldNormal_frag);
             break;
@@ -329,6 +236,24 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_LabelOutline:
             p->initWithByteArrays(ccLabel_vert, ccLabelOutline_frag);
             break;
+        case kShaderType_Grid3DWaves3D:
+            p->initWithByteArrays(ccGrid3D_waves3D_vert, ccPositionTexture_frag);
+            break;
+        case kShaderType_Grid3DRipple3D:
+            p->initWithByteArrays(ccGrid3D_ripple3D_vert, ccPositionTexture_frag);
+            break;
+        case kShaderType_Grid3DWaves:
+            p->initWithByteArrays(ccGrid3D_waves_vert, ccPositionTexture_frag);
+            break;
+        case kShaderType_Grid3DLiquid:
+            p->initWithByteArrays(ccGrid3D_liquid_vert, ccPositionTexture_frag);
+            break;
+        case kShaderType_Grid3DTwirl:
+            p->initWithByteArrays(ccGrid3D_twirl_vert, ccPositionTexture_frag);
+            break;
+        case kShaderType_ParticleGPU:
+            p->initWithByteArrays(ccParticleGPU_vert, ccPositionTextureColor_frag);
+            break;
         default:
             CCLOG("cocos2d: %s:%d, error shader type", __FUNCTION__, __LINE__);
             return;
@@ -338,6 +263,12 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
     p->updateUniforms();
     
     CHECK_GL_ERROR_DEBUG();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    float ms = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0f;
+    _defaultProgramsLoadTime += ms;
+    ++_loadedDefaultPrograms;
+    CCLOGINFO("cocos2d: GLProgramCache: default program %d loaded in %.2f ms", type, ms);
 }
 
 GLProgram* GLProgramCache::getGLProgram(const std::string &key)
@@ -345,6 +276,15 @@ GLProgram* GLProgramCache::getGLProgram(const std::string &key)
     auto it = _programs.find(key);
     if( it != _programs.end() )
         return it->second;
+
+    auto defaultIt = _defaultPrograms.find(key);
+    if( defaultIt != _defaultPrograms.end() )
+    {
+        GLProgram *p = new GLProgram();
+        loadDefaultGLProgram(p, defaultIt->second);
+        _programs.insert( std::make_pair(key, p) );
+        return p;
+    }
     return nullptr;
 }
 
@@ -71,15 +71,22 @@ public:
     /** @deprecated Use destroyInstance() instead */
     CC_DEPRECATED_ATTRIBUTE static void purgeSharedShaderCache();
 
-    /** loads the default shaders */
+    /** registers the default shaders. They are compiled the first time getGLProgram() returns them.
+     Since v3.2 they are no longer all compiled at startup: call preloadDefaultGLPrograms() for that.
+     */
     void loadDefaultGLPrograms();
+
+    /** compiles the default shaders that have not been requested yet, e.g. while a loading screen is displayed
+     @since v3.2
+     */
+    void preloadDefaultGLPrograms();
     CC_DEPRECATED_ATTRIBUTE void loadDefaultShaders() { loadDefaultGLPrograms(); }
 
     /** reload the default shaders */
     void reloadDefaultGLPrograms();
     CC_DEPRECATED_ATTRIBUTE void reloadDefaultShaders() { reloadDefaultGLPrograms(); }
 
-    /** returns a GL program for a given key 
+    /** returns a GL program for a given key. Default programs are compiled on the first call.
      */
     GLProgram * getGLProgram(const std::string &key);
     CC_DEPRECATED_ATTRIBUTE GLProgram * getProgram(const std::string &key) { return getGLProgram(key); }
@@ -89,12 +96,26 @@ public:
     void addGLProgram(GLProgram* program, const std::string &key);
     CC_DEPRECATED_ATTRIBUTE void addProgram(GLProgram* program, const std::string &key) { addGLProgram(program, key); }
 
+    /** number of default programs compiled, or loaded from the GLProgramBinaryCache, so far
+     @since v3.2
+     */
+    inline int getLoadedDefaultProgramsCount() const { return _loadedDefaultPrograms; }
+
+    /** time spent loading the default programs so far, in milliseconds
+     @since v3.2
+     */
+    inline float getDefaultProgramsLoadTime() const { return _defaultProgramsLoadTime; }
+
 private:
     bool init();
     void loadDefaultGLProgram(GLProgram *program, int type);
 
 //    Dictionary* _programs;
     std::unordered_map<std::string, GLProgram*> _programs;
+    // key -> shader type of the default programs, loaded by getGLProgram() when needed
+    std::unordered_map<std::string, int> _defaultPrograms;
+    int _loadedDefaultPrograms;
+    float _defaultProgramsLoadTime;
 };
 
 // end of shaders group
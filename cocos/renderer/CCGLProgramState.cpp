@@ -43,6 +43,8 @@ NS_CC_BEGIN
 
 UniformValue::UniformValue()
 : _useCallback(false)
+, _dirty(true)
+, _textureUnitAssigned(false)
 , _uniform(nullptr)
 , _glprogram(nullptr)
 {
@@ -50,6 +52,8 @@ UniformValue::UniformValue()
 
 UniformValue::UniformValue(Uniform *uniform, GLProgram* glprogram)
 : _useCallback(false)
+, _dirty(true)
+, _textureUnitAssigned(false)
 , _uniform(uniform)
 , _glprogram(glprogram)
 {
@@ -105,6 +109,12 @@ void UniformValue::apply()
     }
 }
 
+bool UniformValue::needsApply() const
+{
+    // textures have to be bound again and callbacks can return a different value
+    return _dirty || _useCallback || _uniform->type == GL_SAMPLER_2D;
+}
+
 void UniformValue::setCallback(const std::function<void(Uniform*)> &callback)
 {
 	// delete previously set callback
@@ -118,6 +128,9 @@ void UniformValue::setCallback(const std::function<void(Uniform*)> &callback)
 	*_value.callback = callback;
 
     _useCallback = true;
+    _dirty = true;
+    // the callback replaced the texture unit
+    _textureUnitAssigned = false;
 }
 
 void UniformValue::setFloat(float value)
@@ -125,6 +138,7 @@ void UniformValue::setFloat(float value)
     CCASSERT (_uniform->type == GL_FLOAT, "");
     _value.floatValue = value;
     _useCallback = false;
+    _dirty = true;
 }
 
 void UniformValue::setTexture(GLuint textureId, GLuint textureUnit)
@@ -133,12 +147,15 @@ void UniformValue::setTexture(GLuint textureId, GLuint textureUnit)
     _value.tex.textureId = textureId;
     _value.tex.textureUnit = textureUnit;
     _useCallback = false;
+    _dirty = true;
+    _textureUnitAssigned = true;
 }
 void UniformValue::setInt(int value)
 {
     CCASSERT(_uniform->type == GL_INT, "Wrong type: expecting GL_INT");
     _value.intValue = value;
     _useCallback = false;
+    _dirty = true;
 }
 
 void UniformValue::setVec2(const Vec2& value)
@@ -146,6 +163,7 @@ void UniformValue::setVec2(const Vec2& value)
     CCASSERT (_uniform->type == GL_FLOAT_VEC2, "");
 	memcpy(_value.v2Value, &value, sizeof(_value.v2Value));
     _useCallback = false;
+    _dirty = true;
 }
 
 void UniformValue::setVec3(const Vec3& value)
@@ -153,6 +171,7 @@ void UniformValue::setVec3(const Vec3& value)
     CCASSERT (_uniform->type == GL_FLOAT_VEC3, "");
 	memcpy(_value.v3Value, &value, sizeof(_value.v3Value));
 	_useCallback = false;
+    _dirty = true;
 }
 
 void UniformValue::setVec4(const Vec4& value)
@@ -160,6 +179,7 @@ void UniformValue::setVec4(const Vec4& value)
     CCASSERT (_uniform->type == GL_FLOAT_VEC4, "");
 	memcpy(_value.v4Value, &value, sizeof(_value.v4Value));
 	_useCallback = false;
+    _dirty = true;
 }
 
 void UniformValue::setMat4(const Mat4& value)
@@ -167,6 +187,7 @@ void UniformValue::setMat4(const Mat4& value)
     CCASSERT(_uniform->type == GL_FLOAT_MAT4, "");
 	memcpy(_value.matrixValue, &value, sizeof(_value.matrixValue));
 	_useCallback = false;
+    _dirty = true;
 }
 
 //
@@ -272,8 +293,8 @@ GLProgramState::GLProgramState()
 }
 
 GLProgramState::~GLProgramState()
-{    
-    CC_SAFE_RELEASE(_glprogram);
+{
+    resetGLProgram();
 }
 
 bool GLProgramState::init(GLProgram* glprogram)
@@ -283,14 +304,17 @@ bool GLProgramState::init(GLProgram* glprogram)
     _glprogram = glprogram;
     _glprogram->retain();
 
+    // reserved first: the values own their callbacks, they must not be copied once set
+    _attributes.reserve(_glprogram->_vertexAttribs.size());
     for(auto &attrib : _glprogram->_vertexAttribs) {
-        VertexAttribValue value(&attrib.second);
-        _attributes[attrib.first] = value;
+        _attributeHandles[attrib.first] = static_cast<int>(_attributes.size());
+        _attributes.push_back(VertexAttribValue(&attrib.second));
     }
 
+    _uniforms.reserve(_glprogram->_userUniforms.size());
     for(auto &uniform : _glprogram->_userUniforms) {
-        UniformValue value(&uniform.second, _glprogram);
-        _uniforms[uniform.first] = value;
+        _uniformHandles[uniform.first] = static_cast<int>(_uniforms.size());
+        _uniforms.push_back(UniformValue(&uniform.second, _glprogram));
     }
 
     return true;
@@ -298,9 +322,15 @@ bool GLProgramState::init(GLProgram* glprogram)
 
 void GLProgramState::resetGLProgram()
 {
-    CC_SAFE_RELEASE(_glprogram);
+    // the program doesn't hold the values of this state anymore
+    if (_glprogram && _glprogram->_uniformsState == this)
+        _glprogram->_uniformsState = nullptr;
+
+    CC_SAFE_RELEASE_NULL(_glprogram);
     _uniforms.clear();
     _attributes.clear();
+    _uniformHandles.clear();
+    _attributeHandles.clear();
     // first texture is GL_TEXTURE1
     _textureUnitIndex = 1;
 }
@@ -321,14 +351,18 @@ void GLProgramState::apply(const Mat4& modelView)
 
         // set attributes
         for(auto &attribute : _attributes) {
-            attribute.second.apply();
+            attribute.apply();
         }
     }
 
-    // set uniforms
+    // set uniforms: only the ones that changed if the program still has the values of this state
+    bool applyAll = _glprogram->_uniformsState != this;
     for(auto& uniform : _uniforms) {
-        uniform.second.apply();
+        if(applyAll || uniform.needsApply())
+            uniform.apply();
+        uniform._dirty = false;
     }
+    _glprogram->_uniformsState = this;
 }
 
 void GLProgramState::setGLProgram(GLProgram *glprogram)
@@ -341,47 +375,77 @@ void GLProgramState::setGLProgram(GLProgram *glprogram)
     }
 }
 
+int GLProgramState::getUniformHandle(const std::string &name) const
+{
+    const auto itr = _uniformHandles.find(name);
+    if( itr != _uniformHandles.end())
+        return itr->second;
+    return -1;
+}
+
+int GLProgramState::getVertexAttribHandle(const std::string &name) const
+{
+    const auto itr = _attributeHandles.find(name);
+    if( itr != _attributeHandles.end())
+        return itr->second;
+    return -1;
+}
+
+UniformValue* GLProgramState::getUniformValue(int handle)
+{
+    CCASSERT(handle >= 0 && handle < static_cast<int>(_uniforms.size()), "Invalid uniform handle");
+    return &_uniforms[handle];
+}
+
 UniformValue* GLProgramState::getUniformValue(const std::string &name)
 {
-    const auto itr = _uniforms.find(name);
-    if( itr != _uniforms.end())
-        return &itr->second;
+    int handle = getUniformHandle(name);
+    if( handle >= 0 )
+        return &_uniforms[handle];
     return nullptr;
 }
 
 VertexAttribValue* GLProgramState::getVertexAttribValue(const std::string &name)
 {
-    const auto itr = _attributes.find(name);
-    if( itr != _attributes.end())
-        return &itr->second;
+    int handle = getVertexAttribHandle(name);
+    if( handle >= 0 )
+        return &_attributes[handle];
     return nullptr;
 }
 
 // VertexAttrib Setters
 void GLProgramState::setVertexAttribCallback(const std::string &name, const std::function<void(VertexAttrib*)> &callback)
 {
-    VertexAttribValue *v = getVertexAttribValue(name);
-    if(v) {
-        v->setCallback(callback);
-        _vertexAttribsFlags |= 1 << v->_vertexAttrib->index;
-    }
+    int handle = getVertexAttribHandle(name);
+    if(handle >= 0)
+        setVertexAttribCallback(handle, callback);
     else
-    {
 		CCLOG("cocos2d: warning: Attribute not found: %s", name.c_str());
-	}
 }
 
 void GLProgramState::setVertexAttribPointer(const std::string &name, GLint size, GLenum type, GLboolean normalized, GLsizei stride, GLvoid *pointer)
 {
-    auto v = getVertexAttribValue(name);
-    if(v) {
-        v->setPointer(size, type, normalized, stride, pointer);
-        _vertexAttribsFlags |= 1 << v->_vertexAttrib->index;
-    }
+    int handle = getVertexAttribHandle(name);
+    if(handle >= 0)
+        setVertexAttribPointer(handle, size, type, normalized, stride, pointer);
     else
-    {
 		CCLOG("cocos2d: warning: Attribute not found: %s", name.c_str());
-    }
+}
+
+void GLProgramState::setVertexAttribCallback(int handle, const std::function<void(VertexAttrib*)> &callback)
+{
+    CCASSERT(handle >= 0 && handle < static_cast<int>(_attributes.size()), "Invalid attribute handle");
+    auto& v = _attributes[handle];
+    v.setCallback(callback);
+    _vertexAttribsFlags |= 1 << v._vertexAttrib->index;
+}
+
+void GLProgramState::setVertexAttribPointer(int handle, GLint size, GLenum type, GLboolean normalized, GLsizei stride, GLvoid *pointer)
+{
+    CCASSERT(handle >= 0 && handle < static_cast<int>(_attributes.size()), "Invalid attribute handle");
+    auto& v = _attributes[handle];
+    v.setPointer(size, type, normalized, stride, pointer);
+    _vertexAttribsFlags |= 1 << v._vertexAttrib->index;
 }
 
 // Uniform Setters
@@ -449,6 +513,41 @@ void GLProgramState::setUniformMat4(const std::string &uniformName, const Mat4&
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
 
+void GLProgramState::setUniformCallback(int uniformHandle, const std::function<void(Uniform*)> &callback)
+{
+    getUniformValue(uniformHandle)->setCallback(callback);
+}
+
+void GLProgramState::setUniformFloat(int uniformHandle, float value)
+{
+    getUniformValue(uniformHandle)->setFloat(value);
+}
+
+void GLProgramState::setUniformInt(int uniformHandle, int value)
+{
+    getUniformValue(uniformHandle)->setInt(value);
+}
+
+void GLProgramState::setUniformVec2(int uniformHandle, const Vec2& value)
+{
+    getUniformValue(uniformHandle)->setVec2(value);
+}
+
+void GLProgramState::setUniformVec3(int uniformHandle, const Vec3& value)
+{
+    getUniformValue(uniformHandle)->setVec3(value);
+}
+
+void GLProgramState::setUniformVec4(int uniformHandle, const Vec4& value)
+{
+    getUniformValue(uniformHandle)->setVec4(value);
+}
+
+void GLProgramState::setUniformMat4(int uniformHandle, const Mat4& value)
+{
+    getUniformValue(uniformHandle)->setMat4(value);
+}
+
 // Textures
 
 void GLProgramState::setUniformTexture(const std::string &uniformName, Texture2D *texture)
@@ -459,12 +558,25 @@ void GLProgramState::setUniformTexture(const std::string &uniformName, Texture2D
 
 void GLProgramState::setUniformTexture(const std::string &uniformName, GLuint textureId)
 {
-    auto v = getUniformValue(uniformName);
-    if (v)
-        v->setTexture(textureId, _textureUnitIndex++);
+    int handle = getUniformHandle(uniformName);
+    if (handle >= 0)
+        setUniformTexture(handle, textureId);
     else
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
 
+void GLProgramState::setUniformTexture(int uniformHandle, Texture2D *texture)
+{
+    CCASSERT(texture, "Invalid texture");
+    setUniformTexture(uniformHandle, texture->getName());
+}
+
+void GLProgramState::setUniformTexture(int uniformHandle, GLuint textureId)
+{
+    auto v = getUniformValue(uniformHandle);
+    // a sampler keeps its texture unit when its texture is changed
+    GLuint textureUnit = v->_textureUnitAssigned ? v->_value.tex.textureUnit : _textureUnitIndex++;
+    v->setTexture(textureId, textureUnit);
+}
 
 NS_CC_END
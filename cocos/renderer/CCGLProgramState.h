@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "math/Vector4.h"
 
 #include <unordered_map>
+#include <vector>
 
 NS_CC_BEGIN
 
@@ -48,6 +49,7 @@ struct VertexAttrib;
 class UniformValue
 {
     friend class GLProgram;
+    friend class GLProgramState;
 
 public:
     UniformValue();
@@ -66,9 +68,15 @@ public:
     void apply();
 
 protected:
+    // whether the value has to be sent again when the program still has the previous values of the state
+    bool needsApply() const;
+
 	Uniform* _uniform;  // weak ref
     GLProgram* _glprogram; // weak ref
     bool _useCallback;
+    bool _dirty;
+    // whether _value.tex.textureUnit holds the unit given to this sampler
+    bool _textureUnitAssigned;
 
     union U{
         float floatValue;
@@ -178,6 +186,30 @@ public:
     void setUniformTexture(const std::string &uniformName, Texture2D *texture);
     void setUniformTexture(const std::string &uniformName, GLuint textureId);
 
+    /** Returns the handle of an attribute, to set it without looking up its name. -1 if the program has no such attribute.
+     Handles stay valid until the GLProgram of the state is changed.
+     @since v3.2
+     */
+    int getVertexAttribHandle(const std::string &name) const;
+    void setVertexAttribCallback(int handle, const std::function<void(VertexAttrib*)> &callback);
+    void setVertexAttribPointer(int handle, GLint size, GLenum type, GLboolean normalized, GLsizei stride, GLvoid *pointer);
+
+    /** Returns the handle of a uniform, to set it without looking up its name. -1 if the program has no such uniform.
+     Handles stay valid until the GLProgram of the state is changed.
+     Setting a uniform every frame (per instance colors, time...) should use them.
+     @since v3.2
+     */
+    int getUniformHandle(const std::string &uniformName) const;
+    void setUniformInt(int uniformHandle, int value);
+    void setUniformFloat(int uniformHandle, float value);
+    void setUniformVec2(int uniformHandle, const Vec2& value);
+    void setUniformVec3(int uniformHandle, const Vec3& value);
+    void setUniformVec4(int uniformHandle, const Vec4& value);
+    void setUniformMat4(int uniformHandle, const Mat4& value);
+    void setUniformCallback(int uniformHandle, const std::function<void(Uniform*)> &callback);
+    void setUniformTexture(int uniformHandle, Texture2D *texture);
+    void setUniformTexture(int uniformHandle, GLuint textureId);
+
 protected:
     GLProgramState();
     ~GLProgramState();
@@ -185,9 +217,13 @@ protected:
     void resetGLProgram();
     VertexAttribValue* getVertexAttribValue(const std::string &attributeName);
     UniformValue* getUniformValue(const std::string &uniformName);
+    UniformValue* getUniformValue(int uniformHandle);
 
-    std::unordered_map<std::string, UniformValue> _uniforms;
-    std::unordered_map<std::string, VertexAttribValue> _attributes;
+    // the values are indexed by handle
+    std::vector<UniformValue> _uniforms;
+    std::vector<VertexAttribValue> _attributes;
+    std::unordered_map<std::string, int> _uniformHandles;
+    std::unordered_map<std::string, int> _attributeHandles;
 
     int _textureUnitIndex;
     uint32_t _vertexAttribsFlags;
@@ -31,6 +31,7 @@
 #include "CCRenderCommandPool.h"
 
 #include <unordered_map>
+#include <mutex>
 
 NS_CC_BEGIN
 
@@ -46,6 +47,8 @@ protected:
     ~GroupCommandManager();
     bool init();
     std::unordered_map<int, bool> _groupMapping;
+    // group commands can be initialized from the worker threads of Renderer::visitInParallel()
+    std::mutex _mutex;
 };
 
 class GroupCommand : public RenderCommand
@@ -83,6 +83,12 @@ void QuadCommand::generateMaterialID()
 
         _materialID = XXH32((const void*)intArray, sizeof(intArray), 0);
     }
+
+    // keep the layer and depth set by the owner, the material goes in the low bits.
+    // Different materials might share a key: that only costs a batch, the material ID still decides.
+    uint8_t blend = (uint8_t)(_blendType.src * 31 + _blendType.dst);
+    _sortKey = (_sortKey & ~0xFFFFFFFFFFull)
+             | makeSortKey(0, 0, (uint16_t)_glProgramState->getGLProgram()->getProgram(), (uint16_t)_textureID, blend);
 }
 
 void QuadCommand::useMaterial() const
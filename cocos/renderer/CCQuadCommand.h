@@ -55,6 +55,8 @@ public:
     inline GLProgramState* getGLProgramState() const { return _glProgramState; }
     inline BlendFunc getBlendType() const { return _blendType; }
     inline const Mat4& getModelView() const { return _mv; }
+    /** Whether the quads hide what is behind them: they are drawn without blending (`BlendFunc::DISABLE`) */
+    inline bool isOpaque() const { return _blendType.src == GL_ONE && _blendType.dst == GL_ZERO; }
     
 
 protected:
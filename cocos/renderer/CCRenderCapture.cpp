@@ -0,0 +1,483 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "renderer/CCRenderCapture.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "renderer/CCRenderer.h"
+#include "renderer/CCQuadCommand.h"
+#include "renderer/CCTrianglesCommand.h"
+#include "renderer/CCCustomCommand.h"
+#include "renderer/CCGroupCommand.h"
+#include "renderer/CCGLProgram.h"
+#include "renderer/CCGLProgramState.h"
+#include "renderer/ccShaders.h"
+#include "2d/CCTexture2D.h"
+#include "2d/platform/CCFileUtils.h"
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+static const char CAPTURE_MAGIC[4] = { 'C', 'C', 'R', 'C' };
+
+// noMVP fragment shader with a uniform: the commands that had uniforms are not batched when replayed either
+static const char* s_doNotBatchFrag =
+    "#ifdef GL_ES\n"
+    "precision lowp float;\n"
+    "#endif\n"
+    "varying vec4 v_fragmentColor;\n"
+    "varying vec2 v_texCoord;\n"
+    "uniform vec4 u_replayColor;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_FragColor = v_fragmentColor * texture2D(CC_Texture0, v_texCoord) * u_replayColor;\n"
+    "}\n";
+
+//
+// RenderCapture
+//
+
+RenderCapture::RenderCapture(const std::string& filename, int frameCount)
+: _filename(filename)
+, _frameCount(frameCount)
+, _recordedFrames(0)
+, _recordCountOffset(0)
+, _recordCount(0)
+{
+    CCASSERT(frameCount > 0, "At least one frame has to be captured");
+}
+
+void RenderCapture::writeBytes(const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    _data.insert(_data.end(), bytes, bytes + size);
+}
+
+void RenderCapture::beginFrame()
+{
+    // the record count is patched by endFrame()
+    _recordCountOffset = _data.size();
+    _recordCount = 0;
+    write(_recordCount);
+}
+
+bool RenderCapture::endFrame()
+{
+    memcpy(&_data[_recordCountOffset], &_recordCount, sizeof(_recordCount));
+
+    if (++_recordedFrames < _frameCount)
+    {
+        return false;
+    }
+
+    if (save())
+    {
+        CCLOG("cocos2d: RenderCapture: %d frames saved to %s", _recordedFrames, _filename.c_str());
+    }
+    else
+    {
+        CCLOG("cocos2d: RenderCapture: can't write %s", _filename.c_str());
+    }
+    return true;
+}
+
+bool RenderCapture::save() const
+{
+    FILE* file = fopen(_filename.c_str(), "wb");
+    if (!file)
+    {
+        return false;
+    }
+
+    uint32_t version = VERSION;
+    uint32_t frameCount = _recordedFrames;
+    bool ok = fwrite(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC), 1, file) == 1
+           && fwrite(&version, sizeof(version), 1, file) == 1
+           && fwrite(&frameCount, sizeof(frameCount), 1, file) == 1
+           && (_data.empty() || fwrite(_data.data(), _data.size(), 1, file) == 1);
+    fclose(file);
+
+    return ok;
+}
+
+void RenderCapture::writeMaterial(GLuint textureID, GLProgramState* glProgramState, const BlendFunc& blendFunc, bool doNotBatch, const Mat4& mv)
+{
+    write((uint32_t) textureID);
+    write((uint32_t) glProgramState->getGLProgram()->getProgram());
+    write((uint32_t) blendFunc.src);
+    write((uint32_t) blendFunc.dst);
+    write((uint8_t) doNotBatch);
+    writeBytes(mv.m, sizeof(mv.m));
+}
+
+void RenderCapture::recordQuads(const QuadCommand* cmd)
+{
+    write(RenderCaptureRecord::QUADS);
+    writeMaterial(cmd->getTextureID(), cmd->getGLProgramState(), cmd->getBlendType(),
+                  cmd->getMaterialID() == QuadCommand::MATERIAL_ID_DO_NOT_BATCH, cmd->getModelView());
+    write((uint32_t) cmd->getQuadCount());
+    writeBytes(cmd->getQuads(), sizeof(V3F_C4B_T2F_Quad) * cmd->getQuadCount());
+    ++_recordCount;
+}
+
+void RenderCapture::recordTriangles(const TrianglesCommand* cmd)
+{
+    write(RenderCaptureRecord::TRIANGLES);
+    writeMaterial(cmd->getTextureID(), cmd->getGLProgramState(), cmd->getBlendType(),
+                  cmd->getMaterialID() == TrianglesCommand::MATERIAL_ID_DO_NOT_BATCH, cmd->getModelView());
+    write((uint32_t) cmd->getVertexCount());
+    write((uint32_t) cmd->getIndexCount());
+    writeBytes(cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
+    writeBytes(cmd->getIndices(), sizeof(GLuint) * cmd->getIndexCount());
+    ++_recordCount;
+}
+
+void RenderCapture::recordMarker(RenderCaptureRecord record)
+{
+    write(record);
+    ++_recordCount;
+}
+
+//
+// RenderReplay
+//
+
+// bounds checked reads of a capture file
+class CaptureReader
+{
+public:
+    CaptureReader(const unsigned char* data, size_t size) : _data(data), _size(size), _offset(0), _ok(true) {}
+
+    bool readBytes(void* dst, size_t size)
+    {
+        if (!_ok || _size - _offset < size)
+        {
+            _ok = false;
+            return false;
+        }
+        memcpy(dst, _data + _offset, size);
+        _offset += size;
+        return true;
+    }
+
+    template <typename T> T read()
+    {
+        T value = T();
+        readBytes(&value, sizeof(value));
+        return value;
+    }
+
+    // fails the reader when `count` elements can't be in the rest of the data, before anything is allocated for them
+    bool canRead(size_t count, size_t elementSize)
+    {
+        if (!_ok || count > remaining() / elementSize)
+        {
+            _ok = false;
+            return false;
+        }
+        return true;
+    }
+
+    size_t remaining() const { return _size - _offset; }
+    void fail() { _ok = false; }
+    bool isOk() const { return _ok; }
+
+protected:
+    const unsigned char* _data;
+    size_t _size;
+    size_t _offset;
+    bool _ok;
+};
+
+RenderReplay::RenderReplay()
+{
+}
+
+RenderReplay::~RenderReplay()
+{
+    clear();
+}
+
+void RenderReplay::clear()
+{
+    for (auto& frame : _frames)
+    {
+        for (auto& record : frame)
+        {
+            switch (record.type)
+            {
+                case RenderCaptureRecord::QUADS:
+                    delete static_cast<QuadCommand*>(record.command);
+                    break;
+                case RenderCaptureRecord::TRIANGLES:
+                    delete static_cast<TrianglesCommand*>(record.command);
+                    break;
+                case RenderCaptureRecord::CUSTOM:
+                case RenderCaptureRecord::BATCH:
+                    delete static_cast<CustomCommand*>(record.command);
+                    break;
+                case RenderCaptureRecord::GROUP_BEGIN:
+                    delete static_cast<GroupCommand*>(record.command);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    _frames.clear();
+    _quads.clear();
+    _verts.clear();
+    _indices.clear();
+
+    for (auto& texture : _textures)
+    {
+        CC_SAFE_RELEASE(texture.second);
+    }
+    _textures.clear();
+
+    for (auto& glProgramState : _glProgramStates)
+    {
+        glProgramState.second->release();
+    }
+    _glProgramStates.clear();
+}
+
+GLuint RenderReplay::getTexture(uint32_t capturedTexture)
+{
+    if (capturedTexture == 0)
+    {
+        return 0;
+    }
+
+    auto it = _textures.find(capturedTexture);
+    if (it != _textures.end())
+    {
+        return it->second ? it->second->getName() : 0;
+    }
+
+    // the content doesn't matter, only the texture switches do
+    static const uint32_t pixels[4] = { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff };
+    auto texture = new (std::nothrow) Texture2D();
+    if (texture && !texture->initWithData(pixels, sizeof(pixels), Texture2D::PixelFormat::RGBA8888, 2, 2, Size(2, 2)))
+    {
+        CC_SAFE_DELETE(texture);
+    }
+    _textures[capturedTexture] = texture;
+
+    return texture ? texture->getName() : 0;
+}
+
+GLProgramState* RenderReplay::getGLProgramState(uint32_t capturedProgram, bool doNotBatch)
+{
+    uint64_t key = ((uint64_t) capturedProgram << 1) | (doNotBatch ? 1 : 0);
+    auto it = _glProgramStates.find(key);
+    if (it != _glProgramStates.end())
+    {
+        return it->second;
+    }
+
+    // one program per captured program: the material IDs are as different as they were
+    auto glProgram = GLProgram::createWithByteArrays(ccPositionTextureColor_noMVP_vert, doNotBatch ? s_doNotBatchFrag : ccPositionTextureColor_noMVP_frag);
+    auto glProgramState = GLProgramState::create(glProgram);
+    if (doNotBatch)
+    {
+        glProgramState->setUniformVec4("u_replayColor", Vec4(1, 1, 1, 1));
+    }
+    _glProgramStates[key] = glProgramState;
+
+    return glProgramState;
+}
+
+bool RenderReplay::load(const std::string& filename)
+{
+    clear();
+
+    Data data = FileUtils::getInstance()->getDataFromFile(filename);
+    CaptureReader reader(data.getBytes(), data.getSize());
+
+    char magic[4];
+    if (!reader.readBytes(magic, sizeof(magic)) || memcmp(magic, CAPTURE_MAGIC, sizeof(magic)) != 0
+        || reader.read<uint32_t>() != RenderCapture::VERSION)
+    {
+        CCLOG("cocos2d: RenderReplay: %s is not a render capture", filename.c_str());
+        return false;
+    }
+
+    // every frame has at least its record count
+    uint32_t frameCount = reader.read<uint32_t>();
+    if (reader.canRead(frameCount, sizeof(uint32_t)))
+    {
+        _frames.resize(frameCount);
+    }
+
+    // the payloads are read first, the commands point to them once the vectors are complete
+    for (uint32_t frame = 0; frame < frameCount && reader.isOk(); ++frame)
+    {
+        uint32_t recordCount = reader.read<uint32_t>();
+        for (uint32_t i = 0; i < recordCount && reader.isOk(); ++i)
+        {
+            Record record;
+            record.type = reader.read<RenderCaptureRecord>();
+            record.textureID = 0;
+            record.glProgramState = nullptr;
+            record.blendFunc = BlendFunc::DISABLE;
+            record.first = record.count = record.firstIndex = record.indexCount = 0;
+            record.command = nullptr;
+
+            if (record.type == RenderCaptureRecord::QUADS || record.type == RenderCaptureRecord::TRIANGLES)
+            {
+                uint32_t texture = reader.read<uint32_t>();
+                uint32_t program = reader.read<uint32_t>();
+                record.blendFunc.src = reader.read<uint32_t>();
+                record.blendFunc.dst = reader.read<uint32_t>();
+                bool doNotBatch = reader.read<uint8_t>() != 0;
+                reader.readBytes(record.mv.m, sizeof(record.mv.m));
+                if (!reader.isOk())
+                    break;
+
+                record.textureID = getTexture(texture);
+                record.glProgramState = getGLProgramState(program, doNotBatch);
+            }
+
+            if (record.type == RenderCaptureRecord::QUADS)
+            {
+                record.count = reader.read<uint32_t>();
+                if (!reader.canRead(record.count, sizeof(V3F_C4B_T2F_Quad)))
+                    break;
+                record.first = _quads.size();
+                _quads.resize(record.first + record.count);
+                reader.readBytes(_quads.data() + record.first, sizeof(V3F_C4B_T2F_Quad) * record.count);
+            }
+            else if (record.type == RenderCaptureRecord::TRIANGLES)
+            {
+                record.count = reader.read<uint32_t>();
+                record.indexCount = reader.read<uint32_t>();
+                if (!reader.canRead(record.count, sizeof(V3F_C4B_T2F)))
+                    break;
+                record.first = _verts.size();
+                _verts.resize(record.first + record.count);
+                reader.readBytes(_verts.data() + record.first, sizeof(V3F_C4B_T2F) * record.count);
+
+                if (!reader.canRead(record.indexCount, sizeof(GLuint)))
+                    break;
+                record.firstIndex = _indices.size();
+                _indices.resize(record.firstIndex + record.indexCount);
+                reader.readBytes(_indices.data() + record.firstIndex, sizeof(GLuint) * record.indexCount);
+            }
+            else if (record.type < RenderCaptureRecord::QUADS || record.type > RenderCaptureRecord::GROUP_END)
+            {
+                reader.fail();
+                break;
+            }
+
+            _frames[frame].push_back(record);
+        }
+    }
+
+    if (!reader.isOk())
+    {
+        CCLOG("cocos2d: RenderReplay: %s is truncated or corrupted", filename.c_str());
+        clear();
+        return false;
+    }
+
+    for (auto& frame : _frames)
+    {
+        for (auto& record : frame)
+        {
+            switch (record.type)
+            {
+                case RenderCaptureRecord::QUADS:
+                    record.command = new QuadCommand();
+                    break;
+                case RenderCaptureRecord::TRIANGLES:
+                    record.command = new TrianglesCommand();
+                    break;
+                case RenderCaptureRecord::CUSTOM:
+                case RenderCaptureRecord::BATCH:
+                    record.command = new CustomCommand();
+                    break;
+                case RenderCaptureRecord::GROUP_BEGIN:
+                    record.command = new GroupCommand();
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    return true;
+}
+
+void RenderReplay::submitFrame(Renderer* renderer, ssize_t frame)
+{
+    CCASSERT(frame >= 0 && frame < static_cast<ssize_t>(_frames.size()), "Invalid frame");
+
+    // the commands are submitted in the order they were executed, so they all go in the global order 0 queue
+    for (auto& record : _frames[frame])
+    {
+        switch (record.type)
+        {
+            case RenderCaptureRecord::QUADS:
+            {
+                auto cmd = static_cast<QuadCommand*>(record.command);
+                cmd->init(0, record.textureID, record.glProgramState, record.blendFunc, &_quads[record.first], record.count, record.mv);
+                renderer->addCommand(cmd);
+                break;
+            }
+            case RenderCaptureRecord::TRIANGLES:
+            {
+                auto cmd = static_cast<TrianglesCommand*>(record.command);
+                TrianglesCommand::Triangles triangles = { _verts.data() + record.first, _indices.data() + record.firstIndex, (ssize_t) record.count, (ssize_t) record.indexCount };
+                cmd->init(0, record.textureID, record.glProgramState, record.blendFunc, triangles, record.mv);
+                renderer->addCommand(cmd);
+                break;
+            }
+            case RenderCaptureRecord::CUSTOM:
+            case RenderCaptureRecord::BATCH:
+            {
+                auto cmd = static_cast<CustomCommand*>(record.command);
+                cmd->init(0);
+                renderer->addCommand(cmd);
+                break;
+            }
+            case RenderCaptureRecord::GROUP_BEGIN:
+            {
+                auto cmd = static_cast<GroupCommand*>(record.command);
+                cmd->init(0);
+                renderer->addCommand(cmd);
+                renderer->pushGroup(cmd->getRenderQueueID());
+                break;
+            }
+            case RenderCaptureRecord::GROUP_END:
+                renderer->popGroup();
+                break;
+        }
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,154 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_RENDER_CAPTURE_H_
+#define __CC_RENDER_CAPTURE_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "base/CCPlatformMacros.h"
+#include "base/ccTypes.h"
+#include "math/CCMath.h"
+
+NS_CC_BEGIN
+
+class Renderer;
+class RenderCommand;
+class QuadCommand;
+class TrianglesCommand;
+class GLProgramState;
+class Texture2D;
+
+/** Records of a capture file, see RenderCapture */
+enum class RenderCaptureRecord : uint8_t
+{
+    QUADS = 1,
+    TRIANGLES,
+    // markers: what they drew can't be saved, but they break the batches when replayed
+    CUSTOM,
+    BATCH,
+    GROUP_BEGIN,
+    GROUP_END,
+};
+
+/** Records the command streams of the frames rendered by the `Renderer` into a file that `RenderReplay` can load.
+
+ The commands are recorded in the order the renderer executes them, once sorted. The file is in native byte order:
+
+    header:    "CCRC", uint32 version, uint32 frame count
+    frame:     uint32 record count, records
+    QUADS:     uint8 type, material, float[16] model view, uint32 quad count, V3F_C4B_T2F_Quad[quad count]
+    TRIANGLES: uint8 type, material, float[16] model view, uint32 vertex count, uint32 index count,
+               V3F_C4B_T2F[vertex count], uint32[index count]
+    markers:   uint8 type
+    material:  uint32 texture, uint32 program, uint32 blend src, uint32 blend dst, uint8 do not batch
+
+ Use `Renderer::startCapture()` or the `capture` command of the Console.
+ */
+class CC_DLL RenderCapture
+{
+public:
+    static const uint32_t VERSION = 1;
+
+    /** Records the next `frameCount` frames into `filename` (full path) */
+    RenderCapture(const std::string& filename, int frameCount);
+
+    void beginFrame();
+    /** Returns true once all the frames are recorded and the file is written */
+    bool endFrame();
+
+    void recordQuads(const QuadCommand* cmd);
+    void recordTriangles(const TrianglesCommand* cmd);
+    void recordMarker(RenderCaptureRecord record);
+
+protected:
+    void writeBytes(const void* data, size_t size);
+    template <typename T> void write(const T& value) { writeBytes(&value, sizeof(value)); }
+    void writeMaterial(GLuint textureID, GLProgramState* glProgramState, const BlendFunc& blendFunc, bool doNotBatch, const Mat4& mv);
+    bool save() const;
+
+    std::string _filename;
+    int _frameCount;
+    int _recordedFrames;
+
+    std::vector<uint8_t> _data;
+    size_t _recordCountOffset;
+    uint32_t _recordCount;
+};
+
+/** Loads the frames recorded by `RenderCapture` and submits them to the `Renderer` again.
+
+ Every texture of the capture is replaced by a placeholder and every program by a copy of the
+ PositionTextureColor_noMVP shader, so the replay batches and switches materials like the captured frames did.
+ Custom and batch commands are replayed as empty custom commands. Must be used from the GL thread.
+ */
+class CC_DLL RenderReplay
+{
+public:
+    RenderReplay();
+    ~RenderReplay();
+
+    /** Loads a capture file, returns false if it is not valid */
+    bool load(const std::string& filename);
+
+    ssize_t getFrameCount() const { return _frames.size(); }
+
+    /** Adds the commands of a captured frame to the renderer, they are drawn by the next `Renderer::render()` */
+    void submitFrame(Renderer* renderer, ssize_t frame);
+
+protected:
+    struct Record
+    {
+        RenderCaptureRecord type;
+        GLuint textureID;
+        GLProgramState* glProgramState;
+        BlendFunc blendFunc;
+        Mat4 mv;
+        // in _quads, or _verts and _indices
+        size_t first;
+        size_t count;
+        size_t firstIndex;
+        size_t indexCount;
+        RenderCommand* command;
+    };
+
+    void clear();
+    GLuint getTexture(uint32_t capturedTexture);
+    GLProgramState* getGLProgramState(uint32_t capturedProgram, bool doNotBatch);
+
+    std::vector<std::vector<Record>> _frames;
+    std::vector<V3F_C4B_T2F_Quad> _quads;
+    std::vector<V3F_C4B_T2F> _verts;
+    std::vector<GLuint> _indices;
+
+    std::unordered_map<uint32_t, Texture2D*> _textures;
+    std::unordered_map<uint64_t, GLProgramState*> _glProgramStates;
+};
+
+NS_CC_END
+
+#endif //__CC_RENDER_CAPTURE_H_
@@ -30,6 +30,8 @@ NS_CC_BEGIN
 RenderCommand::RenderCommand()
 : _type(RenderCommand::Type::UNKNOWN_COMMAND)
 , _globalOrder(0)
+, _sortKey(0)
+, _isOrderIndependent(false)
 {
 }
 
@@ -37,6 +39,16 @@ RenderCommand::~RenderCommand()
 {
 }
 
+uint64_t RenderCommand::makeSortKey(uint8_t layer, uint16_t depth, uint16_t program, uint16_t texture, uint8_t blend)
+{
+    return ((uint64_t)layer << 56) | ((uint64_t)depth << 40) | ((uint64_t)program << 24) | ((uint64_t)texture << 8) | blend;
+}
+
+void RenderCommand::setSortLayer(uint8_t layer, uint16_t depth)
+{
+    _sortKey = (_sortKey & 0xFFFFFFFFFFull) | makeSortKey(layer, depth, 0, 0, 0);
+}
+
 void printBits(ssize_t const size, void const * const ptr)
 {
     unsigned char *b = (unsigned char*) ptr;
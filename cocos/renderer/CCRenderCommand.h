@@ -47,6 +47,7 @@ public:
         CUSTOM_COMMAND,
         BATCH_COMMAND,
         GROUP_COMMAND,
+        TRIANGLES_COMMAND,
     };
 
     /** Get Render Command Id */
@@ -55,6 +56,22 @@ public:
     /** Returns the Command type */
     inline Type getType() const { return _type; }
 
+    /** Packs a sort key. From the most to the least significant bits: layer, depth, program, texture and blend */
+    static uint64_t makeSortKey(uint8_t layer, uint16_t depth, uint16_t program, uint16_t texture, uint8_t blend);
+
+    /** Returns the key used to reorder the order independent commands. See `makeSortKey()` */
+    inline uint64_t getSortKey() const { return _sortKey; }
+
+    /** Sets the layer and depth of the sort key. Commands with a material (like `QuadCommand`) fill the other fields */
+    void setSortLayer(uint8_t layer, uint16_t depth);
+
+    /** Whether the renderer may draw this command before or after the other order independent commands
+     that have the same global order and are queued right next to it, in order to batch the ones that share a material.
+     Only mark commands that don't overlap each other.
+     */
+    inline bool isOrderIndependent() const { return _isOrderIndependent; }
+    inline void setOrderIndependent(bool orderIndependent) { _isOrderIndependent = orderIndependent; }
+
 protected:
     RenderCommand();
     virtual ~RenderCommand();
@@ -66,6 +83,10 @@ protected:
 
     // commands are sort by depth
     float _globalOrder;
+
+    // order independent commands are sort by this key
+    uint64_t _sortKey;
+    bool _isOrderIndependent;
 };
 
 NS_CC_END
@@ -26,11 +26,13 @@
 #ifndef __CC_RENDERCOMMANDPOOL_H__
 #define __CC_RENDERCOMMANDPOOL_H__
 
-#include <set>
-#include <list>
+#include <vector>
 #include "base/CCPlatformMacros.h"
 NS_CC_BEGIN
 
+/** Pool of commands that outlive a frame.
+ For the commands that only live during one frame, prefer `Renderer::getFrameAllocator()`.
+ */
 template <class T>
 class RenderCommandPool
 {
@@ -40,43 +42,30 @@ public:
     }
     ~RenderCommandPool()
     {
-//        if( 0 != _usedPool.size())
-//        {
-//            CCLOG("All RenderCommand should not be used when Pool is released!");
-//        }
         _freePool.clear();
-        for (typename std::list<T*>::iterator iter = _allocatedPoolBlocks.begin(); iter != _allocatedPoolBlocks.end(); ++iter)
+        for (auto& block : _allocatedPoolBlocks)
         {
-            delete[] *iter;
-            *iter = nullptr;
+            delete[] block;
+            block = nullptr;
         }
         _allocatedPoolBlocks.clear();
     }
 
     T* generateCommand()
     {
-        T* result = nullptr;
         if(_freePool.empty())
         {
             AllocateCommands();
         }
-        result = _freePool.front();
-        _freePool.pop_front();
-        //_usedPool.insert(result);
+        T* result = _freePool.back();
+        _freePool.pop_back();
         return result;
     }
     
     void pushBackCommand(T* ptr)
     {
-//        if(_usedPool.find(ptr) == _usedPool.end())
-//        {
-//            CCLOG("push Back Wrong command!");
-//            return;
-//        }
-        
+        // the free pool only grows when a block is allocated: no allocation here
         _freePool.push_back(ptr);
-        //_usedPool.erase(ptr);
-        
     }
 private:
     void AllocateCommands()
@@ -84,15 +73,15 @@ private:
         static const int COMMANDS_ALLOCATE_BLOCK_SIZE = 32;
         T* commands = new T[COMMANDS_ALLOCATE_BLOCK_SIZE];
         _allocatedPoolBlocks.push_back(commands);
-        for(int index = 0; index < COMMANDS_ALLOCATE_BLOCK_SIZE; ++index)
+        _freePool.reserve(_allocatedPoolBlocks.size() * COMMANDS_ALLOCATE_BLOCK_SIZE);
+        for(int index = COMMANDS_ALLOCATE_BLOCK_SIZE - 1; index >= 0; --index)
         {
             _freePool.push_back(commands+index);
         }
     }
 
-    std::list<T*> _allocatedPoolBlocks;
-    std::list<T*> _freePool;
-    //std::set<T*> _usedPool;
+    std::vector<T*> _allocatedPoolBlocks;
+    std::vector<T*> _freePool;
 };
 
 NS_CC_END
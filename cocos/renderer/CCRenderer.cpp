@@ -27,16 +27,21 @@
 #include <algorithm>
 
 #include "renderer/CCQuadCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 #include "renderer/CCBatchCommand.h"
 #include "renderer/CCCustomCommand.h"
 #include "renderer/CCGroupCommand.h"
+#include "renderer/CCFrameAllocator.h"
+#include "renderer/CCRenderCapture.h"
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/ccGLStateCache.h"
+#include "math/MathUtil.h"
 #include "base/CCConfiguration.h"
 #include "base/CCDirector.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
+#include "base/CCWorkerPool.h"
 
 NS_CC_BEGIN
 
@@ -46,6 +51,15 @@ static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
     return a->getGlobalOrder() < b->getGlobalOrder();
 }
 
+template <typename T>
+static void copyIndices(T* dst, const GLuint* src, ssize_t count, GLuint firstVertex)
+{
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        dst[i] = (T) (src[i] + firstVertex);
+    }
+}
+
 // queue
 
 void RenderQueue::push_back(RenderCommand* command)
@@ -69,6 +83,104 @@ void RenderQueue::sort()
     // Don't sort _queue0, it already comes sorted
     std::sort(std::begin(_queueNegZ), std::end(_queueNegZ), compareRenderCommand);
     std::sort(std::begin(_queuePosZ), std::end(_queuePosZ), compareRenderCommand);
+
+    reorderIndependentCommands(_queueNegZ);
+    reorderIndependentCommands(_queue0);
+    reorderIndependentCommands(_queuePosZ);
+}
+
+void RenderQueue::reorderIndependentCommands(std::vector<RenderCommand*>& queue)
+{
+    size_t size = queue.size();
+    size_t begin = 0;
+    while (begin < size)
+    {
+        if (!queue[begin]->isOrderIndependent())
+        {
+            ++begin;
+            continue;
+        }
+
+        // a run ends at the first command that must stay in place, or that has another global order
+        size_t end = begin + 1;
+        while (end < size && queue[end]->isOrderIndependent() && queue[end]->getGlobalOrder() == queue[begin]->getGlobalOrder())
+        {
+            ++end;
+        }
+
+        if (end - begin > 1)
+        {
+            sortBySortKey(&queue[begin], end - begin);
+        }
+        begin = end;
+    }
+}
+
+void RenderQueue::sortBySortKey(RenderCommand** commands, size_t count)
+{
+    // Both sorts are stable: commands with the same key keep their arrival order
+    static const size_t INSERTION_SORT_THRESHOLD = 16;
+    if (count <= INSERTION_SORT_THRESHOLD)
+    {
+        for (size_t i = 1; i < count; ++i)
+        {
+            RenderCommand* command = commands[i];
+            size_t j = i;
+            for (; j > 0 && commands[j - 1]->getSortKey() > command->getSortKey(); --j)
+            {
+                commands[j] = commands[j - 1];
+            }
+            commands[j] = command;
+        }
+        return;
+    }
+
+    // LSD radix sort, one pass per byte of the key
+    _sortEntries.resize(count);
+    _sortScratch.resize(count);
+
+    size_t histograms[8][256] = {};
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64_t key = commands[i]->getSortKey();
+        _sortEntries[i].key = key;
+        _sortEntries[i].command = commands[i];
+        for (int digit = 0; digit < 8; ++digit)
+        {
+            ++histograms[digit][(key >> (digit * 8)) & 0xFF];
+        }
+    }
+
+    SortEntry* src = _sortEntries.data();
+    SortEntry* dst = _sortScratch.data();
+    for (int digit = 0; digit < 8; ++digit)
+    {
+        size_t* histogram = histograms[digit];
+        int shift = digit * 8;
+
+        // skip the bytes that are the same in all the keys, like the layer most of the time
+        if (histogram[(src[0].key >> shift) & 0xFF] == count)
+            continue;
+
+        size_t offset = 0;
+        for (int bucket = 0; bucket < 256; ++bucket)
+        {
+            size_t bucketSize = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketSize;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        commands[i] = src[i].command;
+    }
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -108,31 +220,89 @@ static const int DEFAULT_RENDER_QUEUE = 0;
 Renderer::Renderer()
 :_lastMaterialID(0)
 ,_numQuads(0)
+,_streamedQuads(nullptr)
+,_isQuadsBufferMapped(false)
+,_ringOffset(0)
+,_useUintIndices(false)
+,_numTriVertices(0)
+,_numTriIndices(0)
+,_trianglesVertexCapacity(0)
+,_trianglesIndexCapacity(0)
+,_trianglesVAO(0)
+,_instancedQuadsEnabled(true)
+,_noMVPProgram(nullptr)
+,_instancedProgram(nullptr)
+,_numInstances(0)
+,_instanceRingOffset(0)
+,_instancesVAO(0)
+,_streamedBytes(0)
+,_drawnInstances(0)
+,_culledNodes(0)
 ,_glViewAssigned(false)
+,_opaquePassEnabled(false)
+,_depthBits(-1)
+,_nextDepth(1.0f)
+,_depthStep(0.0f)
+,_isDrawingWithDepth(false)
+,_batchDepth(1.0f)
+,_lastDepth(-1.0f)
+,_overdrawMeasured(false)
+,_isOverdrawQueryActive(false)
+,_overdrawQueryIndex(0)
+,_overdraw(-1.0f)
 ,_isRendering(false)
+,_isVisitingInParallel(false)
+,_capture(nullptr)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
 {
     _groupCommandManager = new GroupCommandManager();
+    _frameAllocators.push_back(new FrameAllocator());
     
     _commandGroupStack.push(DEFAULT_RENDER_QUEUE);
     
     RenderQueue defaultRenderQueue;
     _renderGroups.push_back(defaultRenderQueue);
     _batchedQuadCommands.reserve(BATCH_QUADCOMMAND_RESEVER_SIZE);
+    _buffersVBO[0] = _buffersVBO[1] = 0;
+    _trianglesVBO[0] = _trianglesVBO[1] = 0;
+    _instancesVBO[0] = _instancesVBO[1] = 0;
+    _overdrawQueries[0] = _overdrawQueries[1] = 0;
+    _overdrawQueryPending[0] = _overdrawQueryPending[1] = false;
+    _overdrawPixels[0] = _overdrawPixels[1] = 0;
 }
 
 Renderer::~Renderer()
 {
     _renderGroups.clear();
     _groupCommandManager->release();
+
+    for (auto allocator : _frameAllocators)
+    {
+        delete allocator;
+    }
+    _frameAllocators.clear();
+
+    CC_SAFE_DELETE(_capture);
+
+    setOverdrawMeasured(false);
     
-    glDeleteBuffers(2, _buffersVBO);
+    GL::deleteBuffers(2, _buffersVBO);
+    GL::deleteBuffers(2, _trianglesVBO);
+    if (_instancedProgram)
+    {
+        GL::deleteBuffers(2, _instancesVBO);
+    }
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         glDeleteVertexArrays(1, &_quadVAO);
+        glDeleteVertexArrays(1, &_trianglesVAO);
+        if (_instancesVAO)
+        {
+            glDeleteVertexArrays(1, &_instancesVAO);
+        }
         GL::bindVAO(0);
     }
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -169,10 +339,22 @@ void Renderer::setupIndices()
         _indices[i*6+4] = (GLushort) (i*4+2);
         _indices[i*6+5] = (GLushort) (i*4+1);
     }
+
+    // the indices of the triangles batch are written by the commands
+    _useUintIndices = Configuration::getInstance()->supportsElementIndexUint();
+    _trianglesVertexCapacity = _useUintIndices ? TRIANGLES_VBO_SIZE_UINT : TRIANGLES_VBO_SIZE;
+    _trianglesIndexCapacity = _trianglesVertexCapacity * 2;
+    _triVerts.resize(_trianglesVertexCapacity);
+    if (_useUintIndices)
+        _triIndices32.resize(_trianglesIndexCapacity);
+    else
+        _triIndices16.resize(_trianglesIndexCapacity);
 }
 
 void Renderer::setupBuffer()
 {
+    _ringOffset = 0;
+
     if(Configuration::getInstance()->supportsShareableVAO())
     {
         setupVBOAndVAO();
@@ -181,6 +363,71 @@ void Renderer::setupBuffer()
     {
         setupVBO();
     }
+
+    setupInstancedQuads();
+}
+
+void Renderer::setupInstancedQuads()
+{
+    _instancedProgram = nullptr;
+    _instancesVAO = 0;
+    _instanceRingOffset = 0;
+
+#ifdef CC_GL_INSTANCED_ARRAYS
+    if (!Configuration::getInstance()->supportsInstancedArrays())
+    {
+        return;
+    }
+
+    auto programCache = GLProgramCache::getInstance();
+    _noMVPProgram = programCache->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
+    _instancedProgram = programCache->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_INSTANCED);
+    if (_noMVPProgram == nullptr || _instancedProgram == nullptr)
+    {
+        _instancedProgram = nullptr;
+        return;
+    }
+
+    _instances.resize(VBO_SIZE);
+
+    // corners of the unit quad, drawn as a triangle strip
+    static const GLfloat unitQuad[] = { 0, 0,  1, 0,  0, 1,  1, 1 };
+
+    GL::bindVAO(0);
+    glGenBuffers(2, &_instancesVBO[0]);
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, _instancesVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(unitQuad), unitQuad, GL_STATIC_DRAW);
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, _instancesVBO[1]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_instances[0]) * VBO_RING_SIZE, nullptr, GL_DYNAMIC_DRAW);
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        glGenVertexArrays(1, &_instancesVAO);
+        GL::bindVAO(_instancesVAO);
+
+        GL::bindBuffer(GL_ARRAY_BUFFER, _instancesVBO[0]);
+        glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 0, (GLvoid*) 0);
+
+        // the pointers of the per instance attributes are set when the batch is drawn
+        glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
+        glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
+        glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_INSTANCE_ROW0);
+        glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_INSTANCE_ROW1);
+        glVertexAttribDivisor(GLProgram::VERTEX_ATTRIB_COLOR, 1);
+        glVertexAttribDivisor(GLProgram::VERTEX_ATTRIB_TEX_COORD, 1);
+        glVertexAttribDivisor(GLProgram::VERTEX_ATTRIB_INSTANCE_ROW0, 1);
+        glVertexAttribDivisor(GLProgram::VERTEX_ATTRIB_INSTANCE_ROW1, 1);
+
+        GL::bindVAO(0);
+    }
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERROR_DEBUG();
+#endif
 }
 
 void Renderer::setupVBOAndVAO()
@@ -190,8 +437,8 @@ void Renderer::setupVBOAndVAO()
 
     glGenBuffers(2, &_buffersVBO[0]);
 
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * VBO_SIZE, _quads, GL_DYNAMIC_DRAW);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * VBO_RING_SIZE, nullptr, GL_DYNAMIC_DRAW);
 
     // vertices
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
@@ -205,13 +452,36 @@ void Renderer::setupVBOAndVAO()
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * VBO_SIZE * 6, _indices, GL_STATIC_DRAW);
 
     // Must unbind the VAO before changing the element buffer.
     GL::bindVAO(0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // triangles: the buffers are filled when the batch is drawn
+    glGenVertexArrays(1, &_trianglesVAO);
+    GL::bindVAO(_trianglesVAO);
+
+    glGenBuffers(2, &_trianglesVBO[0]);
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, _trianglesVBO[0]);
+
+    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, vertices));
+
+    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, colors));
+
+    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
+
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _trianglesVBO[1]);
+
+    GL::bindVAO(0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 
     CHECK_GL_ERROR_DEBUG();
 }
@@ -219,6 +489,7 @@ void Renderer::setupVBOAndVAO()
 void Renderer::setupVBO()
 {
     glGenBuffers(2, &_buffersVBO[0]);
+    glGenBuffers(2, &_trianglesVBO[0]);
 
     mapBuffers();
 }
@@ -228,20 +499,20 @@ void Renderer::mapBuffers()
     // Avoid changing the element buffer for whatever VAO might be bound.
     GL::bindVAO(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * VBO_SIZE, _quads, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * VBO_RING_SIZE, nullptr, GL_DYNAMIC_DRAW);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * VBO_SIZE * 6, _indices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     CHECK_GL_ERROR_DEBUG();
 }
 
 void Renderer::addCommand(RenderCommand* command)
 {
-    int renderQueue =_commandGroupStack.top();
+    int renderQueue = _isVisitingInParallel ? getCurrentRecording()->groupStack.back() : _commandGroupStack.top();
     addCommand(command, renderQueue);
 }
 
@@ -250,230 +521,780 @@ void Renderer::addCommand(RenderCommand* command, int renderQueue)
     CCASSERT(!_isRendering, "Cannot add command while rendering");
     CCASSERT(renderQueue >=0, "Invalid render queue");
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
+
+    if (_isVisitingInParallel)
+    {
+        getCurrentRecording()->commands.push_back(std::make_pair(command, renderQueue));
+        return;
+    }
+
     _renderGroups[renderQueue].push_back(command);
 }
 
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+
+    if (_isVisitingInParallel)
+    {
+        getCurrentRecording()->groupStack.push_back(renderQueueID);
+        return;
+    }
+
     _commandGroupStack.push(renderQueueID);
 }
 
 void Renderer::popGroup()
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+
+    if (_isVisitingInParallel)
+    {
+        auto recording = getCurrentRecording();
+        CCASSERT(recording->groupStack.size() > 1, "popGroup() without pushGroup() in a parallel visit");
+        recording->groupStack.pop_back();
+        return;
+    }
+
     _commandGroupStack.pop();
 }
 
 int Renderer::createRenderQueue()
 {
+    // GroupCommands can be initialized from the worker threads during a parallel visit
+    std::lock_guard<std::mutex> lock(_renderQueueMutex);
+
     RenderQueue newRenderQueue;
     _renderGroups.push_back(newRenderQueue);
     return (int)_renderGroups.size() - 1;
 }
 
-void Renderer::visitRenderQueue(const RenderQueue& queue)
+FrameAllocator* Renderer::getFrameAllocator() const
 {
-    ssize_t size = queue.size();
-    
-    for (ssize_t index = 0; index < size; ++index)
+    if (_isVisitingInParallel)
     {
-        auto command = queue[index];
-        auto commandType = command->getType();
-        if(RenderCommand::Type::QUAD_COMMAND == commandType)
-        {
-            auto cmd = static_cast<QuadCommand*>(command);
-            //Batch quads
-            if(_numQuads + cmd->getQuadCount() > VBO_SIZE)
-            {
-                CCASSERT(cmd->getQuadCount()>= 0 && cmd->getQuadCount() < VBO_SIZE, "VBO is not big enough for quad data, please break the quad data down or use customized render command");
-                
-                //Draw batched quads if VBO is full
-                drawBatchedQuads();
-            }
-            
-            _batchedQuadCommands.push_back(cmd);
-            
-            memcpy(_quads + _numQuads, cmd->getQuads(), sizeof(V3F_C4B_T2F_Quad) * cmd->getQuadCount());
-            convertToWorldCoordinates(_quads + _numQuads, cmd->getQuadCount(), cmd->getModelView());
-            
-            _numQuads += cmd->getQuadCount();
-
-        }
-        else if(RenderCommand::Type::GROUP_COMMAND == commandType)
-        {
-            flush();
-            int renderQueueID = ((GroupCommand*) command)->getRenderQueueID();
-            visitRenderQueue(_renderGroups[renderQueueID]);
-        }
-        else if(RenderCommand::Type::CUSTOM_COMMAND == commandType)
-        {
-            flush();
-            auto cmd = static_cast<CustomCommand*>(command);
-            cmd->execute();
-        }
-        else if(RenderCommand::Type::BATCH_COMMAND == commandType)
-        {
-            flush();
-            auto cmd = static_cast<BatchCommand*>(command);
-            cmd->execute();
-        }
-        else
-        {
-            CCLOGERROR("Unknown commands in renderQueue");
-        }
+        auto threadIndex = WorkerPool::getInstance()->getCurrentThreadIndex();
+        CCASSERT(threadIndex >= 0, "The frame allocator can only be used from the parallel visitor");
+        return _frameAllocators[threadIndex];
     }
+
+    return _frameAllocators[0];
 }
 
-void Renderer::render()
+Renderer::CommandRecording* Renderer::getCurrentRecording() const
 {
-    //Uncomment this once everything is rendered by new renderer
-    //glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    auto threadIndex = WorkerPool::getInstance()->getCurrentThreadIndex();
+    CCASSERT(threadIndex >= 0 && _threadRecordings[threadIndex], "Commands can only be added from the parallel visitor");
+    return _threadRecordings[threadIndex];
+}
 
-    //TODO setup camera or MVP
-    _isRendering = true;
-    
-    if (_glViewAssigned)
-    {
-        // cleanup
-        _drawnBatches = _drawnVertices = 0;
+void Renderer::visitInParallel(ssize_t count, const std::function<void(ssize_t)>& visitor)
+{
+    CCASSERT(!_isRendering, "Cannot visit while rendering");
 
-        //Process render commands
-        //1. Sort render commands based on ID
-        for (auto &renderqueue : _renderGroups)
+    auto pool = WorkerPool::getInstance();
+
+    // nested parallel visits are recorded by the chunk that contains them
+    if (_isVisitingInParallel || pool->getThreadCount() < 2 || count < 2)
+    {
+        for (ssize_t i = 0; i < count; ++i)
         {
-            renderqueue.sort();
+            visitor(i);
         }
-        visitRenderQueue(_renderGroups[0]);
-        flush();
+        return;
     }
-    clean();
-    _isRendering = false;
-}
 
-void Renderer::clean()
-{
-    // Clear render group
-    for (size_t j = 0 ; j < _renderGroups.size(); j++)
+    // a few chunks per thread so that a slow subtree doesn't leave the other threads idle
+    ssize_t chunkCount = std::min(count, pool->getThreadCount() * 4);
+    if (static_cast<ssize_t>(_recordings.size()) < chunkCount)
     {
-        //commands are owned by nodes
-        // for (const auto &cmd : _renderGroups[j])
-        // {
-        //     cmd->releaseToCommandPool();
-        // }
-        _renderGroups[j].clear();
+        _recordings.resize(chunkCount);
+    }
+    _threadRecordings.assign(pool->getThreadCount(), nullptr);
+    while (static_cast<ssize_t>(_frameAllocators.size()) < pool->getThreadCount())
+    {
+        _frameAllocators.push_back(new FrameAllocator());
     }
 
-    // Clear batch quad commands
-    _batchedQuadCommands.clear();
-    _numQuads = 0;
+    int currentRenderQueue = _commandGroupStack.top();
+    for (ssize_t i = 0; i < chunkCount; ++i)
+    {
+        _recordings[i].commands.clear();
+        _recordings[i].groupStack.assign(1, currentRenderQueue);
+    }
 
-    _lastMaterialID = 0;
-}
+    _isVisitingInParallel = true;
 
-void Renderer::convertToWorldCoordinates(V3F_C4B_T2F_Quad* quads, ssize_t quantity, const Mat4& modelView)
-{
-//    kmMat4 matrixP, mvp;
-//    kmGLGetMatrix(KM_GL_PROJECTION, &matrixP);
-//    kmMat4Multiply(&mvp, &matrixP, &modelView);
-    for(ssize_t i=0; i<quantity; ++i)
-    {
-        V3F_C4B_T2F_Quad *q = &quads[i];
-        Vec3 *vec1 = (Vec3*)&q->bl.vertices;
-        modelView.transformPoint(vec1);
+    pool->parallelFor(chunkCount, [&](ssize_t chunk){
+        auto threadIndex = pool->getCurrentThreadIndex();
+        _threadRecordings[threadIndex] = &_recordings[chunk];
 
-        Vec3 *vec2 = (Vec3*)&q->br.vertices;
-        modelView.transformPoint(vec2);
+        ssize_t begin = chunk * count / chunkCount;
+        ssize_t end = (chunk + 1) * count / chunkCount;
+        for (ssize_t i = begin; i < end; ++i)
+        {
+            visitor(i);
+        }
+
+        _threadRecordings[threadIndex] = nullptr;
+    });
 
-        Vec3 *vec3 = (Vec3*)&q->tr.vertices;
-        modelView.transformPoint(vec3);
+    _isVisitingInParallel = false;
 
-        Vec3 *vec4 = (Vec3*)&q->tl.vertices;
-        modelView.transformPoint(vec4);
+    // merge in chunk order: same arrival order as a serial visit
+    for (ssize_t i = 0; i < chunkCount; ++i)
+    {
+        CCASSERT(_recordings[i].groupStack.size() == 1, "pushGroup() without popGroup() in a parallel visit");
+        for (const auto& recorded : _recordings[i].commands)
+        {
+            _renderGroups[recorded.second].push_back(recorded.first);
+        }
     }
 }
 
-void Renderer::drawBatchedQuads()
+void Renderer::startCapture(const std::string& filename, int frameCount)
 {
-    //TODO we can improve the draw performance by insert material switching command before hand.
+    CCASSERT(!_isRendering, "Cannot start a capture while rendering");
 
-    int quadsToDraw = 0;
-    int startQuad = 0;
+    CC_SAFE_DELETE(_capture);
+    _capture = new RenderCapture(filename, frameCount);
+}
 
-    //Upload buffer to VBO
-    if(_numQuads <= 0 || _batchedQuadCommands.empty())
+void Renderer::visitRenderQueue(const RenderQueue& queue)
+{
+    ssize_t size = queue.size();
+    
+    for (ssize_t index = 0; index < size; ++index)
     {
-        return;
+        visitRenderCommand(queue[index]);
     }
+}
 
-    if (Configuration::getInstance()->supportsShareableVAO())
+void Renderer::visitRenderCommand(RenderCommand* command)
+{
+    auto commandType = command->getType();
+    if(RenderCommand::Type::QUAD_COMMAND == commandType)
     {
-        //Set VBO data
-        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-
-        // option 1: subdata
-//        glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0])*start, sizeof(_quads[0]) * n , &_quads[start] );
+        auto cmd = static_cast<QuadCommand*>(command);
 
-        // option 2: data
-//        glBufferData(GL_ARRAY_BUFFER, sizeof(quads_[0]) * (n-start), &quads_[start], GL_DYNAMIC_DRAW);
+        //Quads and triangles are drawn from different buffers
+        if(_numTriIndices > 0)
+        {
+            drawBatchedTriangles();
+        }
 
-        // option 3: orphaning + glMapBuffer
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * (_numQuads), nullptr, GL_DYNAMIC_DRAW);
-        void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-        memcpy(buf, _quads, sizeof(_quads[0])* (_numQuads));
-        glUnmapBuffer(GL_ARRAY_BUFFER);
+        if(!batchQuadInstances(cmd))
+        {
+            //Instanced and plain quads are drawn from different buffers
+            if(_numInstances > 0)
+            {
+                drawBatchedInstances();
+            }
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+            batchQuads(cmd);
+        }
 
-        //Bind VAO
-        GL::bindVAO(_quadVAO);
+        if(_capture)
+        {
+            _capture->recordQuads(cmd);
+        }
     }
-    else
+    else if(RenderCommand::Type::TRIANGLES_COMMAND == commandType)
     {
-#define kQuadSize sizeof(_quads[0].bl)
-        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _numQuads , _quads, GL_DYNAMIC_DRAW);
-
-        GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
-
-        // vertices
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, vertices));
-
-        // colors
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, colors));
+        if(_numQuads > 0)
+        {
+            drawBatchedQuads();
+        }
+        if(_numInstances > 0)
+        {
+            drawBatchedInstances();
+        }
 
-        // tex coords
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
+        auto cmd = static_cast<TrianglesCommand*>(command);
+        batchTriangles(cmd);
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+        if(_capture)
+        {
+            _capture->recordTriangles(cmd);
+        }
     }
-
-    //Start drawing verties in batch
-    for(const auto& cmd : _batchedQuadCommands)
+    else if(RenderCommand::Type::GROUP_COMMAND == commandType)
     {
-        auto newMaterialID = cmd->getMaterialID();
-        if(_lastMaterialID != newMaterialID || newMaterialID == QuadCommand::MATERIAL_ID_DO_NOT_BATCH)
+        flush();
+        int renderQueueID = ((GroupCommand*) command)->getRenderQueueID();
+        if(_capture)
         {
-            //Draw quads
-            if(quadsToDraw > 0)
-            {
-                glDrawElements(GL_TRIANGLES, (GLsizei) quadsToDraw*6, GL_UNSIGNED_SHORT, (GLvoid*) (startQuad*6*sizeof(_indices[0])) );
-                _drawnBatches++;
-                _drawnVertices += quadsToDraw*6;
-
-                startQuad += quadsToDraw;
-                quadsToDraw = 0;
-            }
-
-            //Use new material
-            cmd->useMaterial();
-            _lastMaterialID = newMaterialID;
+            _capture->recordMarker(RenderCaptureRecord::GROUP_BEGIN);
+        }
+        visitRenderQueue(_renderGroups[renderQueueID]);
+        if(_capture)
+        {
+            _capture->recordMarker(RenderCaptureRecord::GROUP_END);
         }
-
-        quadsToDraw += cmd->getQuadCount();
     }
-
+    else if(RenderCommand::Type::CUSTOM_COMMAND == commandType)
+    {
+        flush();
+        auto cmd = static_cast<CustomCommand*>(command);
+        cmd->execute();
+        if(_capture)
+        {
+            _capture->recordMarker(RenderCaptureRecord::CUSTOM);
+        }
+    }
+    else if(RenderCommand::Type::BATCH_COMMAND == commandType)
+    {
+        flush();
+        auto cmd = static_cast<BatchCommand*>(command);
+        cmd->execute();
+        if(_capture)
+        {
+            _capture->recordMarker(RenderCaptureRecord::BATCH);
+        }
+    }
+    else
+    {
+        CCLOGERROR("Unknown commands in renderQueue");
+    }
+}
+
+static inline bool isDepthSortable(RenderCommand* command)
+{
+    return command->getType() == RenderCommand::Type::QUAD_COMMAND || command->getType() == RenderCommand::Type::TRIANGLES_COMMAND;
+}
+
+static void setDepthRange(GLfloat nearValue, GLfloat farValue)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    // glDepthRangef is not part of OpenGL 2.1
+    glDepthRange(nearValue, farValue);
+#else
+    glDepthRangef(nearValue, farValue);
+#endif
+}
+
+void Renderer::visitRenderQueueWithOpaquePass(const RenderQueue& queue)
+{
+    ssize_t size = queue.size();
+    ssize_t index = 0;
+
+    while (index < size)
+    {
+        if (isDepthSortable(queue[index]))
+        {
+            // the quads and triangles up to the next command that might change the GL state
+            ssize_t last = index + 1;
+            while (last < size && isDepthSortable(queue[last]))
+            {
+                ++last;
+            }
+            drawWithOpaquePass(queue, index, last);
+            index = last;
+        }
+        else
+        {
+            visitRenderCommand(queue[index]);
+            ++index;
+        }
+    }
+}
+
+void Renderer::drawWithOpaquePass(const RenderQueue& queue, ssize_t first, ssize_t last)
+{
+    // 1. Split the commands in the runs that would be drawn by a single draw call.
+    // Every run is in front of the ones before it, and of everything drawn before in the frame.
+    _depthRuns.clear();
+    bool hasOpaqueRuns = false;
+
+    for (ssize_t index = first; index < last; ++index)
+    {
+        auto command = queue[index];
+        bool isQuad = command->getType() == RenderCommand::Type::QUAD_COMMAND;
+        uint32_t materialID;
+        bool isOpaque = false;
+        if (isQuad)
+        {
+            auto cmd = static_cast<QuadCommand*>(command);
+            materialID = cmd->getMaterialID();
+            isOpaque = cmd->isOpaque();
+        }
+        else
+        {
+            materialID = static_cast<TrianglesCommand*>(command)->getMaterialID();
+        }
+
+        if (_depthRuns.empty()
+            || materialID == QuadCommand::MATERIAL_ID_DO_NOT_BATCH
+            || _depthRuns.back().materialID != materialID
+            || _depthRuns.back().isQuad != isQuad
+            || _depthRuns.back().isOpaque != isOpaque)
+        {
+            DepthRun run = { index, index, materialID, _nextDepth, isQuad, isOpaque };
+            _depthRuns.push_back(run);
+            _nextDepth = std::max(_nextDepth - _depthStep, 0.0f);
+        }
+        _depthRuns.back().last = index + 1;
+        hasOpaqueRuns = hasOpaqueRuns || isOpaque;
+    }
+
+    if (!hasOpaqueRuns)
+    {
+        // nothing hides anything: the runs already are in front of what was drawn before them
+        for (ssize_t index = first; index < last; ++index)
+        {
+            visitRenderCommand(queue[index]);
+        }
+        return;
+    }
+
+    if (_capture)
+    {
+        for (ssize_t index = first; index < last; ++index)
+        {
+            if (queue[index]->getType() == RenderCommand::Type::QUAD_COMMAND)
+                _capture->recordQuads(static_cast<QuadCommand*>(queue[index]));
+            else
+                _capture->recordTriangles(static_cast<TrianglesCommand*>(queue[index]));
+        }
+    }
+
+    flush();
+
+    bool depthTest = GL::isEnabled(GL_DEPTH_TEST);
+    GLboolean depthMask = GL::getDepthMask();
+    GL::enable(GL_DEPTH_TEST);
+    GL::depthFunc(GL_LEQUAL);
+    _isDrawingWithDepth = true;
+    _lastDepth = -1.0f;
+
+    // 2. The opaque runs front to back, writing their depth.
+    // The quads of a run have the same depth: they still cover each other in order, since equal depths pass the test.
+    GL::depthMask(GL_TRUE);
+    for (auto run = _depthRuns.rbegin(); run != _depthRuns.rend(); ++run)
+    {
+        if (run->isOpaque)
+        {
+            _batchDepth = run->depth;
+            for (ssize_t index = run->first; index < run->last; ++index)
+            {
+                batchQuads(static_cast<QuadCommand*>(queue[index]));
+            }
+        }
+    }
+    flush();
+
+    // 3. The other runs back to front, blended where no opaque run in front of them was drawn
+    GL::depthMask(GL_FALSE);
+    for (const auto& run : _depthRuns)
+    {
+        if (run.isOpaque)
+        {
+            continue;
+        }
+
+        _batchDepth = run.depth;
+        for (ssize_t index = run.first; index < run.last; ++index)
+        {
+            if (run.isQuad)
+            {
+                if (_numTriIndices > 0)
+                {
+                    drawBatchedTriangles();
+                }
+                batchQuads(static_cast<QuadCommand*>(queue[index]));
+            }
+            else
+            {
+                if (_numQuads > 0)
+                {
+                    drawBatchedQuads();
+                }
+                batchTriangles(static_cast<TrianglesCommand*>(queue[index]));
+            }
+        }
+    }
+    flush();
+
+    _isDrawingWithDepth = false;
+    setDepthRange(0.0f, 1.0f);
+    GL::depthMask(depthMask);
+    if (!depthTest)
+    {
+        GL::disable(GL_DEPTH_TEST);
+    }
+}
+
+bool Renderer::hasDepthBuffer()
+{
+    if (_depthBits < 0)
+    {
+        GLint depthBits = 0;
+        glGetIntegerv(GL_DEPTH_BITS, &depthBits);
+        _depthBits = depthBits;
+    }
+    return _depthBits > 0;
+}
+
+void Renderer::setOpaquePassEnabled(bool enabled)
+{
+    CCASSERT(!_isRendering, "Cannot enable the opaque pass while rendering");
+
+    _opaquePassEnabled = enabled;
+    // the framebuffer might have changed since it was queried
+    _depthBits = -1;
+}
+
+void Renderer::setOverdrawMeasured(bool measured)
+{
+#ifdef CC_GL_OCCLUSION_QUERY
+    if (measured == _overdrawMeasured || (measured && !Configuration::getInstance()->supportsOcclusionQuery()))
+    {
+        return;
+    }
+
+    if (measured)
+    {
+        glGenQueries(2, _overdrawQueries);
+    }
+    else
+    {
+        glDeleteQueries(2, _overdrawQueries);
+        _overdrawQueries[0] = _overdrawQueries[1] = 0;
+    }
+    _overdrawQueryPending[0] = _overdrawQueryPending[1] = false;
+    _overdrawMeasured = measured;
+    _overdraw = -1.0f;
+#endif
+}
+
+void Renderer::beginOverdrawQuery()
+{
+#ifdef CC_GL_OCCLUSION_QUERY
+    // read the query of the previous frame if the GPU is done with it
+    int previous = 1 - _overdrawQueryIndex;
+    if (_overdrawQueryPending[previous])
+    {
+        GLuint available = 0;
+        glGetQueryObjectuiv(_overdrawQueries[previous], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available)
+        {
+            GLuint samples = 0;
+            glGetQueryObjectuiv(_overdrawQueries[previous], GL_QUERY_RESULT, &samples);
+            _overdraw = _overdrawPixels[previous] > 0 ? (float) samples / _overdrawPixels[previous] : -1.0f;
+            _overdrawQueryPending[previous] = false;
+        }
+    }
+
+    // the query of two frames ago is still running: skip this frame instead of waiting for it
+    if (_overdrawQueryPending[_overdrawQueryIndex])
+    {
+        return;
+    }
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    _overdrawPixels[_overdrawQueryIndex] = viewport[2] * viewport[3];
+
+    glBeginQuery(GL_SAMPLES_PASSED, _overdrawQueries[_overdrawQueryIndex]);
+    _isOverdrawQueryActive = true;
+#endif
+}
+
+void Renderer::endOverdrawQuery()
+{
+#ifdef CC_GL_OCCLUSION_QUERY
+    if (!_isOverdrawQueryActive)
+    {
+        return;
+    }
+
+    glEndQuery(GL_SAMPLES_PASSED);
+    _isOverdrawQueryActive = false;
+    _overdrawQueryPending[_overdrawQueryIndex] = true;
+    _overdrawQueryIndex = 1 - _overdrawQueryIndex;
+#endif
+}
+
+void Renderer::render()
+{
+    //Uncomment this once everything is rendered by new renderer
+    //glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    //TODO setup camera or MVP
+    _isRendering = true;
+    
+    if (_glViewAssigned)
+    {
+        // cleanup
+        _drawnBatches = _drawnVertices = _streamedBytes = _drawnInstances = 0;
+
+        //Process render commands
+        //1. Sort render commands based on ID
+        for (auto &renderqueue : _renderGroups)
+        {
+            renderqueue.sort();
+        }
+        if (_capture)
+        {
+            _capture->beginFrame();
+        }
+        if (_overdrawMeasured)
+        {
+            beginOverdrawQuery();
+        }
+
+        if (_opaquePassEnabled && hasDepthBuffer())
+        {
+            // one depth per command at most, from the clear value down
+            ssize_t commandCount = 0;
+            for (const auto& renderqueue : _renderGroups)
+            {
+                commandCount += renderqueue.size();
+            }
+            _depthStep = 1.0f / (commandCount + 1);
+            _nextDepth = 1.0f - _depthStep;
+
+            visitRenderQueueWithOpaquePass(_renderGroups[0]);
+        }
+        else
+        {
+            visitRenderQueue(_renderGroups[0]);
+        }
+        flush();
+
+        if (_overdrawMeasured)
+        {
+            endOverdrawQuery();
+        }
+
+        if (_capture && _capture->endFrame())
+        {
+            CC_SAFE_DELETE(_capture);
+        }
+    }
+    clean();
+    _isRendering = false;
+}
+
+void Renderer::clean()
+{
+    // Clear render group
+    for (size_t j = 0 ; j < _renderGroups.size(); j++)
+    {
+        //commands are owned by nodes
+        // for (const auto &cmd : _renderGroups[j])
+        // {
+        //     cmd->releaseToCommandPool();
+        // }
+        _renderGroups[j].clear();
+    }
+
+    // Clear batch quad commands
+    _batchedQuadCommands.clear();
+    _batchedQuadDepths.clear();
+    _numQuads = 0;
+
+    _batchedInstancedCommands.clear();
+    _numInstances = 0;
+
+    _batchedTriangles.clear();
+    _numTriVertices = 0;
+    _numTriIndices = 0;
+
+    _lastMaterialID = 0;
+
+    _culledNodes = 0;
+
+    // the commands of the frame are gone from the queues: release the ones created by the frame allocators
+    for (auto allocator : _frameAllocators)
+    {
+        allocator->reset();
+    }
+}
+
+void Renderer::convertToWorldCoordinates(V3F_C4B_T2F_Quad* quads, ssize_t quantity, const Mat4& modelView)
+{
+    // the 4 vertices of a quad are contiguous, so the whole array can be transformed in place at once
+    MathUtil::transformVertices(&quads->tl, &quads->tl, quantity * 4, modelView);
+}
+
+void Renderer::beginQuadsStream()
+{
+    GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+
+    // Orphan the buffer only when the ring wraps: the batches the GPU might still be reading
+    // are never written again, so no synchronization is needed.
+    if(_ringOffset + VBO_SIZE > VBO_RING_SIZE)
+    {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * VBO_RING_SIZE, nullptr, GL_DYNAMIC_DRAW);
+        _ringOffset = 0;
+    }
+
+    _streamedQuads = _quads;
+
+#ifdef CC_GL_MAP_BUFFER_RANGE
+    if (Configuration::getInstance()->supportsMapBufferRange())
+    {
+        // The batch is not bigger than VBO_SIZE quads: map that much, only what is written gets flushed
+        void* buf = glMapBufferRange(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _ringOffset, sizeof(_quads[0]) * VBO_SIZE,
+                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (buf)
+        {
+            _streamedQuads = static_cast<V3F_C4B_T2F_Quad*>(buf);
+            _isQuadsBufferMapped = true;
+        }
+    }
+#endif
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Renderer::endQuadsStream()
+{
+    if (_streamedQuads == nullptr)
+    {
+        return;
+    }
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+
+    if (_isQuadsBufferMapped)
+    {
+#ifdef CC_GL_MAP_BUFFER_RANGE
+        if (_numQuads > 0)
+        {
+            glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, sizeof(_quads[0]) * _numQuads);
+        }
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+#endif
+        _isQuadsBufferMapped = false;
+    }
+    else if (_numQuads > 0)
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _ringOffset, sizeof(_quads[0]) * _numQuads, _quads);
+    }
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+
+    _streamedBytes += sizeof(_quads[0]) * _numQuads;
+    _streamedQuads = nullptr;
+}
+
+void Renderer::batchQuads(QuadCommand* cmd)
+{
+    //Batch quads
+    if(_numQuads + cmd->getQuadCount() > VBO_SIZE)
+    {
+        CCASSERT(cmd->getQuadCount()>= 0 && cmd->getQuadCount() < VBO_SIZE, "VBO is not big enough for quad data, please break the quad data down or use customized render command");
+
+        //Draw batched quads if VBO is full
+        drawBatchedQuads();
+    }
+
+    if(_streamedQuads == nullptr)
+    {
+        beginQuadsStream();
+    }
+
+    _batchedQuadCommands.push_back(cmd);
+    if(_isDrawingWithDepth)
+    {
+        _batchedQuadDepths.push_back(_batchDepth);
+    }
+
+    //Copy the quads into the vertex buffer, converting them to world coordinates on the way
+    MathUtil::transformVertices(&_streamedQuads[_numQuads].tl, &cmd->getQuads()->tl, cmd->getQuadCount() * 4, cmd->getModelView());
+
+    _numQuads += cmd->getQuadCount();
+}
+
+void Renderer::drawBatchedQuads()
+{
+    //TODO we can improve the draw performance by insert material switching command before hand.
+
+    int quadsToDraw = 0;
+    int startQuad = 0;
+
+    //Upload buffer to VBO
+    endQuadsStream();
+
+    if(_numQuads <= 0 || _batchedQuadCommands.empty())
+    {
+        return;
+    }
+
+    // The batch starts at the ring offset, the attributes are pointed there
+    size_t batchOffset = sizeof(_quads[0]) * _ringOffset;
+#define kQuadSize sizeof(_quads[0].bl)
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        //Bind VAO
+        GL::bindVAO(_quadVAO);
+
+        // the attribute pointers are part of the VAO state
+        GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) (batchOffset + offsetof(V3F_C4B_T2F, vertices)));
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) (batchOffset + offsetof(V3F_C4B_T2F, colors)));
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) (batchOffset + offsetof(V3F_C4B_T2F, texCoords)));
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    else
+    {
+        GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+
+        GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+
+        // vertices
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) (batchOffset + offsetof(V3F_C4B_T2F, vertices)));
+
+        // colors
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) (batchOffset + offsetof(V3F_C4B_T2F, colors)));
+
+        // tex coords
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) (batchOffset + offsetof(V3F_C4B_T2F, texCoords)));
+
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    }
+
+    //Start drawing verties in batch
+    for(size_t i = 0; i < _batchedQuadCommands.size(); ++i)
+    {
+        const auto& cmd = _batchedQuadCommands[i];
+        auto newMaterialID = cmd->getMaterialID();
+        bool materialChanged = _lastMaterialID != newMaterialID || newMaterialID == QuadCommand::MATERIAL_ID_DO_NOT_BATCH;
+        bool depthChanged = _isDrawingWithDepth && _batchedQuadDepths[i] != _lastDepth;
+        if(materialChanged || depthChanged)
+        {
+            //Draw quads
+            if(quadsToDraw > 0)
+            {
+                glDrawElements(GL_TRIANGLES, (GLsizei) quadsToDraw*6, GL_UNSIGNED_SHORT, (GLvoid*) (startQuad*6*sizeof(_indices[0])) );
+                _drawnBatches++;
+                _drawnVertices += quadsToDraw*6;
+
+                startQuad += quadsToDraw;
+                quadsToDraw = 0;
+            }
+
+            //Every fragment of the next draw call gets the depth of its run
+            if(depthChanged)
+            {
+                _lastDepth = _batchedQuadDepths[i];
+                setDepthRange(_lastDepth, _lastDepth);
+            }
+
+            //Use new material
+            if(materialChanged)
+            {
+                cmd->useMaterial();
+                _lastMaterialID = newMaterialID;
+            }
+        }
+
+        quadsToDraw += cmd->getQuadCount();
+    }
+
     //Draw any remaining quad
     if(quadsToDraw > 0)
     {
@@ -489,17 +1310,432 @@ void Renderer::drawBatchedQuads()
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
 
+    _ringOffset += _numQuads;
+
     _batchedQuadCommands.clear();
+    _batchedQuadDepths.clear();
     _numQuads = 0;
 }
 
+bool Renderer::makeQuadInstance(const V3F_C4B_T2F_Quad& quad, const Mat4& modelView, QuadInstance* instance)
+{
+    static const float EPSILON = 1e-3f;
+
+    // a single color and an axis aligned texture rect, not rotated
+    if (!(quad.bl.colors == quad.br.colors && quad.bl.colors == quad.tl.colors && quad.bl.colors == quad.tr.colors)
+        || quad.bl.texCoords.v != quad.br.texCoords.v || quad.tl.texCoords.v != quad.tr.texCoords.v
+        || quad.bl.texCoords.u != quad.tl.texCoords.u || quad.br.texCoords.u != quad.tr.texCoords.u)
+    {
+        return false;
+    }
+
+    const Tex2F& texMin = quad.bl.texCoords;
+    const Tex2F& texMax = quad.tr.texCoords;
+    if (texMin.u < 0 || texMin.u > 1 || texMin.v < 0 || texMin.v > 1
+        || texMax.u < 0 || texMax.u > 1 || texMax.v < 0 || texMax.v > 1)
+    {
+        return false;
+    }
+
+    // a local rectangle, as the quads of the sprites: the model view maps it to a parallelogram
+    const Vec3& origin = quad.bl.vertices;
+    if (quad.br.vertices.y != origin.y || quad.tl.vertices.x != origin.x
+        || quad.tr.vertices.x != quad.br.vertices.x || quad.tr.vertices.y != quad.tl.vertices.y
+        || quad.br.vertices.z != origin.z || quad.tl.vertices.z != origin.z || quad.tr.vertices.z != origin.z)
+    {
+        return false;
+    }
+
+    // only the origin and the two edges are transformed, the vertex shader computes the corners
+    const float* m = modelView.m;
+    float width = quad.br.vertices.x - origin.x;
+    float height = quad.tl.vertices.y - origin.y;
+
+    // the unit quad can only be mapped to a parallelogram parallel to the screen
+    if (fabsf(m[2] * width) > EPSILON || fabsf(m[6] * height) > EPSILON)
+    {
+        return false;
+    }
+
+    instance->row0[0] = m[0] * width;
+    instance->row0[1] = m[4] * height;
+    instance->row0[2] = m[0] * origin.x + m[4] * origin.y + m[8] * origin.z + m[12];
+    instance->row0[3] = m[2] * origin.x + m[6] * origin.y + m[10] * origin.z + m[14];
+    instance->row1[0] = m[1] * width;
+    instance->row1[1] = m[5] * height;
+    instance->row1[2] = m[1] * origin.x + m[5] * origin.y + m[9] * origin.z + m[13];
+    instance->texRect[0] = (GLushort) (texMin.u * 65535 + 0.5f);
+    instance->texRect[1] = (GLushort) (texMin.v * 65535 + 0.5f);
+    instance->texRect[2] = (GLushort) (texMax.u * 65535 + 0.5f);
+    instance->texRect[3] = (GLushort) (texMax.v * 65535 + 0.5f);
+    instance->color = quad.bl.colors;
+
+    return true;
+}
+
+bool Renderer::batchQuadInstances(QuadCommand* cmd)
+{
+    if (!_instancedQuadsEnabled || _instancedProgram == nullptr
+        || cmd->getMaterialID() == QuadCommand::MATERIAL_ID_DO_NOT_BATCH
+        || cmd->getGLProgramState()->getGLProgram() != _noMVPProgram
+        || cmd->getGLProgramState()->getVertexAttribsFlags() != 0
+        || cmd->getQuadCount() <= 0 || cmd->getQuadCount() > VBO_SIZE)
+    {
+        return false;
+    }
+
+    const Mat4& mv = cmd->getModelView();
+    if (mv.m[3] != 0 || mv.m[7] != 0 || mv.m[11] != 0 || mv.m[15] != 1)
+    {
+        return false;
+    }
+
+    if (_numInstances + cmd->getQuadCount() > VBO_SIZE)
+    {
+        drawBatchedInstances();
+    }
+
+    // the instances are only kept if all the quads of the command can be instanced
+    auto quads = cmd->getQuads();
+    for (ssize_t i = 0; i < cmd->getQuadCount(); ++i)
+    {
+        if (!makeQuadInstance(quads[i], mv, &_instances[_numInstances + i]))
+        {
+            return false;
+        }
+    }
+
+    if (_numQuads > 0)
+    {
+        drawBatchedQuads();
+    }
+
+    _batchedInstancedCommands.push_back(cmd);
+    _numInstances += cmd->getQuadCount();
+    return true;
+}
+
+#ifdef CC_GL_INSTANCED_ARRAYS
+// points the per instance attributes at `offset` bytes of the instances buffer
+static void setInstanceAttribPointers(size_t offset, GLsizei stride)
+{
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_INSTANCE_ROW0, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*) offset);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_INSTANCE_ROW1, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*) (offset + 4 * sizeof(GLfloat)));
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 4, GL_UNSIGNED_SHORT, GL_TRUE, stride, (GLvoid*) (offset + 7 * sizeof(GLfloat)));
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (GLvoid*) (offset + 7 * sizeof(GLfloat) + 4 * sizeof(GLushort)));
+}
+
+static void setInstanceAttribDivisors(GLuint divisor)
+{
+    glVertexAttribDivisor(GLProgram::VERTEX_ATTRIB_COLOR, divisor);
+    glVertexAttribDivisor(GLProgram::VERTEX_ATTRIB_TEX_COORD, divisor);
+    glVertexAttribDivisor(GLProgram::VERTEX_ATTRIB_INSTANCE_ROW0, divisor);
+    glVertexAttribDivisor(GLProgram::VERTEX_ATTRIB_INSTANCE_ROW1, divisor);
+}
+#endif
+
+void Renderer::drawBatchedInstances()
+{
+#ifdef CC_GL_INSTANCED_ARRAYS
+    if(_numInstances <= 0 || _batchedInstancedCommands.empty())
+    {
+        return;
+    }
+
+    const GLsizei instanceSize = sizeof(_instances[0]);
+
+    //Upload the instances after the previous batch, orphaning the buffer when the ring wraps
+    GL::bindBuffer(GL_ARRAY_BUFFER, _instancesVBO[1]);
+    if(_instanceRingOffset + _numInstances > VBO_RING_SIZE)
+    {
+        glBufferData(GL_ARRAY_BUFFER, instanceSize * VBO_RING_SIZE, nullptr, GL_DYNAMIC_DRAW);
+        _instanceRingOffset = 0;
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, instanceSize * _instanceRingOffset, instanceSize * _numInstances, &_instances[0]);
+    _streamedBytes += instanceSize * _numInstances;
+
+    bool useVAO = Configuration::getInstance()->supportsShareableVAO();
+    if (useVAO)
+    {
+        GL::bindVAO(_instancesVAO);
+    }
+    else
+    {
+        GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX
+                                | (1 << GLProgram::VERTEX_ATTRIB_INSTANCE_ROW0)
+                                | (1 << GLProgram::VERTEX_ATTRIB_INSTANCE_ROW1));
+
+        GL::bindBuffer(GL_ARRAY_BUFFER, _instancesVBO[0]);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 0, (GLvoid*) 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _instancesVBO[1]);
+
+        setInstanceAttribDivisors(1);
+    }
+
+    // There is no base instance in OpenGL ES 2: the attributes are pointed at the first instance of each draw
+    int startInstance = _instanceRingOffset;
+    int instancesToDraw = 0;
+    uint32_t materialID = QuadCommand::MATERIAL_ID_DO_NOT_BATCH;
+
+    for(const auto& cmd : _batchedInstancedCommands)
+    {
+        if(cmd->getMaterialID() != materialID)
+        {
+            if(instancesToDraw > 0)
+            {
+                setInstanceAttribPointers(startInstance * instanceSize, instanceSize);
+                glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, instancesToDraw);
+                _drawnBatches++;
+                _drawnVertices += instancesToDraw*6;
+                _drawnInstances += instancesToDraw;
+
+                startInstance += instancesToDraw;
+                instancesToDraw = 0;
+            }
+
+            //Same material as QuadCommand::useMaterial(), with the instanced program
+            GL::bindTexture2D(cmd->getTextureID());
+            GL::blendFunc(cmd->getBlendType().src, cmd->getBlendType().dst);
+            _instancedProgram->use();
+            _instancedProgram->setUniformsForBuiltins(cmd->getModelView());
+            materialID = cmd->getMaterialID();
+        }
+
+        instancesToDraw += cmd->getQuadCount();
+    }
+
+    if(instancesToDraw > 0)
+    {
+        setInstanceAttribPointers(startInstance * instanceSize, instanceSize);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, instancesToDraw);
+        _drawnBatches++;
+        _drawnVertices += instancesToDraw*6;
+        _drawnInstances += instancesToDraw;
+    }
+
+    if (useVAO)
+    {
+        GL::bindVAO(0);
+    }
+    else
+    {
+        // the other draws read one vertex per attribute
+        setInstanceAttribDivisors(0);
+    }
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+
+    _instanceRingOffset += _numInstances;
+
+    // the quads batched next have to set their material again
+    _lastMaterialID = 0;
+#endif
+
+    _batchedInstancedCommands.clear();
+    _numInstances = 0;
+}
+
+void Renderer::batchTriangles(TrianglesCommand* cmd)
+{
+    ssize_t vertCount = cmd->getVertexCount();
+    ssize_t indexCount = cmd->getIndexCount();
+    if(indexCount <= 0)
+    {
+        return;
+    }
+
+    if(vertCount > _trianglesVertexCapacity || indexCount > _trianglesIndexCapacity)
+    {
+        splitTriangles(cmd);
+        return;
+    }
+
+    //Draw batched triangles if the buffers are full
+    if(_numTriVertices + vertCount > _trianglesVertexCapacity || _numTriIndices + indexCount > _trianglesIndexCapacity)
+    {
+        drawBatchedTriangles();
+    }
+
+    //Copy the vertices converting them to world coordinates, the indices are moved after the vertices already in the batch
+    MathUtil::transformVertices(&_triVerts[_numTriVertices], cmd->getVertices(), vertCount, cmd->getModelView());
+    if(_useUintIndices)
+        copyIndices(&_triIndices32[_numTriIndices], cmd->getIndices(), indexCount, (GLuint) _numTriVertices);
+    else
+        copyIndices(&_triIndices16[_numTriIndices], cmd->getIndices(), indexCount, (GLuint) _numTriVertices);
+
+    _numTriVertices += vertCount;
+    _numTriIndices += indexCount;
+
+    BatchedTriangles batched = { cmd, indexCount, _batchDepth };
+    _batchedTriangles.push_back(batched);
+}
+
+void Renderer::splitTriangles(TrianglesCommand* cmd)
+{
+    // The command is bigger than a batch: it is cut on triangle boundaries and
+    // each part gets a copy of the vertices it uses, with indices relative to its batch
+    const V3F_C4B_T2F* verts = cmd->getVertices();
+    const GLuint* indices = cmd->getIndices();
+    ssize_t vertCount = cmd->getVertexCount();
+    ssize_t indexCount = cmd->getIndexCount();
+
+    _vertexRemap.assign(vertCount, -1);
+    ssize_t batchedIndices = 0;
+
+    for(ssize_t i = 0; i < indexCount; i += 3)
+    {
+        if(_numTriVertices + 3 > _trianglesVertexCapacity || _numTriIndices + 3 > _trianglesIndexCapacity)
+        {
+            if(batchedIndices > 0)
+            {
+                BatchedTriangles batched = { cmd, batchedIndices, _batchDepth };
+                _batchedTriangles.push_back(batched);
+                batchedIndices = 0;
+            }
+            drawBatchedTriangles();
+            std::fill(_vertexRemap.begin(), _vertexRemap.end(), -1);
+        }
+
+        for(int corner = 0; corner < 3; ++corner)
+        {
+            GLuint index = indices[i + corner];
+            CCASSERT(index < (GLuint) vertCount, "Invalid index in TrianglesCommand");
+
+            int& batchIndex = _vertexRemap[index];
+            if(batchIndex < 0)
+            {
+                MathUtil::transformVertices(&_triVerts[_numTriVertices], &verts[index], 1, cmd->getModelView());
+                batchIndex = (int) _numTriVertices++;
+            }
+
+            if(_useUintIndices)
+                _triIndices32[_numTriIndices++] = (GLuint) batchIndex;
+            else
+                _triIndices16[_numTriIndices++] = (GLushort) batchIndex;
+        }
+        batchedIndices += 3;
+    }
+
+    if(batchedIndices > 0)
+    {
+        BatchedTriangles batched = { cmd, batchedIndices, _batchDepth };
+        _batchedTriangles.push_back(batched);
+    }
+}
+
+void Renderer::drawBatchedTriangles()
+{
+    if(_numTriIndices <= 0 || _batchedTriangles.empty())
+    {
+        return;
+    }
+
+    GLenum indexType = _useUintIndices ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+    size_t indexSize = _useUintIndices ? sizeof(GLuint) : sizeof(GLushort);
+    const GLvoid* indexData = _useUintIndices ? (const GLvoid*) _triIndices32.data() : (const GLvoid*) _triIndices16.data();
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        //Bind VAO, it holds the attribute pointers and the element buffer
+        GL::bindVAO(_trianglesVAO);
+    }
+    else
+    {
+        GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+    }
+
+    //Upload the batch, glBufferData orphans the storage the GPU might still be reading
+    GL::bindBuffer(GL_ARRAY_BUFFER, _trianglesVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_triVerts[0]) * _numTriVertices, _triVerts.data(), GL_STREAM_DRAW);
+
+    if (!Configuration::getInstance()->supportsShareableVAO())
+    {
+        // vertices
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof(V3F_C4B_T2F, vertices));
+
+        // colors
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof(V3F_C4B_T2F, colors));
+
+        // tex coords
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
+    }
+
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _trianglesVBO[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexSize * _numTriIndices, indexData, GL_STREAM_DRAW);
+
+    _streamedBytes += sizeof(_triVerts[0]) * _numTriVertices + indexSize * _numTriIndices;
+
+    ssize_t indicesToDraw = 0;
+    ssize_t startIndex = 0;
+
+    //Start drawing vertices in batch, same material switching as the quads
+    for(const auto& batched : _batchedTriangles)
+    {
+        auto newMaterialID = batched.command->getMaterialID();
+        bool materialChanged = _lastMaterialID != newMaterialID || newMaterialID == TrianglesCommand::MATERIAL_ID_DO_NOT_BATCH;
+        bool depthChanged = _isDrawingWithDepth && batched.depth != _lastDepth;
+        if(materialChanged || depthChanged)
+        {
+            //Draw triangles
+            if(indicesToDraw > 0)
+            {
+                glDrawElements(GL_TRIANGLES, (GLsizei) indicesToDraw, indexType, (GLvoid*) (startIndex*indexSize));
+                _drawnBatches++;
+                _drawnVertices += indicesToDraw;
+
+                startIndex += indicesToDraw;
+                indicesToDraw = 0;
+            }
+
+            if(depthChanged)
+            {
+                _lastDepth = batched.depth;
+                setDepthRange(_lastDepth, _lastDepth);
+            }
+
+            //Use new material
+            if(materialChanged)
+            {
+                batched.command->useMaterial();
+                _lastMaterialID = newMaterialID;
+            }
+        }
+
+        indicesToDraw += batched.indexCount;
+    }
+
+    //Draw any remaining triangles
+    if(indicesToDraw > 0)
+    {
+        glDrawElements(GL_TRIANGLES, (GLsizei) indicesToDraw, indexType, (GLvoid*) (startIndex*indexSize));
+        _drawnBatches++;
+        _drawnVertices += indicesToDraw;
+    }
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        //Unbind VAO
+        GL::bindVAO(0);
+    }
+    else
+    {
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+
+    _batchedTriangles.clear();
+    _numTriVertices = 0;
+    _numTriIndices = 0;
+}
+
 void Renderer::flush()
 {
     drawBatchedQuads();
+    drawBatchedInstances();
+    drawBatchedTriangles();
     _lastMaterialID = 0;
 }
 
@@ -32,16 +32,23 @@
 #include "CCGL.h"
 #include <vector>
 #include <stack>
+#include <functional>
+#include <mutex>
+#include <atomic>
 
 NS_CC_BEGIN
 
 class EventListenerCustom;
 class QuadCommand;
+class TrianglesCommand;
+class FrameAllocator;
+class RenderCapture;
 
 /** Class that knows how to sort `RenderCommand` objects.
  Since the commands that have `z == 0` are "pushed back" in
  the correct order, the only `RenderCommand` objects that need to be sorted,
  are the ones that have `z < 0` and `z > 0`.
+ Runs of order independent commands are then reordered by sort key, so that the commands sharing a material can be batched.
 */
 class RenderQueue {
 
@@ -53,9 +60,22 @@ public:
     void clear();
 
 protected:
+    struct SortEntry
+    {
+        uint64_t key;
+        RenderCommand* command;
+    };
+
+    void reorderIndependentCommands(std::vector<RenderCommand*>& queue);
+    void sortBySortKey(RenderCommand** commands, size_t count);
+
     std::vector<RenderCommand*> _queueNegZ;
     std::vector<RenderCommand*> _queue0;
     std::vector<RenderCommand*> _queuePosZ;
+
+    // kept between frames to avoid allocations
+    std::vector<SortEntry> _sortEntries;
+    std::vector<SortEntry> _sortScratch;
 };
 
 struct RenderStackElement
@@ -68,13 +88,19 @@ class GroupCommandManager;
 
 /* Class responsible for the rendering in.
 
-Whenever possible prefer to use `QuadCommand` objects since the renderer will automatically batch them.
+Whenever possible prefer to use `QuadCommand` or `TrianglesCommand` objects since the renderer will automatically batch them.
  */
 class Renderer
 {
 public:
     static const int VBO_SIZE = 65536 / 6;
+    /** Size in quads of the vertex ring buffer: batches are streamed one after the other, and the buffer is only orphaned when it wraps */
+    static const int VBO_RING_SIZE = VBO_SIZE * 3;
     static const int BATCH_QUADCOMMAND_RESEVER_SIZE = 64;
+    /** Size in vertices of the triangles batch with 16-bit indices: the most they can address */
+    static const int TRIANGLES_VBO_SIZE = 65536;
+    /** Size in vertices of the triangles batch when the GPU supports 32-bit indices */
+    static const int TRIANGLES_VBO_SIZE_UINT = TRIANGLES_VBO_SIZE * 4;
 
     Renderer();
     ~Renderer();
@@ -111,12 +137,87 @@ public:
     ssize_t getDrawnVertices() const { return _drawnVertices; }
     /* RenderCommands (except) QuadCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
+    /* returns the number of bytes of batched vertices and indices streamed to the GPU in the last frame */
+    ssize_t getStreamedBytes() const { return _streamedBytes; }
+    /* returns the number of quads drawn as instances of the unit quad in the last frame */
+    ssize_t getDrawnInstances() const { return _drawnInstances; }
+    /* returns the number of nodes skipped because they were off screen during the current visit */
+    int getCulledNodes() const { return _culledNodes; }
+    /* Nodes that are not drawn because they are off screen should update this value. Can be called while visiting in parallel */
+    void addCulledNodes(int number) { _culledNodes += number; }
 
     inline GroupCommandManager* getGroupCommandManager() const { return _groupCommandManager; };
 
+    /** Returns the allocator of the commands that only live during the current frame.
+     Nodes can create their commands and payloads there (`getFrameAllocator()->create<QuadCommand>()`) instead of owning them:
+     everything is released by `clean()` once the frame is rendered, so never keep those pointers across frames.
+     During a parallel visit each thread gets its own allocator.
+     */
+    FrameAllocator* getFrameAllocator() const;
+
     /** returns whether or not a rectangle is visible or not */
     bool checkVisibility(const Mat4& transform, const Size& size);
 
+    /** Calls `visitor(index)` for every index in [0, count) on the worker threads.
+     The `RenderCommand`s added by each call are recorded on the side and merged back in index order,
+     so the render queues end up exactly as if the calls had been made serially.
+     Only nodes that just emit commands in `draw()` (no GL calls, no autoreleased objects) can be visited this way.
+     */
+    void visitInParallel(ssize_t count, const std::function<void(ssize_t)>& visitor);
+
+    /** Returns whether the commands are being recorded by `visitInParallel()` */
+    inline bool isVisitingInParallel() const { return _isVisitingInParallel; }
+
+    /** Records the commands of the next `frameCount` rendered frames into `filename` (full path).
+     The file can be replayed with `RenderReplay`, see `RenderCapture` for its format.
+     */
+    void startCapture(const std::string& filename, int frameCount);
+
+    /** Returns whether the frames are being recorded by `startCapture()` */
+    inline bool isCapturing() const { return _capture != nullptr; }
+
+    /** Enables or disables drawing the sprites with instanced arrays (enabled by default when
+     `Configuration::supportsInstancedArrays()`). Has no effect when the GPU doesn't support them.
+     @since v3.2
+     */
+    void setInstancedQuadsEnabled(bool enabled) { _instancedQuadsEnabled = enabled; }
+    /** Returns whether the sprites are drawn with instanced arrays
+     @since v3.2
+     */
+    bool isInstancedQuadsEnabled() const { return _instancedQuadsEnabled && _instancedProgram != nullptr; }
+
+    /** Enables or disables the opaque pass (disabled by default).
+     The commands of the main render queue are split in runs that are drawn by a single draw call, and every run
+     gets its own depth from its position in the queue (global Z order, then arrival order). The runs of opaque quads
+     (see `QuadCommand::isOpaque()`) are drawn first, front to back, writing the depth buffer. The other quads and
+     triangles are drawn after them, back to front, only where the depth test passes: the fragments hidden by
+     an opaque sprite are rejected before being shaded, and the result is the same as drawing everything in order.
+     Custom, batch and group commands are drawn in place and the commands are never moved across them.
+     The depth of the quads is replaced, so don't enable it on scenes that rely on the depth test.
+     It has no effect when the framebuffer has no depth buffer, and the quads are not instanced while it is used.
+     @since v3.2
+     */
+    void setOpaquePassEnabled(bool enabled);
+    /** Returns whether the opaque pass is enabled
+     @since v3.2
+     */
+    bool isOpaquePassEnabled() const { return _opaquePassEnabled; }
+
+    /** Enables or disables measuring the overdraw with occlusion queries (disabled by default).
+     Has no effect when `Configuration::supportsOcclusionQuery()` is false.
+     @since v3.2
+     */
+    void setOverdrawMeasured(bool measured);
+    /** Returns whether the overdraw is measured
+     @since v3.2
+     */
+    bool isOverdrawMeasured() const { return _overdrawMeasured; }
+    /** Returns the number of samples drawn by a recent frame divided by the number of pixels of the viewport,
+     or -1 when it is not measured. Results are read one frame late to not stall the GPU.
+     @since v3.2
+     */
+    float getOverdraw() const { return _overdraw; }
+
 protected:
 
     void setupIndices();
@@ -126,15 +227,49 @@ protected:
     void setupVBO();
     void mapBuffers();
 
+    // Copies the quads of the command in the vertex buffer, drawing the batched quads first if they don't fit
+    void batchQuads(QuadCommand* cmd);
     void drawBatchedQuads();
 
+    // Batches the quads of the command as instances of the unit quad, returns false when they can't be
+    bool batchQuadInstances(QuadCommand* cmd);
+    void drawBatchedInstances();
+    void setupInstancedQuads();
+
+    // Copies the triangles of the command in the triangles batch, splitting them when they don't fit
+    void batchTriangles(TrianglesCommand* cmd);
+    void splitTriangles(TrianglesCommand* cmd);
+    void drawBatchedTriangles();
+
+    // Starts a batch in the vertex ring buffer: sets `_streamedQuads` to where its quads are written
+    void beginQuadsStream();
+    // Hands the quads of the current batch over to the GPU
+    void endQuadsStream();
+
     //Draw the previews queued quads and flush previous context
     void flush();
     
     void visitRenderQueue(const RenderQueue& queue);
+    void visitRenderCommand(RenderCommand* command);
+
+    // Same as visitRenderQueue(), with the opaque pass for the quads and triangles between the other commands
+    void visitRenderQueueWithOpaquePass(const RenderQueue& queue);
+    void drawWithOpaquePass(const RenderQueue& queue, ssize_t first, ssize_t last);
+    bool hasDepthBuffer();
+
+    void beginOverdrawQuery();
+    void endOverdrawQuery();
 
     void convertToWorldCoordinates(V3F_C4B_T2F_Quad* quads, ssize_t quantity, const Mat4& modelView);
 
+    // Commands added from one chunk of a parallel visit, with the render queue they belong to
+    struct CommandRecording
+    {
+        std::vector<std::pair<RenderCommand*, int>> commands;
+        std::vector<int> groupStack;
+    };
+    CommandRecording* getCurrentRecording() const;
+
     std::stack<int> _commandGroupStack;
     
     std::vector<RenderQueue> _renderGroups;
@@ -142,6 +277,8 @@ protected:
     uint32_t _lastMaterialID;
 
     std::vector<QuadCommand*> _batchedQuadCommands;
+    // depth of each batched quad command, only filled during the opaque pass
+    std::vector<GLfloat> _batchedQuadDepths;
 
     V3F_C4B_T2F_Quad _quads[VBO_SIZE];
     GLushort _indices[6 * VBO_SIZE];
@@ -149,16 +286,111 @@ protected:
     GLuint _buffersVBO[2]; //0: vertex  1: indices
 
     int _numQuads;
+
+    // vertex streaming: the current batch is written at `_ringOffset` (in quads) of the vertex buffer,
+    // either straight into the mapped buffer or into `_quads` when glMapBufferRange is not supported
+    V3F_C4B_T2F_Quad* _streamedQuads;
+    bool _isQuadsBufferMapped;
+    int _ringOffset;
+
+    // Triangles of TrianglesCommand, with their own buffers since their indices are not static.
+    // Commands split across batches appear once per batch, with the number of indices they have there.
+    struct BatchedTriangles
+    {
+        TrianglesCommand* command;
+        ssize_t indexCount;
+        GLfloat depth;      // only used during the opaque pass
+    };
+    std::vector<BatchedTriangles> _batchedTriangles;
+    std::vector<V3F_C4B_T2F> _triVerts;
+    // only one of them is used, depending on Configuration::supportsElementIndexUint()
+    std::vector<GLushort> _triIndices16;
+    std::vector<GLuint> _triIndices32;
+    bool _useUintIndices;
+    ssize_t _numTriVertices;
+    ssize_t _numTriIndices;
+    ssize_t _trianglesVertexCapacity;
+    ssize_t _trianglesIndexCapacity;
+    // index in the batch of each vertex of a command being split, -1 if not copied yet
+    std::vector<int> _vertexRemap;
+    GLuint _trianglesVAO;
+    GLuint _trianglesVBO[2]; //0: vertex  1: indices
+
+    // Instanced quads: quads of SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP that are 2D parallelograms with
+    // a single color and an axis aligned texture rect are drawn as instances of the unit quad,
+    // which takes 40 bytes per quad instead of 96.
+    struct QuadInstance
+    {
+        GLfloat row0[4];        // world x = row0[0] * u + row0[1] * v + row0[2], row0[3] is the z
+        GLfloat row1[3];        // world y = row1[0] * u + row1[1] * v + row1[2]
+        GLushort texRect[4];    // normalized texture coordinates of the bottom left and top right corners
+        Color4B color;
+    };
+    static bool makeQuadInstance(const V3F_C4B_T2F_Quad& quad, const Mat4& modelView, QuadInstance* instance);
+    bool _instancedQuadsEnabled;
+    GLProgram* _noMVPProgram;
+    GLProgram* _instancedProgram;  // nullptr when instanced arrays are not supported
+    std::vector<QuadCommand*> _batchedInstancedCommands;
+    std::vector<QuadInstance> _instances;
+    int _numInstances;
+    int _instanceRingOffset;
+    GLuint _instancesVAO;
+    GLuint _instancesVBO[2]; //0: unit quad  1: instances
     
     bool _glViewAssigned;
 
+    // Opaque pass: commands that can be drawn by the same draw call share a run, and a depth
+    struct DepthRun
+    {
+        ssize_t first;
+        ssize_t last;
+        uint32_t materialID;
+        GLfloat depth;
+        bool isQuad;
+        bool isOpaque;
+    };
+    bool _opaquePassEnabled;
+    int _depthBits;                 // of the default framebuffer, -1 until queried
+    std::vector<DepthRun> _depthRuns;
+    GLfloat _nextDepth;             // decreases by _depthStep after each run, from 1 (the clear value) to 0
+    GLfloat _depthStep;
+    bool _isDrawingWithDepth;       // whether the batched commands have a depth
+    GLfloat _batchDepth;            // depth given to the commands being batched
+    GLfloat _lastDepth;             // depth range used by the last draw call
+
+    // overdraw, measured by the query of a frame and read the next one
+    bool _overdrawMeasured;
+    bool _isOverdrawQueryActive;
+    GLuint _overdrawQueries[2];
+    bool _overdrawQueryPending[2];
+    GLint _overdrawPixels[2];
+    int _overdrawQueryIndex;
+    float _overdraw;
+
     // stats
     ssize_t _drawnBatches;
     ssize_t _drawnVertices;
+    ssize_t _streamedBytes;
+    ssize_t _drawnInstances;
+    // updated during the visit, reset once the frame is rendered
+    std::atomic<int> _culledNodes;
     //the flag for checking whether renderer is rendering
     bool _isRendering;
     
     GroupCommandManager* _groupCommandManager;
+
+    // [0] is used by the cocos2d thread, the others by the threads of a parallel visit
+    std::vector<FrameAllocator*> _frameAllocators;
+
+    // parallel visit
+    bool _isVisitingInParallel;
+    std::vector<CommandRecording> _recordings;
+    // recording used by each thread of the WorkerPool
+    std::vector<CommandRecording*> _threadRecordings;
+    std::mutex _renderQueueMutex;
+
+    // frame capture, see startCapture()
+    RenderCapture* _capture;
     
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     EventListenerCustom* _cacheTextureListener;
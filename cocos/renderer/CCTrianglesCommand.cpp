@@ -0,0 +1,105 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+
+#include "renderer/CCTrianglesCommand.h"
+#include "renderer/ccGLStateCache.h"
+#include "renderer/CCGLProgram.h"
+#include "renderer/CCGLProgramState.h"
+#include "xxhash.h"
+
+NS_CC_BEGIN
+
+TrianglesCommand::TrianglesCommand()
+:_materialID(0)
+,_textureID(0)
+,_glProgramState(nullptr)
+,_blendType(BlendFunc::DISABLE)
+{
+    _type = RenderCommand::Type::TRIANGLES_COMMAND;
+    _triangles.verts = nullptr;
+    _triangles.indices = nullptr;
+    _triangles.vertCount = 0;
+    _triangles.indexCount = 0;
+}
+
+TrianglesCommand::~TrianglesCommand()
+{
+}
+
+void TrianglesCommand::init(float globalOrder, GLuint textureID, GLProgramState* glProgramState, BlendFunc blendType, const Triangles& triangles, const Mat4& mv)
+{
+    CCASSERT(glProgramState, "Invalid GLProgramState");
+    CCASSERT(glProgramState->getVertexAttribsFlags() == 0, "No custom attributes are supported in TrianglesCommand");
+    CCASSERT(triangles.indexCount % 3 == 0, "The index count must be a multiple of 3");
+
+    _globalOrder = globalOrder;
+
+    _triangles = triangles;
+
+    _mv = mv;
+
+    if( _textureID != textureID || _blendType.src != blendType.src || _blendType.dst != blendType.dst || _glProgramState != glProgramState) {
+
+        _textureID = textureID;
+        _blendType = blendType;
+        _glProgramState = glProgramState;
+
+        generateMaterialID();
+    }
+}
+
+void TrianglesCommand::generateMaterialID()
+{
+    // same material ID as QuadCommand
+    if(_glProgramState->getUniformCount() > 0)
+    {
+        _materialID = TrianglesCommand::MATERIAL_ID_DO_NOT_BATCH;
+    }
+    else
+    {
+        int glProgram = (int)_glProgramState->getGLProgram()->getProgram();
+        int intArray[4] = { glProgram, (int)_textureID, (int)_blendType.src, (int)_blendType.dst};
+
+        _materialID = XXH32((const void*)intArray, sizeof(intArray), 0);
+    }
+
+    uint8_t blend = (uint8_t)(_blendType.src * 31 + _blendType.dst);
+    _sortKey = (_sortKey & ~0xFFFFFFFFFFull)
+             | makeSortKey(0, 0, (uint16_t)_glProgramState->getGLProgram()->getProgram(), (uint16_t)_textureID, blend);
+}
+
+void TrianglesCommand::useMaterial() const
+{
+    //Set texture
+    GL::bindTexture2D(_textureID);
+
+    //set blend mode
+    GL::blendFunc(_blendType.src, _blendType.dst);
+
+    _glProgramState->apply(_mv);
+}
+
+NS_CC_END
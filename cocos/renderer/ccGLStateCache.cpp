@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include "base/ccConfig.h"
 #include "base/CCConfiguration.h"
 
+#include <string.h>
+
 NS_CC_BEGIN
 
 static const int MAX_ATTRIBUTES = 16;
@@ -41,6 +43,9 @@ namespace
     static GLuint s_currentProjectionMatrix = -1;
     static uint32_t s_attributeFlags = 0;  // 32 attributes max
 
+    static unsigned int s_issuedCalls = 0;
+    static unsigned int s_skippedCalls = 0;
+
 #if CC_ENABLE_GL_STATE_CACHE
 
     static GLuint    s_currentShaderProgram = -1;
@@ -51,6 +56,43 @@ namespace
     static GLuint    s_VAO = 0;
     static GLenum    s_activeTexture = -1;
 
+    // capabilities tracked by enable() / disable(), -1 means unknown
+    static const GLenum s_capabilities[] = { GL_BLEND, GL_DEPTH_TEST, GL_STENCIL_TEST, GL_SCISSOR_TEST, GL_CULL_FACE, GL_POLYGON_OFFSET_FILL };
+    static const int CAPABILITY_COUNT = sizeof(s_capabilities) / sizeof(s_capabilities[0]);
+    static int       s_capabilityEnabled[CAPABILITY_COUNT] = { -1, -1, -1, -1, -1, -1 };
+
+    static GLenum    s_depthFunc = 0;
+    static int       s_depthMask = -1;
+
+    static bool      s_stencilFuncKnown = false;
+    static GLenum    s_stencilFunc = 0;
+    static GLint     s_stencilRef = 0;
+    static GLuint    s_stencilValueMask = 0;
+    static bool      s_stencilOpKnown = false;
+    static GLenum    s_stencilFail = 0;
+    static GLenum    s_stencilPassDepthFail = 0;
+    static GLenum    s_stencilPassDepthPass = 0;
+    static bool      s_stencilMaskKnown = false;
+    static GLuint    s_stencilWriteMask = 0;
+
+    static bool      s_scissorBoxKnown = false;
+    static GLint     s_scissorBox[4] = { 0, 0, 0, 0 };
+    static bool      s_viewportKnown = false;
+    static GLint     s_viewport[4] = { 0, 0, 0, 0 };
+
+    static GLuint    s_arrayBuffer = -1;
+    static GLuint    s_elementArrayBuffer = -1;
+
+    static int getCapabilityIndex(GLenum capability)
+    {
+        for (int i = 0; i < CAPABILITY_COUNT; ++i)
+        {
+            if (s_capabilities[i] == capability)
+                return i;
+        }
+        return -1;
+    }
+
 #endif // CC_ENABLE_GL_STATE_CACHE
 }
 
@@ -75,7 +117,27 @@ void invalidateStateCache( void )
     s_blendingDest = -1;
     s_GLServerState = 0;
     s_VAO = 0;
-    
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    invalidateDrawState();
+}
+
+void invalidateDrawState( void )
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    for (int i = 0; i < CAPABILITY_COUNT; ++i)
+    {
+        s_capabilityEnabled[i] = -1;
+    }
+    s_depthFunc = 0;
+    s_depthMask = -1;
+    s_stencilFuncKnown = false;
+    s_stencilOpKnown = false;
+    s_stencilMaskKnown = false;
+    s_scissorBoxKnown = false;
+    s_viewportKnown = false;
+    s_arrayBuffer = -1;
+    s_elementArrayBuffer = -1;
 #endif // CC_ENABLE_GL_STATE_CACHE
 }
 
@@ -96,9 +158,15 @@ void useProgram( GLuint program )
 #if CC_ENABLE_GL_STATE_CACHE
     if( program != s_currentShaderProgram ) {
         s_currentShaderProgram = program;
+        ++s_issuedCalls;
         glUseProgram(program);
     }
+    else
+    {
+        ++s_skippedCalls;
+    }
 #else
+    ++s_issuedCalls;
     glUseProgram(program);
 #endif // CC_ENABLE_GL_STATE_CACHE
 }
@@ -107,11 +175,12 @@ static void SetBlending(GLenum sfactor, GLenum dfactor)
 {
 	if (sfactor == GL_ONE && dfactor == GL_ZERO)
     {
-		glDisable(GL_BLEND);
+		disable(GL_BLEND);
 	}
     else
     {
-		glEnable(GL_BLEND);
+		enable(GL_BLEND);
+		++s_issuedCalls;
 		glBlendFunc(sfactor, dfactor);
 	}
 }
@@ -125,6 +194,10 @@ void blendFunc(GLenum sfactor, GLenum dfactor)
         s_blendingDest = dfactor;
         SetBlending(sfactor, dfactor);
     }
+    else
+    {
+        ++s_skippedCalls;
+    }
 #else
     SetBlending( sfactor, dfactor );
 #endif // CC_ENABLE_GL_STATE_CACHE
@@ -153,9 +226,15 @@ void bindTexture2DN(GLuint textureUnit, GLuint textureId)
     {
         s_currentBoundTexture[textureUnit] = textureId;
         activeTexture(GL_TEXTURE0 + textureUnit);
+        ++s_issuedCalls;
         glBindTexture(GL_TEXTURE_2D, textureId);
     }
+    else
+    {
+        ++s_skippedCalls;
+    }
 #else
+    s_issuedCalls += 2;
     glActiveTexture(GL_TEXTURE0 + textureUnit);
     glBindTexture(GL_TEXTURE_2D, textureId);
 #endif
@@ -184,9 +263,15 @@ void activeTexture(GLenum texture)
 #if CC_ENABLE_GL_STATE_CACHE
     if(s_activeTexture != texture) {
         s_activeTexture = texture;
+        ++s_issuedCalls;
         glActiveTexture(s_activeTexture);
     }
+    else
+    {
+        ++s_skippedCalls;
+    }
 #else
+    ++s_issuedCalls;
     glActiveTexture(texture);
 #endif
 }
@@ -200,9 +285,17 @@ void bindVAO(GLuint vaoId)
         if (s_VAO != vaoId)
         {
             s_VAO = vaoId;
+            // the element array buffer binding is part of the VAO state
+            s_elementArrayBuffer = -1;
+            ++s_issuedCalls;
             glBindVertexArray(vaoId);
         }
+        else
+        {
+            ++s_skippedCalls;
+        }
 #else
+        ++s_issuedCalls;
         glBindVertexArray(vaoId);
 #endif // CC_ENABLE_GL_STATE_CACHE
     
@@ -221,6 +314,7 @@ void enableVertexAttribs(uint32_t flags)
         bool enabled = flags & bit;
         bool enabledBefore = s_attributeFlags & bit;
         if(enabled != enabledBefore) {
+            ++s_issuedCalls;
             if( enabled )
                 glEnableVertexAttribArray(i);
             else
@@ -230,6 +324,326 @@ void enableVertexAttribs(uint32_t flags)
     s_attributeFlags = flags;
 }
 
+// GL Server state functions
+
+void enable(GLenum capability)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    int index = getCapabilityIndex(capability);
+    if (index >= 0)
+    {
+        if (s_capabilityEnabled[index] == 1)
+        {
+            ++s_skippedCalls;
+            return;
+        }
+        s_capabilityEnabled[index] = 1;
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    ++s_issuedCalls;
+    glEnable(capability);
+}
+
+void disable(GLenum capability)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    int index = getCapabilityIndex(capability);
+    if (index >= 0)
+    {
+        if (s_capabilityEnabled[index] == 0)
+        {
+            ++s_skippedCalls;
+            return;
+        }
+        s_capabilityEnabled[index] = 0;
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    ++s_issuedCalls;
+    glDisable(capability);
+}
+
+bool isEnabled(GLenum capability)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    int index = getCapabilityIndex(capability);
+    if (index >= 0)
+    {
+        if (s_capabilityEnabled[index] < 0)
+        {
+            s_capabilityEnabled[index] = glIsEnabled(capability) ? 1 : 0;
+        }
+        return s_capabilityEnabled[index] == 1;
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    return glIsEnabled(capability) ? true : false;
+}
+
+void depthFunc(GLenum func)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_depthFunc == func)
+    {
+        ++s_skippedCalls;
+        return;
+    }
+    s_depthFunc = func;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    ++s_issuedCalls;
+    glDepthFunc(func);
+}
+
+void depthMask(GLboolean flag)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_depthMask == (flag ? 1 : 0))
+    {
+        ++s_skippedCalls;
+        return;
+    }
+    s_depthMask = flag ? 1 : 0;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    ++s_issuedCalls;
+    glDepthMask(flag);
+}
+
+GLboolean getDepthMask()
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_depthMask < 0)
+    {
+        GLboolean flag = GL_TRUE;
+        glGetBooleanv(GL_DEPTH_WRITEMASK, &flag);
+        s_depthMask = flag ? 1 : 0;
+    }
+    return s_depthMask ? GL_TRUE : GL_FALSE;
+#else
+    GLboolean flag = GL_TRUE;
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &flag);
+    return flag;
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void stencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_stencilFuncKnown && s_stencilFunc == func && s_stencilRef == ref && s_stencilValueMask == mask)
+    {
+        ++s_skippedCalls;
+        return;
+    }
+    s_stencilFuncKnown = true;
+    s_stencilFunc = func;
+    s_stencilRef = ref;
+    s_stencilValueMask = mask;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    ++s_issuedCalls;
+    glStencilFunc(func, ref, mask);
+}
+
+void getStencilFunc(GLenum* func, GLint* ref, GLuint* mask)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (!s_stencilFuncKnown)
+    {
+        glGetIntegerv(GL_STENCIL_FUNC, (GLint*)&s_stencilFunc);
+        glGetIntegerv(GL_STENCIL_REF, &s_stencilRef);
+        glGetIntegerv(GL_STENCIL_VALUE_MASK, (GLint*)&s_stencilValueMask);
+        s_stencilFuncKnown = true;
+    }
+    *func = s_stencilFunc;
+    *ref = s_stencilRef;
+    *mask = s_stencilValueMask;
+#else
+    glGetIntegerv(GL_STENCIL_FUNC, (GLint*)func);
+    glGetIntegerv(GL_STENCIL_REF, ref);
+    glGetIntegerv(GL_STENCIL_VALUE_MASK, (GLint*)mask);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void stencilOp(GLenum fail, GLenum zfail, GLenum zpass)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_stencilOpKnown && s_stencilFail == fail && s_stencilPassDepthFail == zfail && s_stencilPassDepthPass == zpass)
+    {
+        ++s_skippedCalls;
+        return;
+    }
+    s_stencilOpKnown = true;
+    s_stencilFail = fail;
+    s_stencilPassDepthFail = zfail;
+    s_stencilPassDepthPass = zpass;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    ++s_issuedCalls;
+    glStencilOp(fail, zfail, zpass);
+}
+
+void getStencilOp(GLenum* fail, GLenum* zfail, GLenum* zpass)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (!s_stencilOpKnown)
+    {
+        glGetIntegerv(GL_STENCIL_FAIL, (GLint*)&s_stencilFail);
+        glGetIntegerv(GL_STENCIL_PASS_DEPTH_FAIL, (GLint*)&s_stencilPassDepthFail);
+        glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS, (GLint*)&s_stencilPassDepthPass);
+        s_stencilOpKnown = true;
+    }
+    *fail = s_stencilFail;
+    *zfail = s_stencilPassDepthFail;
+    *zpass = s_stencilPassDepthPass;
+#else
+    glGetIntegerv(GL_STENCIL_FAIL, (GLint*)fail);
+    glGetIntegerv(GL_STENCIL_PASS_DEPTH_FAIL, (GLint*)zfail);
+    glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS, (GLint*)zpass);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void stencilMask(GLuint mask)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_stencilMaskKnown && s_stencilWriteMask == mask)
+    {
+        ++s_skippedCalls;
+        return;
+    }
+    s_stencilMaskKnown = true;
+    s_stencilWriteMask = mask;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    ++s_issuedCalls;
+    glStencilMask(mask);
+}
+
+GLuint getStencilMask()
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (!s_stencilMaskKnown)
+    {
+        glGetIntegerv(GL_STENCIL_WRITEMASK, (GLint*)&s_stencilWriteMask);
+        s_stencilMaskKnown = true;
+    }
+    return s_stencilWriteMask;
+#else
+    GLuint mask = 0;
+    glGetIntegerv(GL_STENCIL_WRITEMASK, (GLint*)&mask);
+    return mask;
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void scissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_scissorBoxKnown && s_scissorBox[0] == x && s_scissorBox[1] == y && s_scissorBox[2] == width && s_scissorBox[3] == height)
+    {
+        ++s_skippedCalls;
+        return;
+    }
+    s_scissorBoxKnown = true;
+    s_scissorBox[0] = x;
+    s_scissorBox[1] = y;
+    s_scissorBox[2] = width;
+    s_scissorBox[3] = height;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    ++s_issuedCalls;
+    glScissor(x, y, width, height);
+}
+
+void getScissorBox(GLint* box)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (!s_scissorBoxKnown)
+    {
+        glGetIntegerv(GL_SCISSOR_BOX, s_scissorBox);
+        s_scissorBoxKnown = true;
+    }
+    memcpy(box, s_scissorBox, sizeof(s_scissorBox));
+#else
+    glGetIntegerv(GL_SCISSOR_BOX, box);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_viewportKnown && s_viewport[0] == x && s_viewport[1] == y && s_viewport[2] == width && s_viewport[3] == height)
+    {
+        ++s_skippedCalls;
+        return;
+    }
+    s_viewportKnown = true;
+    s_viewport[0] = x;
+    s_viewport[1] = y;
+    s_viewport[2] = width;
+    s_viewport[3] = height;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    ++s_issuedCalls;
+    glViewport(x, y, width, height);
+}
+
+void getViewport(GLint* box)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (!s_viewportKnown)
+    {
+        glGetIntegerv(GL_VIEWPORT, s_viewport);
+        s_viewportKnown = true;
+    }
+    memcpy(box, s_viewport, sizeof(s_viewport));
+#else
+    glGetIntegerv(GL_VIEWPORT, box);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+// GL Buffer functions
+
+void bindBuffer(GLenum target, GLuint buffer)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    GLuint* current = nullptr;
+    if (target == GL_ARRAY_BUFFER)
+        current = &s_arrayBuffer;
+    else if (target == GL_ELEMENT_ARRAY_BUFFER)
+        current = &s_elementArrayBuffer;
+
+    if (current)
+    {
+        if (*current == buffer)
+        {
+            ++s_skippedCalls;
+            return;
+        }
+        *current = buffer;
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    ++s_issuedCalls;
+    glBindBuffer(target, buffer);
+}
+
+void deleteBuffers(GLsizei count, const GLuint* buffers)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    // deleting a bound buffer binds 0 instead
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (s_arrayBuffer == buffers[i])
+            s_arrayBuffer = 0;
+        if (s_elementArrayBuffer == buffers[i])
+            s_elementArrayBuffer = 0;
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    glDeleteBuffers(count, buffers);
+}
+
 // GL Uniforms functions
 
 void setProjectionMatrixDirty( void )
@@ -237,6 +651,32 @@ void setProjectionMatrixDirty( void )
     s_currentProjectionMatrix = -1;
 }
 
+// Counters
+
+void countCall(bool issued)
+{
+    if (issued)
+        ++s_issuedCalls;
+    else
+        ++s_skippedCalls;
+}
+
+unsigned int getIssuedCallCount()
+{
+    return s_issuedCalls;
+}
+
+unsigned int getSkippedCallCount()
+{
+    return s_skippedCalls;
+}
+
+void resetCallCounters()
+{
+    s_issuedCalls = 0;
+    s_skippedCalls = 0;
+}
+
 } // Namespace GL
 
 NS_CC_END
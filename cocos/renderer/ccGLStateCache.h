@@ -60,10 +60,18 @@ enum {
 
 /** Invalidates the GL state cache.
  If CC_ENABLE_GL_STATE_CACHE it will reset the GL state cache.
+ Call it after changing the GL state without the functions of this file, e.g. from third party code.
  @since v2.0.0
  */
 void CC_DLL invalidateStateCache(void);
 
+/** Forgets the cached capabilities, depth, stencil, scissor and viewport state and the buffer bindings.
+ Unlike invalidateStateCache() it keeps the matrix stacks, so it can be called while the scene is drawn,
+ e.g. after direct glEnable() or glStencilFunc() calls in a CustomCommand.
+ @since v3.2
+ */
+void CC_DLL invalidateDrawState(void);
+
 /** Uses the GL program in case program is different than the current one.
  If CC_ENABLE_GL_STATE_CACHE is disabled, it will the glUseProgram() directly.
  @since v2.0.0
@@ -143,6 +151,132 @@ void CC_DLL activeTexture(GLenum texture);
  */
 void CC_DLL bindVAO(GLuint vaoId);
 
+/** Enables a server side GL capability in case it is not already enabled.
+ GL_BLEND, GL_DEPTH_TEST, GL_STENCIL_TEST, GL_SCISSOR_TEST, GL_CULL_FACE and GL_POLYGON_OFFSET_FILL are cached,
+ the other capabilities are always passed to glEnable().
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glEnable() directly.
+ @since v3.2
+ */
+void CC_DLL enable(GLenum capability);
+
+/** Disables a server side GL capability in case it is not already disabled.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDisable() directly.
+ @since v3.2
+ */
+void CC_DLL disable(GLenum capability);
+
+/** Returns whether a server side GL capability is enabled.
+ The state of the cached capabilities is only queried once from GL.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glIsEnabled() directly.
+ @since v3.2
+ */
+bool CC_DLL isEnabled(GLenum capability);
+
+/** Sets the depth comparison function in case it is not already used.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDepthFunc() directly.
+ @since v3.2
+ */
+void CC_DLL depthFunc(GLenum func);
+
+/** Enables or disables the writes to the depth buffer in case it is not already done.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDepthMask() directly.
+ @since v3.2
+ */
+void CC_DLL depthMask(GLboolean flag);
+
+/** Returns the depth write mask, without querying GL when it is cached.
+ @since v3.2
+ */
+GLboolean CC_DLL getDepthMask();
+
+/** Sets the stencil test function in case it is not already used.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glStencilFunc() directly.
+ @since v3.2
+ */
+void CC_DLL stencilFunc(GLenum func, GLint ref, GLuint mask);
+
+/** Returns the stencil test function, without querying GL when it is cached.
+ @since v3.2
+ */
+void CC_DLL getStencilFunc(GLenum* func, GLint* ref, GLuint* mask);
+
+/** Sets the stencil test actions in case they are not already used.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glStencilOp() directly.
+ @since v3.2
+ */
+void CC_DLL stencilOp(GLenum fail, GLenum zfail, GLenum zpass);
+
+/** Returns the stencil test actions, without querying GL when they are cached.
+ @since v3.2
+ */
+void CC_DLL getStencilOp(GLenum* fail, GLenum* zfail, GLenum* zpass);
+
+/** Sets the stencil write mask in case it is not already used.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glStencilMask() directly.
+ @since v3.2
+ */
+void CC_DLL stencilMask(GLuint mask);
+
+/** Returns the stencil write mask, without querying GL when it is cached.
+ @since v3.2
+ */
+GLuint CC_DLL getStencilMask();
+
+/** Sets the scissor box in case it is not already used.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glScissor() directly.
+ @since v3.2
+ */
+void CC_DLL scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+
+/** Copies the scissor box (x, y, width, height) into `box`, without querying GL when it is cached.
+ @since v3.2
+ */
+void CC_DLL getScissorBox(GLint* box);
+
+/** Sets the viewport in case it is not already used.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glViewport() directly.
+ @since v3.2
+ */
+void CC_DLL viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+/** Copies the viewport (x, y, width, height) into `box`, without querying GL when it is cached.
+ @since v3.2
+ */
+void CC_DLL getViewport(GLint* box);
+
+/** If the buffer is not already bound to the target, it binds it.
+ GL_ARRAY_BUFFER and GL_ELEMENT_ARRAY_BUFFER are cached, the other targets are always passed to glBindBuffer().
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glBindBuffer() directly.
+ @since v3.2
+ */
+void CC_DLL bindBuffer(GLenum target, GLuint buffer);
+
+/** Deletes the buffers. The cached bindings of the deleted buffers are reset to 0.
+ @since v3.2
+ */
+void CC_DLL deleteBuffers(GLsizei count, const GLuint* buffers);
+
+/** Counts a state change made outside of this file, e.g. a uniform update.
+ `issued` tells whether the call reached GL or was skipped because the value did not change.
+ @since v3.2
+ */
+void CC_DLL countCall(bool issued);
+
+/** Number of state changing calls sent to GL since the last call to resetCallCounters().
+ @since v3.2
+ */
+unsigned int CC_DLL getIssuedCallCount();
+
+/** Number of redundant state changing calls skipped since the last call to resetCallCounters().
+ @since v3.2
+ */
+unsigned int CC_DLL getSkippedCallCount();
+
+/** Resets the issued and skipped call counters. The Director does it once per frame.
+ @since v3.2
+ */
+void CC_DLL resetCallCounters();
+
 // end of shaders group
 /// @}
 
@@ -0,0 +1,178 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+// Grid3D effects evaluated in the vertex shader: a_position is the original vertex of the grid,
+// displaced the same way as the update() of the matching Grid3DAction does on the CPU.
+// The effects that depend on the position of the vertex in the grid get it from a_texCoord:
+// u_gridOrigin is the texture coordinate of the vertex (0,0) and u_gridScale maps the texture
+// coordinates to grid coordinates, between (0,0) and u_gridSize.
+
+// Waves3D
+const char* ccGrid3D_waves3D_vert = STRINGIFY(
+
+attribute vec4 a_position;
+attribute vec2 a_texCoord;
+
+uniform float u_phase;
+uniform float u_amplitude;
+
+\n#ifdef GL_ES\n
+varying mediump vec2 v_texCoord;
+\n#else\n
+varying vec2 v_texCoord;
+\n#endif\n
+
+void main()
+{
+    vec4 position = a_position;
+    position.z += sin(u_phase + (position.x + position.y) * 0.01) * u_amplitude;
+
+    gl_Position = CC_MVPMatrix * position;
+    v_texCoord = a_texCoord;
+}
+);
+
+// Ripple3D
+const char* ccGrid3D_ripple3D_vert = STRINGIFY(
+
+attribute vec4 a_position;
+attribute vec2 a_texCoord;
+
+uniform vec2 u_center;
+uniform float u_radius;
+uniform float u_phase;
+uniform float u_amplitude;
+
+\n#ifdef GL_ES\n
+varying mediump vec2 v_texCoord;
+\n#else\n
+varying vec2 v_texCoord;
+\n#endif\n
+
+void main()
+{
+    vec4 position = a_position;
+    float r = u_radius - distance(u_center, position.xy);
+    if (r > 0.0)
+    {
+        float rate = r / u_radius;
+        position.z += sin(u_phase + r * 0.1) * u_amplitude * rate * rate;
+    }
+
+    gl_Position = CC_MVPMatrix * position;
+    v_texCoord = a_texCoord;
+}
+);
+
+// Waves: u_direction.x is 1 for the vertical waves, u_direction.y is 1 for the horizontal ones
+const char* ccGrid3D_waves_vert = STRINGIFY(
+
+attribute vec4 a_position;
+attribute vec2 a_texCoord;
+
+uniform vec2 u_direction;
+uniform float u_phase;
+uniform float u_amplitude;
+
+\n#ifdef GL_ES\n
+varying mediump vec2 v_texCoord;
+\n#else\n
+varying vec2 v_texCoord;
+\n#endif\n
+
+void main()
+{
+    vec4 position = a_position;
+    position.x += sin(u_phase + position.y * 0.01) * u_amplitude * u_direction.x;
+    position.y += sin(u_phase + position.x * 0.01) * u_amplitude * u_direction.y;
+
+    gl_Position = CC_MVPMatrix * position;
+    v_texCoord = a_texCoord;
+}
+);
+
+// Liquid: the vertices on the border of the grid don't move
+const char* ccGrid3D_liquid_vert = STRINGIFY(
+
+attribute vec4 a_position;
+attribute vec2 a_texCoord;
+
+uniform vec2 u_gridOrigin;
+uniform vec2 u_gridScale;
+uniform vec2 u_gridSize;
+uniform float u_phase;
+uniform float u_amplitude;
+
+\n#ifdef GL_ES\n
+varying mediump vec2 v_texCoord;
+\n#else\n
+varying vec2 v_texCoord;
+\n#endif\n
+
+void main()
+{
+    vec4 position = a_position;
+    vec2 cell = floor((a_texCoord - u_gridOrigin) * u_gridScale + 0.5);
+    if (cell.x > 0.5 && cell.y > 0.5 && cell.x < u_gridSize.x - 0.5 && cell.y < u_gridSize.y - 0.5)
+    {
+        position.x += sin(u_phase + position.x * 0.01) * u_amplitude;
+        position.y += sin(u_phase + position.y * 0.01) * u_amplitude;
+    }
+
+    gl_Position = CC_MVPMatrix * position;
+    v_texCoord = a_texCoord;
+}
+);
+
+// Twirl: u_twirl is the angle of the rotation per unit of distance to the center of the grid
+const char* ccGrid3D_twirl_vert = STRINGIFY(
+
+attribute vec4 a_position;
+attribute vec2 a_texCoord;
+
+uniform vec2 u_gridOrigin;
+uniform vec2 u_gridScale;
+uniform vec2 u_gridSize;
+uniform vec2 u_center;
+uniform float u_twirl;
+
+\n#ifdef GL_ES\n
+varying mediump vec2 v_texCoord;
+\n#else\n
+varying vec2 v_texCoord;
+\n#endif\n
+
+void main()
+{
+    vec4 position = a_position;
+    vec2 cell = floor((a_texCoord - u_gridOrigin) * u_gridScale + 0.5);
+    float a = length(cell - u_gridSize * 0.5) * u_twirl;
+    vec2 d = position.xy - u_center;
+    position.xy = u_center + vec2(sin(a) * d.y + cos(a) * d.x, cos(a) * d.y - sin(a) * d.x);
+
+    gl_Position = CC_MVPMatrix * position;
+    v_texCoord = a_texCoord;
+}
+);
@@ -0,0 +1,78 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+
+// ParticleSystemGPU: the state of a particle is a function of its spawn parameters and its age.
+// Every particle slot emits once per u_period seconds, starting at its spawn time, as long as the
+// emission time is before u_emitEnd. Dead particles collapse into a zero sized quad.
+//   a_position: start position (xy), corner of the quad between -0.5 and 0.5 (zw)
+//   a_velocity: start velocity (xy), spawn time (z), life (w)
+//   a_sizeRotation: start size, size per second, start rotation, rotation per second (degrees)
+//   a_color, a_deltaColor: start color, color per second
+const char* ccParticleGPU_vert = STRINGIFY(
+
+attribute vec4 a_position;
+attribute vec4 a_velocity;
+attribute vec4 a_sizeRotation;
+attribute vec4 a_color;
+attribute vec4 a_deltaColor;
+
+uniform float u_time;
+uniform float u_period;
+uniform float u_emitEnd;
+uniform vec2 u_gravity;
+uniform float u_opacityModifyRGB;
+
+\n#ifdef GL_ES\n
+varying lowp vec4 v_fragmentColor;
+varying mediump vec2 v_texCoord;
+\n#else\n
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+\n#endif\n
+
+void main()
+{
+    float spawnTime = a_velocity.z;
+    float birth = spawnTime + floor((u_time - spawnTime) / u_period) * u_period;
+    float age = u_time - birth;
+    float alive = step(spawnTime, u_time) * step(age, a_velocity.w) * (1.0 - step(u_emitEnd, birth));
+
+    vec2 position = a_position.xy + a_velocity.xy * age + 0.5 * u_gravity * age * age;
+    float size = max(a_sizeRotation.x + a_sizeRotation.y * age, 0.0) * alive;
+    float angle = -radians(a_sizeRotation.z + a_sizeRotation.w * age);
+    float c = cos(angle);
+    float s = sin(angle);
+    vec2 corner = a_position.zw * size;
+    position += vec2(corner.x * c - corner.y * s, corner.x * s + corner.y * c);
+
+    gl_Position = CC_MVPMatrix * vec4(position, 0.0, 1.0);
+
+    vec4 color = clamp(a_color + a_deltaColor * age, 0.0, 1.0);
+    color.rgb *= mix(1.0, color.a, u_opacityModifyRGB);
+    v_fragmentColor = color;
+    v_texCoord = vec2(a_position.z + 0.5, 0.5 - a_position.w);
+}
+);
@@ -48,3 +48,34 @@ void main()
     gl_Position = CC_MVPMatrix * a_position;
 }
 );
+
+// Same as above with the vertices already in world coordinates, used when DrawNode is batched by the Renderer
+const char* ccPositionColorLengthTexture_noMVP_vert = STRINGIFY(
+
+\n#ifdef GL_ES\n
+attribute mediump vec4 a_position;
+attribute mediump vec2 a_texcoord;
+attribute mediump vec4 a_color;
+
+varying mediump vec4 v_color;
+varying mediump vec2 v_texcoord;
+
+\n#else\n
+
+attribute vec4 a_position;
+attribute vec2 a_texcoord;
+attribute vec4 a_color;
+
+varying vec4 v_color;
+varying vec2 v_texcoord;
+
+\n#endif\n
+
+void main()
+{
+    v_color = vec4(a_color.rgb * a_color.a, a_color.a);
+    v_texcoord = a_texcoord;
+
+    gl_Position = CC_PMatrix * a_position;
+}
+);
@@ -0,0 +1,55 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+// Instanced sprites: a_position is a corner of the unit quad, the other attributes are per instance.
+// The unit quad is mapped to world coordinates by the 2D affine transform stored in a_instanceRow0.xyz
+// and a_instanceRow1.xyz, a_instanceRow0.w is the z of the quad. a_texCoord holds the texture
+// coordinates of the bottom left (xy) and top right (zw) corners.
+const char* ccPositionTextureColor_instanced_vert = STRINGIFY(
+attribute vec2 a_position;
+attribute vec4 a_texCoord;
+attribute vec4 a_color;
+attribute vec4 a_instanceRow0;
+attribute vec3 a_instanceRow1;
+
+\n#ifdef GL_ES\n
+varying lowp vec4 v_fragmentColor;
+varying mediump vec2 v_texCoord;
+\n#else\n
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+\n#endif\n
+
+void main()
+{
+    vec4 position = vec4(dot(a_instanceRow0.xy, a_position) + a_instanceRow0.z,
+                         dot(a_instanceRow1.xy, a_position) + a_instanceRow1.z,
+                         a_instanceRow0.w,
+                         1.0);
+    gl_Position = CC_PMatrix * position;
+    v_fragmentColor = a_color;
+    v_texCoord = mix(a_texCoord.xy, a_texCoord.zw, a_position);
+}
+);
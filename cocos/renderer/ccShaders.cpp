@@ -52,6 +52,7 @@ NS_CC_BEGIN
 //
 #include "ccShader_PositionTextureColor_noMVP.frag"
 #include "ccShader_PositionTextureColor_noMVP.vert"
+#include "ccShader_PositionTextureColor_instanced.vert"
 
 //
 #include "ccShader_PositionTextureColorAlphaTest.frag"
@@ -63,6 +64,12 @@ NS_CC_BEGIN
 #include "ccShader_PositionColorLengthTexture.frag"
 #include "ccShader_PositionColorLengthTexture.vert"
 
+//
+#include "ccShader_Grid3D.vert"
+
+//
+#include "ccShader_ParticleGPU.vert"
+
 //
 #include "ccShader_Label.vert"
 #include "ccShader_Label_df.frag"
@@ -53,6 +53,7 @@ extern CC_DLL const GLchar * ccPositionTextureColor_vert;
 
 extern CC_DLL const GLchar * ccPositionTextureColor_noMVP_frag;
 extern CC_DLL const GLchar * ccPositionTextureColor_noMVP_vert;
+extern CC_DLL const GLchar * ccPositionTextureColor_instanced_vert;
 
 extern CC_DLL const GLchar * ccPositionTextureColorAlphaTest_frag;
 
@@ -61,6 +62,15 @@ extern CC_DLL const GLchar * ccPositionTexture_uColor_vert;
 
 extern CC_DLL const GLchar * ccPositionColorLengthTexture_frag;
 extern CC_DLL const GLchar * ccPositionColorLengthTexture_vert;
+extern CC_DLL const GLchar * ccPositionColorLengthTexture_noMVP_vert;
+
+extern CC_DLL const GLchar * ccGrid3D_waves3D_vert;
+extern CC_DLL const GLchar * ccGrid3D_ripple3D_vert;
+extern CC_DLL const GLchar * ccGrid3D_waves_vert;
+extern CC_DLL const GLchar * ccGrid3D_liquid_vert;
+extern CC_DLL const GLchar * ccGrid3D_twirl_vert;
+
+extern CC_DLL const GLchar * ccParticleGPU_vert;
 
 extern CC_DLL const GLchar * ccLabelDistanceFieldNormal_frag;
 extern CC_DLL const GLchar * ccLabelDistanceFieldGlow_frag;
@@ -196,12 +196,6 @@
 -- @param self
 -- @param #color4f_table color4f
         
---------------------------------
--- @function [parent=#ParticleSystem] updateQuadWithParticle 
--- @param self
--- @param #cc.sParticle sparticle
--- @param #cc.Vec2 vec2
-        
 --------------------------------
 -- @function [parent=#ParticleSystem] getAtlasIndex 
 -- @param self
@@ -276,11 +270,6 @@
 -- @param self
 -- @return float#float ret (return value: float)
         
---------------------------------
--- @function [parent=#ParticleSystem] initParticle 
--- @param self
--- @param #cc.sParticle sparticle
-        
 --------------------------------
 -- @function [parent=#ParticleSystem] setEmitterMode 
 -- @param self
@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include "extensions/GUI/CCControlExtension/CCScale9Sprite.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramCache.h"
+#include "renderer/ccGLStateCache.h"
 #include "base/CCDirector.h"
 #include "2d/CCDrawingPrimitives.h"
 #include "renderer/CCRenderer.h"
@@ -829,22 +830,18 @@ void Layout::onBeforeVisitStencil()
     GLint mask_layer = 0x1 << s_layer;
     GLint mask_layer_l = mask_layer - 1;
     _mask_layer_le = mask_layer | mask_layer_l;
-    _currentStencilEnabled = glIsEnabled(GL_STENCIL_TEST);
-    glGetIntegerv(GL_STENCIL_WRITEMASK, (GLint *)&_currentStencilWriteMask);
-    glGetIntegerv(GL_STENCIL_FUNC, (GLint *)&_currentStencilFunc);
-    glGetIntegerv(GL_STENCIL_REF, &_currentStencilRef);
-    glGetIntegerv(GL_STENCIL_VALUE_MASK, (GLint *)&_currentStencilValueMask);
-    glGetIntegerv(GL_STENCIL_FAIL, (GLint *)&_currentStencilFail);
-    glGetIntegerv(GL_STENCIL_PASS_DEPTH_FAIL, (GLint *)&_currentStencilPassDepthFail);
-    glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS, (GLint *)&_currentStencilPassDepthPass);
-    
-    glEnable(GL_STENCIL_TEST);
+    _currentStencilEnabled = GL::isEnabled(GL_STENCIL_TEST);
+    _currentStencilWriteMask = GL::getStencilMask();
+    GL::getStencilFunc(&_currentStencilFunc, &_currentStencilRef, &_currentStencilValueMask);
+    GL::getStencilOp(&_currentStencilFail, &_currentStencilPassDepthFail, &_currentStencilPassDepthPass);
+    
+    GL::enable(GL_STENCIL_TEST);
     CHECK_GL_ERROR_DEBUG();
-    glStencilMask(mask_layer);
-    glGetBooleanv(GL_DEPTH_WRITEMASK, &_currentDepthWriteMask);
-    glDepthMask(GL_FALSE);
-    glStencilFunc(GL_NEVER, mask_layer, mask_layer);
-    glStencilOp(GL_ZERO, GL_KEEP, GL_KEEP);
+    GL::stencilMask(mask_layer);
+    _currentDepthWriteMask = GL::getDepthMask();
+    GL::depthMask(GL_FALSE);
+    GL::stencilFunc(GL_NEVER, mask_layer, mask_layer);
+    GL::stencilOp(GL_ZERO, GL_KEEP, GL_KEEP);
 
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
@@ -857,26 +854,26 @@ void Layout::onBeforeVisitStencil()
     
     director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
     director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    glStencilFunc(GL_NEVER, mask_layer, mask_layer);
-    glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_NEVER, mask_layer, mask_layer);
+    GL::stencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
 }
 
 void Layout::onAfterDrawStencil()
 {
-    glDepthMask(_currentDepthWriteMask);
-    glStencilFunc(GL_EQUAL, _mask_layer_le, _mask_layer_le);
-    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    GL::depthMask(_currentDepthWriteMask);
+    GL::stencilFunc(GL_EQUAL, _mask_layer_le, _mask_layer_le);
+    GL::stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 }
 
 
 void Layout::onAfterVisitStencil()
 {
-    glStencilFunc(_currentStencilFunc, _currentStencilRef, _currentStencilValueMask);
-    glStencilOp(_currentStencilFail, _currentStencilPassDepthFail, _currentStencilPassDepthPass);
-    glStencilMask(_currentStencilWriteMask);
+    GL::stencilFunc(_currentStencilFunc, _currentStencilRef, _currentStencilValueMask);
+    GL::stencilOp(_currentStencilFail, _currentStencilPassDepthFail, _currentStencilPassDepthPass);
+    GL::stencilMask(_currentStencilWriteMask);
     if (!_currentStencilEnabled)
     {
-        glDisable(GL_STENCIL_TEST);
+        GL::disable(GL_STENCIL_TEST);
     }
     s_layer--;
 }
@@ -884,14 +881,14 @@ void Layout::onAfterVisitStencil()
 void Layout::onBeforeVisitScissor()
 {
     Rect clippingRect = getClippingRect();
-    glEnable(GL_SCISSOR_TEST);
+    GL::enable(GL_SCISSOR_TEST);
     auto glview = Director::getInstance()->getOpenGLView();
     glview->setScissorInPoints(clippingRect.origin.x, clippingRect.origin.y, clippingRect.size.width, clippingRect.size.height);
 }
 
 void Layout::onAfterVisitScissor()
 {
-    glDisable(GL_SCISSOR_TEST);
+    GL::disable(GL_SCISSOR_TEST);
 }
     
 void Layout::scissorClippingVisit(Renderer *renderer, const Mat4& parentTransform, bool parentTransformUpdated)
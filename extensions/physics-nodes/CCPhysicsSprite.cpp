@@ -39,7 +39,10 @@ PhysicsSprite::PhysicsSprite()
 , _CPBody(nullptr)
 , _pB2Body(nullptr)
 , _PTMRatio(0.0f)
-{}
+{
+    // the transform follows the body without going through the setters: the cached bounds of the parents would be stale
+    _cullable = false;
+}
 
 PhysicsSprite* PhysicsSprite::create()
 {
@@ -156,6 +156,16 @@ Classes/PerformanceTest/PerformanceContainerTest.cpp \
 Classes/PerformanceTest/PerformanceEventDispatcherTest.cpp \
 Classes/PerformanceTest/PerformanceScenarioTest.cpp \
 Classes/PerformanceTest/PerformanceCallbackTest.cpp \
+Classes/PerformanceTest/PerformanceMathTest.cpp \
+Classes/PerformanceTest/PerformanceStaticBatchTest.cpp \
+Classes/PerformanceTest/PerformanceUniformTest.cpp \
+Classes/PerformanceTest/PerformanceDynamicAtlasTest.cpp \
+Classes/PerformanceTest/PerformanceOpaquePassTest.cpp \
+Classes/PerformanceTest/PerformanceClippingNodeTest.cpp \
+Classes/PerformanceTest/PerformanceGridTest.cpp \
+Classes/PerformanceTest/PerformanceInstancedQuadsTest.cpp \
+Classes/PerformanceTest/PerformanceParticleSystemsTest.cpp \
+Classes/PerformanceTest/PerformanceParticleSpawnTest.cpp \
 Classes/PhysicsTest/PhysicsTest.cpp \
 Classes/ReleasePoolTest/ReleasePoolTest.cpp \
 Classes/RenderTextureTest/RenderTextureTest.cpp \
@@ -660,22 +660,27 @@ void RawStencilBufferTest::draw(Renderer *renderer, const Mat4 &transform, bool
     renderer->addCommand(&(*iter));
 }
 
+// These tests set the stencil state with direct GL calls, so the cache is told about it after each of them
+
 void RawStencilBufferTest::onEnableStencil()
 {
     glEnable(GL_STENCIL_TEST);
     CHECK_GL_ERROR_DEBUG();
+    GL::invalidateDrawState();
 }
 
 void RawStencilBufferTest::onDisableStencil()
 {
     glDisable(GL_STENCIL_TEST);
     CHECK_GL_ERROR_DEBUG();
+    GL::invalidateDrawState();
 }
 
 void RawStencilBufferTest::onBeforeDrawClip(int planeIndex, const Vec2& pt)
 {
     this->setupStencilForClippingOnPlane(planeIndex);
     CHECK_GL_ERROR_DEBUG();
+    GL::invalidateDrawState();
     DrawPrimitives::drawSolidRect(Vec2::ZERO, pt, Color4F(1, 1, 1, 1));
 }
 
@@ -683,6 +688,7 @@ void RawStencilBufferTest::onBeforeDrawSprite(int planeIndex, const Vec2& pt)
 {
     this->setupStencilForDrawingOnPlane(planeIndex);
     CHECK_GL_ERROR_DEBUG();
+    GL::invalidateDrawState();
     
     DrawPrimitives::drawSolidRect(Vec2::ZERO, pt, _planeColor[planeIndex]);
 }
@@ -715,12 +721,12 @@ std::string RawStencilBufferTest2::subtitle() const
 void RawStencilBufferTest2::setupStencilForClippingOnPlane(GLint plane)
 {
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDepthMask(GL_FALSE);
+    GL::depthMask(GL_FALSE);
 }
 
 void RawStencilBufferTest2::setupStencilForDrawingOnPlane(GLint plane)
 {
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 }
 
@@ -734,14 +740,14 @@ std::string RawStencilBufferTest3::subtitle() const
 void RawStencilBufferTest3::setupStencilForClippingOnPlane(GLint plane)
 {
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    GL::disable(GL_DEPTH_TEST);
+    GL::depthMask(GL_FALSE);
 }
 
 void RawStencilBufferTest3::setupStencilForDrawingOnPlane(GLint plane)
 {
-    glDepthMask(GL_TRUE);
-    //glEnable(GL_DEPTH_TEST);
+    GL::depthMask(GL_TRUE);
+    //GL::enable(GL_DEPTH_TEST);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 }
 
@@ -764,7 +770,7 @@ std::string RawStencilBufferTest4::subtitle() const
 void RawStencilBufferTest4::setupStencilForClippingOnPlane(GLint plane)
 {
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDepthMask(GL_FALSE);
+    GL::depthMask(GL_FALSE);
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glEnable(GL_ALPHA_TEST);
@@ -782,7 +788,7 @@ void RawStencilBufferTest4::setupStencilForDrawingOnPlane(GLint plane)
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glDisable(GL_ALPHA_TEST);
 #endif
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 }
 
@@ -796,8 +802,8 @@ std::string RawStencilBufferTest5::subtitle() const
 void RawStencilBufferTest5::setupStencilForClippingOnPlane(GLint plane)
 {
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    GL::disable(GL_DEPTH_TEST);
+    GL::depthMask(GL_FALSE);
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glEnable(GL_ALPHA_TEST);
@@ -815,8 +821,8 @@ void RawStencilBufferTest5::setupStencilForDrawingOnPlane(GLint plane)
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glDisable(GL_ALPHA_TEST);
 #endif
-    glDepthMask(GL_TRUE);
-    //glEnable(GL_DEPTH_TEST);
+    GL::depthMask(GL_TRUE);
+    //GL::enable(GL_DEPTH_TEST);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 }
 
@@ -834,7 +840,7 @@ void RawStencilBufferTest6::setup()
     auto winPoint = Vec2(Director::getInstance()->getWinSize());
     //by default, glReadPixels will pack data with 4 bytes allignment
     unsigned char bits[4] = {0,0,0,0};
-    glStencilMask(~0);
+    GL::stencilMask(~0);
     glClearStencil(0);
     glClear(GL_STENCIL_BUFFER_BIT);
     glFlush();
@@ -842,7 +848,7 @@ void RawStencilBufferTest6::setup()
     auto clearToZeroLabel = Label::createWithTTF(String::createWithFormat("00=%02x", bits[0])->getCString(), "fonts/arial.ttf", 20);
     clearToZeroLabel->setPosition( Vec2((winPoint.x / 3) * 1, winPoint.y - 10) );
     this->addChild(clearToZeroLabel);
-    glStencilMask(0x0F);
+    GL::stencilMask(0x0F);
     glClearStencil(0xAA);
     glClear(GL_STENCIL_BUFFER_BIT);
     glFlush();
@@ -851,20 +857,20 @@ void RawStencilBufferTest6::setup()
     clearToMaskLabel->setPosition( Vec2((winPoint.x / 3) * 2, winPoint.y - 10) );
     this->addChild(clearToMaskLabel);
 #endif
-    glStencilMask(~0);
+    GL::stencilMask(~0);
 }
 
 void RawStencilBufferTest6::setupStencilForClippingOnPlane(GLint plane)
 {
     GLint planeMask = 0x1 << plane;
-    glStencilMask(planeMask);
-    glStencilFunc(GL_NEVER, 0, planeMask);
-    glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::stencilMask(planeMask);
+    GL::stencilFunc(GL_NEVER, 0, planeMask);
+    GL::stencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
     DrawPrimitives::drawSolidRect(Vec2::ZERO, Vec2(Director::getInstance()->getWinSize()), Color4F(1, 1, 1, 1));
-    glStencilFunc(GL_NEVER, planeMask, planeMask);
-    glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    GL::stencilFunc(GL_NEVER, planeMask, planeMask);
+    GL::stencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::disable(GL_DEPTH_TEST);
+    GL::depthMask(GL_FALSE);
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glEnable(GL_ALPHA_TEST);
     glAlphaFunc(GL_GREATER, _alphaThreshold);
@@ -882,8 +888,8 @@ void RawStencilBufferTest6::setupStencilForDrawingOnPlane(GLint plane)
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glDisable(GL_ALPHA_TEST);
 #endif
-    glDepthMask(GL_TRUE);
-    //glEnable(GL_DEPTH_TEST);
+    GL::depthMask(GL_TRUE);
+    //GL::enable(GL_DEPTH_TEST);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
     glFlush();
 }
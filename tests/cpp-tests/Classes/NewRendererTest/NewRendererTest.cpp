@@ -40,6 +40,8 @@ static std::function<Layer*()> createFunctions[] =
     CL(NewDrawNodeTest),
     CL(NewCullingTest),
     CL(VBOFullTest),
+    CL(BatchReorderTest),
+    CL(TrianglesCommandTest),
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -484,6 +486,23 @@ NewCullingTest::NewCullingTest()
     sprite2->setPosition(Vec2(size.width/2,size.height * 2/3));
     sprite2->setScale(2);
     addChild(sprite2);
+
+    // groups of sprites around the screen: the groups that are off screen are skipped as a whole
+    const Vec2 groupPositions[] = { Vec2(-size.width, 0), Vec2(size.width, 0), Vec2(0, -size.height), Vec2(0, size.height) };
+    for (const auto& groupPosition : groupPositions)
+    {
+        auto group = Node::create();
+        group->setPosition(groupPosition);
+        addChild(group);
+
+        for (int i = 0; i < 100; ++i)
+        {
+            auto child = Sprite::create("Images/grossini_dance_01.png");
+            child->setPosition(Vec2(size.width * (i % 10 + 0.5f) / 10, size.height * (i / 10 + 0.5f) / 10));
+            child->setScale(0.3f);
+            group->addChild(child);
+        }
+    }
     
     auto listener = EventListenerTouchOneByOne::create();
     listener->setSwallowTouches(true);
@@ -527,7 +546,7 @@ std::string NewCullingTest::title() const
 
 std::string NewCullingTest::subtitle() const
 {
-    return "Drag the layer to test the result of culling";
+    return "Drag the layer to test the result of culling\nThe number of culled nodes is in the stats";
 }
 
 VBOFullTest::VBOFullTest()
@@ -559,3 +578,140 @@ std::string VBOFullTest::subtitle() const
 {
     return "VBO full Test, everthing should render normally";
 }
+
+BatchReorderTest::BatchReorderTest()
+: _orderIndependent(true)
+{
+    Size s = Director::getInstance()->getWinSize();
+
+    // A grid of icons coming from 2 textures, interleaved: without reordering every icon breaks the batch
+    const int columns = 20;
+    const int rows = 10;
+    for (int i = 0; i < columns * rows; ++i)
+    {
+        auto icon = Sprite::create(i % 2 ? "Images/grossini_dance_01.png" : "Images/grossini_dance_02.png");
+        icon->setScale(0.3f);
+        icon->setPosition(Vec2(s.width * ((i % columns) + 0.5f) / columns, s.height * 0.2f + s.height * 0.6f * (i / columns) / rows));
+        icon->setOrderIndependent(_orderIndependent);
+        addChild(icon);
+        _icons.pushBack(icon);
+    }
+
+    auto item = MenuItemFont::create("Toggle reorder", CC_CALLBACK_1(BatchReorderTest::onToggle, this));
+    auto menu = Menu::create(item, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height * 0.1f));
+    addChild(menu, 1);
+}
+
+BatchReorderTest::~BatchReorderTest()
+{
+    
+}
+
+void BatchReorderTest::onToggle(Ref* sender)
+{
+    _orderIndependent = !_orderIndependent;
+    for (auto& icon : _icons)
+    {
+        icon->setOrderIndependent(_orderIndependent);
+    }
+}
+
+std::string BatchReorderTest::title() const
+{
+    return "New Renderer";
+}
+
+std::string BatchReorderTest::subtitle() const
+{
+    return "Order independent sprites of 2 textures. Toggle and compare the draw calls";
+}
+
+// A textured grid of columns x rows cells drawn with a TrianglesCommand
+class TrianglesGrid : public Node
+{
+public:
+    static TrianglesGrid* create(const std::string& filename, const Size& size, int columns, int rows)
+    {
+        auto ret = new TrianglesGrid();
+        ret->init(filename, size, columns, rows);
+        ret->autorelease();
+        return ret;
+    }
+
+    void init(const std::string& filename, const Size& size, int columns, int rows)
+    {
+        _texture = Director::getInstance()->getTextureCache()->addImage(filename);
+        setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP));
+        setContentSize(size);
+
+        for (int y = 0; y <= rows; ++y)
+        {
+            for (int x = 0; x <= columns; ++x)
+            {
+                V3F_C4B_T2F vertex;
+                vertex.vertices = Vec3(size.width * x / columns, size.height * y / rows, 0);
+                vertex.colors = Color4B::WHITE;
+                vertex.texCoords = Tex2F((float) x / columns, 1 - (float) y / rows);
+                _verts.push_back(vertex);
+            }
+        }
+
+        for (int y = 0; y < rows; ++y)
+        {
+            for (int x = 0; x < columns; ++x)
+            {
+                GLuint bl = y * (columns + 1) + x;
+                GLuint tl = bl + columns + 1;
+                GLuint cell[6] = { bl, bl + 1, tl, tl, bl + 1, tl + 1 };
+                _indices.insert(_indices.end(), cell, cell + 6);
+            }
+        }
+    }
+
+    virtual void draw(Renderer *renderer, const Mat4 &transform, bool transformUpdated) override
+    {
+        TrianglesCommand::Triangles triangles = { _verts.data(), _indices.data(), (ssize_t) _verts.size(), (ssize_t) _indices.size() };
+        _command.init(_globalZOrder, _texture->getName(), getGLProgramState(), BlendFunc::ALPHA_PREMULTIPLIED, triangles, transform);
+        renderer->addCommand(&_command);
+    }
+
+protected:
+    Texture2D* _texture;
+    std::vector<V3F_C4B_T2F> _verts;
+    std::vector<GLuint> _indices;
+    TrianglesCommand _command;
+};
+
+TrianglesCommandTest::TrianglesCommandTest()
+{
+    Size s = Director::getInstance()->getWinSize();
+
+    // same material: drawn with one call
+    for (int i = 0; i < 2; ++i)
+    {
+        auto grid = TrianglesGrid::create("Images/grossini_dance_01.png", Size(s.width / 4, s.height / 2), 8, 8);
+        grid->setPosition(Vec2(s.width * (0.05f + 0.25f * i), s.height / 4));
+        addChild(grid);
+    }
+
+    // more vertices than 16-bit indices can address: split across batches
+    auto bigGrid = TrianglesGrid::create("Images/grossini_dance_02.png", Size(s.width * 0.4f, s.height / 2), 300, 300);
+    bigGrid->setPosition(Vec2(s.width * 0.55f, s.height / 4));
+    addChild(bigGrid);
+}
+
+TrianglesCommandTest::~TrianglesCommandTest()
+{
+
+}
+
+std::string TrianglesCommandTest::title() const
+{
+    return "New Renderer";
+}
+
+std::string TrianglesCommandTest::subtitle() const
+{
+    return "TrianglesCommand: 2 batched grids and a 90601 vertices one, everything should render normally";
+}
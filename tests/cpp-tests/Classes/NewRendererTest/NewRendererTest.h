@@ -146,4 +146,33 @@ protected:
     virtual ~VBOFullTest();
 };
 
+class BatchReorderTest : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(BatchReorderTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void onToggle(Ref* sender);
+
+protected:
+    BatchReorderTest();
+    virtual ~BatchReorderTest();
+
+    Vector<Sprite*> _icons;
+    bool _orderIndependent;
+};
+
+class TrianglesCommandTest : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(TrianglesCommandTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    TrianglesCommandTest();
+    virtual ~TrianglesCommandTest();
+};
+
 #endif //__NewRendererTest_H_
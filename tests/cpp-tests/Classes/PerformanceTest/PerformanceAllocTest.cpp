@@ -4,6 +4,9 @@
 #include "PerformanceAllocTest.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <climits>
 
 // Enable profiles for this file
 #undef CC_PROFILER_DISPLAY_TIMERS
@@ -39,6 +42,7 @@ static std::function<PerformceAllocScene*()> createFunctions[] =
     CL(SpriteCreateEmptyTest),
     CL(SpriteCreateTest),
     CL(SpriteDeallocTest),
+    CL(FrameCommandsAllocTest),
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -470,6 +474,148 @@ const char*  SpriteDeallocTest::testName()
     return "Sprite::~Sprite()";
 }
 
+////////////////////////////////////////////////////////
+//
+// FrameCommandsAllocTest
+//
+////////////////////////////////////////////////////////
+
+// Every heap allocation of the program goes through these operators, so that the test can count the ones made by a frame.
+// When the engine is a DLL (Windows), the allocations made inside of it use its own operators and are not counted.
+static std::atomic<unsigned int> s_heapAllocationCount(0);
+
+void* operator new(std::size_t size)
+{
+    ++s_heapAllocationCount;
+    void* ptr = malloc(size ? size : 1);
+    // the tests are also built without exceptions
+    if (ptr == nullptr)
+        abort();
+    return ptr;
+}
+
+void operator delete(void* ptr) throw()
+{
+    free(ptr);
+}
+
+void FrameCommandsAllocTest::updateQuantityOfNodes()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    _nodes->removeAllChildren();
+
+    // a third of sprites, of labels and of draw nodes: they all emit their commands from the frame allocator
+    for (int i = 0; i < quantityOfNodes; ++i)
+    {
+        Node* node = nullptr;
+        switch (i % 3)
+        {
+            case 0:
+            {
+                auto sprite = Sprite::create("Images/grossini.png");
+                sprite->setScale(0.25f);
+                node = sprite;
+                break;
+            }
+            case 1:
+                node = Label::createWithTTF("label", "fonts/arial.ttf", 12);
+                break;
+            default:
+            {
+                auto drawNode = DrawNode::create();
+                drawNode->drawDot(Vec2::ZERO, 5, Color4F(CCRANDOM_0_1(), CCRANDOM_0_1(), CCRANDOM_0_1(), 1));
+                node = drawNode;
+                break;
+            }
+        }
+        node->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        _nodes->addChild(node);
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void FrameCommandsAllocTest::initWithQuantityOfNodes(unsigned int nNodes)
+{
+    _nodes = Node::create();
+    addChild(_nodes);
+
+    _afterUpdateListener = nullptr;
+    _afterVisitListener = nullptr;
+    _afterDrawListener = nullptr;
+    _allocationsBeforeVisit = 0;
+    _minFrameAllocations = UINT_MAX;
+    _usedBytes = 0;
+    _elapsed = 0;
+
+    PerformceAllocScene::initWithQuantityOfNodes(nNodes);
+
+    auto s = Director::getInstance()->getWinSize();
+
+    _allocationLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _allocationLabel->setPosition(Vec2(s.width/2, s.height/2-60));
+    addChild(_allocationLabel, 1);
+
+    scheduleUpdate();
+}
+
+void FrameCommandsAllocTest::onEnter()
+{
+    PerformceAllocScene::onEnter();
+
+    // the heap allocations made while the scene is visited and rendered
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    _afterUpdateListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [this](EventCustom* event){
+        _allocationsBeforeVisit = s_heapAllocationCount;
+    });
+    _afterVisitListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_VISIT, [this](EventCustom* event){
+        _usedBytes = Director::getInstance()->getRenderer()->getFrameAllocator()->getUsedBytes();
+    });
+    _afterDrawListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom* event){
+        _minFrameAllocations = std::min(_minFrameAllocations, s_heapAllocationCount - _allocationsBeforeVisit);
+    });
+}
+
+void FrameCommandsAllocTest::onExit()
+{
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    dispatcher->removeEventListener(_afterUpdateListener);
+    dispatcher->removeEventListener(_afterVisitListener);
+    dispatcher->removeEventListener(_afterDrawListener);
+
+    PerformceAllocScene::onExit();
+}
+
+void FrameCommandsAllocTest::update(float dt)
+{
+    // the frame that draws the updated label allocates its letters: the fewest allocations of a frame are shown
+    _elapsed += dt;
+    if (_elapsed >= 1 && _minFrameAllocations != UINT_MAX)
+    {
+        _allocationLabel->setString(StringUtils::format("%u heap allocations per frame, %d KB of commands",
+                                                        _minFrameAllocations, (int)(_usedBytes / 1024)));
+        CCLOG("%s: %u heap allocations during the visit and the render", profilerName(), _minFrameAllocations);
+        _minFrameAllocations = UINT_MAX;
+        _elapsed = 0;
+    }
+}
+
+std::string FrameCommandsAllocTest::title() const
+{
+    return "Frame allocator";
+}
+
+std::string FrameCommandsAllocTest::subtitle() const
+{
+    return "Heap allocations of a frame of sprites, labels and draw nodes. Hide the stats";
+}
+
+const char*  FrameCommandsAllocTest::testName()
+{
+    return "Sprite, Label and DrawNode commands";
+}
+
 ///----------------------------------------
 void runAllocPerformanceTest()
 {
@@ -115,6 +115,35 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class FrameCommandsAllocTest : public PerformceAllocScene
+{
+public:
+    CREATE_FUNC(FrameCommandsAllocTest);
+
+    virtual void updateQuantityOfNodes();
+    virtual void initWithQuantityOfNodes(unsigned int nNodes);
+    virtual void update(float dt);
+    virtual const char* testName();
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    // the sprites, labels and draw nodes
+    Node* _nodes;
+    Label* _allocationLabel;
+    EventListenerCustom* _afterUpdateListener;
+    EventListenerCustom* _afterVisitListener;
+    EventListenerCustom* _afterDrawListener;
+    unsigned int _allocationsBeforeVisit;
+    // fewest heap allocations made by a frame since the label was updated
+    unsigned int _minFrameAllocations;
+    size_t _usedBytes;
+    float _elapsed;
+};
 
 void runAllocPerformanceTest();
 
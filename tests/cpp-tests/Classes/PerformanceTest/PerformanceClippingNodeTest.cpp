@@ -0,0 +1,241 @@
+//
+//  PerformanceClippingNodeTest.cpp
+//
+
+#include "PerformanceClippingNodeTest.h"
+
+static std::function<PerformanceClippingNodeScene*()> createFunctions[] =
+{
+    CL(ClippingNodeStencilPerfTest),
+    CL(ClippingNodeScissorPerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+
+static int g_curCase = 0;
+// kept when switching between the stencil and the scissor tests
+static int g_nesting = 4;
+
+////////////////////////////////////////////////////////
+//
+// ClippingNodeBasicLayer
+//
+////////////////////////////////////////////////////////
+
+ClippingNodeBasicLayer::ClippingNodeBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void ClippingNodeBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceClippingNodeScene
+//
+////////////////////////////////////////////////////////
+
+bool PerformanceClippingNodeScene::init()
+{
+    if (!Scene::init())
+        return false;
+
+    _root = nullptr;
+    _nestingLabel = nullptr;
+    _resultLabel = nullptr;
+    _afterUpdateListener = nullptr;
+    _afterDrawListener = nullptr;
+    _drawMicroseconds = 0;
+    _frames = 0;
+    _drawnBatches = 0;
+
+    return true;
+}
+
+void PerformanceClippingNodeScene::onEnter()
+{
+    Scene::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    MenuItemFont::setFontSize(65);
+    auto decrease = MenuItemFont::create(" - ", [&](Ref *sender) {
+        g_nesting = std::max(g_nesting - 1, 1);
+        updateNesting();
+    });
+    decrease->setColor(Color3B(0,200,20));
+    auto increase = MenuItemFont::create(" + ", [&](Ref *sender) {
+        g_nesting = std::min(g_nesting + 1, (int)MAX_NESTING);
+        updateNesting();
+    });
+    increase->setColor(Color3B(0,200,20));
+
+    auto menu = Menu::create(decrease, increase, NULL);
+    menu->alignItemsHorizontally();
+    menu->setPosition(Vec2(s.width/2, s.height/2+45));
+    addChild(menu, 1);
+
+    _nestingLabel = Label::createWithTTF("", "fonts/Marker Felt.ttf", 30);
+    _nestingLabel->setColor(Color3B(0,200,20));
+    _nestingLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_nestingLabel, 1);
+
+    _resultLabel = Label::createWithTTF("", "fonts/Marker Felt.ttf", 30);
+    _resultLabel->setColor(Color3B(0,200,20));
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2-35));
+    addChild(_resultLabel, 1);
+
+    auto menuLayer = new ClippingNodeBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    updateNesting();
+
+    // CPU time of the visit and of the render, where the stencils are drawn
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    _afterUpdateListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [this](EventCustom* event){
+        _frameStart = std::chrono::high_resolution_clock::now();
+    });
+    _afterDrawListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom* event){
+        auto end = std::chrono::high_resolution_clock::now();
+        _drawMicroseconds += static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(end - _frameStart).count());
+        _drawnBatches = Director::getInstance()->getRenderer()->getDrawnBatches();
+        ++_frames;
+    });
+
+    getScheduler()->schedule(schedule_selector(PerformanceClippingNodeScene::updateResult), this, 1, false);
+}
+
+void PerformanceClippingNodeScene::onExit()
+{
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    dispatcher->removeEventListener(_afterUpdateListener);
+    dispatcher->removeEventListener(_afterDrawListener);
+
+    getScheduler()->unscheduleAllForTarget(this);
+    Scene::onExit();
+}
+
+void PerformanceClippingNodeScene::updateNesting()
+{
+    if (_root)
+    {
+        _root->removeFromParent();
+    }
+
+    auto s = Director::getInstance()->getWinSize();
+    _root = Node::create();
+    addChild(_root);
+
+    // every level clips a slightly smaller rectangle than its parent
+    Node* parent = _root;
+    float inset = std::min(s.width, s.height) / (4 * MAX_NESTING);
+    for (int level = 0; level < g_nesting; ++level)
+    {
+        auto stencil = LayerColor::create(Color4B::WHITE, s.width - 2 * inset * (level + 1), s.height - 2 * inset * (level + 1));
+        stencil->setPosition(Vec2(inset * (level + 1), inset * (level + 1)));
+
+        auto clipper = ClippingNode::create(stencil);
+        clipper->setScissorEnabled(isScissorEnabled());
+        parent->addChild(clipper);
+
+        for (int i = 0; i < SPRITES_PER_LEVEL; ++i)
+        {
+            auto sprite = Sprite::create("Images/grossini.png");
+            sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+            clipper->addChild(sprite);
+        }
+
+        parent = clipper;
+    }
+
+    _nestingLabel->setString(StringUtils::format("%d nested clipping nodes", g_nesting));
+    _drawMicroseconds = 0;
+    _frames = 0;
+}
+
+std::string PerformanceClippingNodeScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceClippingNodeScene::subtitle() const
+{
+    return "";
+}
+
+void PerformanceClippingNodeScene::updateResult(float dt)
+{
+    if (_frames > 0)
+    {
+        float drawMs = _drawMicroseconds / (1000.0f * _frames);
+        _resultLabel->setString(StringUtils::format("visit + render: %.2f ms, draw calls: %ld", drawMs, (long)_drawnBatches));
+        CCLOG("%s: %d nested, visit + render %.2f ms/frame, %ld draw calls", title().c_str(), g_nesting, drawMs, (long)_drawnBatches);
+    }
+    _drawMicroseconds = 0;
+    _frames = 0;
+}
+
+////////////////////////////////////////////////////////
+//
+// ClippingNodeStencilPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ClippingNodeStencilPerfTest::title() const
+{
+    return "Stencil clipping";
+}
+
+std::string ClippingNodeStencilPerfTest::subtitle() const
+{
+    return "ClippingNode::setScissorEnabled(false). Use +/- to change the nesting";
+}
+
+////////////////////////////////////////////////////////
+//
+// ClippingNodeScissorPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ClippingNodeScissorPerfTest::title() const
+{
+    return "Scissor clipping";
+}
+
+std::string ClippingNodeScissorPerfTest::subtitle() const
+{
+    return "The rectangular stencils are replaced by nested scissor boxes";
+}
+
+void runClippingNodePerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
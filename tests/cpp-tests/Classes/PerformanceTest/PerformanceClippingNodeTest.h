@@ -0,0 +1,74 @@
+//
+//  PerformanceClippingNodeTest.h
+
+#ifndef __PERFORMANCE_CLIPPING_NODE_TEST_H__
+#define __PERFORMANCE_CLIPPING_NODE_TEST_H__
+
+#include "PerformanceTest.h"
+
+#include <chrono>
+
+class ClippingNodeBasicLayer : public PerformBasicLayer
+{
+public:
+    ClippingNodeBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+// Clipping nodes with rectangular stencils nested in each other, with sprites at each level
+class PerformanceClippingNodeScene : public Scene
+{
+public:
+    virtual bool init() override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+    // whether the clipping nodes may use the scissor test
+    virtual bool isScissorEnabled() const = 0;
+
+    void updateNesting();
+    void updateResult(float dt);
+protected:
+
+    Node* _root;
+    Label* _nestingLabel;
+    Label* _resultLabel;
+    EventListenerCustom* _afterUpdateListener;
+    EventListenerCustom* _afterDrawListener;
+    std::chrono::high_resolution_clock::time_point _frameStart;
+    long _drawMicroseconds;
+    int _frames;
+    ssize_t _drawnBatches;
+
+    static const int SPRITES_PER_LEVEL = 20;
+    // the stencil buffer has 8 bits
+    static const int MAX_NESTING = 8;
+};
+
+class ClippingNodeStencilPerfTest : public PerformanceClippingNodeScene
+{
+public:
+    CREATE_FUNC(ClippingNodeStencilPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual bool isScissorEnabled() const override { return false; }
+};
+
+class ClippingNodeScissorPerfTest : public PerformanceClippingNodeScene
+{
+public:
+    CREATE_FUNC(ClippingNodeScissorPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual bool isScissorEnabled() const override { return true; }
+};
+
+void runClippingNodePerformanceTest();
+
+#endif /* __PERFORMANCE_CLIPPING_NODE_TEST_H__ */
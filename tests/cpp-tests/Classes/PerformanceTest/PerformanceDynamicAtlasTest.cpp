@@ -0,0 +1,185 @@
+//
+//  PerformanceDynamicAtlasTest.cpp
+//
+
+#include "PerformanceDynamicAtlasTest.h"
+
+#include <chrono>
+
+static std::function<PerformanceDynamicAtlasScene*()> createFunctions[] =
+{
+    CL(DynamicAtlasOffPerfTest),
+    CL(DynamicAtlasOnPerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+
+static int g_curCase = 0;
+
+////////////////////////////////////////////////////////
+//
+// DynamicAtlasBasicLayer
+//
+////////////////////////////////////////////////////////
+
+DynamicAtlasBasicLayer::DynamicAtlasBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void DynamicAtlasBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceDynamicAtlasScene
+//
+////////////////////////////////////////////////////////
+
+bool PerformanceDynamicAtlasScene::init()
+{
+    if (!Scene::init())
+        return false;
+
+    _resultLabel = nullptr;
+    _afterDrawListener = nullptr;
+    _drawnBatches = 0;
+
+    auto s = Director::getInstance()->getWinSize();
+    auto textureCache = Director::getInstance()->getTextureCache();
+
+    textureCache->setDynamicAtlasEnabled(isDynamicAtlasEnabled());
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // 14 images of 85 x 121 pixels: neighbours never share a texture unless they are packed
+    auto parent = Node::create();
+    addChild(parent);
+    for (int i = 0; i < SPRITE_COUNT; ++i)
+    {
+        auto sprite = Sprite::create(StringUtils::format("Images/grossini_dance_%02d.png", i % 14 + 1));
+        sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        sprite->setScale(0.5f);
+        parent->addChild(sprite);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    _textureLoadMicroseconds = static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+
+    return true;
+}
+
+void PerformanceDynamicAtlasScene::onEnter()
+{
+    Scene::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto menuLayer = new DynamicAtlasBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    _resultLabel = Label::createWithTTF(StringUtils::format("%d sprites", SPRITE_COUNT), "fonts/Marker Felt.ttf", 30);
+    _resultLabel->setColor(Color3B(0,200,20));
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    _afterDrawListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom* event){
+        _drawnBatches = Director::getInstance()->getRenderer()->getDrawnBatches();
+    });
+
+    getScheduler()->schedule(schedule_selector(PerformanceDynamicAtlasScene::updateResult), this, 1, false);
+}
+
+void PerformanceDynamicAtlasScene::onExit()
+{
+    Director::getInstance()->getEventDispatcher()->removeEventListener(_afterDrawListener);
+    getScheduler()->unscheduleAllForTarget(this);
+
+    // the pages stay alive while the sprites use them
+    Director::getInstance()->getTextureCache()->setDynamicAtlasEnabled(false);
+
+    Scene::onExit();
+}
+
+std::string PerformanceDynamicAtlasScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceDynamicAtlasScene::subtitle() const
+{
+    return "";
+}
+
+void PerformanceDynamicAtlasScene::updateResult(float dt)
+{
+    _resultLabel->setString(StringUtils::format("draw calls: %ld, sprites created in %.2f ms",
+                                                (long)_drawnBatches, _textureLoadMicroseconds / 1000.0f));
+    CCLOG("%s: %ld draw calls for %d sprites, created in %.2f ms",
+          title().c_str(), (long)_drawnBatches, SPRITE_COUNT, _textureLoadMicroseconds / 1000.0f);
+}
+
+////////////////////////////////////////////////////////
+//
+// DynamicAtlasOffPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string DynamicAtlasOffPerfTest::title() const
+{
+    return "One texture per image";
+}
+
+std::string DynamicAtlasOffPerfTest::subtitle() const
+{
+    return "1000 sprites, 14 images. Compare the draw calls with the next test";
+}
+
+////////////////////////////////////////////////////////
+//
+// DynamicAtlasOnPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string DynamicAtlasOnPerfTest::title() const
+{
+    return "Images packed by the dynamic atlas";
+}
+
+std::string DynamicAtlasOnPerfTest::subtitle() const
+{
+    return "TextureCache::setDynamicAtlasEnabled(true): the 14 images share a page";
+}
+
+void runDynamicAtlasPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
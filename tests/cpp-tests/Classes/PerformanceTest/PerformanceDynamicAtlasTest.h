@@ -0,0 +1,64 @@
+//
+//  PerformanceDynamicAtlasTest.h
+
+#ifndef __PERFORMANCE_DYNAMIC_ATLAS_TEST_H__
+#define __PERFORMANCE_DYNAMIC_ATLAS_TEST_H__
+
+#include "PerformanceTest.h"
+
+class DynamicAtlasBasicLayer : public PerformBasicLayer
+{
+public:
+    DynamicAtlasBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+// Sprites made from small images, each one with a different image than its neighbours
+class PerformanceDynamicAtlasScene : public Scene
+{
+public:
+    virtual bool init() override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+    // whether the images are packed in the dynamic atlas
+    virtual bool isDynamicAtlasEnabled() const = 0;
+
+    void updateResult(float dt);
+protected:
+
+    Label* _resultLabel;
+    EventListenerCustom* _afterDrawListener;
+    ssize_t _drawnBatches;
+    long _textureLoadMicroseconds;
+
+    static const int SPRITE_COUNT = 1000;
+};
+
+class DynamicAtlasOffPerfTest : public PerformanceDynamicAtlasScene
+{
+public:
+    CREATE_FUNC(DynamicAtlasOffPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual bool isDynamicAtlasEnabled() const override { return false; }
+};
+
+class DynamicAtlasOnPerfTest : public PerformanceDynamicAtlasScene
+{
+public:
+    CREATE_FUNC(DynamicAtlasOnPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual bool isDynamicAtlasEnabled() const override { return true; }
+};
+
+void runDynamicAtlasPerformanceTest();
+
+#endif /* __PERFORMANCE_DYNAMIC_ATLAS_TEST_H__ */
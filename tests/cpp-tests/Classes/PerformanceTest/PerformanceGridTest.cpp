@@ -0,0 +1,260 @@
+//
+//  PerformanceGridTest.cpp
+//
+
+#include "PerformanceGridTest.h"
+
+static std::function<PerformanceGridScene*()> createFunctions[] =
+{
+    CL(GridCPUPerfTest),
+    CL(GridShaderPerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+
+static int g_curCase = 0;
+
+// Grid3D indices are 16 bits: at most 255x255 cells
+static const int GRID_SIZES[] = { 10, 20, 40, 80, 160, 250 };
+static const int GRID_SIZE_COUNT = sizeof(GRID_SIZES) / sizeof(GRID_SIZES[0]);
+// kept when switching between the CPU and the shader tests
+static int g_gridSizeIndex = 3;
+
+////////////////////////////////////////////////////////
+//
+// GridBasicLayer
+//
+////////////////////////////////////////////////////////
+
+GridBasicLayer::GridBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void GridBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceGridScene
+//
+////////////////////////////////////////////////////////
+
+bool PerformanceGridScene::init()
+{
+    if (!Scene::init())
+        return false;
+
+    _gridNode = nullptr;
+    _action = nullptr;
+    _gridSizeLabel = nullptr;
+    _resultLabel = nullptr;
+    _afterUpdateListener = nullptr;
+    _afterDrawListener = nullptr;
+    _updateMicroseconds = 0;
+    _drawMicroseconds = 0;
+    _frames = 0;
+    _wasShaderEffectsEnabled = true;
+
+    return true;
+}
+
+void PerformanceGridScene::onEnter()
+{
+    Scene::onEnter();
+
+    _wasShaderEffectsEnabled = Grid3DAction::isShaderEffectsEnabled();
+    Grid3DAction::setShaderEffectsEnabled(isShaderEffectsEnabled());
+
+    auto s = Director::getInstance()->getWinSize();
+
+    _gridNode = NodeGrid::create();
+    addChild(_gridNode);
+
+    auto background = Sprite::create("Images/background3.png");
+    background->setPosition(Vec2(s.width/2, s.height/2));
+    background->setScale(std::max(s.width / background->getContentSize().width, s.height / background->getContentSize().height));
+    _gridNode->addChild(background);
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    MenuItemFont::setFontSize(65);
+    auto decrease = MenuItemFont::create(" - ", [&](Ref *sender) {
+        g_gridSizeIndex = std::max(g_gridSizeIndex - 1, 0);
+        updateGridSize();
+    });
+    decrease->setColor(Color3B(0,200,20));
+    auto increase = MenuItemFont::create(" + ", [&](Ref *sender) {
+        g_gridSizeIndex = std::min(g_gridSizeIndex + 1, GRID_SIZE_COUNT - 1);
+        updateGridSize();
+    });
+    increase->setColor(Color3B(0,200,20));
+
+    auto menu = Menu::create(decrease, increase, NULL);
+    menu->alignItemsHorizontally();
+    menu->setPosition(Vec2(s.width/2, s.height/2+45));
+    addChild(menu, 1);
+
+    _gridSizeLabel = Label::createWithTTF("", "fonts/Marker Felt.ttf", 30);
+    _gridSizeLabel->setColor(Color3B(0,200,20));
+    _gridSizeLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_gridSizeLabel, 1);
+
+    _resultLabel = Label::createWithTTF("", "fonts/Marker Felt.ttf", 30);
+    _resultLabel->setColor(Color3B(0,200,20));
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2-35));
+    addChild(_resultLabel, 1);
+
+    auto menuLayer = new GridBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    updateGridSize();
+
+    // visit + render time, which includes the blit of the grid
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    _afterUpdateListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [this](EventCustom* event){
+        _frameStart = std::chrono::high_resolution_clock::now();
+    });
+    _afterDrawListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom* event){
+        auto end = std::chrono::high_resolution_clock::now();
+        _drawMicroseconds += static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(end - _frameStart).count());
+        ++_frames;
+    });
+
+    scheduleUpdate();
+    getScheduler()->schedule(schedule_selector(PerformanceGridScene::updateResult), this, 1, false);
+}
+
+void PerformanceGridScene::onExit()
+{
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    dispatcher->removeEventListener(_afterUpdateListener);
+    dispatcher->removeEventListener(_afterDrawListener);
+
+    if (_action)
+    {
+        _action->stop();
+        CC_SAFE_RELEASE_NULL(_action);
+    }
+
+    Grid3DAction::setShaderEffectsEnabled(_wasShaderEffectsEnabled);
+
+    getScheduler()->unscheduleAllForTarget(this);
+    Scene::onExit();
+}
+
+void PerformanceGridScene::updateGridSize()
+{
+    if (_action)
+    {
+        _action->stop();
+        CC_SAFE_RELEASE_NULL(_action);
+    }
+
+    // the action is stepped by update() so that only its own time is measured
+    int gridSize = GRID_SIZES[g_gridSizeIndex];
+    _action = RepeatForever::create(Waves3D::create(5, Size(gridSize, gridSize), 5, 40));
+    _action->retain();
+    _action->startWithTarget(_gridNode);
+
+    _gridSizeLabel->setString(StringUtils::format("%dx%d grid", gridSize, gridSize));
+    _updateMicroseconds = 0;
+    _drawMicroseconds = 0;
+    _frames = 0;
+}
+
+void PerformanceGridScene::update(float dt)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    _action->step(dt);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    _updateMicroseconds += static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+}
+
+std::string PerformanceGridScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceGridScene::subtitle() const
+{
+    return "";
+}
+
+void PerformanceGridScene::updateResult(float dt)
+{
+    if (_frames > 0)
+    {
+        float updateMs = _updateMicroseconds / (1000.0f * _frames);
+        float drawMs = _drawMicroseconds / (1000.0f * _frames);
+        _resultLabel->setString(StringUtils::format("update: %.2f ms, visit + render: %.2f ms", updateMs, drawMs));
+        CCLOG("%s: %d grid, update %.2f ms/frame, visit + render %.2f ms/frame", title().c_str(), GRID_SIZES[g_gridSizeIndex], updateMs, drawMs);
+    }
+    _updateMicroseconds = 0;
+    _drawMicroseconds = 0;
+    _frames = 0;
+}
+
+////////////////////////////////////////////////////////
+//
+// GridCPUPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string GridCPUPerfTest::title() const
+{
+    return "Waves3D on the CPU";
+}
+
+std::string GridCPUPerfTest::subtitle() const
+{
+    return "The vertices are computed and sent every frame. Use +/- to change the grid size";
+}
+
+////////////////////////////////////////////////////////
+//
+// GridShaderPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string GridShaderPerfTest::title() const
+{
+    return "Waves3D in the vertex shader";
+}
+
+std::string GridShaderPerfTest::subtitle() const
+{
+    return "The grid stays in a VBO, the effect parameters are uniforms";
+}
+
+void runGridPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
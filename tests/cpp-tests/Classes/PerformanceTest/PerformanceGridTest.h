@@ -0,0 +1,73 @@
+//
+//  PerformanceGridTest.h
+
+#ifndef __PERFORMANCE_GRID_TEST_H__
+#define __PERFORMANCE_GRID_TEST_H__
+
+#include "PerformanceTest.h"
+
+#include <chrono>
+
+class GridBasicLayer : public PerformBasicLayer
+{
+public:
+    GridBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+// A full screen NodeGrid running Waves3D, the grid resolution is changed with +/-
+class PerformanceGridScene : public Scene
+{
+public:
+    virtual bool init() override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+    // whether Grid3DAction displaces the grid in the vertex shader
+    virtual bool isShaderEffectsEnabled() const = 0;
+
+    void updateGridSize();
+    void update(float dt) override;
+    void updateResult(float dt);
+protected:
+
+    NodeGrid* _gridNode;
+    Action* _action;
+    Label* _gridSizeLabel;
+    Label* _resultLabel;
+    EventListenerCustom* _afterUpdateListener;
+    EventListenerCustom* _afterDrawListener;
+    std::chrono::high_resolution_clock::time_point _frameStart;
+    long _updateMicroseconds;
+    long _drawMicroseconds;
+    int _frames;
+    bool _wasShaderEffectsEnabled;
+};
+
+class GridCPUPerfTest : public PerformanceGridScene
+{
+public:
+    CREATE_FUNC(GridCPUPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual bool isShaderEffectsEnabled() const override { return false; }
+};
+
+class GridShaderPerfTest : public PerformanceGridScene
+{
+public:
+    CREATE_FUNC(GridShaderPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual bool isShaderEffectsEnabled() const override { return true; }
+};
+
+void runGridPerformanceTest();
+
+#endif /* __PERFORMANCE_GRID_TEST_H__ */
@@ -0,0 +1,212 @@
+//
+//  PerformanceInstancedQuadsTest.cpp
+//
+
+#include "PerformanceInstancedQuadsTest.h"
+
+static std::function<PerformanceInstancedQuadsScene*()> createFunctions[] =
+{
+    CL(InstancedQuadsOffPerfTest),
+    CL(InstancedQuadsOnPerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+
+static int g_curCase = 0;
+
+////////////////////////////////////////////////////////
+//
+// InstancedQuadsBasicLayer
+//
+////////////////////////////////////////////////////////
+
+InstancedQuadsBasicLayer::InstancedQuadsBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void InstancedQuadsBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceInstancedQuadsScene
+//
+////////////////////////////////////////////////////////
+
+bool PerformanceInstancedQuadsScene::init()
+{
+    if (!Scene::init())
+        return false;
+
+    _resultLabel = nullptr;
+    _afterVisitListener = nullptr;
+    _afterDrawListener = nullptr;
+    _renderMicroseconds = 0;
+    _frames = 0;
+    _drawnInstances = 0;
+    _streamedBytes = 0;
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto parent = Node::create();
+    addChild(parent);
+
+    _sprites.reserve(SPRITE_COUNT);
+    for (int i = 0; i < SPRITE_COUNT; ++i)
+    {
+        auto sprite = Sprite::create("Images/grossini_dance_01.png");
+        sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        sprite->setScale(0.25f);
+        sprite->setRotation(CCRANDOM_0_1() * 360);
+        parent->addChild(sprite);
+        _sprites.pushBack(sprite);
+    }
+
+    return true;
+}
+
+void PerformanceInstancedQuadsScene::onEnter()
+{
+    Scene::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto menuLayer = new InstancedQuadsBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    _resultLabel = Label::createWithTTF(StringUtils::format("%d rotating sprites", SPRITE_COUNT), "fonts/Marker Felt.ttf", 30);
+    _resultLabel->setColor(Color3B(0,200,20));
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+
+    auto renderer = Director::getInstance()->getRenderer();
+    renderer->setInstancedQuadsEnabled(isInstancedQuadsEnabled());
+
+    // CPU time of the render, where the quads are transformed and copied
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    _afterVisitListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_VISIT, [this](EventCustom* event){
+        _renderStart = std::chrono::high_resolution_clock::now();
+    });
+    _afterDrawListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom* event){
+        auto end = std::chrono::high_resolution_clock::now();
+        _renderMicroseconds += static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(end - _renderStart).count());
+        ++_frames;
+
+        auto renderer = Director::getInstance()->getRenderer();
+        _drawnInstances = renderer->getDrawnInstances();
+        _streamedBytes = renderer->getStreamedBytes();
+    });
+
+    scheduleUpdate();
+    getScheduler()->schedule(schedule_selector(PerformanceInstancedQuadsScene::updateResult), this, 2, false);
+}
+
+void PerformanceInstancedQuadsScene::onExit()
+{
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    dispatcher->removeEventListener(_afterVisitListener);
+    dispatcher->removeEventListener(_afterDrawListener);
+
+    getScheduler()->unscheduleAllForTarget(this);
+
+    Director::getInstance()->getRenderer()->setInstancedQuadsEnabled(true);
+
+    Scene::onExit();
+}
+
+void PerformanceInstancedQuadsScene::update(float dt)
+{
+    for (auto sprite : _sprites)
+    {
+        sprite->setRotation(sprite->getRotation() + 90 * dt);
+    }
+}
+
+std::string PerformanceInstancedQuadsScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceInstancedQuadsScene::subtitle() const
+{
+    return "";
+}
+
+void PerformanceInstancedQuadsScene::updateResult(float dt)
+{
+    if (_frames > 0)
+    {
+        float renderMs = _renderMicroseconds / (1000.0f * _frames);
+        _resultLabel->setString(StringUtils::format("render: %.2f ms, instances: %ld, streamed: %ld KB",
+                                                    renderMs, (long)_drawnInstances, (long)_streamedBytes / 1024));
+        CCLOG("%s: render %.2f ms/frame, %ld instances, %ld bytes streamed", title().c_str(), renderMs, (long)_drawnInstances, (long)_streamedBytes);
+    }
+    _renderMicroseconds = 0;
+    _frames = 0;
+}
+
+////////////////////////////////////////////////////////
+//
+// InstancedQuadsOffPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string InstancedQuadsOffPerfTest::title() const
+{
+    return "10000 sprites as quads";
+}
+
+std::string InstancedQuadsOffPerfTest::subtitle() const
+{
+    return "setInstancedQuadsEnabled(false): the corners are transformed on the CPU. See console";
+}
+
+////////////////////////////////////////////////////////
+//
+// InstancedQuadsOnPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string InstancedQuadsOnPerfTest::title() const
+{
+    return "10000 sprites as instances";
+}
+
+std::string InstancedQuadsOnPerfTest::subtitle() const
+{
+    return Configuration::getInstance()->supportsInstancedArrays() ?
+        "The vertex shader computes the corners. See console" : "Instanced arrays are not supported by this GPU";
+}
+
+void runInstancedQuadsPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
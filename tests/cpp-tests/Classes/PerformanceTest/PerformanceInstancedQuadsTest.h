@@ -0,0 +1,73 @@
+//
+//  PerformanceInstancedQuadsTest.h
+
+#ifndef __PERFORMANCE_INSTANCED_QUADS_TEST_H__
+#define __PERFORMANCE_INSTANCED_QUADS_TEST_H__
+
+#include <chrono>
+
+#include "PerformanceTest.h"
+
+class InstancedQuadsBasicLayer : public PerformBasicLayer
+{
+public:
+    InstancedQuadsBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+// Sprites of the default shader rotating every frame, drawn as plain quads or as instances
+class PerformanceInstancedQuadsScene : public Scene
+{
+public:
+    virtual bool init() override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+    // whether the renderer draws the sprites with instanced arrays
+    virtual bool isInstancedQuadsEnabled() const = 0;
+
+    void updateResult(float dt);
+protected:
+
+    Vector<Sprite*> _sprites;
+
+    Label* _resultLabel;
+    EventListenerCustom* _afterVisitListener;
+    EventListenerCustom* _afterDrawListener;
+    std::chrono::high_resolution_clock::time_point _renderStart;
+    long _renderMicroseconds;
+    int _frames;
+    ssize_t _drawnInstances;
+    ssize_t _streamedBytes;
+
+    static const int SPRITE_COUNT = 10000;
+};
+
+class InstancedQuadsOffPerfTest : public PerformanceInstancedQuadsScene
+{
+public:
+    CREATE_FUNC(InstancedQuadsOffPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual bool isInstancedQuadsEnabled() const override { return false; }
+};
+
+class InstancedQuadsOnPerfTest : public PerformanceInstancedQuadsScene
+{
+public:
+    CREATE_FUNC(InstancedQuadsOnPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual bool isInstancedQuadsEnabled() const override { return true; }
+};
+
+void runInstancedQuadsPerformanceTest();
+
+#endif /* __PERFORMANCE_INSTANCED_QUADS_TEST_H__ */
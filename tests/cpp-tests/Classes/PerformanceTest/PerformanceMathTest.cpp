@@ -0,0 +1,232 @@
+//
+//  PerformanceMathTest.cpp
+//
+
+#include "PerformanceMathTest.h"
+
+#include <chrono>
+
+#include "math/MathUtil.h"
+
+// Enable profiles for this file
+#undef CC_PROFILER_DISPLAY_TIMERS
+#define CC_PROFILER_DISPLAY_TIMERS() Profiler::getInstance()->displayTimers()
+#undef CC_PROFILER_PURGE_ALL
+#define CC_PROFILER_PURGE_ALL() Profiler::getInstance()->releaseAllTimers()
+
+#undef CC_PROFILER_START
+#define CC_PROFILER_START(__name__) ProfilingBeginTimingBlock(__name__)
+#undef CC_PROFILER_STOP
+#define CC_PROFILER_STOP(__name__) ProfilingEndTimingBlock(__name__)
+
+static std::function<PerformanceMathScene*()> createFunctions[] =
+{
+    CL(QuadTransformScalarPerfTest),
+    CL(QuadTransformBatchPerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+
+static int g_curCase = 0;
+
+////////////////////////////////////////////////////////
+//
+// MathBasicLayer
+//
+////////////////////////////////////////////////////////
+
+MathBasicLayer::MathBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void MathBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceMathScene
+//
+////////////////////////////////////////////////////////
+
+bool PerformanceMathScene::init()
+{
+    if (!Scene::init())
+        return false;
+
+    _resultLabel = nullptr;
+    _elapsedMicroseconds = 0;
+    _transformedQuads = 0;
+
+    // same kind of data a sprite sends in its QuadCommand
+    _quads.resize(QUAD_COUNT);
+    _stagingQuads.resize(QUAD_COUNT);
+    for (auto& quad : _quads)
+    {
+        float x = CCRANDOM_0_1() * 1024;
+        float y = CCRANDOM_0_1() * 768;
+        quad.bl.vertices = Vec3(x, y, 0);
+        quad.br.vertices = Vec3(x + 32, y, 0);
+        quad.tl.vertices = Vec3(x, y + 32, 0);
+        quad.tr.vertices = Vec3(x + 32, y + 32, 0);
+        quad.bl.colors = quad.br.colors = quad.tl.colors = quad.tr.colors = Color4B::WHITE;
+        quad.bl.texCoords = Tex2F(0, 1);
+        quad.br.texCoords = Tex2F(1, 1);
+        quad.tl.texCoords = Tex2F(0, 0);
+        quad.tr.texCoords = Tex2F(1, 0);
+    }
+
+    Mat4::createRotationZ(CC_DEGREES_TO_RADIANS(30), &_modelView);
+    _modelView.translate(100, 50, 0);
+    _modelView.scale(1.5f);
+
+    return true;
+}
+
+void PerformanceMathScene::onEnter()
+{
+    Scene::onEnter();
+
+    CC_PROFILER_PURGE_ALL();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto menuLayer = new MathBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    _resultLabel = Label::createWithTTF(StringUtils::format("%d quads per frame", QUAD_COUNT), "fonts/Marker Felt.ttf", 30);
+    _resultLabel->setColor(Color3B(0,200,20));
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+
+    getScheduler()->schedule(schedule_selector(PerformanceMathScene::onUpdate), this, 0.0f, false);
+    getScheduler()->schedule(schedule_selector(PerformanceMathScene::dumpProfilerInfo), this, 2, false);
+}
+
+void PerformanceMathScene::onExit()
+{
+    getScheduler()->unscheduleAllForTarget(this);
+    Scene::onExit();
+}
+
+std::string PerformanceMathScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceMathScene::subtitle() const
+{
+    return "";
+}
+
+void PerformanceMathScene::onUpdate(float dt)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    CC_PROFILER_START(_profileName.c_str());
+    runKernel();
+    CC_PROFILER_STOP(_profileName.c_str());
+
+    auto end = std::chrono::high_resolution_clock::now();
+    _elapsedMicroseconds += static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+    _transformedQuads += QUAD_COUNT;
+}
+
+void PerformanceMathScene::dumpProfilerInfo(float dt)
+{
+    CC_PROFILER_DISPLAY_TIMERS();
+
+    if (_elapsedMicroseconds > 0)
+    {
+        float quadsPerMs = _transformedQuads * 1000.0f / _elapsedMicroseconds;
+        _resultLabel->setString(StringUtils::format("%.0f quads/ms", quadsPerMs));
+        CCLOG("%s: %.0f quads/ms", _profileName.c_str(), quadsPerMs);
+    }
+    _elapsedMicroseconds = 0;
+    _transformedQuads = 0;
+}
+
+////////////////////////////////////////////////////////
+//
+// QuadTransformScalarPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string QuadTransformScalarPerfTest::title() const
+{
+    return "Quad transform: memcpy + transformPoint";
+}
+
+std::string QuadTransformScalarPerfTest::subtitle() const
+{
+    return "Copy then transform every vertex one by one. See console";
+}
+
+void QuadTransformScalarPerfTest::runKernel()
+{
+    _profileName = "QuadTransformScalar";
+
+    memcpy(_stagingQuads.data(), _quads.data(), sizeof(V3F_C4B_T2F_Quad) * QUAD_COUNT);
+    for (auto& quad : _stagingQuads)
+    {
+        _modelView.transformPoint(&quad.bl.vertices);
+        _modelView.transformPoint(&quad.br.vertices);
+        _modelView.transformPoint(&quad.tr.vertices);
+        _modelView.transformPoint(&quad.tl.vertices);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// QuadTransformBatchPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string QuadTransformBatchPerfTest::title() const
+{
+    return "Quad transform: MathUtil::transformVertices";
+}
+
+std::string QuadTransformBatchPerfTest::subtitle() const
+{
+    return "Copy and transform fused in one SIMD pass. See console";
+}
+
+void QuadTransformBatchPerfTest::runKernel()
+{
+    _profileName = "QuadTransformBatch";
+
+    MathUtil::transformVertices(&_stagingQuads[0].tl, &_quads[0].tl, QUAD_COUNT * 4, _modelView);
+}
+
+void runMathPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
@@ -0,0 +1,69 @@
+//
+//  PerformanceMathTest.h
+
+#ifndef __PERFORMANCE_MATH_TEST_H__
+#define __PERFORMANCE_MATH_TEST_H__
+
+#include "PerformanceTest.h"
+
+class MathBasicLayer : public PerformBasicLayer
+{
+public:
+    MathBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+class PerformanceMathScene : public Scene
+{
+public:
+    virtual bool init() override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+    virtual void onUpdate(float dt);
+
+    // runs the benchmarked code once over `_quads`
+    virtual void runKernel() = 0;
+
+    void dumpProfilerInfo(float dt);
+protected:
+
+    std::string _profileName;
+    std::vector<V3F_C4B_T2F_Quad> _quads;
+    std::vector<V3F_C4B_T2F_Quad> _stagingQuads;
+    Mat4 _modelView;
+
+    Label* _resultLabel;
+    long _elapsedMicroseconds;
+    long _transformedQuads;
+
+    static const int QUAD_COUNT = 20000;
+};
+
+// Old path of Renderer::visitRenderQueue: memcpy, then Mat4::transformPoint per vertex
+class QuadTransformScalarPerfTest : public PerformanceMathScene
+{
+public:
+    CREATE_FUNC(QuadTransformScalarPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void runKernel() override;
+};
+
+// New path: MathUtil::transformVertices, copy and transform fused into one SIMD pass
+class QuadTransformBatchPerfTest : public PerformanceMathScene
+{
+public:
+    CREATE_FUNC(QuadTransformBatchPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void runKernel() override;
+};
+
+void runMathPerformanceTest();
+
+#endif /* __PERFORMANCE_MATH_TEST_H__ */
@@ -46,6 +46,7 @@ static std::function<NodeChildrenMainScene*()> createFunctions[] =
     CL(SortAllChildrenSpriteSheet),
 
     CL(VisitSceneGraph),
+    CL(VisitSceneGraphParallel),
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -968,6 +969,63 @@ const char*  VisitSceneGraph::testName()
     return "visit()";
 }
 
+////////////////////////////////////////////////////////
+//
+// VisitSceneGraphParallel
+//
+////////////////////////////////////////////////////////
+void VisitSceneGraphParallel::initWithQuantityOfNodes(unsigned int nodes)
+{
+    // the nodes live in a container so that only them are visited by the worker threads
+    _container = Node::create();
+    _container->setParallelVisitEnabled(true);
+    this->addChild(_container);
+
+    VisitSceneGraph::initWithQuantityOfNodes(nodes);
+}
+
+void VisitSceneGraphParallel::updateQuantityOfNodes()
+{
+    // increase nodes
+    if( currentQuantityOfNodes < quantityOfNodes )
+    {
+        for(int i = 0; i < (quantityOfNodes-currentQuantityOfNodes); i++)
+        {
+            auto node = Node::create();
+            _container->addChild(node);
+            node->setVisible(true);
+            node->setPosition(Vec2(-1000,-1000));
+            node->setTag(1000 + currentQuantityOfNodes + i );
+        }
+    }
+
+    // decrease nodes
+    else if ( currentQuantityOfNodes > quantityOfNodes )
+    {
+        for(int i = 0; i < (currentQuantityOfNodes-quantityOfNodes); i++)
+        {
+            _container->removeChildByTag(1000 + currentQuantityOfNodes - i -1 );
+        }
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+std::string VisitSceneGraphParallel::title() const
+{
+    return "Performance of visiting the scene graph in parallel";
+}
+
+std::string VisitSceneGraphParallel::subtitle() const
+{
+    return "Node::setParallelVisitEnabled(true). See console";
+}
+
+const char*  VisitSceneGraphParallel::testName()
+{
+    return "visit() parallel";
+}
+
 ///----------------------------------------
 void runNodeChildrenTest()
 {
@@ -226,6 +226,22 @@ public:
     virtual const char* testName() override;
 };
 
+class VisitSceneGraphParallel : public VisitSceneGraph
+{
+public:
+    CREATE_FUNC(VisitSceneGraphParallel);
+
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    Node* _container;
+};
+
 void runNodeChildrenTest();
 
 #endif // __PERFORMANCE_NODE_CHILDREN_TEST_H__
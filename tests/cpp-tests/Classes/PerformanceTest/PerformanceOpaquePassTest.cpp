@@ -0,0 +1,189 @@
+//
+//  PerformanceOpaquePassTest.cpp
+//
+
+#include "PerformanceOpaquePassTest.h"
+
+static std::function<PerformanceOpaquePassScene*()> createFunctions[] =
+{
+    CL(OpaquePassOffPerfTest),
+    CL(OpaquePassOnPerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+
+static int g_curCase = 0;
+
+////////////////////////////////////////////////////////
+//
+// OpaquePassBasicLayer
+//
+////////////////////////////////////////////////////////
+
+OpaquePassBasicLayer::OpaquePassBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void OpaquePassBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceOpaquePassScene
+//
+////////////////////////////////////////////////////////
+
+bool PerformanceOpaquePassScene::init()
+{
+    if (!Scene::init())
+        return false;
+
+    _resultLabel = nullptr;
+    _afterDrawListener = nullptr;
+    _drawnBatches = 0;
+    _overdraw = -1;
+
+    auto s = Director::getInstance()->getWinSize();
+
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        // drawn without blending: hides everything behind it
+        auto background = Sprite::create(layer % 2 ? "Images/background2.png" : "Images/background1.png");
+        background->setBlendFunc(BlendFunc::DISABLE);
+        background->setScaleX(s.width / background->getContentSize().width);
+        background->setScaleY(s.height / background->getContentSize().height);
+        background->setPosition(Vec2(s.width/2, s.height/2));
+        addChild(background);
+
+        for (int i = 0; i < SPRITES_PER_LAYER; ++i)
+        {
+            auto sprite = Sprite::create("Images/grossini.png");
+            sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+            addChild(sprite);
+        }
+    }
+
+    return true;
+}
+
+void PerformanceOpaquePassScene::onEnter()
+{
+    Scene::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto menuLayer = new OpaquePassBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    _resultLabel = Label::createWithTTF(StringUtils::format("%d backgrounds", LAYER_COUNT), "fonts/Marker Felt.ttf", 30);
+    _resultLabel->setColor(Color3B(0,200,20));
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+
+    auto renderer = Director::getInstance()->getRenderer();
+    renderer->setOpaquePassEnabled(isOpaquePassEnabled());
+    renderer->setOverdrawMeasured(true);
+
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    _afterDrawListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom* event){
+        auto renderer = Director::getInstance()->getRenderer();
+        _drawnBatches = renderer->getDrawnBatches();
+        _overdraw = renderer->getOverdraw();
+    });
+
+    getScheduler()->schedule(schedule_selector(PerformanceOpaquePassScene::updateResult), this, 1, false);
+}
+
+void PerformanceOpaquePassScene::onExit()
+{
+    Director::getInstance()->getEventDispatcher()->removeEventListener(_afterDrawListener);
+    getScheduler()->unscheduleAllForTarget(this);
+
+    auto renderer = Director::getInstance()->getRenderer();
+    renderer->setOpaquePassEnabled(false);
+    renderer->setOverdrawMeasured(false);
+
+    Scene::onExit();
+}
+
+std::string PerformanceOpaquePassScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceOpaquePassScene::subtitle() const
+{
+    return "";
+}
+
+void PerformanceOpaquePassScene::updateResult(float dt)
+{
+    std::string overdraw = _overdraw < 0 ? "n/a" : StringUtils::format("%.2fx", _overdraw);
+    _resultLabel->setString(StringUtils::format("overdraw: %s, draw calls: %ld", overdraw.c_str(), (long)_drawnBatches));
+    CCLOG("%s: overdraw %s, %ld draw calls", title().c_str(), overdraw.c_str(), (long)_drawnBatches);
+}
+
+////////////////////////////////////////////////////////
+//
+// OpaquePassOffPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string OpaquePassOffPerfTest::title() const
+{
+    return "Drawn in order";
+}
+
+std::string OpaquePassOffPerfTest::subtitle() const
+{
+    return "8 opaque backgrounds, 400 sprites. Overdraw needs GL_ARB_occlusion_query";
+}
+
+////////////////////////////////////////////////////////
+//
+// OpaquePassOnPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string OpaquePassOnPerfTest::title() const
+{
+    return "Opaque pass";
+}
+
+std::string OpaquePassOnPerfTest::subtitle() const
+{
+    return "Renderer::setOpaquePassEnabled(true): the hidden backgrounds are rejected by the depth test";
+}
+
+void runOpaquePassPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
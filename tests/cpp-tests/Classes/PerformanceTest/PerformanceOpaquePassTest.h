@@ -0,0 +1,65 @@
+//
+//  PerformanceOpaquePassTest.h
+
+#ifndef __PERFORMANCE_OPAQUE_PASS_TEST_H__
+#define __PERFORMANCE_OPAQUE_PASS_TEST_H__
+
+#include "PerformanceTest.h"
+
+class OpaquePassBasicLayer : public PerformBasicLayer
+{
+public:
+    OpaquePassBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+// Full screen opaque backgrounds stacked on top of each other, with translucent sprites between them
+class PerformanceOpaquePassScene : public Scene
+{
+public:
+    virtual bool init() override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+    // whether the renderer draws the opaque sprites first
+    virtual bool isOpaquePassEnabled() const = 0;
+
+    void updateResult(float dt);
+protected:
+
+    Label* _resultLabel;
+    EventListenerCustom* _afterDrawListener;
+    ssize_t _drawnBatches;
+    float _overdraw;
+
+    static const int LAYER_COUNT = 8;
+    static const int SPRITES_PER_LAYER = 50;
+};
+
+class OpaquePassOffPerfTest : public PerformanceOpaquePassScene
+{
+public:
+    CREATE_FUNC(OpaquePassOffPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual bool isOpaquePassEnabled() const override { return false; }
+};
+
+class OpaquePassOnPerfTest : public PerformanceOpaquePassScene
+{
+public:
+    CREATE_FUNC(OpaquePassOnPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual bool isOpaquePassEnabled() const override { return true; }
+};
+
+void runOpaquePassPerformanceTest();
+
+#endif /* __PERFORMANCE_OPAQUE_PASS_TEST_H__ */
@@ -0,0 +1,178 @@
+//
+//  PerformanceParticleSpawnTest.cpp
+//
+
+#include "PerformanceParticleSpawnTest.h"
+
+#include <chrono>
+
+static std::function<PerformanceParticleSpawnScene*()> createFunctions[] =
+{
+    CL(ParticleSpawnCreatePerfTest),
+    CL(ParticleSpawnCachePerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+
+static int g_curCase = 0;
+
+static const int EXPLOSIONS_PER_BURST = 50;
+static const char* EXPLOSION_FILE = "Particles/ExplodingRing.plist";
+
+////////////////////////////////////////////////////////
+//
+// ParticleSpawnBasicLayer
+//
+////////////////////////////////////////////////////////
+
+ParticleSpawnBasicLayer::ParticleSpawnBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void ParticleSpawnBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceParticleSpawnScene
+//
+////////////////////////////////////////////////////////
+
+bool PerformanceParticleSpawnScene::init()
+{
+    if (!Scene::init())
+        return false;
+
+    _resultLabel = nullptr;
+
+    return true;
+}
+
+void PerformanceParticleSpawnScene::onEnter()
+{
+    Scene::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    _resultLabel = Label::createWithTTF("", "fonts/Marker Felt.ttf", 30);
+    _resultLabel->setColor(Color3B(0,200,20));
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+
+    auto menuLayer = new ParticleSpawnBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    getScheduler()->schedule(schedule_selector(PerformanceParticleSpawnScene::spawnExplosions), this, 1, false);
+}
+
+void PerformanceParticleSpawnScene::onExit()
+{
+    getScheduler()->unscheduleAllForTarget(this);
+    Scene::onExit();
+}
+
+void PerformanceParticleSpawnScene::spawnExplosions(float dt)
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (int i = 0; i < EXPLOSIONS_PER_BURST; ++i)
+    {
+        auto explosion = createExplosion();
+        explosion->setAutoRemoveOnFinish(true);
+        explosion->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        addChild(explosion);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    float spawnMs = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0f;
+
+    _resultLabel->setString(StringUtils::format("%d explosions spawned in %.2f ms", EXPLOSIONS_PER_BURST, spawnMs));
+    CCLOG("%s: %d explosions spawned in %.2f ms", title().c_str(), EXPLOSIONS_PER_BURST, spawnMs);
+}
+
+std::string PerformanceParticleSpawnScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceParticleSpawnScene::subtitle() const
+{
+    return "";
+}
+
+////////////////////////////////////////////////////////
+//
+// ParticleSpawnCreatePerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ParticleSpawnCreatePerfTest::title() const
+{
+    return "ParticleSystemQuad::create";
+}
+
+std::string ParticleSpawnCreatePerfTest::subtitle() const
+{
+    return "Every explosion is initialized from the plist file and allocates its particles";
+}
+
+ParticleSystem* ParticleSpawnCreatePerfTest::createExplosion()
+{
+    return ParticleSystemQuad::create(EXPLOSION_FILE);
+}
+
+////////////////////////////////////////////////////////
+//
+// ParticleSpawnCachePerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ParticleSpawnCachePerfTest::title() const
+{
+    return "ParticleSystemCache::getParticleSystem";
+}
+
+std::string ParticleSpawnCachePerfTest::subtitle() const
+{
+    return "The finished explosions are reset and reused";
+}
+
+ParticleSystem* ParticleSpawnCachePerfTest::createExplosion()
+{
+    return ParticleSystemCache::getInstance()->getParticleSystem(EXPLOSION_FILE);
+}
+
+void runParticleSpawnPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
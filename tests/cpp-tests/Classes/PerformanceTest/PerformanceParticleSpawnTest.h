@@ -0,0 +1,59 @@
+//
+//  PerformanceParticleSpawnTest.h
+
+#ifndef __PERFORMANCE_PARTICLE_SPAWN_TEST_H__
+#define __PERFORMANCE_PARTICLE_SPAWN_TEST_H__
+
+#include "PerformanceTest.h"
+
+class ParticleSpawnBasicLayer : public PerformBasicLayer
+{
+public:
+    ParticleSpawnBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+// Spawns a burst of explosions from a plist file every second
+class PerformanceParticleSpawnScene : public Scene
+{
+public:
+    virtual bool init() override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+    // returns a new explosion
+    virtual ParticleSystem* createExplosion() = 0;
+
+    void spawnExplosions(float dt);
+protected:
+
+    Label* _resultLabel;
+};
+
+class ParticleSpawnCreatePerfTest : public PerformanceParticleSpawnScene
+{
+public:
+    CREATE_FUNC(ParticleSpawnCreatePerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual ParticleSystem* createExplosion() override;
+};
+
+class ParticleSpawnCachePerfTest : public PerformanceParticleSpawnScene
+{
+public:
+    CREATE_FUNC(ParticleSpawnCachePerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual ParticleSystem* createExplosion() override;
+};
+
+void runParticleSpawnPerformanceTest();
+
+#endif /* __PERFORMANCE_PARTICLE_SPAWN_TEST_H__ */
@@ -0,0 +1,321 @@
+//
+//  PerformanceParticleSystemsTest.cpp
+//
+
+#include "PerformanceParticleSystemsTest.h"
+
+static std::function<PerformanceParticleSystemsScene*()> createFunctions[] =
+{
+    CL(ParticleSystemsSerialPerfTest),
+    CL(ParticleSystemsParallelPerfTest),
+    CL(ParticleSystemsGPUPerfTest),
+    CL(ParticleSystemsInterleavedPerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+
+static int g_curCase = 0;
+
+static const int EMITTERS_INCREASE = 20;
+static const int MAX_EMITTERS = 400;
+// kept when switching between the tests
+static int g_emitterCount = 100;
+
+////////////////////////////////////////////////////////
+//
+// ParticleSystemsBasicLayer
+//
+////////////////////////////////////////////////////////
+
+ParticleSystemsBasicLayer::ParticleSystemsBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void ParticleSystemsBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceParticleSystemsScene
+//
+////////////////////////////////////////////////////////
+
+bool PerformanceParticleSystemsScene::init()
+{
+    if (!Scene::init())
+        return false;
+
+    _emitters = nullptr;
+    _countLabel = nullptr;
+    _resultLabel = nullptr;
+    _afterVisitListener = nullptr;
+    _afterDrawListener = nullptr;
+    _frameMicroseconds = 0;
+    _frames = 0;
+    _drawCalls = 0;
+    _wasParallelUpdateEnabled = false;
+
+    return true;
+}
+
+void PerformanceParticleSystemsScene::onEnter()
+{
+    Scene::onEnter();
+
+    _wasParallelUpdateEnabled = ParticleSystem::isParallelUpdateEnabled();
+    ParticleSystem::setParallelUpdateEnabled(isParallelUpdateEnabled());
+
+    auto s = Director::getInstance()->getWinSize();
+
+    _emitters = Node::create();
+    addChild(_emitters);
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    MenuItemFont::setFontSize(65);
+    auto decrease = MenuItemFont::create(" - ", [&](Ref *sender) {
+        g_emitterCount = std::max(g_emitterCount - EMITTERS_INCREASE, EMITTERS_INCREASE);
+        createEmitters();
+    });
+    decrease->setColor(Color3B(0,200,20));
+    auto increase = MenuItemFont::create(" + ", [&](Ref *sender) {
+        g_emitterCount = std::min(g_emitterCount + EMITTERS_INCREASE, MAX_EMITTERS);
+        createEmitters();
+    });
+    increase->setColor(Color3B(0,200,20));
+
+    auto menu = Menu::create(decrease, increase, NULL);
+    menu->alignItemsHorizontally();
+    menu->setPosition(Vec2(s.width/2, s.height/2+45));
+    addChild(menu, 1);
+
+    _countLabel = Label::createWithTTF("", "fonts/Marker Felt.ttf", 30);
+    _countLabel->setColor(Color3B(0,200,20));
+    _countLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_countLabel, 1);
+
+    _resultLabel = Label::createWithTTF("", "fonts/Marker Felt.ttf", 30);
+    _resultLabel->setColor(Color3B(0,200,20));
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2-35));
+    addChild(_resultLabel, 1);
+
+    auto menuLayer = new ParticleSystemsBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    createEmitters();
+
+    // from the first update to the end of the visit, which covers the parallel update of the systems
+    _afterVisitListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_VISIT, [this](EventCustom* event){
+        auto end = std::chrono::high_resolution_clock::now();
+        _frameMicroseconds += static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(end - _frameStart).count());
+        ++_frames;
+    });
+
+    // the draw calls of the whole scene, labels included
+    _afterDrawListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom* event){
+        _drawCalls = Director::getInstance()->getRenderer()->getDrawnBatches();
+    });
+
+    scheduleUpdateWithPriority(Scheduler::PRIORITY_NON_SYSTEM_MIN);
+    getScheduler()->schedule(schedule_selector(PerformanceParticleSystemsScene::updateResult), this, 1, false);
+}
+
+void PerformanceParticleSystemsScene::onExit()
+{
+    Director::getInstance()->getEventDispatcher()->removeEventListener(_afterVisitListener);
+    Director::getInstance()->getEventDispatcher()->removeEventListener(_afterDrawListener);
+
+    ParticleSystem::setParallelUpdateEnabled(_wasParallelUpdateEnabled);
+
+    getScheduler()->unscheduleAllForTarget(this);
+    Scene::onExit();
+}
+
+void PerformanceParticleSystemsScene::createEmitters()
+{
+    _emitters->removeAllChildren();
+
+    auto s = Director::getInstance()->getWinSize();
+    int columns = static_cast<int>(ceilf(sqrtf(static_cast<float>(g_emitterCount))));
+    int rows = (g_emitterCount + columns - 1) / columns;
+
+    for (int i = 0; i < g_emitterCount; ++i)
+    {
+        auto emitter = createEmitter();
+        emitter->setRandomSeed(i + 1);
+        emitter->setPosition(Vec2(s.width * (i % columns + 0.5f) / columns, s.height * (i / columns + 0.5f) / rows));
+        _emitters->addChild(emitter);
+    }
+
+    _countLabel->setString(StringUtils::format("%d emitters", g_emitterCount));
+    _frameMicroseconds = 0;
+    _frames = 0;
+}
+
+ParticleSystem* PerformanceParticleSystemsScene::createEmitter()
+{
+    return ParticleSun::createWithTotalParticles(200);
+}
+
+void PerformanceParticleSystemsScene::update(float dt)
+{
+    // scheduled before the other nodes
+    _frameStart = std::chrono::high_resolution_clock::now();
+}
+
+std::string PerformanceParticleSystemsScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceParticleSystemsScene::subtitle() const
+{
+    return "";
+}
+
+void PerformanceParticleSystemsScene::updateResult(float dt)
+{
+    if (_frames > 0)
+    {
+        float frameMs = _frameMicroseconds / (1000.0f * _frames);
+        _resultLabel->setString(StringUtils::format("update + visit: %.2f ms, %d draw calls", frameMs, (int)_drawCalls));
+        CCLOG("%s: %d emitters, update + visit %.2f ms/frame, %d draw calls", title().c_str(), g_emitterCount, frameMs, (int)_drawCalls);
+    }
+    _frameMicroseconds = 0;
+    _frames = 0;
+}
+
+////////////////////////////////////////////////////////
+//
+// ParticleSystemsSerialPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ParticleSystemsSerialPerfTest::title() const
+{
+    return "Serial particle update";
+}
+
+std::string ParticleSystemsSerialPerfTest::subtitle() const
+{
+    return "Each emitter is updated by the Scheduler. Use +/- to change the number of emitters";
+}
+
+////////////////////////////////////////////////////////
+//
+// ParticleSystemsParallelPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ParticleSystemsParallelPerfTest::title() const
+{
+    return "Parallel particle update";
+}
+
+std::string ParticleSystemsParallelPerfTest::subtitle() const
+{
+    return "The emitters are updated together on the worker threads";
+}
+
+////////////////////////////////////////////////////////
+//
+// ParticleSystemsGPUPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ParticleSystemsGPUPerfTest::title() const
+{
+    return "GPU particle update";
+}
+
+std::string ParticleSystemsGPUPerfTest::subtitle() const
+{
+    return "The particles are computed in the vertex shader, each emitter only sets its time";
+}
+
+ParticleSystem* ParticleSystemsGPUPerfTest::createEmitter()
+{
+    // the same parameters as ParticleSun
+    auto emitter = ParticleSystemGPU::createWithTotalParticles(200);
+    emitter->setTexture(Director::getInstance()->getTextureCache()->addImage("Images/fire.png"));
+    emitter->setBlendAdditive(true);
+    emitter->setDuration(ParticleSystem::DURATION_INFINITY);
+    emitter->setEmitterMode(ParticleSystem::Mode::GRAVITY);
+    emitter->setGravity(Vec2::ZERO);
+    emitter->setSpeed(20);
+    emitter->setSpeedVar(5);
+    emitter->setAngle(90);
+    emitter->setAngleVar(360);
+    emitter->setPosVar(Vec2::ZERO);
+    emitter->setLife(1);
+    emitter->setLifeVar(0.5f);
+    emitter->setStartSize(30);
+    emitter->setStartSizeVar(10);
+    emitter->setEndSize(ParticleSystem::START_SIZE_EQUAL_TO_END_SIZE);
+    emitter->setEmissionRate(200);
+    emitter->setStartColor(Color4F(0.76f, 0.25f, 0.12f, 1.0f));
+    emitter->setStartColorVar(Color4F(0, 0, 0, 0));
+    emitter->setEndColor(Color4F(0, 0, 0, 1));
+    emitter->setEndColorVar(Color4F(0, 0, 0, 0));
+    return emitter;
+}
+
+////////////////////////////////////////////////////////
+//
+// ParticleSystemsInterleavedPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string ParticleSystemsInterleavedPerfTest::title() const
+{
+    return "Interleaved emitters";
+}
+
+std::string ParticleSystemsInterleavedPerfTest::subtitle() const
+{
+    return "A sprite is drawn after each emitter, both are order independent";
+}
+
+ParticleSystem* ParticleSystemsInterleavedPerfTest::createEmitter()
+{
+    auto emitter = ParticleSun::createWithTotalParticles(200);
+    // additive, the emitters can be drawn in any order
+    emitter->setOrderIndependent(true);
+
+    auto sprite = Sprite::create("Images/r1.png");
+    sprite->setOrderIndependent(true);
+    emitter->addChild(sprite);
+
+    return emitter;
+}
+
+void runParticleSystemsPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
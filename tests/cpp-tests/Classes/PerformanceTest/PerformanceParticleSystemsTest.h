@@ -0,0 +1,97 @@
+//
+//  PerformanceParticleSystemsTest.h
+
+#ifndef __PERFORMANCE_PARTICLE_SYSTEMS_TEST_H__
+#define __PERFORMANCE_PARTICLE_SYSTEMS_TEST_H__
+
+#include "PerformanceTest.h"
+
+#include <chrono>
+
+class ParticleSystemsBasicLayer : public PerformBasicLayer
+{
+public:
+    ParticleSystemsBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+// Many small emitters updated together, the number of emitters is changed with +/-
+class PerformanceParticleSystemsScene : public Scene
+{
+public:
+    virtual bool init() override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+    // whether the systems are updated on the worker threads
+    virtual bool isParallelUpdateEnabled() const = 0;
+    // a small sun, 200 particles
+    virtual ParticleSystem* createEmitter();
+
+    void createEmitters();
+    void update(float dt) override;
+    void updateResult(float dt);
+protected:
+
+    Node* _emitters;
+    Label* _countLabel;
+    Label* _resultLabel;
+    EventListenerCustom* _afterVisitListener;
+    EventListenerCustom* _afterDrawListener;
+    std::chrono::high_resolution_clock::time_point _frameStart;
+    long _frameMicroseconds;
+    int _frames;
+    ssize_t _drawCalls;
+    bool _wasParallelUpdateEnabled;
+};
+
+class ParticleSystemsSerialPerfTest : public PerformanceParticleSystemsScene
+{
+public:
+    CREATE_FUNC(ParticleSystemsSerialPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual bool isParallelUpdateEnabled() const override { return false; }
+};
+
+class ParticleSystemsParallelPerfTest : public PerformanceParticleSystemsScene
+{
+public:
+    CREATE_FUNC(ParticleSystemsParallelPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual bool isParallelUpdateEnabled() const override { return true; }
+};
+
+class ParticleSystemsGPUPerfTest : public PerformanceParticleSystemsScene
+{
+public:
+    CREATE_FUNC(ParticleSystemsGPUPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual bool isParallelUpdateEnabled() const override { return false; }
+    virtual ParticleSystem* createEmitter() override;
+};
+
+// Every emitter has a sprite child, which is drawn between it and the next emitter
+class ParticleSystemsInterleavedPerfTest : public PerformanceParticleSystemsScene
+{
+public:
+    CREATE_FUNC(ParticleSystemsInterleavedPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual bool isParallelUpdateEnabled() const override { return false; }
+    virtual ParticleSystem* createEmitter() override;
+};
+
+void runParticleSystemsPerformanceTest();
+
+#endif /* __PERFORMANCE_PARTICLE_SYSTEMS_TEST_H__ */
@@ -1,11 +1,13 @@
 #include "PerformanceParticleTest.h"
 
+#include <chrono>
 
 enum {
     kTagInfoLayer = 1,
     kTagMainLayer = 2,
     kTagParticleSystem = 3,
     kTagLabelAtlas = 4,
+    kTagResultLabel = 5,
     kTagMenuLayer = 1000,
 
     TEST_COUNT = 4,
@@ -77,6 +79,8 @@ void ParticleMainScene::initWithSubTest(int asubtest, int particles)
 
     lastRenderedCount = 0;
     quantityParticles = particles;
+    updateMicroseconds = 0;
+    updatedParticles = 0;
 
     MenuItemFont::setFontSize(65);
     auto decrease = MenuItemFont::create(" - ", [&](Ref *sender) {
@@ -108,6 +112,11 @@ void ParticleMainScene::initWithSubTest(int asubtest, int particles)
     infoLabel->setPosition(Vec2(s.width/2, s.height - 90));
     addChild(infoLabel, 1, kTagInfoLayer);
 
+    auto resultLabel = Label::createWithTTF("", "fonts/Marker Felt.ttf", 30);
+    resultLabel->setColor(Color3B(0,200,20));
+    resultLabel->setPosition(Vec2(s.width/2, s.height/2-35));
+    addChild(resultLabel, 1, kTagResultLabel);
+
     // particles on stage
     auto labelAtlas = LabelAtlas::create("0000", "fps_images.png", 12, 32, '.');
     addChild(labelAtlas, 0, kTagLabelAtlas);
@@ -150,6 +159,7 @@ void ParticleMainScene::initWithSubTest(int asubtest, int particles)
     createParticleSystem();
 
     schedule(schedule_selector(ParticleMainScene::step));
+    schedule(schedule_selector(ParticleMainScene::updateResult), 1.0f);
 }
 
 std::string ParticleMainScene::title() const
@@ -162,11 +172,34 @@ void ParticleMainScene::step(float dt)
     auto atlas = (LabelAtlas*) getChildByTag(kTagLabelAtlas);
     auto emitter = (ParticleSystem*) getChildByTag(kTagParticleSystem);
 
+    // the emitter is stepped here instead of by the scheduler so its update can be timed
+    emitter->unscheduleUpdate();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    emitter->update(dt);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    updateMicroseconds += static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+    updatedParticles += emitter->getParticleCount();
+
     char str[10] = {0};
     sprintf(str, "%4d", emitter->getParticleCount());
     atlas->setString(str);
 }
 
+void ParticleMainScene::updateResult(float dt)
+{
+    if (updateMicroseconds > 0)
+    {
+        float particlesPerMs = updatedParticles * 1000.0f / updateMicroseconds;
+        auto resultLabel = (Label*) getChildByTag(kTagResultLabel);
+        resultLabel->setString(StringUtils::format("%.0f particles updated/ms", particlesPerMs));
+        CCLOG("%s: %d particles, %.0f particles updated/ms", title().c_str(), quantityParticles, particlesPerMs);
+    }
+    updateMicroseconds = 0;
+    updatedParticles = 0;
+}
+
 void ParticleMainScene::createParticleSystem()
 {
     ParticleSystemQuad *particleSystem = nullptr;
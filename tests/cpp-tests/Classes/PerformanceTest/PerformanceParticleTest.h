@@ -17,6 +17,7 @@ public:
     virtual std::string title() const;
 
     void step(float dt);
+    void updateResult(float dt);
     void createParticleSystem();
     void testNCallback(Ref* sender);
     void updateQuantityLabel();
@@ -28,6 +29,10 @@ protected:
     int            lastRenderedCount;
     int            quantityParticles;
     int            subtestNumber;
+
+    // time spent in the emitter update and particles it updated since the last result
+    long           updateMicroseconds;
+    long           updatedParticles;
 };
 
 class ParticlePerformTest1 : public ParticleMainScene
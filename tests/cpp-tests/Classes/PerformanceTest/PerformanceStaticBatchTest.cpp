@@ -0,0 +1,211 @@
+//
+//  PerformanceStaticBatchTest.cpp
+//
+
+#include "PerformanceStaticBatchTest.h"
+
+// Enable profiles for this file
+#undef CC_PROFILER_DISPLAY_TIMERS
+#define CC_PROFILER_DISPLAY_TIMERS() Profiler::getInstance()->displayTimers()
+#undef CC_PROFILER_PURGE_ALL
+#define CC_PROFILER_PURGE_ALL() Profiler::getInstance()->releaseAllTimers()
+
+static std::function<PerformanceStaticBatchScene*()> createFunctions[] =
+{
+    CL(StaticSpritesNodePerfTest),
+    CL(StaticSpritesBatchPerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+
+static int g_curCase = 0;
+
+////////////////////////////////////////////////////////
+//
+// StaticBatchBasicLayer
+//
+////////////////////////////////////////////////////////
+
+StaticBatchBasicLayer::StaticBatchBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void StaticBatchBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceStaticBatchScene
+//
+////////////////////////////////////////////////////////
+
+bool PerformanceStaticBatchScene::init()
+{
+    if (!Scene::init())
+        return false;
+
+    _resultLabel = nullptr;
+    _afterUpdateListener = nullptr;
+    _afterDrawListener = nullptr;
+    _elapsedMicroseconds = 0;
+    _frames = 0;
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto container = createContainer();
+    addChild(container);
+
+    for (int i = 0; i < SPRITE_COUNT; ++i)
+    {
+        auto sprite = Sprite::create("Images/grossini_dance_01.png");
+        sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        sprite->setRotation(CCRANDOM_0_1() * 360);
+        sprite->setScale(0.25f);
+        container->addChild(sprite);
+    }
+
+    return true;
+}
+
+void PerformanceStaticBatchScene::onEnter()
+{
+    Scene::onEnter();
+
+    CC_PROFILER_PURGE_ALL();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto menuLayer = new StaticBatchBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    _resultLabel = Label::createWithTTF(StringUtils::format("%d static sprites", SPRITE_COUNT), "fonts/Marker Felt.ttf", 30);
+    _resultLabel->setColor(Color3B(0,200,20));
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+
+    // CPU time of the visit and of the render, the scheduler update is left out
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    _afterUpdateListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [this](EventCustom* event){
+        _frameStart = std::chrono::high_resolution_clock::now();
+    });
+    _afterDrawListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom* event){
+        auto end = std::chrono::high_resolution_clock::now();
+        _elapsedMicroseconds += static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(end - _frameStart).count());
+        ++_frames;
+    });
+
+    getScheduler()->schedule(schedule_selector(PerformanceStaticBatchScene::dumpProfilerInfo), this, 2, false);
+}
+
+void PerformanceStaticBatchScene::onExit()
+{
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    dispatcher->removeEventListener(_afterUpdateListener);
+    dispatcher->removeEventListener(_afterDrawListener);
+
+    getScheduler()->unscheduleAllForTarget(this);
+    Scene::onExit();
+}
+
+std::string PerformanceStaticBatchScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceStaticBatchScene::subtitle() const
+{
+    return "";
+}
+
+void PerformanceStaticBatchScene::dumpProfilerInfo(float dt)
+{
+    CC_PROFILER_DISPLAY_TIMERS();
+
+    if (_frames > 0)
+    {
+        float msPerFrame = _elapsedMicroseconds / (1000.0f * _frames);
+        _resultLabel->setString(StringUtils::format("visit + render: %.2f ms/frame", msPerFrame));
+        CCLOG("%s: visit + render %.2f ms/frame", _profileName.c_str(), msPerFrame);
+    }
+    _elapsedMicroseconds = 0;
+    _frames = 0;
+}
+
+////////////////////////////////////////////////////////
+//
+// StaticSpritesNodePerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string StaticSpritesNodePerfTest::title() const
+{
+    return "50000 static sprites in a Node";
+}
+
+std::string StaticSpritesNodePerfTest::subtitle() const
+{
+    return "Visited and transformed every frame. See console";
+}
+
+Node* StaticSpritesNodePerfTest::createContainer()
+{
+    _profileName = "StaticSpritesNode";
+
+    return Node::create();
+}
+
+////////////////////////////////////////////////////////
+//
+// StaticSpritesBatchPerfTest
+//
+////////////////////////////////////////////////////////
+
+std::string StaticSpritesBatchPerfTest::title() const
+{
+    return "50000 static sprites in a StaticBatchNode";
+}
+
+std::string StaticSpritesBatchPerfTest::subtitle() const
+{
+    return "Captured once in a static VBO. See console";
+}
+
+Node* StaticSpritesBatchPerfTest::createContainer()
+{
+    _profileName = "StaticSpritesBatch";
+
+    return StaticBatchNode::create();
+}
+
+void runStaticBatchPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
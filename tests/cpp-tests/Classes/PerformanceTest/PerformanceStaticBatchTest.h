@@ -0,0 +1,70 @@
+//
+//  PerformanceStaticBatchTest.h
+
+#ifndef __PERFORMANCE_STATIC_BATCH_TEST_H__
+#define __PERFORMANCE_STATIC_BATCH_TEST_H__
+
+#include <chrono>
+
+#include "PerformanceTest.h"
+
+class StaticBatchBasicLayer : public PerformBasicLayer
+{
+public:
+    StaticBatchBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+class PerformanceStaticBatchScene : public Scene
+{
+public:
+    virtual bool init() override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+    // returns the node the static sprites are added to
+    virtual Node* createContainer() = 0;
+
+    void dumpProfilerInfo(float dt);
+protected:
+
+    std::string _profileName;
+
+    Label* _resultLabel;
+    EventListenerCustom* _afterUpdateListener;
+    EventListenerCustom* _afterDrawListener;
+    std::chrono::high_resolution_clock::time_point _frameStart;
+    long _elapsedMicroseconds;
+    int _frames;
+
+    static const int SPRITE_COUNT = 50000;
+};
+
+// The sprites are visited and send their QuadCommand every frame
+class StaticSpritesNodePerfTest : public PerformanceStaticBatchScene
+{
+public:
+    CREATE_FUNC(StaticSpritesNodePerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual Node* createContainer() override;
+};
+
+// The quads of the sprites are captured once by a StaticBatchNode
+class StaticSpritesBatchPerfTest : public PerformanceStaticBatchScene
+{
+public:
+    CREATE_FUNC(StaticSpritesBatchPerfTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual Node* createContainer() override;
+};
+
+void runStaticBatchPerformanceTest();
+
+#endif /* __PERFORMANCE_STATIC_BATCH_TEST_H__ */
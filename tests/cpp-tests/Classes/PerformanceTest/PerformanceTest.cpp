@@ -12,6 +12,16 @@
 #include "PerformanceEventDispatcherTest.h"
 #include "PerformanceScenarioTest.h"
 #include "PerformanceCallbackTest.h"
+#include "PerformanceMathTest.h"
+#include "PerformanceStaticBatchTest.h"
+#include "PerformanceUniformTest.h"
+#include "PerformanceDynamicAtlasTest.h"
+#include "PerformanceOpaquePassTest.h"
+#include "PerformanceClippingNodeTest.h"
+#include "PerformanceGridTest.h"
+#include "PerformanceParticleSystemsTest.h"
+#include "PerformanceParticleSpawnTest.h"
+#include "PerformanceInstancedQuadsTest.h"
 
 enum
 {
@@ -36,6 +46,16 @@ struct {
     { "EventDispatcher Perf Test", [](Ref* sender ) { runEventDispatcherPerformanceTest(); } },
     { "Scenario Perf Test", [](Ref* sender ) { runScenarioTest(); } },
     { "Callback Perf Test", [](Ref* sender ) { runCallbackPerformanceTest(); } },
+    { "Math Perf Test", [](Ref* sender ) { runMathPerformanceTest(); } },
+    { "Static Batch Perf Test", [](Ref* sender ) { runStaticBatchPerformanceTest(); } },
+    { "Uniform Perf Test", [](Ref* sender ) { runUniformPerformanceTest(); } },
+    { "Dynamic Atlas Perf Test", [](Ref* sender ) { runDynamicAtlasPerformanceTest(); } },
+    { "Opaque Pass Perf Test", [](Ref* sender ) { runOpaquePassPerformanceTest(); } },
+    { "Clipping Node Perf Test", [](Ref* sender ) { runClippingNodePerformanceTest(); } },
+    { "Grid Effect Perf Test", [](Ref* sender ) { runGridPerformanceTest(); } },
+    { "Particle Systems Perf Test", [](Ref* sender ) { runParticleSystemsPerformanceTest(); } },
+    { "Particle Spawn Perf Test", [](Ref* sender ) { runParticleSpawnPerformanceTest(); } },
+    { "Instanced Quads Perf Test", [](Ref* sender ) { runInstancedQuadsPerformanceTest(); } },
 };
 
 static const int g_testMax = sizeof(g_testsName)/sizeof(g_testsName[0]);
@@ -0,0 +1,270 @@
+//
+//  PerformanceUniformTest.cpp
+//
+
+#include "PerformanceUniformTest.h"
+
+// Enable profiles for this file
+#undef CC_PROFILER_DISPLAY_TIMERS
+#define CC_PROFILER_DISPLAY_TIMERS() Profiler::getInstance()->displayTimers()
+#undef CC_PROFILER_PURGE_ALL
+#define CC_PROFILER_PURGE_ALL() Profiler::getInstance()->releaseAllTimers()
+
+static std::function<PerformanceUniformScene*()> createFunctions[] =
+{
+    CL(UniformByNamePerfTest),
+    CL(UniformByHandlePerfTest),
+};
+
+#define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
+
+
+static int g_curCase = 0;
+
+static const char* s_tintFrag = "                                   \n\
+#ifdef GL_ES                                                        \n\
+precision lowp float;                                               \n\
+#endif                                                              \n\
+                                                                    \n\
+varying vec4 v_fragmentColor;                                       \n\
+varying vec2 v_texCoord;                                            \n\
+uniform vec4 u_tint;                                                \n\
+                                                                    \n\
+void main()                                                         \n\
+{                                                                   \n\
+    gl_FragColor = v_fragmentColor * u_tint * texture2D(CC_Texture0, v_texCoord); \n\
+}                                                                   \n\
+";
+
+////////////////////////////////////////////////////////
+//
+// UniformBasicLayer
+//
+////////////////////////////////////////////////////////
+
+UniformBasicLayer::UniformBasicLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+}
+
+void UniformBasicLayer::showCurrentTest()
+{
+    auto scene = createFunctions[_curCase]();
+
+    g_curCase = _curCase;
+
+    if (scene)
+    {
+        Director::getInstance()->replaceScene(scene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerformanceUniformScene
+//
+////////////////////////////////////////////////////////
+
+bool PerformanceUniformScene::init()
+{
+    if (!Scene::init())
+        return false;
+
+    _time = 0;
+    _resultLabel = nullptr;
+    _afterUpdateListener = nullptr;
+    _afterDrawListener = nullptr;
+    _updateMicroseconds = 0;
+    _drawMicroseconds = 0;
+    _frames = 0;
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto glprogram = GLProgram::createWithByteArrays(ccPositionTextureColor_noMVP_vert, s_tintFrag);
+
+    auto parent = Node::create();
+    addChild(parent);
+
+    _states.reserve(SPRITE_COUNT);
+    for (int i = 0; i < SPRITE_COUNT; ++i)
+    {
+        auto sprite = Sprite::create("Images/grossini_dance_01.png");
+        sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        sprite->setScale(0.25f);
+
+        // one state per sprite: each of them has its own tint
+        auto state = GLProgramState::create(glprogram);
+        sprite->setGLProgramState(state);
+        _states.push_back(state);
+
+        parent->addChild(sprite);
+    }
+
+    return true;
+}
+
+void PerformanceUniformScene::onEnter()
+{
+    Scene::onEnter();
+
+    CC_PROFILER_PURGE_ALL();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto menuLayer = new UniformBasicLayer(true, MAX_LAYER, g_curCase);
+    addChild(menuLayer);
+    menuLayer->release();
+
+    // Title
+    auto label = Label::createWithTTF(title().c_str(), "fonts/arial.ttf", 32);
+    addChild(label, 1);
+    label->setPosition(Vec2(s.width/2, s.height-50));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        auto l = Label::createWithTTF(strSubTitle.c_str(), "fonts/Thonburi.ttf", 16);
+        addChild(l, 1);
+        l->setPosition(Vec2(s.width/2, s.height-80));
+    }
+
+    _resultLabel = Label::createWithTTF(StringUtils::format("%d sprites with a per sprite uniform", SPRITE_COUNT), "fonts/Marker Felt.ttf", 30);
+    _resultLabel->setColor(Color3B(0,200,20));
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel, 1);
+
+    // CPU time of the visit and of the render, where the uniforms are applied
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    _afterUpdateListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [this](EventCustom* event){
+        _frameStart = std::chrono::high_resolution_clock::now();
+    });
+    _afterDrawListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom* event){
+        auto end = std::chrono::high_resolution_clock::now();
+        _drawMicroseconds += static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(end - _frameStart).count());
+        ++_frames;
+    });
+
+    scheduleUpdate();
+    getScheduler()->schedule(schedule_selector(PerformanceUniformScene::dumpProfilerInfo), this, 2, false);
+}
+
+void PerformanceUniformScene::onExit()
+{
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    dispatcher->removeEventListener(_afterUpdateListener);
+    dispatcher->removeEventListener(_afterDrawListener);
+
+    getScheduler()->unscheduleAllForTarget(this);
+    Scene::onExit();
+}
+
+void PerformanceUniformScene::update(float dt)
+{
+    _time += dt;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (int i = 0; i < SPRITE_COUNT; ++i)
+    {
+        float phase = _time + i * 0.01f;
+        setTint(i, Vec4(0.5f + 0.5f * sinf(phase), 0.5f + 0.5f * cosf(phase), 1, 1));
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    _updateMicroseconds += static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+}
+
+std::string PerformanceUniformScene::title() const
+{
+    return "No title";
+}
+
+std::string PerformanceUniformScene::subtitle() const
+{
+    return "";
+}
+
+void PerformanceUniformScene::dumpProfilerInfo(float dt)
+{
+    CC_PROFILER_DISPLAY_TIMERS();
+
+    if (_frames > 0)
+    {
+        float updateMs = _updateMicroseconds / (1000.0f * _frames);
+        float drawMs = _drawMicroseconds / (1000.0f * _frames);
+        _resultLabel->setString(StringUtils::format("set: %.2f ms, visit + render: %.2f ms", updateMs, drawMs));
+        CCLOG("%s: set uniforms %.2f ms/frame, visit + render %.2f ms/frame", _profileName.c_str(), updateMs, drawMs);
+    }
+    _updateMicroseconds = 0;
+    _drawMicroseconds = 0;
+    _frames = 0;
+}
+
+////////////////////////////////////////////////////////
+//
+// UniformByNamePerfTest
+//
+////////////////////////////////////////////////////////
+
+bool UniformByNamePerfTest::init()
+{
+    _profileName = "UniformByName";
+
+    return PerformanceUniformScene::init();
+}
+
+std::string UniformByNamePerfTest::title() const
+{
+    return "10000 uniforms set by name";
+}
+
+std::string UniformByNamePerfTest::subtitle() const
+{
+    return "setUniformVec4(\"u_tint\", ...) every frame. See console";
+}
+
+void UniformByNamePerfTest::setTint(int index, const Vec4& tint)
+{
+    _states[index]->setUniformVec4("u_tint", tint);
+}
+
+////////////////////////////////////////////////////////
+//
+// UniformByHandlePerfTest
+//
+////////////////////////////////////////////////////////
+
+bool UniformByHandlePerfTest::init()
+{
+    _profileName = "UniformByHandle";
+
+    if (!PerformanceUniformScene::init())
+        return false;
+
+    // all the states share the program: they have the same handles
+    _tintHandle = _states[0]->getUniformHandle("u_tint");
+    return true;
+}
+
+std::string UniformByHandlePerfTest::title() const
+{
+    return "10000 uniforms set by handle";
+}
+
+std::string UniformByHandlePerfTest::subtitle() const
+{
+    return "getUniformHandle(\"u_tint\") once, setUniformVec4(handle, ...) every frame. See console";
+}
+
+void UniformByHandlePerfTest::setTint(int index, const Vec4& tint)
+{
+    _states[index]->setUniformVec4(_tintHandle, tint);
+}
+
+void runUniformPerformanceTest()
+{
+    auto scene = createFunctions[g_curCase]();
+
+    Director::getInstance()->replaceScene(scene);
+}
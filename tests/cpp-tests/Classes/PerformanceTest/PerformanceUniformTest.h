@@ -0,0 +1,82 @@
+//
+//  PerformanceUniformTest.h
+
+#ifndef __PERFORMANCE_UNIFORM_TEST_H__
+#define __PERFORMANCE_UNIFORM_TEST_H__
+
+#include <chrono>
+
+#include "PerformanceTest.h"
+
+class UniformBasicLayer : public PerformBasicLayer
+{
+public:
+    UniformBasicLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+
+    virtual void showCurrentTest();
+};
+
+// Sprites with their own GLProgramState, their tint uniform is changed every frame
+class PerformanceUniformScene : public Scene
+{
+public:
+    virtual bool init() override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+
+    virtual std::string title() const;
+    virtual std::string subtitle() const;
+
+    // sets the tint uniform of the sprite `index`
+    virtual void setTint(int index, const Vec4& tint) = 0;
+
+    void dumpProfilerInfo(float dt);
+protected:
+
+    std::string _profileName;
+
+    std::vector<GLProgramState*> _states;
+    float _time;
+
+    Label* _resultLabel;
+    EventListenerCustom* _afterUpdateListener;
+    EventListenerCustom* _afterDrawListener;
+    std::chrono::high_resolution_clock::time_point _frameStart;
+    long _updateMicroseconds;
+    long _drawMicroseconds;
+    int _frames;
+
+    static const int SPRITE_COUNT = 10000;
+};
+
+// The uniform is set by name
+class UniformByNamePerfTest : public PerformanceUniformScene
+{
+public:
+    CREATE_FUNC(UniformByNamePerfTest);
+
+    virtual bool init() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void setTint(int index, const Vec4& tint) override;
+};
+
+// The uniform is set with the handle resolved once
+class UniformByHandlePerfTest : public PerformanceUniformScene
+{
+public:
+    CREATE_FUNC(UniformByHandlePerfTest);
+
+    virtual bool init() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void setTint(int index, const Vec4& tint) override;
+
+protected:
+    int _tintHandle;
+};
+
+void runUniformPerformanceTest();
+
+#endif /* __PERFORMANCE_UNIFORM_TEST_H__ */
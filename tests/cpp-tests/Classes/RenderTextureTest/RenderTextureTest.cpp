@@ -139,19 +139,19 @@ void RenderTextureSave::saveImage(cocos2d::Ref *sender)
     sprintf(jpg, "image-%d.jpg", counter);
 
     _target->saveToFile(png, Image::Format::PNG);
-    _target->saveToFile(jpg, Image::Format::JPG);
-    
-    std::string fileName = FileUtils::getInstance()->getWritablePath() + jpg;
-    auto action1 = DelayTime::create(1);
-    auto func = [&,fileName]()
+
+    // the file is written in the background, show it once it is there
+    int rotation = counter * 3;
+    retain();
+    _target->saveToFile(jpg, Image::Format::JPG, [this, rotation](RenderTexture* renderTexture, const std::string& fullpath)
     {
-        auto sprite = Sprite::create(fileName);
+        auto sprite = Sprite::create(fullpath);
         addChild(sprite);
         sprite->setScale(0.3f);
         sprite->setPosition(Vec2(40, 40));
-        sprite->setRotation(counter * 3);
-    };
-    runAction(Sequence::create(action1, CallFunc::create(func), NULL));
+        sprite->setRotation(rotation);
+        release();
+    });
 
     CCLOG("Image saved %s and %s", png, jpg);
 
@@ -544,25 +544,25 @@ void RenderTextureTestDepthStencil::draw(Renderer *renderer, const Mat4 &transfo
 
 void RenderTextureTestDepthStencil::onBeforeClear()
 {
-    glStencilMask(0xFF);
+    GL::stencilMask(0xFF);
 }
 
 void RenderTextureTestDepthStencil::onBeforeStencil()
 {
     //! mark sprite quad into stencil buffer
-    glEnable(GL_STENCIL_TEST);
-    glStencilFunc(GL_NEVER, 1, 0xFF);
-    glStencilOp(GL_REPLACE, GL_REPLACE, GL_REPLACE);
+    GL::enable(GL_STENCIL_TEST);
+    GL::stencilFunc(GL_NEVER, 1, 0xFF);
+    GL::stencilOp(GL_REPLACE, GL_REPLACE, GL_REPLACE);
 }
 
 void RenderTextureTestDepthStencil::onBeforDraw()
 {
-    glStencilFunc(GL_NOTEQUAL, 1, 0xFF);
+    GL::stencilFunc(GL_NOTEQUAL, 1, 0xFF);
 }
 
 void RenderTextureTestDepthStencil::onAfterDraw()
 {
-    glDisable(GL_STENCIL_TEST);
+    GL::disable(GL_STENCIL_TEST);
 }
 
 std::string RenderTextureTestDepthStencil::title() const
@@ -12,5 +12,46 @@ int main(int argc, char **argv)
 {
     // create the application instance
     AppDelegate app;
+
+#if CC_USE_HEADLESS
+    // cpp-tests [--headless[=null|osmesa]] [--frames N]
+    // --headless runs without a window (GLViewHeadless), with GLNull by default.
+    // --frames quits after N frames; the tests can be driven with the "autotest" console command.
+    bool headless = false;
+    auto backend = GLViewHeadless::Backend::NULL_GL;
+    unsigned int frames = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--headless")
+        {
+            headless = true;
+        }
+        else if (arg.compare(0, 11, "--headless=") == 0)
+        {
+            headless = true;
+            if (!GLViewHeadless::getBackendByName(arg.substr(11), &backend))
+            {
+                fprintf(stderr, "unknown headless backend: %s\n", arg.c_str() + 11);
+                return 1;
+            }
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            frames = atoi(argv[++i]);
+        }
+    }
+
+    if (headless)
+    {
+        auto glview = GLViewHeadless::create("Cpp Tests", Size(960, 640), backend);
+        if (!glview)
+            return 1;
+
+        glview->setFrameLimit(frames);
+        Director::getInstance()->setOpenGLView(glview);
+    }
+#endif // CC_USE_HEADLESS
+
     return Application::getInstance()->run();
 }
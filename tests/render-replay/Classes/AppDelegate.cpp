@@ -0,0 +1,117 @@
+#include "AppDelegate.h"
+
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#include "renderer/CCRenderCapture.h"
+#if CC_USE_HEADLESS
+#include "2d/platform/linux/CCGLNull.h"
+#endif
+
+USING_NS_CC;
+
+AppDelegate::AppDelegate(const std::string& captureFile, int iterations)
+: _captureFile(captureFile)
+, _iterations(iterations)
+, _exitCode(1)
+{
+}
+
+AppDelegate::~AppDelegate()
+{
+}
+
+bool AppDelegate::applicationDidFinishLaunching() {
+    auto director = Director::getInstance();
+    auto glview = director->getOpenGLView();
+    if(!glview) {
+        glview = GLView::create("Render Replay");
+        director->setOpenGLView(glview);
+    }
+
+    RenderReplay replay;
+    if (_captureFile.empty() || !replay.load(_captureFile))
+    {
+        log("usage: render-replay [--headless[=null|osmesa]] <capture file> [iterations]");
+        return false;
+    }
+
+    auto renderer = director->getRenderer();
+    ssize_t frameCount = replay.getFrameCount();
+
+    struct FrameStats
+    {
+        double totalMs;
+        double minMs;
+        double maxMs;
+        ssize_t batches;
+        ssize_t vertices;
+    };
+    std::vector<FrameStats> stats(frameCount);
+
+    // first pass: warm up, creates the GL objects of the renderer and of the driver
+    for (ssize_t frame = 0; frame < frameCount; ++frame)
+    {
+        replay.submitFrame(renderer, frame);
+        renderer->render();
+        stats[frame].totalMs = stats[frame].maxMs = 0;
+        stats[frame].minMs = 1e9;
+        stats[frame].batches = renderer->getDrawnBatches();
+        stats[frame].vertices = renderer->getDrawnVertices();
+    }
+    glFinish();
+#if CC_USE_HEADLESS
+    GLNull::resetCallCounts();
+#endif
+
+    for (int i = 0; i < _iterations; ++i)
+    {
+        for (ssize_t frame = 0; frame < frameCount; ++frame)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+
+            replay.submitFrame(renderer, frame);
+            renderer->render();
+
+            auto end = std::chrono::high_resolution_clock::now();
+            double ms = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+
+            auto& frameStats = stats[frame];
+            frameStats.totalMs += ms;
+            frameStats.minMs = std::min(frameStats.minMs, ms);
+            frameStats.maxMs = std::max(frameStats.maxMs, ms);
+        }
+
+        // don't let the driver queue up more than one replay
+        glFinish();
+    }
+
+    double totalMs = 0;
+    log("frame, avg ms, min ms, max ms, batches, vertices");
+    for (ssize_t frame = 0; frame < frameCount; ++frame)
+    {
+        const auto& frameStats = stats[frame];
+        log("%d, %.3f, %.3f, %.3f, %d, %d", (int) frame, frameStats.totalMs / _iterations, frameStats.minMs, frameStats.maxMs,
+            (int) frameStats.batches, (int) frameStats.vertices);
+        totalMs += frameStats.totalMs;
+    }
+    log("%d frames x %d iterations: %.3f ms/frame", (int) frameCount, _iterations, totalMs / (frameCount * _iterations));
+#if CC_USE_HEADLESS
+    if (GLNull::isInstalled())
+    {
+        log("GLNull: %.1f GL calls/frame", GLNull::getTotalCallCount() / (double)(frameCount * _iterations));
+    }
+#endif
+
+    _exitCode = 0;
+
+    // nothing else to run
+    return false;
+}
+
+void AppDelegate::applicationDidEnterBackground() {
+}
+
+void AppDelegate::applicationWillEnterForeground() {
+}
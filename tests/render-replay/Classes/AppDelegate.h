@@ -0,0 +1,30 @@
+#ifndef  _APP_DELEGATE_H_
+#define  _APP_DELEGATE_H_
+
+#include "cocos2d.h"
+
+/**
+@brief    Replays a render capture (see cocos2d::RenderCapture) in a tight loop and prints the timings.
+
+No scene is run: everything happens in applicationDidFinishLaunching(), which returns false so that the application quits.
+*/
+class  AppDelegate : private cocos2d::Application
+{
+public:
+    AppDelegate(const std::string& captureFile, int iterations);
+    virtual ~AppDelegate();
+
+    virtual bool applicationDidFinishLaunching();
+    virtual void applicationDidEnterBackground();
+    virtual void applicationWillEnterForeground();
+
+    /** 0 if the capture was replayed, 1 otherwise */
+    int getExitCode() const { return _exitCode; }
+
+protected:
+    std::string _captureFile;
+    int _iterations;
+    int _exitCode;
+};
+
+#endif // _APP_DELEGATE_H_
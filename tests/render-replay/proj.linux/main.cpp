@@ -0,0 +1,65 @@
+#include "../Classes/AppDelegate.h"
+#include "cocos2d.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+USING_NS_CC;
+
+int main(int argc, char **argv)
+{
+    // render-replay [--headless[=null|osmesa]] <capture file> [iterations]
+    // --headless is only there when the engine is built with USE_HEADLESS
+#if CC_USE_HEADLESS
+    bool headless = false;
+    auto backend = GLViewHeadless::Backend::NULL_GL;
+#endif
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+#if CC_USE_HEADLESS
+        if (arg == "--headless")
+        {
+            headless = true;
+        }
+        else if (arg.compare(0, 11, "--headless=") == 0)
+        {
+            headless = true;
+            if (!GLViewHeadless::getBackendByName(arg.substr(11), &backend))
+            {
+                fprintf(stderr, "unknown headless backend: %s\n", arg.c_str() + 11);
+                return 1;
+            }
+        }
+        else
+#endif
+        {
+            args.push_back(arg);
+        }
+    }
+
+    std::string captureFile = args.size() > 0 ? args[0] : "";
+    int iterations = args.size() > 1 ? atoi(args[1].c_str()) : 100;
+
+    // create the application instance
+    AppDelegate app(captureFile, iterations > 0 ? iterations : 1);
+
+#if CC_USE_HEADLESS
+    if (headless)
+    {
+        auto glview = GLViewHeadless::create("Render Replay", Size(960, 640), backend);
+        if (!glview)
+            return 1;
+
+        Director::getInstance()->setOpenGLView(glview);
+    }
+#endif
+
+    Application::getInstance()->run();
+
+    return app.getExitCode();
+}